@@ -12,8 +12,10 @@
 #define API_AUDIO_AUDIO_MIXER_H_
 
 #include <memory>
+#include <optional>
 
 #include "api/audio/audio_frame.h"
+#include "api/rtp_headers.h"
 #include "rtc_base/ref_count.h"
 
 namespace webrtc {
@@ -48,6 +50,21 @@ class AudioMixer : public RefCountInterface {
     // with this sample rate or higher will not cause quality loss.
     virtual int PreferredSampleRate() const = 0;
 
+    // Returns the audio level and voice activity of the audio that the next
+    // GetAudioFrameWithInfo() call would produce, if the source knows them
+    // without producing the audio, e.g. from the RTP audio level header
+    // extension of the latest received packet. Mixers may use them to not
+    // ask inactive sources for audio at all, so a source returning a level
+    // must tolerate not being asked for audio for a while.
+    virtual std::optional<AudioLevel> LatestAudioLevel() const {
+      return std::nullopt;
+    }
+
+    // Called with true when a mixer stops asking the source for audio because
+    // of its `LatestAudioLevel()`, and with false before it asks again. While
+    // deselected, the source may drop the audio it would have produced.
+    virtual void SetDeselected(bool /* deselected */) {}
+
     virtual ~Source() {}
   };
 
@@ -56,6 +56,9 @@ std::string AudioReceiveStreamInterface::Config::ToString() const {
   if (!sync_group.empty()) {
     ss << ", sync_group: " << sync_group;
   }
+  if (encoded_frame_sink) {
+    ss << ", encoded_frame_sink: (EncodedFrameSink)";
+  }
   ss << '}';
   return ss.str();
 }
@@ -74,9 +77,10 @@ std::unique_ptr<voe::ChannelReceiveInterface> CreateChannelReceive(
       config.rtcp_send_transport, config.rtp.local_ssrc, config.rtp.remote_ssrc,
       config.jitter_buffer_max_packets, config.jitter_buffer_fast_accelerate,
       config.jitter_buffer_min_delay_ms, config.enable_non_sender_rtt,
-      config.decoder_factory, config.codec_pair_id,
+      config.use_polyphase_resampler, config.decoder_factory,
+      config.codec_pair_id,
       std::move(config.frame_decryptor), config.crypto_options,
-      std::move(config.frame_transformer));
+      std::move(config.frame_transformer), config.encoded_frame_sink);
 }
 }  // namespace
 
@@ -158,6 +162,8 @@ void AudioReceiveStreamImpl::ReconfigureForTesting(
   // Decoder factory cannot be changed because it is configured at
   // voe::Channel construction time.
   RTC_DCHECK_EQ(config_.decoder_factory, config.decoder_factory);
+  // The encoded frame sink is passed to voe::Channel at construction time.
+  RTC_DCHECK_EQ(config_.encoded_frame_sink, config.encoded_frame_sink);
 
   // TODO(solenberg): Config NACK history window (which is a packet count),
   // using the actual packet size for the configured codec.
@@ -179,7 +185,11 @@ void AudioReceiveStreamImpl::Start() {
   RTC_LOG(LS_INFO) << "AudioReceiveStreamImpl::Start: " << remote_ssrc();
   channel_receive_->StartPlayout();
   playing_ = true;
-  audio_state()->AddReceivingStream(this);
+  // Pass-through streams are not mixed, which leaves playout to the other
+  // streams and keeps the audio device idle if there are none.
+  if (!config_.encoded_frame_sink) {
+    audio_state()->AddReceivingStream(this);
+  }
 }
 
 void AudioReceiveStreamImpl::Stop() {
@@ -190,7 +200,9 @@ void AudioReceiveStreamImpl::Stop() {
   RTC_LOG(LS_INFO) << "AudioReceiveStreamImpl::Stop: " << remote_ssrc();
   channel_receive_->StopPlayout();
   playing_ = false;
-  audio_state()->RemoveReceivingStream(this);
+  if (!config_.encoded_frame_sink) {
+    audio_state()->RemoveReceivingStream(this);
+  }
 }
 
 bool AudioReceiveStreamImpl::IsRunning() const {
@@ -384,6 +396,14 @@ int AudioReceiveStreamImpl::PreferredSampleRate() const {
   return channel_receive_->PreferredSampleRate();
 }
 
+std::optional<AudioLevel> AudioReceiveStreamImpl::LatestAudioLevel() const {
+  return channel_receive_->LatestAudioLevel();
+}
+
+void AudioReceiveStreamImpl::SetDeselected(bool deselected) {
+  channel_receive_->SetDeselected(deselected);
+}
+
 uint32_t AudioReceiveStreamImpl::id() const {
   RTC_DCHECK_RUN_ON(&worker_thread_checker_);
   return remote_ssrc();
@@ -105,6 +105,8 @@ class AudioReceiveStreamImpl final : public webrtc::AudioReceiveStreamInterface,
                                        AudioFrame* audio_frame) override;
   int Ssrc() const override;
   int PreferredSampleRate() const override;
+  std::optional<AudioLevel> LatestAudioLevel() const override;
+  void SetDeselected(bool deselected) override;
 
   // Syncable
   uint32_t id() const override;
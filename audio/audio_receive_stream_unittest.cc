@@ -337,6 +337,23 @@ TEST(AudioReceiveStreamTest, SetGain) {
   }
 }
 
+TEST(AudioReceiveStreamTest, ReportsLatestAudioLevelOfChannel) {
+  test::RunLoop loop;
+  for (bool use_null_audio_processing : {false, true}) {
+    ConfigHelper helper(use_null_audio_processing);
+    auto recv_stream = helper.CreateAudioReceiveStream();
+    EXPECT_CALL(*helper.channel_receive(), LatestAudioLevel())
+        .WillOnce(Return(std::nullopt))
+        .WillOnce(Return(AudioLevel(/*voice_activity=*/true, 30)));
+    EXPECT_FALSE(recv_stream->LatestAudioLevel());
+    std::optional<AudioLevel> audio_level = recv_stream->LatestAudioLevel();
+    ASSERT_TRUE(audio_level);
+    EXPECT_TRUE(audio_level->voice_activity());
+    EXPECT_EQ(audio_level->level(), 30);
+    recv_stream->UnregisterFromTransport();
+  }
+}
+
 TEST(AudioReceiveStreamTest, StreamsShouldBeAddedToMixerOnceOnStart) {
   test::RunLoop loop;
   for (bool use_null_audio_processing : {false, true}) {
@@ -372,6 +389,36 @@ TEST(AudioReceiveStreamTest, StreamsShouldBeAddedToMixerOnceOnStart) {
   }
 }
 
+TEST(AudioReceiveStreamTest, PassThroughStreamsShouldNotBeAddedToMixer) {
+  class NullEncodedFrameSink
+      : public AudioReceiveStreamInterface::EncodedFrameSink {
+   public:
+    void OnEncodedFrame(rtc::ArrayView<const uint8_t> payload,
+                        const RTPHeader& header,
+                        Timestamp receive_time) override {}
+  };
+
+  test::RunLoop loop;
+  for (bool use_null_audio_processing : {false, true}) {
+    NullEncodedFrameSink encoded_frame_sink;
+    ConfigHelper helper(use_null_audio_processing);
+    helper.config().encoded_frame_sink = &encoded_frame_sink;
+    auto recv_stream = helper.CreateAudioReceiveStream();
+
+    EXPECT_CALL(*helper.channel_receive(), StartPlayout()).Times(1);
+    EXPECT_CALL(*helper.channel_receive(), StopPlayout()).Times(1);
+    EXPECT_CALL(*helper.audio_mixer(), AddSource(_)).Times(0);
+    EXPECT_CALL(*helper.audio_mixer(), RemoveSource(_)).Times(0);
+
+    recv_stream->Start();
+    EXPECT_TRUE(recv_stream->IsRunning());
+    recv_stream->Stop();
+    EXPECT_FALSE(recv_stream->IsRunning());
+
+    recv_stream->UnregisterFromTransport();
+  }
+}
+
 TEST(AudioReceiveStreamTest, ReconfigureWithUpdatedConfig) {
   test::RunLoop loop;
   for (bool use_null_audio_processing : {false, true}) {
@@ -11,6 +11,7 @@
 #include "audio/channel_receive.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <map>
@@ -96,6 +97,13 @@ constexpr double kAudioSampleDurationSeconds = 0.01;
 constexpr int kVoiceEngineMinMinPlayoutDelayMs = 0;
 constexpr int kVoiceEngineMaxMinPlayoutDelayMs = 10000;
 
+// A mixer that selects active speakers by `LatestAudioLevel()` stops pulling
+// audio from the other streams and tells them with `SetDeselected()`. While
+// deselected, NetEq is flushed whenever it may hold more than this much audio,
+// so that playout resumes from recent packets instead of from a backlog that
+// has built up since the last pull.
+constexpr TimeDelta kMaxDeselectedBufferedAudio = TimeDelta::Millis(100);
+
 std::unique_ptr<NetEq> CreateNetEq(
     NetEqFactory* neteq_factory,
     std::optional<AudioCodecPairId> codec_pair_id,
@@ -131,11 +139,13 @@ class ChannelReceive : public ChannelReceiveInterface,
       bool jitter_buffer_fast_playout,
       int jitter_buffer_min_delay_ms,
       bool enable_non_sender_rtt,
+      bool use_polyphase_resampler,
       rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
       std::optional<AudioCodecPairId> codec_pair_id,
       rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
       const webrtc::CryptoOptions& crypto_options,
-      rtc::scoped_refptr<FrameTransformerInterface> frame_transformer);
+      rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+      AudioReceiveStreamInterface::EncodedFrameSink* encoded_frame_sink);
   ~ChannelReceive() override;
 
   void SetSink(AudioSinkInterface* sink) override;
@@ -201,6 +211,9 @@ class ChannelReceive : public ChannelReceiveInterface,
 
   int PreferredSampleRate() const override;
 
+  std::optional<webrtc::AudioLevel> LatestAudioLevel() const override;
+  void SetDeselected(bool deselected) override;
+
   std::vector<RtpSource> GetSources() const override;
 
   // Associate to a send channel.
@@ -262,6 +275,16 @@ class ChannelReceive : public ChannelReceiveInterface,
   Mutex callback_mutex_;
   Mutex volume_settings_mutex_;
   mutable Mutex call_stats_mutex_;
+  mutable Mutex audio_level_mutex_;
+
+  // Audio level of the latest received packet.
+  std::optional<webrtc::AudioLevel> latest_audio_level_
+      RTC_GUARDED_BY(audio_level_mutex_);
+
+  // Set by the mixer, see `kMaxDeselectedBufferedAudio`.
+  std::atomic<bool> deselected_{false};
+  Timestamp last_deselected_flush_time_
+      RTC_GUARDED_BY(worker_thread_checker_) = Timestamp::MinusInfinity();
 
   bool playing_ RTC_GUARDED_BY(worker_thread_checker_) = false;
 
@@ -348,6 +371,12 @@ class ChannelReceive : public ChannelReceiveInterface,
       RTC_GUARDED_BY(rtcp_counter_mutex_);
 
   std::map<int, SdpAudioFormat> payload_type_map_;
+
+  // If set, received frames are forwarded to the sink instead of NetEq.
+  AudioReceiveStreamInterface::EncodedFrameSink* const encoded_frame_sink_;
+  // Payload type of the last frame forwarded to `encoded_frame_sink_`.
+  std::optional<int> last_forwarded_payload_type_
+      RTC_GUARDED_BY(worker_thread_checker_);
 };
 
 void ChannelReceive::OnReceivedPayloadData(
@@ -373,6 +402,30 @@ void ChannelReceive::OnReceivedPayloadData(
     return;
   }
 
+  if (encoded_frame_sink_) {
+    // Pass-through stream: nothing pulls audio out of NetEq, so the frame is
+    // "delivered" on arrival, like above, and forwarded without decoding.
+    RtpPacketInfos::vector_type packet_vector = {
+        RtpPacketInfo(rtpHeader, receive_time)};
+    source_tracker_.OnFrameDelivered(RtpPacketInfos(packet_vector),
+                                     env_.clock().CurrentTime());
+    last_forwarded_payload_type_ = rtpHeader.payloadType;
+    encoded_frame_sink_->OnEncodedFrame(payload, rtpHeader, receive_time);
+    return;
+  }
+
+  if (rtpHeader.extension.audio_level()) {
+    MutexLock lock(&audio_level_mutex_);
+    latest_audio_level_ = rtpHeader.extension.audio_level();
+  }
+  if (deselected_.load(std::memory_order_relaxed)) {
+    const Timestamp now = env_.clock().CurrentTime();
+    if (now - last_deselected_flush_time_ > kMaxDeselectedBufferedAudio) {
+      last_deselected_flush_time_ = now;
+      neteq_->FlushBuffers();
+    }
+  }
+
   // Push the incoming payload (parsed and ready for decoding) into NetEq.
   if (payload.empty()) {
     neteq_->InsertEmptyPacket(rtpHeader);
@@ -565,6 +618,15 @@ int ChannelReceive::PreferredSampleRate() const {
                   neteq_->last_output_sample_rate_hz());
 }
 
+std::optional<webrtc::AudioLevel> ChannelReceive::LatestAudioLevel() const {
+  MutexLock lock(&audio_level_mutex_);
+  return latest_audio_level_;
+}
+
+void ChannelReceive::SetDeselected(bool deselected) {
+  deselected_.store(deselected, std::memory_order_relaxed);
+}
+
 ChannelReceive::ChannelReceive(
     const Environment& env,
     NetEqFactory* neteq_factory,
@@ -576,11 +638,13 @@ ChannelReceive::ChannelReceive(
     bool jitter_buffer_fast_playout,
     int jitter_buffer_min_delay_ms,
     bool enable_non_sender_rtt,
+    bool use_polyphase_resampler,
     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
     std::optional<AudioCodecPairId> codec_pair_id,
     rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
     const webrtc::CryptoOptions& crypto_options,
-    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer)
+    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+    AudioReceiveStreamInterface::EncodedFrameSink* encoded_frame_sink)
     : env_(env),
       worker_thread_(TaskQueueBase::Current()),
       rtp_receive_statistics_(ReceiveStatistics::Create(&env_.clock())),
@@ -593,6 +657,7 @@ ChannelReceive::ChannelReceive(
                          jitter_buffer_min_delay_ms,
                          env_,
                          decoder_factory)),
+      resampler_helper_(use_polyphase_resampler),
       _outputAudioLevel(),
       ntp_estimator_(&env_.clock()),
       playout_timestamp_rtp_(0),
@@ -604,7 +669,8 @@ ChannelReceive::ChannelReceive(
       associated_send_channel_(nullptr),
       frame_decryptor_(frame_decryptor),
       crypto_options_(crypto_options),
-      absolute_capture_time_interpolator_(&env_.clock()) {
+      absolute_capture_time_interpolator_(&env_.clock()),
+      encoded_frame_sink_(encoded_frame_sink) {
   RTC_DCHECK(audio_device_module);
 
   network_thread_checker_.Detach();
@@ -648,6 +714,8 @@ void ChannelReceive::SetSink(AudioSinkInterface* sink) {
 void ChannelReceive::StartPlayout() {
   RTC_DCHECK_RUN_ON(&worker_thread_checker_);
   playing_ = true;
+  // A mixer adding the stream again starts pulling it right away.
+  deselected_.store(false, std::memory_order_relaxed);
 }
 
 void ChannelReceive::StopPlayout() {
@@ -663,6 +731,13 @@ std::optional<std::pair<int, SdpAudioFormat>> ChannelReceive::GetReceiveCodec()
   std::optional<NetEq::DecoderFormat> decoder =
       neteq_->GetCurrentDecoderFormat();
   if (!decoder) {
+    // Pass-through streams never decode, report the forwarded codec instead.
+    if (last_forwarded_payload_type_) {
+      auto it = payload_type_map_.find(*last_forwarded_payload_type_);
+      if (it != payload_type_map_.end()) {
+        return std::make_pair(it->first, it->second);
+      }
+    }
     return std::nullopt;
   }
   return std::make_pair(decoder->payload_type, decoder->sdp_format);
@@ -1231,17 +1306,20 @@ std::unique_ptr<ChannelReceiveInterface> CreateChannelReceive(
     bool jitter_buffer_fast_playout,
     int jitter_buffer_min_delay_ms,
     bool enable_non_sender_rtt,
+    bool use_polyphase_resampler,
     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
     std::optional<AudioCodecPairId> codec_pair_id,
     rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
     const webrtc::CryptoOptions& crypto_options,
-    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer) {
+    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+    AudioReceiveStreamInterface::EncodedFrameSink* encoded_frame_sink) {
   return std::make_unique<ChannelReceive>(
       env, neteq_factory, audio_device_module, rtcp_send_transport, local_ssrc,
       remote_ssrc, jitter_buffer_max_packets, jitter_buffer_fast_playout,
-      jitter_buffer_min_delay_ms, enable_non_sender_rtt, decoder_factory,
-      codec_pair_id, std::move(frame_decryptor), crypto_options,
-      std::move(frame_transformer));
+      jitter_buffer_min_delay_ms, enable_non_sender_rtt,
+      use_polyphase_resampler, decoder_factory, codec_pair_id,
+      std::move(frame_decryptor), crypto_options, std::move(frame_transformer),
+      encoded_frame_sink);
 }
 
 }  // namespace voe
@@ -25,7 +25,9 @@
 #include "api/environment/environment.h"
 #include "api/frame_transformer_interface.h"
 #include "api/neteq/neteq_factory.h"
+#include "api/rtp_headers.h"
 #include "api/transport/rtp/rtp_source.h"
+#include "call/audio_receive_stream.h"
 #include "call/rtp_packet_sink_interface.h"
 #include "call/syncable.h"
 #include "modules/audio_coding/include/audio_coding_module_typedefs.h"
@@ -151,6 +153,13 @@ class ChannelReceiveInterface : public RtpPacketSinkInterface {
 
   virtual int PreferredSampleRate() const = 0;
 
+  // Returns the audio level carried by the RTP audio level header extension
+  // of the latest received packet, if any. See
+  // `AudioMixer::Source::LatestAudioLevel()`.
+  virtual std::optional<webrtc::AudioLevel> LatestAudioLevel() const = 0;
+  // See `AudioMixer::Source::SetDeselected()`.
+  virtual void SetDeselected(bool deselected) = 0;
+
   virtual std::vector<RtpSource> GetSources() const = 0;
 
   // Associate to a send channel.
@@ -182,11 +191,13 @@ std::unique_ptr<ChannelReceiveInterface> CreateChannelReceive(
     bool jitter_buffer_fast_playout,
     int jitter_buffer_min_delay_ms,
     bool enable_non_sender_rtt,
+    bool use_polyphase_resampler,
     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
     std::optional<AudioCodecPairId> codec_pair_id,
     rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
     const webrtc::CryptoOptions& crypto_options,
-    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer);
+    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+    AudioReceiveStreamInterface::EncodedFrameSink* encoded_frame_sink);
 
 }  // namespace voe
 }  // namespace webrtc
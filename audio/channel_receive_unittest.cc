@@ -17,12 +17,14 @@
 #include "api/environment/environment_factory.h"
 #include "api/test/mock_frame_transformer.h"
 #include "modules/audio_device/include/mock_audio_device.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/ntp_time_util.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/thread.h"
@@ -36,6 +38,9 @@ namespace webrtc {
 namespace voe {
 namespace {
 
+using ::testing::_;
+using ::testing::ElementsAreArray;
+using ::testing::Field;
 using ::testing::NiceMock;
 using ::testing::NotNull;
 using ::testing::Return;
@@ -48,6 +53,17 @@ constexpr char kPayloadName[] = "PCMA";
 constexpr int kPayloadType = 8;
 constexpr int kSampleRateHz = 8000;
 
+class MockEncodedFrameSink
+    : public AudioReceiveStreamInterface::EncodedFrameSink {
+ public:
+  MOCK_METHOD(void,
+              OnEncodedFrame,
+              (rtc::ArrayView<const uint8_t> payload,
+               const RTPHeader& header,
+               Timestamp receive_time),
+              (override));
+};
+
 class ChannelReceiveTest : public Test {
  public:
   ChannelReceiveTest()
@@ -55,21 +71,26 @@ class ChannelReceiveTest : public Test {
         audio_device_module_(test::MockAudioDeviceModule::CreateNice()),
         audio_decoder_factory_(CreateBuiltinAudioDecoderFactory()) {
     ON_CALL(*audio_device_module_, PlayoutDelay).WillByDefault(Return(0));
+    extensions_.Register<AudioLevelExtension>(/*id=*/1);
   }
 
-  std::unique_ptr<ChannelReceiveInterface> CreateTestChannelReceive() {
+  std::unique_ptr<ChannelReceiveInterface> CreateTestChannelReceive(
+      AudioReceiveStreamInterface::EncodedFrameSink* encoded_frame_sink =
+          nullptr,
+      size_t jitter_buffer_max_packets = 0) {
     CryptoOptions crypto_options;
     auto channel = CreateChannelReceive(
         CreateEnvironment(time_controller_.GetClock()),
         /* neteq_factory= */ nullptr, audio_device_module_.get(), &transport_,
         kLocalSsrc, kRemoteSsrc,
-        /* jitter_buffer_max_packets= */ 0,
+        jitter_buffer_max_packets,
         /* jitter_buffer_fast_playout= */ false,
         /* jitter_buffer_min_delay_ms= */ 0,
-        /* enable_non_sender_rtt= */ false, audio_decoder_factory_,
+        /* enable_non_sender_rtt= */ false,
+        /* use_polyphase_resampler= */ false, audio_decoder_factory_,
         /* codec_pair_id= */ std::nullopt,
         /* frame_decryptor_interface= */ nullptr, crypto_options,
-        /* frame_transformer= */ nullptr);
+        /* frame_transformer= */ nullptr, encoded_frame_sink);
     channel->SetReceiveCodecs(
         {{kPayloadType, {kPayloadName, kSampleRateHz, 1}}});
     return channel;
@@ -82,8 +103,12 @@ class ChannelReceiveTest : public Test {
     return rtc::TimeMillis() * 1000 / kSampleRateHz;
   }
 
-  RtpPacketReceived CreateRtpPacket() {
-    RtpPacketReceived packet;
+  RtpPacketReceived CreateRtpPacket(
+      std::optional<AudioLevel> audio_level = std::nullopt) {
+    RtpPacketReceived packet(&extensions_);
+    if (audio_level) {
+      packet.SetExtension<AudioLevelExtension>(*audio_level);
+    }
     packet.set_arrival_time(time_controller_.GetClock()->CurrentTime());
     packet.SetTimestamp(RtpNow());
     packet.SetSsrc(kLocalSsrc);
@@ -159,6 +184,7 @@ class ChannelReceiveTest : public Test {
   rtc::scoped_refptr<test::MockAudioDeviceModule> audio_device_module_;
   rtc::scoped_refptr<AudioDecoderFactory> audio_decoder_factory_;
   MockTransport transport_;
+  RtpHeaderExtensionMap extensions_;
 };
 
 TEST_F(ChannelReceiveTest, CreateAndDestroy) {
@@ -260,6 +286,111 @@ TEST_F(ChannelReceiveTest, SettingFrameTransformerMultipleTimes) {
   channel->SetDepacketizerToDecoderFrameTransformer(mock_frame_transformer);
 }
 
+TEST_F(ChannelReceiveTest, ForwardsFramesToEncodedFrameSink) {
+  MockEncodedFrameSink encoded_frame_sink;
+  auto channel = CreateTestChannelReceive(&encoded_frame_sink);
+  EXPECT_FALSE(channel->GetReceiveCodec());
+
+  // Must start playout, otherwise packet is discarded.
+  channel->StartPlayout();
+
+  RtpPacketReceived packet = CreateRtpPacket();
+  packet.SetSsrc(kRemoteSsrc);
+  rtc::ArrayView<const uint8_t> payload = packet.payload();
+  EXPECT_CALL(encoded_frame_sink,
+              OnEncodedFrame(ElementsAreArray(payload),
+                             Field(&RTPHeader::payloadType, kPayloadType),
+                             packet.arrival_time()));
+  channel->OnRtpPacket(packet);
+
+  // The frame is not decoded, but the codec and the RTP stats are reported.
+  std::optional<std::pair<int, SdpAudioFormat>> codec =
+      channel->GetReceiveCodec();
+  ASSERT_TRUE(codec);
+  EXPECT_EQ(codec->first, kPayloadType);
+  EXPECT_EQ(codec->second.name, kPayloadName);
+  EXPECT_EQ(channel->GetRTCPStatistics().packets_received, 1);
+  EXPECT_EQ(channel->GetSources().size(), 1u);
+}
+
+TEST_F(ChannelReceiveTest, DiscardsFramesForEncodedFrameSinkWhenNotPlaying) {
+  MockEncodedFrameSink encoded_frame_sink;
+  auto channel = CreateTestChannelReceive(&encoded_frame_sink);
+
+  RtpPacketReceived packet = CreateRtpPacket();
+  packet.SetSsrc(kRemoteSsrc);
+  EXPECT_CALL(encoded_frame_sink, OnEncodedFrame).Times(0);
+  channel->OnRtpPacket(packet);
+}
+
+TEST_F(ChannelReceiveTest, ReportsAudioLevelOfLatestPacket) {
+  auto channel = CreateTestChannelReceive();
+  channel->StartPlayout();
+  EXPECT_FALSE(channel->LatestAudioLevel());
+
+  channel->OnRtpPacket(CreateRtpPacket(AudioLevel(/*voice_activity=*/true,
+                                                  /*audio_level=*/30)));
+  std::optional<AudioLevel> audio_level = channel->LatestAudioLevel();
+  ASSERT_TRUE(audio_level);
+  EXPECT_TRUE(audio_level->voice_activity());
+  EXPECT_EQ(audio_level->level(), 30);
+
+  // Packets without the extension do not reset the level.
+  channel->OnRtpPacket(CreateRtpPacket());
+  EXPECT_TRUE(channel->LatestAudioLevel());
+}
+
+TEST_F(ChannelReceiveTest, CatchesUpWhenDeselected) {
+  auto channel = CreateTestChannelReceive(/*encoded_frame_sink=*/nullptr,
+                                          /*jitter_buffer_max_packets=*/200);
+  channel->StartPlayout();
+  channel->SetDeselected(true);
+
+  // One second of 12.5 ms packets arrives while nothing pulls audio, as for a
+  // stream that a mixer does not select.
+  constexpr int kPacketSamples = 100;
+  for (int i = 0; i < 80; ++i) {
+    RtpPacketReceived packet = CreateRtpPacket();
+    packet.SetSequenceNumber(i);
+    packet.SetTimestamp(i * kPacketSamples);
+    channel->OnRtpPacket(packet);
+    time_controller_.AdvanceTime(TimeDelta::Micros(12500));
+  }
+
+  // Only the audio received since the last catch-up is buffered.
+  channel->SetDeselected(false);
+  AudioFrame audio_frame;
+  EXPECT_EQ(channel->GetAudioFrameWithInfo(kSampleRateHz, &audio_frame),
+            AudioMixer::Source::AudioFrameInfo::kNormal);
+  EXPECT_LE(channel->GetNetworkStatistics(/*get_and_clear_legacy_stats=*/false)
+                .currentBufferSize,
+            150);
+}
+
+TEST_F(ChannelReceiveTest, KeepsBufferedAudioWhenNotPulledUnlessDeselected) {
+  auto channel = CreateTestChannelReceive(/*encoded_frame_sink=*/nullptr,
+                                          /*jitter_buffer_max_packets=*/200);
+  channel->StartPlayout();
+
+  // Nothing pulls audio for half a second, e.g. because of a stalled audio
+  // thread, without the stream being deselected.
+  constexpr int kPacketSamples = 100;
+  for (int i = 0; i < 40; ++i) {
+    RtpPacketReceived packet = CreateRtpPacket();
+    packet.SetSequenceNumber(i);
+    packet.SetTimestamp(i * kPacketSamples);
+    channel->OnRtpPacket(packet);
+    time_controller_.AdvanceTime(TimeDelta::Micros(12500));
+  }
+
+  AudioFrame audio_frame;
+  EXPECT_EQ(channel->GetAudioFrameWithInfo(kSampleRateHz, &audio_frame),
+            AudioMixer::Source::AudioFrameInfo::kNormal);
+  EXPECT_GE(channel->GetNetworkStatistics(/*get_and_clear_legacy_stats=*/false)
+                .currentBufferSize,
+            400);
+}
+
 }  // namespace
 }  // namespace voe
 }  // namespace webrtc
@@ -62,6 +62,11 @@ class MockChannelReceive : public voe::ChannelReceiveInterface {
               (int sample_rate_hz, AudioFrame*),
               (override));
   MOCK_METHOD(int, PreferredSampleRate, (), (const, override));
+  MOCK_METHOD(std::optional<AudioLevel>,
+              LatestAudioLevel,
+              (),
+              (const, override));
+  MOCK_METHOD(void, SetDeselected, (bool deselected), (override));
   MOCK_METHOD(std::vector<RtpSource>, GetSources, (), (const, override));
   MOCK_METHOD(void,
               SetAssociatedSendChannel,
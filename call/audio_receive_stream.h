@@ -17,6 +17,7 @@
 #include <optional>
 #include <string>
 
+#include "api/array_view.h"
 #include "api/audio_codecs/audio_codec_pair_id.h"
 #include "api/audio_codecs/audio_decoder_factory.h"
 #include "api/audio_codecs/audio_format.h"
@@ -36,6 +37,20 @@ class AudioSinkInterface;
 
 class AudioReceiveStreamInterface : public MediaReceiveStreamInterface {
  public:
+  // Receives the encoded frames of a pass-through stream, see
+  // `Config::encoded_frame_sink`.
+  class EncodedFrameSink {
+   public:
+    virtual ~EncodedFrameSink() = default;
+
+    // Called on the worker thread for every received frame, after decryption
+    // and the frame transformer if set. `payload` is empty if the frame could
+    // not be decrypted.
+    virtual void OnEncodedFrame(rtc::ArrayView<const uint8_t> payload,
+                                const RTPHeader& header,
+                                Timestamp receive_time) = 0;
+  };
+
   struct Stats {
     Stats();
     ~Stats();
@@ -141,6 +156,12 @@ class AudioReceiveStreamInterface : public MediaReceiveStreamInterface {
     bool jitter_buffer_fast_accelerate = false;
     int jitter_buffer_min_delay_ms = 0;
 
+    // Resample the decoded audio with PolyphaseResampler when the ratio of
+    // the decoder and output rates allows it, e.g. for 16 kHz Opus mixed at
+    // 48 kHz. It is faster than the default resampler, which matters on a
+    // server mixing many streams, but its output is not bit-exact with it.
+    bool use_polyphase_resampler = false;
+
     // Identifier for an A/V synchronization group. Empty string to disable.
     // TODO(pbos): Synchronize streams in a sync group, not just one video
     // stream to one audio stream. Tracked by issue webrtc:4762.
@@ -170,6 +191,17 @@ class AudioReceiveStreamInterface : public MediaReceiveStreamInterface {
     // a part of the AudioReceiveStreamInterface state but rather a pass through
     // variable.
     rtc::scoped_refptr<webrtc::FrameTransformerInterface> frame_transformer;
+
+    // If set, the stream passes the received frames to this sink instead of
+    // decoding them, for servers which forward the audio. Such a stream is
+    // neither mixed nor played out and keeps the audio device idle; the stats
+    // derived from NetEq and the decoded audio stay empty, while the RTP
+    // stats (packets, loss, jitter) are still computed. The jitter buffer
+    // does not request retransmissions. The stream still creates its NetEq,
+    // which stays empty but costs about 120 kB per stream. Ownership of the
+    // sink is managed by the caller, which must keep it alive for the lifetime
+    // of the stream.
+    EncodedFrameSink* encoded_frame_sink = nullptr;
   };
 
   // Methods that support reconfiguring the stream post initialization.
@@ -18,6 +18,7 @@
 
 namespace webrtc {
 
+class PolyphaseResampler;
 class PushSincResampler;
 
 // Wraps PushSincResampler to provide stereo support.
@@ -26,9 +27,15 @@ template <typename T>
 class PushResampler final {
  public:
   PushResampler();
+  // If `use_polyphase` is true, rates with a simple rational ratio, such as
+  // 48 kHz <-> 16 kHz, are resampled with PolyphaseResampler instead. It has
+  // the same response and delay, and is faster, but its output isn't bit-exact
+  // with that of PushSincResampler.
+  explicit PushResampler(bool use_polyphase);
   PushResampler(size_t src_samples_per_channel,
                 size_t dst_samples_per_channel,
-                size_t num_channels);
+                size_t num_channels,
+                bool use_polyphase = false);
   ~PushResampler();
 
   // Returns the total number of samples provided in destination (e.g. 32 kHz,
@@ -45,12 +52,20 @@ class PushResampler final {
                          size_t dst_samples_per_channel,
                          size_t num_channels);
 
+  // Resamples channel `channel` with the resampler in use.
+  size_t ResampleChannel(size_t channel,
+                         MonoView<const T> src,
+                         MonoView<T> dst);
+
   // Buffers used for when a deinterleaving step is necessary.
   std::unique_ptr<T[]> source_;
   std::unique_ptr<T[]> destination_;
   DeinterleavedView<T> source_view_;
   DeinterleavedView<T> destination_view_;
 
+  const bool use_polyphase_ = false;
+  // One resampler per channel, in only one of the two vectors.
+  std::vector<std::unique_ptr<PolyphaseResampler>> polyphase_resamplers_;
   std::vector<std::unique_ptr<PushSincResampler>> resamplers_;
 };
 }  // namespace webrtc
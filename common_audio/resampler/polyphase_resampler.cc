@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "common_audio/resampler/polyphase_resampler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <numeric>
+
+#include "common_audio/include/audio_util.h"
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+
+// Samples of the previous block which the kernels of a block reach back to.
+// They span the kernel and the rounding of the first output position, which
+// is less than one decimation step.
+constexpr size_t kHistorySize =
+    PolyphaseResampler::kKernelSize + PolyphaseResampler::kMaxDecimation;
+
+// The delay of PushSincResampler, in input samples, is half its kernel.
+constexpr size_t kHalfKernelSize = PolyphaseResampler::kKernelSize / 2;
+
+// Same cutoff as SincResampler.
+double SincScaleFactor(double io_ratio) {
+  return (io_ratio > 1.0 ? 1.0 / io_ratio : 1.0) * 0.9;
+}
+
+}  // namespace
+
+// If we know the minimum architecture at compile time, avoid CPU detection.
+void PolyphaseResampler::InitializeCPUSpecificFeatures() {
+#if defined(WEBRTC_HAS_NEON)
+  convolve_proc_ = Convolve_NEON;
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (GetCPUInfo(kAVX2) && GetCPUInfo(kFMA3))
+    convolve_proc_ = Convolve_AVX2;
+  else if (GetCPUInfo(kSSE2))
+    convolve_proc_ = Convolve_SSE;
+  else
+    convolve_proc_ = Convolve_C;
+#else
+  // Unknown architecture.
+  convolve_proc_ = Convolve_C;
+#endif
+}
+
+bool PolyphaseResampler::IsSupported(size_t source_frames,
+                                     size_t destination_frames) {
+  if (source_frames < kHistorySize || destination_frames == 0) {
+    return false;
+  }
+  const size_t divisor = std::gcd(source_frames, destination_frames);
+  return destination_frames / divisor <= kMaxInterpolation &&
+         source_frames / divisor <= kMaxDecimation;
+}
+
+PolyphaseResampler::PolyphaseResampler(size_t source_frames,
+                                       size_t destination_frames)
+    : source_frames_(source_frames),
+      destination_frames_(destination_frames),
+      input_buffer_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * (kHistorySize + source_frames), 32))),
+      convolve_proc_(nullptr) {
+  RTC_DCHECK(IsSupported(source_frames, destination_frames));
+  InitializeCPUSpecificFeatures();
+  RTC_DCHECK(convolve_proc_);
+  memset(input_buffer_.get(), 0, sizeof(float) * kHistorySize);
+
+  const size_t divisor = std::gcd(source_frames, destination_frames);
+  InitializeKernels(destination_frames / divisor, source_frames / divisor);
+  InitializeTaps(destination_frames / divisor, source_frames / divisor);
+}
+
+PolyphaseResampler::~PolyphaseResampler() = default;
+
+void PolyphaseResampler::InitializeKernels(size_t interpolation,
+                                           size_t decimation) {
+  // Blackman window parameters.
+  static const double kAlpha = 0.16;
+  static const double kA0 = 0.5 * (1.0 - kAlpha);
+  static const double kA1 = 0.5;
+  static const double kA2 = 0.5 * kAlpha;
+
+  kernel_storage_.reset(static_cast<float*>(
+      AlignedMalloc(sizeof(float) * kKernelSize * interpolation, 32)));
+  const double sinc_scale_factor =
+      SincScaleFactor(static_cast<double>(decimation) / interpolation);
+  for (size_t phase = 0; phase < interpolation; ++phase) {
+    const double subsample_offset = static_cast<double>(phase) / interpolation;
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      const double pre_sinc =
+          M_PI * (static_cast<int>(i) - static_cast<int>(kHalfKernelSize) -
+                  subsample_offset);
+      const double x = (i - subsample_offset) / kKernelSize;
+      const double window =
+          kA0 - kA1 * cos(2.0 * M_PI * x) + kA2 * cos(4.0 * M_PI * x);
+      kernel_storage_[phase * kKernelSize + i] = static_cast<float>(
+          window * ((pre_sinc == 0)
+                        ? sinc_scale_factor
+                        : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
+    }
+  }
+}
+
+void PolyphaseResampler::InitializeTaps(size_t interpolation,
+                                        size_t decimation) {
+  // PushSincResampler primes SincResampler with a block of zeros and drops
+  // the first ChunkSize() output samples. Output sample n of a block is then
+  // centered on the input position (n + chunk_size) * io_ratio - source_frames
+  // relative to the block, counted in 1 / `interpolation` input samples here.
+  const double io_ratio =
+      static_cast<double>(source_frames_) / destination_frames_;
+  const int64_t chunk_size =
+      static_cast<int64_t>((source_frames_ - kHalfKernelSize) / io_ratio);
+  const int64_t l = interpolation;
+  const int64_t m = decimation;
+  taps_.resize(destination_frames_);
+  for (size_t n = 0; n < destination_frames_; ++n) {
+    const int64_t position = (static_cast<int64_t>(n) + chunk_size) * m -
+                             static_cast<int64_t>(source_frames_) * l;
+    // Rounds towards negative infinity.
+    const int64_t sample =
+        position >= 0 ? position / l : -((l - 1 - position) / l);
+    const int64_t phase = position - sample * l;
+    // The kernel is centered on its tap `kHalfKernelSize` + phase / l.
+    const int64_t input_offset = static_cast<int64_t>(kHistorySize) + sample -
+                                 static_cast<int64_t>(kHalfKernelSize);
+    RTC_DCHECK_GE(input_offset, 0);
+    RTC_DCHECK_LE(input_offset + kKernelSize, kHistorySize + source_frames_);
+    taps_[n] = {static_cast<size_t>(input_offset),
+                static_cast<size_t>(phase) * kKernelSize};
+  }
+}
+
+size_t PolyphaseResampler::Resample(const int16_t* source,
+                                    size_t source_frames,
+                                    int16_t* destination,
+                                    size_t destination_capacity) {
+  RTC_CHECK_EQ(source_frames, source_frames_);
+  RTC_CHECK_GE(destination_capacity, destination_frames_);
+  if (!float_buffer_)
+    float_buffer_.reset(new float[destination_frames_]);
+
+  float* const input = input_buffer_.get() + kHistorySize;
+  for (size_t i = 0; i < source_frames; ++i)
+    input[i] = static_cast<float>(source[i]);
+  Filter(float_buffer_.get());
+  FloatS16ToS16(float_buffer_.get(), destination_frames_, destination);
+  return destination_frames_;
+}
+
+size_t PolyphaseResampler::Resample(const float* source,
+                                    size_t source_frames,
+                                    float* destination,
+                                    size_t destination_capacity) {
+  RTC_CHECK_EQ(source_frames, source_frames_);
+  RTC_CHECK_GE(destination_capacity, destination_frames_);
+  memcpy(input_buffer_.get() + kHistorySize, source,
+         sizeof(float) * source_frames);
+  Filter(destination);
+  return destination_frames_;
+}
+
+void PolyphaseResampler::Filter(float* destination) {
+  const float* const input = input_buffer_.get();
+  const float* const kernels = kernel_storage_.get();
+  for (size_t n = 0; n < destination_frames_; ++n) {
+    destination[n] = convolve_proc_(input + taps_[n].input_offset,
+                                    kernels + taps_[n].kernel_offset);
+  }
+  // Keep the end of the block for the kernels of the next one.
+  memcpy(input_buffer_.get(), input_buffer_.get() + source_frames_,
+         sizeof(float) * kHistorySize);
+}
+
+float PolyphaseResampler::Convolve_C(const float* input_ptr,
+                                     const float* kernel) {
+  float sum = 0;
+  for (size_t i = 0; i < kKernelSize; ++i)
+    sum += input_ptr[i] * kernel[i];
+  return sum;
+}
+
+}  // namespace webrtc
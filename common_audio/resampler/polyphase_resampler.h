@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
+#define COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/gtest_prod_util.h"
+#include "rtc_base/memory/aligned_malloc.h"
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+
+// Single-channel push-based resampler for sample rates with a simple rational
+// ratio, such as 48 kHz <-> 16 kHz, 32 kHz or 8 kHz. Where SincResampler
+// tracks a sub-sample position and interpolates between two of its kernels
+// for every output sample, the output samples of a rational ratio only fall
+// on a few phases. A kernel is computed for each phase, which makes every
+// output sample a single dot product with positions known ahead of time.
+//
+// The kernels are those of SincResampler, evaluated at the exact phases, and
+// the delay is that of PushSincResampler, such that the two are
+// interchangeable.
+class PolyphaseResampler {
+ public:
+  // Number of taps of the kernel of each phase.
+  static constexpr size_t kKernelSize = 32;
+
+  // Largest interpolation and decimation factors of the reduced ratio, which
+  // bound the number of kernels and the history to keep.
+  static constexpr size_t kMaxInterpolation = 8;
+  static constexpr size_t kMaxDecimation = 8;
+
+  // Returns whether the ratio of `source_frames` to `destination_frames` is
+  // simple enough for PolyphaseResampler.
+  static bool IsSupported(size_t source_frames, size_t destination_frames);
+
+  // Provide the size of the source and destination blocks in samples. These
+  // must correspond to the same time duration (typically 10 ms) and their
+  // ratio must be supported.
+  PolyphaseResampler(size_t source_frames, size_t destination_frames);
+  ~PolyphaseResampler();
+
+  PolyphaseResampler(const PolyphaseResampler&) = delete;
+  PolyphaseResampler& operator=(const PolyphaseResampler&) = delete;
+
+  // Perform the resampling. `source_frames` must always equal the
+  // `source_frames` provided at construction. `destination_capacity` must be
+  // at least as large as `destination_frames`. Returns the number of samples
+  // provided in destination.
+  size_t Resample(const int16_t* source,
+                  size_t source_frames,
+                  int16_t* destination,
+                  size_t destination_capacity);
+  size_t Resample(const float* source,
+                  size_t source_frames,
+                  float* destination,
+                  size_t destination_capacity);
+
+ private:
+  FRIEND_TEST_ALL_PREFIXES(PolyphaseResamplerTest, Convolve);
+
+  // Position of the input and kernel of one output sample.
+  struct Tap {
+    size_t input_offset;
+    size_t kernel_offset;
+  };
+
+  void InitializeKernels(size_t interpolation, size_t decimation);
+  void InitializeTaps(size_t interpolation, size_t decimation);
+  void InitializeCPUSpecificFeatures();
+
+  // Filters the input block in `input_buffer_` into `destination`.
+  void Filter(float* destination);
+
+  // Returns the dot product of `kKernelSize` samples of `input_ptr` with
+  // `kernel`, which is 32-byte aligned. On x86 and ARM the underlying
+  // implementation is chosen at run time.
+  static float Convolve_C(const float* input_ptr, const float* kernel);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static float Convolve_SSE(const float* input_ptr, const float* kernel);
+  static float Convolve_AVX2(const float* input_ptr, const float* kernel);
+#elif defined(WEBRTC_HAS_NEON)
+  static float Convolve_NEON(const float* input_ptr, const float* kernel);
+#endif
+
+  const size_t source_frames_;
+  const size_t destination_frames_;
+
+  // One kernel of `kKernelSize` taps per phase, back-to-back.
+  std::unique_ptr<float[], AlignedFreeDeleter> kernel_storage_;
+
+  // The last `kHistorySize` samples of the previous block followed by the
+  // current block.
+  std::unique_ptr<float[], AlignedFreeDeleter> input_buffer_;
+
+  // The taps of each output sample of a block, which are the same for every
+  // block since a block holds a whole number of periods of the phases.
+  std::vector<Tap> taps_;
+
+  // Holds the float output of the int16_t version of Resample().
+  std::unique_ptr<float[]> float_buffer_;
+
+  typedef float (*ConvolveProc)(const float*, const float*);
+  ConvolveProc convolve_proc_;
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
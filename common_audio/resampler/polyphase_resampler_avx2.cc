@@ -0,0 +1,41 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+
+#include "common_audio/resampler/polyphase_resampler.h"
+
+namespace webrtc {
+
+float PolyphaseResampler::Convolve_AVX2(const float* input_ptr,
+                                        const float* kernel) {
+  // Two accumulators hide the latency of the multiply-adds.
+  __m256 m_sums1 = _mm256_setzero_ps();
+  __m256 m_sums2 = _mm256_setzero_ps();
+  for (size_t i = 0; i < kKernelSize; i += 16) {
+    m_sums1 = _mm256_fmadd_ps(_mm256_loadu_ps(input_ptr + i),
+                              _mm256_load_ps(kernel + i), m_sums1);
+    m_sums2 = _mm256_fmadd_ps(_mm256_loadu_ps(input_ptr + i + 8),
+                              _mm256_load_ps(kernel + i + 8), m_sums2);
+  }
+  m_sums1 = _mm256_add_ps(m_sums1, m_sums2);
+
+  // Sum components together.
+  __m128 m128_sums = _mm_add_ps(_mm256_extractf128_ps(m_sums1, 0),
+                                _mm256_extractf128_ps(m_sums1, 1));
+  m128_sums = _mm_add_ps(_mm_movehl_ps(m128_sums, m128_sums), m128_sums);
+  float result;
+  _mm_store_ss(&result,
+               _mm_add_ss(m128_sums, _mm_shuffle_ps(m128_sums, m128_sums, 1)));
+  return result;
+}
+
+}  // namespace webrtc
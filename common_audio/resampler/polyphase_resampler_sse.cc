@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stddef.h>
+#include <xmmintrin.h>
+
+#include "common_audio/resampler/polyphase_resampler.h"
+
+namespace webrtc {
+
+float PolyphaseResampler::Convolve_SSE(const float* input_ptr,
+                                       const float* kernel) {
+  // Two accumulators hide the latency of the additions.
+  __m128 m_sums1 = _mm_setzero_ps();
+  __m128 m_sums2 = _mm_setzero_ps();
+  for (size_t i = 0; i < kKernelSize; i += 8) {
+    m_sums1 = _mm_add_ps(m_sums1, _mm_mul_ps(_mm_loadu_ps(input_ptr + i),
+                                             _mm_load_ps(kernel + i)));
+    m_sums2 = _mm_add_ps(m_sums2, _mm_mul_ps(_mm_loadu_ps(input_ptr + i + 4),
+                                             _mm_load_ps(kernel + i + 4)));
+  }
+  m_sums1 = _mm_add_ps(m_sums1, m_sums2);
+
+  // Sum components together.
+  float result;
+  m_sums2 = _mm_add_ps(_mm_movehl_ps(m_sums1, m_sums1), m_sums1);
+  _mm_store_ss(&result,
+               _mm_add_ss(m_sums2, _mm_shuffle_ps(m_sums2, m_sums2, 1)));
+  return result;
+}
+
+}  // namespace webrtc
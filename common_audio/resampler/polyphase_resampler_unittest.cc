@@ -0,0 +1,263 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/resampler/polyphase_resampler.h"
+
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/include/push_resampler.h"
+#include "common_audio/resampler/push_sinc_resampler.h"
+#include "common_audio/resampler/sinusoidal_linear_chirp_source.h"
+#include "rtc_base/memory/aligned_malloc.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// One second of 10 ms blocks.
+constexpr size_t kNumBlocks = 100;
+
+// Used to convert errors to dbFS.
+double DBFS(double x) {
+  return 20 * std::log10(x);
+}
+
+// Returns the RMS error of `resampled` against `expected`, in dbFS.
+double RmsErrorDbfs(const std::vector<float>& resampled,
+                    const std::vector<float>& expected) {
+  double sum_of_squares = 0;
+  for (size_t i = 0; i < resampled.size(); ++i) {
+    const double error = resampled[i] - expected[i];
+    sum_of_squares += error * error;
+  }
+  return DBFS(std::sqrt(sum_of_squares / resampled.size()));
+}
+
+}  // namespace
+
+TEST(PolyphaseResamplerTest, SupportsSimpleRatios) {
+  EXPECT_TRUE(PolyphaseResampler::IsSupported(480, 160));
+  EXPECT_TRUE(PolyphaseResampler::IsSupported(160, 480));
+  EXPECT_TRUE(PolyphaseResampler::IsSupported(480, 320));
+  EXPECT_TRUE(PolyphaseResampler::IsSupported(320, 480));
+  EXPECT_TRUE(PolyphaseResampler::IsSupported(480, 80));
+  EXPECT_TRUE(PolyphaseResampler::IsSupported(80, 480));
+  EXPECT_TRUE(PolyphaseResampler::IsSupported(320, 160));
+  EXPECT_TRUE(PolyphaseResampler::IsSupported(160, 80));
+  EXPECT_FALSE(PolyphaseResampler::IsSupported(441, 480));
+  EXPECT_FALSE(PolyphaseResampler::IsSupported(480, 441));
+  EXPECT_FALSE(PolyphaseResampler::IsSupported(220, 480));
+  EXPECT_FALSE(PolyphaseResampler::IsSupported(960, 80));
+}
+
+// Ensure the optimized Convolve() methods return the same value as
+// Convolve_C(), with aligned and unaligned input.
+TEST(PolyphaseResamplerTest, Convolve) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  bool result_test = GetCPUInfo(kSSE2) || GetCPUInfo(kAVX2);
+#elif defined(WEBRTC_HAS_NEON)
+  bool result_test = true;
+#else
+  bool result_test = false;
+#endif
+  if (!result_test) {
+    return;
+  }
+
+  PolyphaseResampler resampler(480, 320);
+  std::unique_ptr<float[], AlignedFreeDeleter> input(static_cast<float*>(
+      AlignedMalloc(sizeof(float) * 2 * PolyphaseResampler::kKernelSize, 32)));
+  Random random(42);
+  for (size_t i = 0; i < 2 * PolyphaseResampler::kKernelSize; ++i) {
+    input[i] = 2 * random.Rand<float>() - 1;
+  }
+  const float* kernel =
+      resampler.kernel_storage_.get() + PolyphaseResampler::kKernelSize;
+
+  // The optimized versions sum in a different order than Convolve_C().
+  static const double kEpsilon = 0.000001;
+  for (size_t offset : {0, 1, 5}) {
+    const float expected =
+        PolyphaseResampler::Convolve_C(input.get() + offset, kernel);
+    EXPECT_NEAR(expected,
+                resampler.convolve_proc_(input.get() + offset, kernel),
+                kEpsilon)
+        << "offset " << offset;
+  }
+}
+
+class PolyphaseResamplerRateTest
+    : public ::testing::TestWithParam<::testing::tuple<int, int>> {
+ public:
+  PolyphaseResamplerRateTest()
+      : input_rate_(::testing::get<0>(GetParam())),
+        output_rate_(::testing::get<1>(GetParam())),
+        input_block_size_(input_rate_ / 100),
+        output_block_size_(output_rate_ / 100) {}
+
+ protected:
+  const int input_rate_;
+  const int output_rate_;
+  const size_t input_block_size_;
+  const size_t output_block_size_;
+};
+
+// PolyphaseResampler replaces PushSincResampler for these rates, so it must
+// have the same delay and at least the same quality.
+TEST_P(PolyphaseResamplerRateTest, MatchesPushSincResampler) {
+  ASSERT_TRUE(
+      PolyphaseResampler::IsSupported(input_block_size_, output_block_size_));
+  const size_t input_samples = kNumBlocks * input_block_size_;
+  const size_t output_samples = kNumBlocks * output_block_size_;
+  const double input_nyquist_freq = 0.5 * input_rate_;
+
+  std::vector<float> source(input_samples);
+  SinusoidalLinearChirpSource resampler_source(input_rate_, input_samples,
+                                               input_nyquist_freq, 0);
+  resampler_source.Run(input_samples, source.data());
+
+  PolyphaseResampler polyphase(input_block_size_, output_block_size_);
+  PushSincResampler sinc(input_block_size_, output_block_size_);
+  std::vector<float> polyphase_destination(output_samples);
+  std::vector<float> sinc_destination(output_samples);
+  for (size_t i = 0; i < kNumBlocks; ++i) {
+    EXPECT_EQ(output_block_size_,
+              polyphase.Resample(&source[i * input_block_size_],
+                                 input_block_size_,
+                                 &polyphase_destination[i * output_block_size_],
+                                 output_block_size_));
+    sinc.Resample(&source[i * input_block_size_], input_block_size_,
+                  &sinc_destination[i * output_block_size_],
+                  output_block_size_);
+  }
+
+  // The outputs only differ by the interpolation of the sinc kernels.
+  EXPECT_LT(RmsErrorDbfs(polyphase_destination, sinc_destination), -60);
+
+  // Compare both against the pure signal, delayed like in
+  // PushSincResamplerTest.
+  const double io_ratio =
+      static_cast<double>(input_block_size_) / output_block_size_;
+  const size_t output_delay_samples =
+      output_block_size_ -
+      static_cast<size_t>(
+          (input_block_size_ - PolyphaseResampler::kKernelSize / 2) / io_ratio);
+  std::vector<float> pure_destination(output_samples);
+  SinusoidalLinearChirpSource pure_source(output_rate_, output_samples,
+                                          input_nyquist_freq,
+                                          output_delay_samples);
+  pure_source.Run(output_samples, pure_destination.data());
+  EXPECT_LE(RmsErrorDbfs(polyphase_destination, pure_destination),
+            RmsErrorDbfs(sinc_destination, pure_destination) + 0.01);
+}
+
+TEST_P(PolyphaseResamplerRateTest, ResamplesIntLikeFloat) {
+  Random random(42);
+  std::vector<int16_t> source_int(input_block_size_);
+  std::vector<float> source(input_block_size_);
+  std::vector<int16_t> destination_int(output_block_size_);
+  std::vector<float> destination(output_block_size_);
+  PolyphaseResampler resampler_int(input_block_size_, output_block_size_);
+  PolyphaseResampler resampler(input_block_size_, output_block_size_);
+  for (size_t i = 0; i < 10; ++i) {
+    for (size_t j = 0; j < input_block_size_; ++j) {
+      source_int[j] = random.Rand(-10000, 10000);
+      source[j] = source_int[j];
+    }
+    resampler_int.Resample(source_int.data(), input_block_size_,
+                           destination_int.data(), output_block_size_);
+    resampler.Resample(source.data(), input_block_size_, destination.data(),
+                       output_block_size_);
+    for (size_t j = 0; j < output_block_size_; ++j) {
+      EXPECT_EQ(destination_int[j], FloatS16ToS16(destination[j]));
+    }
+  }
+}
+
+// PushResampler selects PolyphaseResampler for every channel when asked to.
+TEST_P(PolyphaseResamplerRateTest, IsUsedByPushResampler) {
+  constexpr size_t kNumChannels = 2;
+  Random random(42);
+  std::vector<float> source(kNumChannels * input_block_size_);
+  std::vector<float> destination(kNumChannels * output_block_size_);
+  std::vector<float> source_mono(input_block_size_);
+  std::vector<float> destination_mono(output_block_size_);
+  PushResampler<float> push_resampler(input_block_size_, output_block_size_,
+                                      kNumChannels, /*use_polyphase=*/true);
+  std::vector<std::unique_ptr<PolyphaseResampler>> resamplers;
+  for (size_t ch = 0; ch < kNumChannels; ++ch) {
+    resamplers.push_back(std::make_unique<PolyphaseResampler>(
+        input_block_size_, output_block_size_));
+  }
+  for (size_t i = 0; i < 10; ++i) {
+    for (float& sample : source) {
+      sample = random.Rand(-10000, 10000);
+    }
+    push_resampler.Resample(
+        InterleavedView<const float>(source.data(), input_block_size_,
+                                     kNumChannels),
+        InterleavedView<float>(destination.data(), output_block_size_,
+                               kNumChannels));
+    for (size_t ch = 0; ch < kNumChannels; ++ch) {
+      for (size_t j = 0; j < input_block_size_; ++j) {
+        source_mono[j] = source[j * kNumChannels + ch];
+      }
+      resamplers[ch]->Resample(source_mono.data(), input_block_size_,
+                               destination_mono.data(), output_block_size_);
+      for (size_t j = 0; j < output_block_size_; ++j) {
+        ASSERT_EQ(destination[j * kNumChannels + ch], destination_mono[j]);
+      }
+    }
+  }
+}
+
+// By default, PushResampler stays bit-exact with PushSincResampler.
+TEST_P(PolyphaseResamplerRateTest, IsNotUsedByPushResamplerByDefault) {
+  Random random(42);
+  std::vector<float> source(input_block_size_);
+  std::vector<float> destination(output_block_size_);
+  std::vector<float> expected(output_block_size_);
+  PushResampler<float> push_resampler(input_block_size_, output_block_size_,
+                                      /*num_channels=*/1);
+  PushSincResampler resampler(input_block_size_, output_block_size_);
+  for (size_t i = 0; i < 10; ++i) {
+    for (float& sample : source) {
+      sample = random.Rand(-10000, 10000);
+    }
+    push_resampler.Resample(
+        MonoView<const float>(source.data(), input_block_size_),
+        MonoView<float>(destination.data(), output_block_size_));
+    resampler.Resample(source.data(), input_block_size_, expected.data(),
+                       output_block_size_);
+    for (size_t j = 0; j < output_block_size_; ++j) {
+      ASSERT_EQ(destination[j], expected[j]);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(PolyphaseResamplerRateTest,
+                         PolyphaseResamplerRateTest,
+                         ::testing::Values(std::make_tuple(48000, 16000),
+                                           std::make_tuple(16000, 48000),
+                                           std::make_tuple(48000, 32000),
+                                           std::make_tuple(32000, 48000),
+                                           std::make_tuple(48000, 8000),
+                                           std::make_tuple(8000, 48000),
+                                           std::make_tuple(32000, 16000),
+                                           std::make_tuple(16000, 8000)));
+
+}  // namespace webrtc
@@ -17,6 +17,7 @@
 
 #include "api/audio/audio_frame.h"
 #include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/polyphase_resampler.h"
 #include "common_audio/resampler/push_sinc_resampler.h"
 #include "rtc_base/checks.h"
 
@@ -31,10 +32,16 @@ constexpr int kMaxNumberOfChannels = 8;
 template <typename T>
 PushResampler<T>::PushResampler() = default;
 
+template <typename T>
+PushResampler<T>::PushResampler(bool use_polyphase)
+    : use_polyphase_(use_polyphase) {}
+
 template <typename T>
 PushResampler<T>::PushResampler(size_t src_samples_per_channel,
                                 size_t dst_samples_per_channel,
-                                size_t num_channels) {
+                                size_t num_channels,
+                                bool use_polyphase)
+    : use_polyphase_(use_polyphase) {
   EnsureInitialized(src_samples_per_channel, dst_samples_per_channel,
                     num_channels);
 }
@@ -69,11 +76,32 @@ void PushResampler<T>::EnsureInitialized(size_t src_samples_per_channel,
                                       num_channels);
   destination_view_ = DeinterleavedView<T>(
       destination_.get(), dst_samples_per_channel, num_channels);
-  resamplers_.resize(num_channels);
-  for (size_t i = 0; i < num_channels; ++i) {
-    resamplers_[i] = std::make_unique<PushSincResampler>(
-        src_samples_per_channel, dst_samples_per_channel);
+  polyphase_resamplers_.clear();
+  resamplers_.clear();
+  if (use_polyphase_ &&
+      PolyphaseResampler::IsSupported(src_samples_per_channel,
+                                      dst_samples_per_channel)) {
+    for (size_t i = 0; i < num_channels; ++i) {
+      polyphase_resamplers_.push_back(std::make_unique<PolyphaseResampler>(
+          src_samples_per_channel, dst_samples_per_channel));
+    }
+  } else {
+    for (size_t i = 0; i < num_channels; ++i) {
+      resamplers_.push_back(std::make_unique<PushSincResampler>(
+          src_samples_per_channel, dst_samples_per_channel));
+    }
+  }
+}
+
+template <typename T>
+size_t PushResampler<T>::ResampleChannel(size_t channel,
+                                         MonoView<const T> src,
+                                         MonoView<T> dst) {
+  if (!polyphase_resamplers_.empty()) {
+    return polyphase_resamplers_[channel]->Resample(
+        &src[0], SamplesPerChannel(src), &dst[0], SamplesPerChannel(dst));
   }
+  return resamplers_[channel]->Resample(src, dst);
 }
 
 template <typename T>
@@ -96,9 +124,9 @@ int PushResampler<T>::Resample(InterleavedView<const T> src,
 
   Deinterleave(src, source_view_);
 
-  for (size_t i = 0; i < resamplers_.size(); ++i) {
+  for (size_t i = 0; i < NumChannels(source_view_); ++i) {
     size_t dst_length_mono =
-        resamplers_[i]->Resample(source_view_[i], destination_view_[i]);
+        ResampleChannel(i, source_view_[i], destination_view_[i]);
     RTC_DCHECK_EQ(dst_length_mono, SamplesPerChannel(dst));
   }
 
@@ -108,7 +136,7 @@ int PushResampler<T>::Resample(InterleavedView<const T> src,
 
 template <typename T>
 int PushResampler<T>::Resample(MonoView<const T> src, MonoView<T> dst) {
-  RTC_DCHECK_EQ(resamplers_.size(), 1);
+  RTC_DCHECK_EQ(NumChannels(source_view_), 1);
   RTC_DCHECK_EQ(SamplesPerChannel(src), SamplesPerChannel(source_view_));
   RTC_DCHECK_EQ(SamplesPerChannel(dst), SamplesPerChannel(destination_view_));
 
@@ -117,7 +145,7 @@ int PushResampler<T>::Resample(MonoView<const T> src, MonoView<T> dst) {
     return static_cast<int>(src.size());
   }
 
-  return resamplers_[0]->Resample(src, dst);
+  return static_cast<int>(ResampleChannel(0, src, dst));
 }
 
 // Explictly generate required instantiations.
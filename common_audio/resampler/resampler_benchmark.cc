@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of resampling 10 ms of audio for the conversions which a
+// conferencing server does for every participant, with the general sinc
+// resampler and with the polyphase resampler which PushResampler can select
+// for them.
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/audio/audio_view.h"
+#include "benchmark/benchmark.h"
+#include "common_audio/resampler/include/push_resampler.h"
+#include "common_audio/resampler/polyphase_resampler.h"
+#include "common_audio/resampler/push_sinc_resampler.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+namespace {
+
+void SetRates(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"in", "out"});
+  for (auto [in, out] : {std::pair{48000, 16000}, std::pair{16000, 48000},
+                         std::pair{48000, 32000}, std::pair{32000, 48000},
+                         std::pair{48000, 8000}, std::pair{8000, 48000}}) {
+    benchmark->Args({in, out});
+  }
+}
+
+std::vector<float> RandomSamples(size_t size) {
+  Random random(42);
+  std::vector<float> samples(size);
+  for (float& sample : samples) {
+    sample = random.Rand(-2000, 2000);
+  }
+  return samples;
+}
+
+template <typename Resampler>
+void BM_Resampler(benchmark::State& state) {
+  const size_t source_frames = state.range(0) / 100;
+  const size_t destination_frames = state.range(1) / 100;
+  const std::vector<float> source = RandomSamples(source_frames);
+  std::vector<float> destination(destination_frames);
+  Resampler resampler(source_frames, destination_frames);
+  for (auto _ : state) {
+    resampler.Resample(source.data(), source_frames, destination.data(),
+                       destination_frames);
+    benchmark::DoNotOptimize(destination.data());
+  }
+  state.SetItemsProcessed(state.iterations() * destination_frames);
+}
+
+BENCHMARK_TEMPLATE(BM_Resampler, PushSincResampler)->Apply(SetRates);
+BENCHMARK_TEMPLATE(BM_Resampler, PolyphaseResampler)->Apply(SetRates);
+
+// Stereo int16_t audio through PushResampler, as in the audio transport.
+void BM_PushResamplerStereo(benchmark::State& state) {
+  constexpr size_t kNumChannels = 2;
+  const size_t source_frames = state.range(0) / 100;
+  const size_t destination_frames = state.range(1) / 100;
+  const std::vector<float> samples =
+      RandomSamples(source_frames * kNumChannels);
+  const std::vector<int16_t> source(samples.begin(), samples.end());
+  std::vector<int16_t> destination(destination_frames * kNumChannels);
+  PushResampler<int16_t> resampler(source_frames, destination_frames,
+                                   kNumChannels, /*use_polyphase=*/true);
+  for (auto _ : state) {
+    resampler.Resample(
+        InterleavedView<const int16_t>(source.data(), source_frames,
+                                       kNumChannels),
+        InterleavedView<int16_t>(destination.data(), destination_frames,
+                                 kNumChannels));
+    benchmark::DoNotOptimize(destination.data());
+  }
+  state.SetItemsProcessed(state.iterations() * destination_frames);
+}
+BENCHMARK(BM_PushResamplerStereo)->Apply(SetRates);
+
+}  // namespace
+}  // namespace webrtc
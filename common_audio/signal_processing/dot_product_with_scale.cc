@@ -11,11 +11,27 @@
 #include "common_audio/signal_processing/dot_product_with_scale.h"
 
 #include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "common_audio/signal_processing/spl_x86.h"
+#endif
 
 int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
                                       const int16_t* vector2,
                                       size_t length,
                                       int scaling) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return WebRtcSpl_DotProductWithScaleX86(vector1, vector2, length, scaling);
+#else
+  return WebRtcSpl_DotProductWithScaleC(vector1, vector2, length, scaling);
+#endif
+}
+
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       size_t length,
+                                       int scaling) {
   int64_t sum = 0;
   size_t i = 0;
 
@@ -239,6 +239,8 @@ void WebRtcSpl_MinMaxW16(const int16_t* vector, size_t length,
                          int16_t* min_val, int16_t* max_val) {
 #if defined(WEBRTC_HAS_NEON)
   return WebRtcSpl_MinMaxW16Neon(vector, length, min_val, max_val);
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  WebRtcSpl_MinMaxW16X86(vector, length, min_val, max_val);
 #else
   int16_t minimum = WEBRTC_SPL_WORD16_MAX;
   int16_t maximum = WEBRTC_SPL_WORD16_MIN;
@@ -9,11 +9,21 @@
  */
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/random.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gtest.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "common_audio/signal_processing/spl_avx2.h"
+#include "common_audio/signal_processing/spl_sse2.h"
+#endif
+
 static const size_t kVector16Size = 9;
 static const int16_t vector16[kVector16Size] = {1,
                                                 -15511,
@@ -544,7 +554,7 @@ TEST(SplTest, CrossCorrelationTest) {
   const int32_t kExpected[kCrossCorrelationDimension] = {-266947903, -15579555,
                                                          -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] = {
       -266947901, -15579553, -171281999};
   if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
@@ -671,3 +681,143 @@ TEST(SplTest, Resample48WithSaturationTest) {
     EXPECT_EQ(kRefValue16kHz2, out_vector_w16[i]);
   }
 }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+namespace webrtc {
+namespace {
+
+struct SplX86Implementation {
+  const char* name;
+  CrossCorrelation cross_correlation;
+  int32_t (*dot_product_with_scale)(const int16_t*,
+                                    const int16_t*,
+                                    size_t,
+                                    int);
+  MaxAbsValueW16 max_abs_value_w16;
+  void (*min_max_w16)(const int16_t*, size_t, int16_t*, int16_t*);
+};
+
+std::vector<SplX86Implementation> GetSplX86ImplementationsToTest() {
+  std::vector<SplX86Implementation> v;
+  v.push_back({"Dispatched", WebRtcSpl_CrossCorrelationX86,
+               WebRtcSpl_DotProductWithScaleX86, WebRtcSpl_MaxAbsValueW16X86,
+               WebRtcSpl_MinMaxW16X86});
+  v.push_back({"SSE2", CrossCorrelationSSE2, DotProductWithScaleSSE2,
+               MaxAbsValueW16SSE2, MinMaxW16SSE2});
+  if (GetCPUInfo(kAVX2)) {
+    v.push_back({"AVX2", CrossCorrelationAVX2, DotProductWithScaleAVX2,
+                 MaxAbsValueW16AVX2, MinMaxW16AVX2});
+  }
+  return v;
+}
+
+// Generates a random vector in which the extreme values are frequent, in
+// order to test the saturations and wrap-arounds of the C versions.
+std::vector<int16_t> RandomVector(Random& random, size_t length) {
+  std::vector<int16_t> v(length);
+  for (int16_t& x : v) {
+    switch (random.Rand(0, 7)) {
+      case 0:
+        x = WEBRTC_SPL_WORD16_MIN;
+        break;
+      case 1:
+        x = WEBRTC_SPL_WORD16_MAX;
+        break;
+      default:
+        x = random.Rand(WEBRTC_SPL_WORD16_MIN, WEBRTC_SPL_WORD16_MAX);
+    }
+  }
+  return v;
+}
+
+// The lengths are chosen to exercise the SIMD blocks as well as the remaining
+// samples.
+constexpr size_t kLengths[] = {1, 7, 8, 15, 16, 17, 33, 60, 100, 257};
+
+class SplX86Test : public ::testing::TestWithParam<SplX86Implementation> {};
+
+TEST_P(SplX86Test, CrossCorrelationIsBitExact) {
+  constexpr size_t kDimCrossCorrelation = 5;
+  Random random(42);
+  for (size_t length : kLengths) {
+    for (int step : {-1, 1}) {
+      for (int right_shifts : {0, 1, 6, 15}) {
+        SCOPED_TRACE(length);
+        SCOPED_TRACE(step);
+        SCOPED_TRACE(right_shifts);
+        const std::vector<int16_t> seq1 = RandomVector(random, length);
+        const std::vector<int16_t> seq2 =
+            RandomVector(random, length + kDimCrossCorrelation - 1);
+        const int16_t* seq2_start =
+            step > 0 ? seq2.data() : seq2.data() + kDimCrossCorrelation - 1;
+        int32_t expected[kDimCrossCorrelation];
+        int32_t actual[kDimCrossCorrelation];
+        WebRtcSpl_CrossCorrelationC(expected, seq1.data(), seq2_start, length,
+                                    kDimCrossCorrelation, right_shifts, step);
+        GetParam().cross_correlation(actual, seq1.data(), seq2_start, length,
+                                     kDimCrossCorrelation, right_shifts, step);
+        for (size_t i = 0; i < kDimCrossCorrelation; ++i) {
+          EXPECT_EQ(expected[i], actual[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST_P(SplX86Test, DotProductWithScaleIsBitExact) {
+  Random random(42);
+  for (size_t length : kLengths) {
+    for (int scaling : {0, 1, 6, 15}) {
+      SCOPED_TRACE(length);
+      SCOPED_TRACE(scaling);
+      const std::vector<int16_t> vector1 = RandomVector(random, length);
+      const std::vector<int16_t> vector2 = RandomVector(random, length);
+      EXPECT_EQ(WebRtcSpl_DotProductWithScaleC(vector1.data(), vector2.data(),
+                                               length, scaling),
+                GetParam().dot_product_with_scale(
+                    vector1.data(), vector2.data(), length, scaling));
+    }
+  }
+  // The sum saturates.
+  const std::vector<int16_t> minimum(100, WEBRTC_SPL_WORD16_MIN);
+  EXPECT_EQ(WEBRTC_SPL_WORD32_MAX,
+            GetParam().dot_product_with_scale(minimum.data(), minimum.data(),
+                                              minimum.size(), 0));
+}
+
+TEST_P(SplX86Test, MaxAbsValueW16IsBitExact) {
+  Random random(42);
+  for (size_t length : kLengths) {
+    SCOPED_TRACE(length);
+    const std::vector<int16_t> vector = RandomVector(random, length);
+    EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(vector.data(), length),
+              GetParam().max_abs_value_w16(vector.data(), length));
+  }
+  const std::vector<int16_t> minimum(20, WEBRTC_SPL_WORD16_MIN);
+  EXPECT_EQ(WEBRTC_SPL_WORD16_MAX,
+            GetParam().max_abs_value_w16(minimum.data(), minimum.size()));
+}
+
+TEST_P(SplX86Test, MinMaxW16IsBitExact) {
+  Random random(42);
+  for (size_t length : kLengths) {
+    SCOPED_TRACE(length);
+    const std::vector<int16_t> vector = RandomVector(random, length);
+    int16_t min_val, max_val;
+    GetParam().min_max_w16(vector.data(), length, &min_val, &max_val);
+    EXPECT_EQ(*std::min_element(vector.begin(), vector.end()), min_val);
+    EXPECT_EQ(*std::max_element(vector.begin(), vector.end()), max_val);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SplTest,
+    SplX86Test,
+    ::testing::ValuesIn(GetSplX86ImplementationsToTest()),
+    [](const ::testing::TestParamInfo<SplX86Implementation>& info) {
+      return std::string(info.param.name);
+    });
+
+}  // namespace
+}  // namespace webrtc
+#endif  // defined(WEBRTC_ARCH_X86_FAMILY)
@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/signal_processing/spl_avx2.h"
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+// Computes the 16 products of `x` and `y` as 2 x 8 32-bit integers.
+inline void MultiplyS16(__m256i x, __m256i y, __m256i* p0, __m256i* p1) {
+  const __m256i lo = _mm256_mullo_epi16(x, y);
+  const __m256i hi = _mm256_mulhi_epi16(x, y);
+  *p0 = _mm256_unpacklo_epi16(lo, hi);
+  *p1 = _mm256_unpackhi_epi16(lo, hi);
+}
+
+// Sign-extends the 8 32-bit integers of `x` and adds them to the 4 64-bit
+// integers of `sum`.
+inline __m256i AccumulateS32ToS64(__m256i x, __m256i sum) {
+  const __m256i sign = _mm256_srai_epi32(x, 31);
+  sum = _mm256_add_epi64(sum, _mm256_unpacklo_epi32(x, sign));
+  return _mm256_add_epi64(sum, _mm256_unpackhi_epi32(x, sign));
+}
+
+inline int32_t HorizontalSumS32(__m256i x) {
+  __m128i y = _mm_add_epi32(_mm256_castsi256_si128(x),
+                            _mm256_extracti128_si256(x, 1));
+  y = _mm_add_epi32(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+  y = _mm_add_epi32(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(y);
+}
+
+inline int16_t HorizontalMaxS16(__m256i x) {
+  __m128i y = _mm_max_epi16(_mm256_castsi256_si128(x),
+                            _mm256_extracti128_si256(x, 1));
+  y = _mm_max_epi16(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+  y = _mm_max_epi16(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  y = _mm_max_epi16(y, _mm_shufflelo_epi16(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<int16_t>(_mm_cvtsi128_si32(y));
+}
+
+inline int16_t HorizontalMinS16(__m256i x) {
+  __m128i y = _mm_min_epi16(_mm256_castsi256_si128(x),
+                            _mm256_extracti128_si256(x, 1));
+  y = _mm_min_epi16(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+  y = _mm_min_epi16(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  y = _mm_min_epi16(y, _mm_shufflelo_epi16(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<int16_t>(_mm_cvtsi128_si32(y));
+}
+
+// Computes the sum of the products of `seq1` and `seq2`, each right-shifted by
+// `right_shifts`, with the wrap-around of the 32-bit sum of the C version.
+int32_t DotProductS32(const int16_t* seq1,
+                      const int16_t* seq2,
+                      size_t length,
+                      int right_shifts) {
+  __m256i sum = _mm256_setzero_si256();
+  size_t i = 0;
+  if (right_shifts == 0) {
+    for (; i + 16 <= length; i += 16) {
+      const __m256i x =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&seq1[i]));
+      const __m256i y =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&seq2[i]));
+      sum = _mm256_add_epi32(sum, _mm256_madd_epi16(x, y));
+    }
+  } else {
+    const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+    for (; i + 16 <= length; i += 16) {
+      __m256i p0, p1;
+      MultiplyS16(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&seq1[i])),
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&seq2[i])), &p0,
+          &p1);
+      sum = _mm256_add_epi32(
+          sum, _mm256_add_epi32(_mm256_sra_epi32(p0, shift),
+                                _mm256_sra_epi32(p1, shift)));
+    }
+  }
+  // Unsigned arithmetic wraps around like the 32-bit sum of the C version.
+  uint32_t result = static_cast<uint32_t>(HorizontalSumS32(sum));
+  for (; i < length; ++i) {
+    result += static_cast<uint32_t>((seq1[i] * seq2[i]) >> right_shifts);
+  }
+  return static_cast<int32_t>(result);
+}
+
+}  // namespace
+
+void CrossCorrelationAVX2(int32_t* cross_correlation,
+                          const int16_t* seq1,
+                          const int16_t* seq2,
+                          size_t dim_seq,
+                          size_t dim_cross_correlation,
+                          int right_shifts,
+                          int step_seq2) {
+  for (size_t i = 0; i < dim_cross_correlation; ++i) {
+    cross_correlation[i] = DotProductS32(seq1, seq2, dim_seq, right_shifts);
+    seq2 += step_seq2;
+  }
+}
+
+int32_t DotProductWithScaleAVX2(const int16_t* vector1,
+                                const int16_t* vector2,
+                                size_t length,
+                                int scaling) {
+  // The shifted products are accumulated in 64 bits, like in the C version.
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m256i sum = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m256i p0, p1;
+    MultiplyS16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&vector1[i])),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&vector2[i])),
+        &p0, &p1);
+    sum = AccumulateS32ToS64(_mm256_sra_epi32(p0, shift), sum);
+    sum = AccumulateS32ToS64(_mm256_sra_epi32(p1, shift), sum);
+  }
+  __m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum),
+                                 _mm256_extracti128_si256(sum, 1));
+  sum128 = _mm_add_epi64(sum128, _mm_unpackhi_epi64(sum128, sum128));
+  int64_t result;
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(&result), sum128);
+  for (; i < length; ++i) {
+    result += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return static_cast<int32_t>(
+      std::clamp<int64_t>(result, std::numeric_limits<int32_t>::min(),
+                          std::numeric_limits<int32_t>::max()));
+}
+
+int16_t MaxAbsValueW16AVX2(const int16_t* vector, size_t length) {
+  RTC_DCHECK_GT(length, 0);
+  // The saturated negation maps -32768 to 32767, which is the limit of the
+  // C version.
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i maximum = zero;
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&vector[i]));
+    maximum = _mm256_max_epi16(maximum,
+                               _mm256_max_epi16(x, _mm256_subs_epi16(zero, x)));
+  }
+  int result = HorizontalMaxS16(maximum);
+  for (; i < length; ++i) {
+    result = std::max(result, std::abs(static_cast<int>(vector[i])));
+  }
+  return static_cast<int16_t>(
+      std::min(result, static_cast<int>(std::numeric_limits<int16_t>::max())));
+}
+
+void MinMaxW16AVX2(const int16_t* vector,
+                   size_t length,
+                   int16_t* min_val,
+                   int16_t* max_val) {
+  RTC_DCHECK_GT(length, 0);
+  __m256i minimum = _mm256_set1_epi16(std::numeric_limits<int16_t>::max());
+  __m256i maximum = _mm256_set1_epi16(std::numeric_limits<int16_t>::min());
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&vector[i]));
+    minimum = _mm256_min_epi16(minimum, x);
+    maximum = _mm256_max_epi16(maximum, x);
+  }
+  int16_t min_result = HorizontalMinS16(minimum);
+  int16_t max_result = HorizontalMaxS16(maximum);
+  for (; i < length; ++i) {
+    min_result = std::min(min_result, vector[i]);
+    max_result = std::max(max_result, vector[i]);
+  }
+  *min_val = min_result;
+  *max_val = max_result;
+}
+
+}  // namespace webrtc
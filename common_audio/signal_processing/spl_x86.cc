@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/signal_processing/spl_x86.h"
+
+#include "common_audio/signal_processing/spl_avx2.h"
+#include "common_audio/signal_processing/spl_sse2.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace {
+
+// The CPU detection is done once, since it is expensive compared to the
+// functions. SSE2 is available on all x86 CPUs that WebRTC supports.
+bool UseAvx2() {
+  static const bool use_avx2 = webrtc::GetCPUInfo(webrtc::kAVX2) != 0;
+  return use_avx2;
+}
+
+}  // namespace
+
+void WebRtcSpl_CrossCorrelationX86(int32_t* cross_correlation,
+                                   const int16_t* seq1,
+                                   const int16_t* seq2,
+                                   size_t dim_seq,
+                                   size_t dim_cross_correlation,
+                                   int right_shifts,
+                                   int step_seq2) {
+  if (UseAvx2()) {
+    webrtc::CrossCorrelationAVX2(cross_correlation, seq1, seq2, dim_seq,
+                                 dim_cross_correlation, right_shifts,
+                                 step_seq2);
+  } else {
+    webrtc::CrossCorrelationSSE2(cross_correlation, seq1, seq2, dim_seq,
+                                 dim_cross_correlation, right_shifts,
+                                 step_seq2);
+  }
+}
+
+int32_t WebRtcSpl_DotProductWithScaleX86(const int16_t* vector1,
+                                         const int16_t* vector2,
+                                         size_t length,
+                                         int scaling) {
+  return UseAvx2() ? webrtc::DotProductWithScaleAVX2(vector1, vector2, length,
+                                                     scaling)
+                   : webrtc::DotProductWithScaleSSE2(vector1, vector2, length,
+                                                     scaling);
+}
+
+int16_t WebRtcSpl_MaxAbsValueW16X86(const int16_t* vector, size_t length) {
+  return UseAvx2() ? webrtc::MaxAbsValueW16AVX2(vector, length)
+                   : webrtc::MaxAbsValueW16SSE2(vector, length);
+}
+
+void WebRtcSpl_MinMaxW16X86(const int16_t* vector,
+                            size_t length,
+                            int16_t* min_val,
+                            int16_t* max_val) {
+  if (UseAvx2()) {
+    webrtc::MinMaxW16AVX2(vector, length, min_val, max_val);
+  } else {
+    webrtc::MinMaxW16SSE2(vector, length, min_val, max_val);
+  }
+}
@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_SIGNAL_PROCESSING_SPL_X86_H_
+#define COMMON_AUDIO_SIGNAL_PROCESSING_SPL_X86_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// x86 versions of signal processing library functions, which use AVX2 if the
+// CPU supports it and SSE2 otherwise. They produce the same results, bit by
+// bit, as the C versions.
+void WebRtcSpl_CrossCorrelationX86(int32_t* cross_correlation,
+                                   const int16_t* seq1,
+                                   const int16_t* seq2,
+                                   size_t dim_seq,
+                                   size_t dim_cross_correlation,
+                                   int right_shifts,
+                                   int step_seq2);
+int32_t WebRtcSpl_DotProductWithScaleX86(const int16_t* vector1,
+                                         const int16_t* vector2,
+                                         size_t length,
+                                         int scaling);
+int16_t WebRtcSpl_MaxAbsValueW16X86(const int16_t* vector, size_t length);
+void WebRtcSpl_MinMaxW16X86(const int16_t* vector,
+                            size_t length,
+                            int16_t* min_val,
+                            int16_t* max_val);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+#endif  // COMMON_AUDIO_SIGNAL_PROCESSING_SPL_X86_H_
@@ -10,6 +10,7 @@
 
 #include "media/sctp/dcsctp_transport.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -21,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/functional/any_invocable.h"
 #include "absl/strings/string_view.h"
 #include "api/array_view.h"
 #include "api/data_channel_interface.h"
@@ -28,7 +30,9 @@
 #include "api/environment/environment.h"
 #include "api/priority.h"
 #include "api/rtc_error.h"
+#include "api/scoped_refptr.h"
 #include "api/sequence_checker.h"
+#include "api/task_queue/pending_task_safety_flag.h"
 #include "api/task_queue/task_queue_base.h"
 #include "api/transport/data_channel_transport_interface.h"
 #include "media/sctp/sctp_transport_internal.h"
@@ -40,15 +44,21 @@
 #include "net/dcsctp/public/text_pcap_packet_observer.h"
 #include "net/dcsctp/public/timeout.h"
 #include "net/dcsctp/public/types.h"
+#include "net/dcsctp/timer/shared_timeout_service.h"
+#include "net/dcsctp/timer/task_queue_timeout.h"
 #include "p2p/base/packet_transport_internal.h"
 #include "p2p/dtls/dtls_transport_internal.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/containers/flat_set.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/network/received_packet.h"
+#include "rtc_base/random.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/system/no_unique_address.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
 #include "rtc_base/trace_event.h"
 #include "system_wrappers/include/clock.h"
 
@@ -132,6 +142,233 @@ bool IsEmptyPPID(dcsctp::PPID ppid) {
 }
 }  // namespace
 
+// Runs the socket on the SCTP task queue. It's created on the network thread,
+// but is otherwise only accessed on the SCTP task queue, by tasks posted from
+// the network thread, and it's destroyed there too. Sent packets, events and
+// the buffered amounts of streams are posted back to the network thread, where
+// they are dropped once the transport has been destroyed.
+class DcSctpTransport::Association : public dcsctp::DcSctpSocketCallbacks {
+ public:
+  Association(DcSctpTransport& transport,
+              std::unique_ptr<dcsctp::DcSctpSocketFactory> socket_factory,
+              dcsctp::SharedTimeoutService* timeout_service)
+      : transport_(transport),
+        network_thread_(*transport.network_thread_),
+        sctp_task_queue_(*transport.sctp_task_queue_),
+        network_safety_(transport.network_safety_.flag()),
+        clock_(transport.env_.clock()),
+        random_(clock_.TimeInMicroseconds()),
+        socket_factory_(std::move(socket_factory)),
+        timeout_service_(timeout_service) {
+    sequence_checker_.Detach();
+  }
+
+  void CreateSocket(absl::string_view name,
+                    std::unique_ptr<dcsctp::PacketObserver> packet_observer,
+                    const dcsctp::DcSctpOptions& options) {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    if (timeout_service_ == nullptr && !timeout_factory_.has_value()) {
+      timeout_factory_.emplace(
+          sctp_task_queue_, [this]() { return TimeMillis(); },
+          [this](dcsctp::TimeoutID timeout_id) {
+            RTC_DCHECK_RUN_ON(&sequence_checker_);
+            socket_->HandleTimeout(timeout_id);
+          });
+    }
+    name_ = std::string(name);
+    socket_ = socket_factory_->Create(name, *this, std::move(packet_observer),
+                                      options);
+  }
+
+  void ResetSocket() {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    socket_ = nullptr;
+    streams_with_data_.clear();
+  }
+
+  dcsctp::DcSctpSocketInterface* socket() {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    return socket_.get();
+  }
+
+  // Sends `message`, and reports the buffered amount of its stream back to the
+  // network thread, also if the message couldn't be sent.
+  void Send(dcsctp::DcSctpMessage message,
+            const dcsctp::SendOptions& send_options) {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    dcsctp::StreamID stream_id = message.stream_id();
+    size_t size = message.payload().size();
+    size_t buffered_amount = 0;
+    if (socket_) {
+      dcsctp::SendStatus status =
+          socket_->Send(std::move(message), send_options);
+      if (status != dcsctp::SendStatus::kSuccess) {
+        RTC_LOG(LS_ERROR) << name_
+                          << "->SendData(...): send() failed with error "
+                          << dcsctp::ToString(status) << ".";
+      }
+      streams_with_data_.insert(stream_id);
+      buffered_amount = socket_->buffered_amount(stream_id);
+    }
+    PostToNetworkThread(
+        [stream_id, buffered_amount, size](DcSctpTransport& transport) {
+          transport.OnBufferedAmountReported(stream_id, buffered_amount, size);
+        });
+  }
+
+  // dcsctp::DcSctpSocketCallbacks
+  SendPacketStatus SendPacketWithStatus(
+      rtc::ArrayView<const uint8_t> data) override {
+    PostToNetworkThread(
+        [packet = rtc::CopyOnWriteBuffer(data)](DcSctpTransport& transport) {
+          transport.SendPacketWithStatus(packet);
+        });
+    return SendPacketStatus::kSuccess;
+  }
+  std::unique_ptr<dcsctp::Timeout> CreateTimeout(
+      TaskQueueBase::DelayPrecision precision) override {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    if (timeout_service_ != nullptr) {
+      // The shared timeouts ignore the precision, and may expire up to the
+      // resolution of the service late.
+      return timeout_service_->CreateTimeout(
+          [this](dcsctp::TimeoutID timeout_id) {
+            RTC_DCHECK_RUN_ON(&sequence_checker_);
+            socket_->HandleTimeout(timeout_id);
+          });
+    }
+    return timeout_factory_->CreateTimeout(precision);
+  }
+  dcsctp::TimeMs TimeMillis() override {
+    return dcsctp::TimeMs(clock_.TimeInMilliseconds());
+  }
+  uint32_t GetRandomInt(uint32_t low, uint32_t high) override {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    return random_.Rand(low, high);
+  }
+  void OnTotalBufferedAmountLow() override {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    std::vector<std::pair<dcsctp::StreamID, size_t>> buffered_amounts;
+    for (dcsctp::StreamID stream_id : streams_with_data_) {
+      buffered_amounts.emplace_back(stream_id,
+                                    socket_->buffered_amount(stream_id));
+    }
+    PostToNetworkThread([buffered_amounts = std::move(buffered_amounts)](
+                            DcSctpTransport& transport) {
+      for (const auto& [stream_id, buffered_amount] : buffered_amounts) {
+        transport.OnBufferedAmountReported(stream_id, buffered_amount,
+                                           /*sent_bytes=*/0);
+      }
+      transport.OnTotalBufferedAmountLow();
+    });
+  }
+  void OnBufferedAmountLow(dcsctp::StreamID stream_id) override {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    size_t buffered_amount = socket_->buffered_amount(stream_id);
+    PostToNetworkThread(
+        [stream_id, buffered_amount](DcSctpTransport& transport) {
+          transport.OnBufferedAmountReported(stream_id, buffered_amount,
+                                             /*sent_bytes=*/0);
+          transport.OnBufferedAmountLow(stream_id);
+        });
+  }
+  void OnMessageReceived(dcsctp::DcSctpMessage message) override {
+    PostToNetworkThread(
+        [message = std::move(message)](DcSctpTransport& transport) mutable {
+          transport.OnMessageReceived(std::move(message));
+        });
+  }
+  void OnError(dcsctp::ErrorKind error, absl::string_view message) override {
+    PostToNetworkThread(
+        [error, message = std::string(message)](DcSctpTransport& transport) {
+          transport.OnError(error, message);
+        });
+  }
+  void OnAborted(dcsctp::ErrorKind error, absl::string_view message) override {
+    PostToNetworkThread(
+        [error, message = std::string(message)](DcSctpTransport& transport) {
+          transport.OnAborted(error, message);
+        });
+  }
+  void OnConnected() override {
+    PostToNetworkThread(
+        [](DcSctpTransport& transport) { transport.OnConnected(); });
+  }
+  void OnClosed() override {
+    PostToNetworkThread(
+        [](DcSctpTransport& transport) { transport.OnClosed(); });
+  }
+  void OnConnectionRestarted() override {
+    PostToNetworkThread(
+        [](DcSctpTransport& transport) { transport.OnConnectionRestarted(); });
+  }
+  void OnStreamsResetFailed(
+      rtc::ArrayView<const dcsctp::StreamID> outgoing_streams,
+      absl::string_view reason) override {
+    PostToNetworkThread(
+        [streams = std::vector<dcsctp::StreamID>(outgoing_streams.begin(),
+                                                 outgoing_streams.end()),
+         reason = std::string(reason)](DcSctpTransport& transport) {
+          transport.OnStreamsResetFailed(streams, reason);
+        });
+  }
+  void OnStreamsResetPerformed(
+      rtc::ArrayView<const dcsctp::StreamID> outgoing_streams) override {
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+    for (dcsctp::StreamID stream_id : outgoing_streams) {
+      // Messages queued on a reset stream have been discarded.
+      streams_with_data_.erase(stream_id);
+    }
+    PostToNetworkThread(
+        [streams = std::vector<dcsctp::StreamID>(outgoing_streams.begin(),
+                                                 outgoing_streams.end())](
+            DcSctpTransport& transport) {
+          transport.OnStreamsResetPerformed(streams);
+        });
+  }
+  void OnIncomingStreamsReset(
+      rtc::ArrayView<const dcsctp::StreamID> incoming_streams) override {
+    PostToNetworkThread(
+        [streams = std::vector<dcsctp::StreamID>(incoming_streams.begin(),
+                                                 incoming_streams.end())](
+            DcSctpTransport& transport) {
+          transport.OnIncomingStreamsReset(streams);
+        });
+  }
+
+ private:
+  void PostToNetworkThread(
+      absl::AnyInvocable<void(DcSctpTransport&) &&> task) {
+    network_thread_.PostTask(SafeTask(
+        network_safety_,
+        [&transport = transport_, task = std::move(task)]() mutable {
+          std::move(task)(transport);
+        }));
+  }
+
+  RTC_NO_UNIQUE_ADDRESS SequenceChecker sequence_checker_;
+  // Only accessed on the network thread, by tasks posted with
+  // `network_safety_`.
+  DcSctpTransport& transport_;
+  TaskQueueBase& network_thread_;
+  TaskQueueBase& sctp_task_queue_;
+  const rtc::scoped_refptr<PendingTaskSafetyFlag> network_safety_;
+  Clock& clock_;
+  Random random_ RTC_GUARDED_BY(sequence_checker_);
+  const std::unique_ptr<dcsctp::DcSctpSocketFactory> socket_factory_;
+  std::string name_ RTC_GUARDED_BY(sequence_checker_);
+  // Creates the timeouts if set. Otherwise, `timeout_factory_` does, which is
+  // created on the SCTP task queue, where its timeouts are used.
+  dcsctp::SharedTimeoutService* const timeout_service_;
+  std::optional<dcsctp::TaskQueueTimeoutFactory> timeout_factory_;
+  std::unique_ptr<dcsctp::DcSctpSocketInterface> socket_
+      RTC_GUARDED_BY(sequence_checker_);
+  // Streams that messages have been sent on, which are reported when the
+  // total buffered amount is low.
+  flat_set<dcsctp::StreamID> streams_with_data_
+      RTC_GUARDED_BY(sequence_checker_);
+};
+
 DcSctpTransport::DcSctpTransport(const Environment& env,
                                  rtc::Thread* network_thread,
                                  cricket::DtlsTransportInternal* transport)
@@ -144,12 +381,14 @@ DcSctpTransport::DcSctpTransport(
     const Environment& env,
     rtc::Thread* network_thread,
     cricket::DtlsTransportInternal* transport,
-    std::unique_ptr<dcsctp::DcSctpSocketFactory> socket_factory)
+    std::unique_ptr<dcsctp::DcSctpSocketFactory> socket_factory,
+    TaskQueueBase* sctp_task_queue,
+    dcsctp::SharedTimeoutService* timeout_service)
     : network_thread_(network_thread),
+      sctp_task_queue_(sctp_task_queue),
       transport_(transport),
       env_(env),
       random_(env_.clock().TimeInMicroseconds()),
-      socket_factory_(std::move(socket_factory)),
       task_queue_timeout_factory_(
           *network_thread,
           [this]() { return TimeMillis(); },
@@ -157,6 +396,13 @@ DcSctpTransport::DcSctpTransport(
             socket_->HandleTimeout(timeout_id);
           }) {
   RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK(sctp_task_queue_ || !timeout_service);
+  if (sctp_task_queue_) {
+    association_ = std::make_unique<Association>(
+        *this, std::move(socket_factory), timeout_service);
+  } else {
+    socket_factory_ = std::move(socket_factory);
+  }
   static std::atomic<int> instance_count = 0;
   rtc::StringBuilder sb;
   sb << debug_name_ << instance_count++;
@@ -165,6 +411,15 @@ DcSctpTransport::DcSctpTransport(
 }
 
 DcSctpTransport::~DcSctpTransport() {
+  if (association_) {
+    // Runs after the tasks already posted to the association. Events posted
+    // back by it are dropped, as `network_safety_` is invalidated.
+    sctp_task_queue_->PostTask([association = std::move(association_)] {
+      if (association->socket()) {
+        association->socket()->Close();
+      }
+    });
+  }
   if (socket_) {
     socket_->Close();
   }
@@ -201,7 +456,7 @@ bool DcSctpTransport::Start(int local_sctp_port,
                     << ", remote=" << remote_sctp_port
                     << ", max_message_size=" << max_message_size << ")";
 
-  if (!socket_) {
+  if (!options_.has_value()) {
     dcsctp::DcSctpOptions options;
     options.local_port = local_sctp_port;
     options.remote_port = remote_sctp_port;
@@ -223,24 +478,40 @@ bool DcSctpTransport::Start(int local_sctp_port,
           std::make_unique<dcsctp::TextPcapPacketObserver>(debug_name_);
     }
 
-    socket_ = socket_factory_->Create(debug_name_, *this,
-                                      std::move(packet_observer), options);
+    options_ = options;
+    if (association_) {
+      sctp_task_queue_->PostTask(
+          [association = association_.get(), name = debug_name_,
+           packet_observer = std::move(packet_observer), options]() mutable {
+            association->CreateSocket(name, std::move(packet_observer),
+                                      options);
+          });
+    } else {
+      socket_ = socket_factory_->Create(debug_name_, *this,
+                                        std::move(packet_observer), options);
+    }
   } else {
-    if (local_sctp_port != socket_->options().local_port ||
-        remote_sctp_port != socket_->options().remote_port) {
+    if (local_sctp_port != options_->local_port ||
+        remote_sctp_port != options_->remote_port) {
       RTC_LOG(LS_ERROR)
           << debug_name_ << "->Start(local=" << local_sctp_port
           << ", remote=" << remote_sctp_port
           << "): Can't change ports on already started transport.";
       return false;
     }
-    socket_->SetMaxMessageSize(max_message_size);
+    options_->max_message_size = max_message_size;
+    RunOnSocket([max_message_size](dcsctp::DcSctpSocketInterface& socket) {
+      socket.SetMaxMessageSize(max_message_size);
+    });
   }
 
   MaybeConnectSocket();
 
   for (const auto& [sid, stream_state] : stream_states_) {
-    socket_->SetStreamPriority(sid, stream_state.priority);
+    RunOnSocket([sid = sid, priority = stream_state.priority](
+                    dcsctp::DcSctpSocketInterface& socket) {
+      socket.SetStreamPriority(sid, priority);
+    });
   }
 
   return true;
@@ -255,10 +526,10 @@ bool DcSctpTransport::OpenStream(int sid, PriorityValue priority) {
   stream_state.priority = dcsctp::StreamPriority(priority.value());
   stream_states_.insert_or_assign(dcsctp::StreamID(static_cast<uint16_t>(sid)),
                                   stream_state);
-  if (socket_) {
-    socket_->SetStreamPriority(dcsctp::StreamID(sid),
-                               dcsctp::StreamPriority(priority.value()));
-  }
+  RunOnSocket([sid, priority](dcsctp::DcSctpSocketInterface& socket) {
+    socket.SetStreamPriority(dcsctp::StreamID(sid),
+                             dcsctp::StreamPriority(priority.value()));
+  });
 
   return true;
 }
@@ -266,7 +537,7 @@ bool DcSctpTransport::OpenStream(int sid, PriorityValue priority) {
 bool DcSctpTransport::ResetStream(int sid) {
   RTC_DCHECK_RUN_ON(network_thread_);
   RTC_DLOG(LS_INFO) << debug_name_ << "->ResetStream(" << sid << ").";
-  if (!socket_) {
+  if (!options_.has_value()) {
     RTC_LOG(LS_ERROR) << debug_name_ << "->ResetStream(sid=" << sid
                       << "): Transport is not started.";
     return false;
@@ -289,7 +560,10 @@ bool DcSctpTransport::ResetStream(int sid) {
     return false;
   }
   stream_state.closure_initiated = true;
-  socket_->ResetStreams(streams);
+  RunOnSocket([stream_id = streams[0]](dcsctp::DcSctpSocketInterface& socket) {
+    dcsctp::StreamID streams[1] = {stream_id};
+    socket.ResetStreams(streams);
+  });
   return true;
 }
 
@@ -301,7 +575,7 @@ RTCError DcSctpTransport::SendData(int sid,
                        << ", type=" << static_cast<int>(params.type)
                        << ", length=" << payload.size() << ").";
 
-  if (!socket_) {
+  if (!options_.has_value()) {
     RTC_LOG(LS_ERROR) << debug_name_
                       << "->SendData(...): Transport is not started.";
     return RTCError(RTCErrorType::INVALID_STATE);
@@ -329,7 +603,7 @@ RTCError DcSctpTransport::SendData(int sid,
     return RTCError(RTCErrorType::INVALID_STATE);
   }
 
-  auto max_message_size = socket_->options().max_message_size;
+  auto max_message_size = options_->max_message_size;
   if (max_message_size > 0 && payload.size() > max_message_size) {
     RTC_LOG(LS_WARNING) << debug_name_
                         << "->SendData(...): "
@@ -368,6 +642,25 @@ RTCError DcSctpTransport::SendData(int sid,
     send_options.max_retransmissions = *params.max_rtx_count;
   }
 
+  if (association_) {
+    // The buffered amount of the stream can only have decreased since it was
+    // last reported, so if it's below the limit including what has been sent
+    // since, the socket will accept the message too, like it does here.
+    StreamState& state = stream_state->second;
+    if (state.buffered_amount + state.unreported_sent_bytes >=
+        options_->per_stream_send_queue_limit) {
+      ready_to_send_data_ = false;
+      return RTCError(RTCErrorType::RESOURCE_EXHAUSTED);
+    }
+    state.unreported_sent_bytes += message.payload().size();
+    sctp_task_queue_->PostTask([association = association_.get(),
+                                message = std::move(message),
+                                send_options]() mutable {
+      association->Send(std::move(message), send_options);
+    });
+    return RTCError::OK();
+  }
+
   dcsctp::SendStatus error = socket_->Send(std::move(message), send_options);
   switch (error) {
     case dcsctp::SendStatus::kSuccess:
@@ -390,42 +683,66 @@ bool DcSctpTransport::ReadyToSendData() {
 }
 
 int DcSctpTransport::max_message_size() const {
-  if (!socket_) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!options_.has_value()) {
     RTC_LOG(LS_ERROR) << debug_name_
                       << "->max_message_size(...): Transport is not started.";
     return 0;
   }
-  return socket_->options().max_message_size;
+  return options_->max_message_size;
 }
 
 std::optional<int> DcSctpTransport::max_outbound_streams() const {
-  if (!socket_)
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!options_.has_value())
     return std::nullopt;
-  return socket_->options().announced_maximum_outgoing_streams;
+  return options_->announced_maximum_outgoing_streams;
 }
 
 std::optional<int> DcSctpTransport::max_inbound_streams() const {
-  if (!socket_)
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!options_.has_value())
     return std::nullopt;
-  return socket_->options().announced_maximum_incoming_streams;
+  return options_->announced_maximum_incoming_streams;
 }
 
 size_t DcSctpTransport::buffered_amount(int sid) const {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (association_) {
+    auto it = stream_states_.find(dcsctp::StreamID(sid));
+    if (it == stream_states_.end())
+      return 0;
+    return it->second.buffered_amount + it->second.unreported_sent_bytes;
+  }
   if (!socket_)
     return 0;
   return socket_->buffered_amount(dcsctp::StreamID(sid));
 }
 
 size_t DcSctpTransport::buffered_amount_low_threshold(int sid) const {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (association_) {
+    auto it = stream_states_.find(dcsctp::StreamID(sid));
+    if (it == stream_states_.end())
+      return 0;
+    return it->second.buffered_amount_low_threshold;
+  }
   if (!socket_)
     return 0;
   return socket_->buffered_amount_low_threshold(dcsctp::StreamID(sid));
 }
 
 void DcSctpTransport::SetBufferedAmountLowThreshold(int sid, size_t bytes) {
-  if (!socket_)
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!options_.has_value())
     return;
-  socket_->SetBufferedAmountLowThreshold(dcsctp::StreamID(sid), bytes);
+  auto it = stream_states_.find(dcsctp::StreamID(sid));
+  if (it != stream_states_.end()) {
+    it->second.buffered_amount_low_threshold = bytes;
+  }
+  RunOnSocket([sid, bytes](dcsctp::DcSctpSocketInterface& socket) {
+    socket.SetBufferedAmountLowThreshold(dcsctp::StreamID(sid), bytes);
+  });
 }
 
 void DcSctpTransport::set_debug_name_for_testing(const char* debug_name) {
@@ -435,14 +752,14 @@ void DcSctpTransport::set_debug_name_for_testing(const char* debug_name) {
 SendPacketStatus DcSctpTransport::SendPacketWithStatus(
     rtc::ArrayView<const uint8_t> data) {
   RTC_DCHECK_RUN_ON(network_thread_);
-  RTC_DCHECK(socket_);
+  RTC_DCHECK(options_.has_value());
 
-  if (data.size() > (socket_->options().mtu)) {
+  if (data.size() > options_->mtu) {
     RTC_LOG(LS_ERROR) << debug_name_
                       << "->SendPacket(...): "
                          "SCTP seems to have made a packet that is bigger "
                          "than its official MTU: "
-                      << data.size() << " vs max of " << socket_->options().mtu;
+                      << data.size() << " vs max of " << options_->mtu;
     return SendPacketStatus::kError;
   }
   TRACE_EVENT0("webrtc", "DcSctpTransport::SendPacket");
@@ -514,14 +831,16 @@ void DcSctpTransport::OnMessageReceived(dcsctp::DcSctpMessage message) {
                         << " on an SCTP packet. Dropping.";
     return;
   }
-  receive_buffer_.Clear();
-  if (!IsEmptyPPID(message.ppid()))
-    receive_buffer_.AppendData(message.payload().data(),
-                               message.payload().size());
+  int channel_id = message.stream_id().value();
+  rtc::CopyOnWriteBuffer payload;
+  if (!IsEmptyPPID(message.ppid())) {
+    // Received messages are backed by an `rtc::Buffer`, which is adopted
+    // without copying it.
+    payload = rtc::CopyOnWriteBuffer(std::move(message).ReleasePayloadBuffer());
+  }
 
   if (data_channel_sink_) {
-    data_channel_sink_->OnDataReceived(message.stream_id().value(), *type,
-                                       receive_buffer_);
+    data_channel_sink_->OnDataReceived(channel_id, *type, payload);
   }
 }
 
@@ -641,8 +960,11 @@ void DcSctpTransport::OnIncomingStreamsReset(
       // When receiving an incoming stream reset event for a non local close
       // procedure, the transport needs to reset the stream in the other
       // direction too.
-      dcsctp::StreamID streams[1] = {stream_id};
-      socket_->ResetStreams(streams);
+      RunOnSocket([stream_id = stream_id](
+                      dcsctp::DcSctpSocketInterface& socket) {
+        dcsctp::StreamID streams[1] = {stream_id};
+        socket.ResetStreams(streams);
+      });
       if (data_channel_sink_) {
         data_channel_sink_->OnChannelClosing(stream_id.value());
       }
@@ -712,7 +1034,8 @@ void DcSctpTransport::OnTransportWritableState(
 void DcSctpTransport::OnDtlsTransportState(
     cricket::DtlsTransportInternal* transport,
     webrtc::DtlsTransportState state) {
-  if (state == DtlsTransportState::kNew && socket_) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (state == DtlsTransportState::kNew && options_.has_value()) {
     // IF DTLS restart (DtlsTransportState::kNew)
     // THEN
     //   restart socket so that we send an SCPT init
@@ -720,7 +1043,17 @@ void DcSctpTransport::OnDtlsTransportState(
     //   after DTLS fingerprint changed since peer will discard
     //   messages with crypto derived from old fingerprint.
     RTC_DLOG(LS_INFO) << debug_name_ << " DTLS restart";
-    dcsctp::DcSctpOptions options = socket_->options();
+    dcsctp::DcSctpOptions options = *options_;
+    options_ = std::nullopt;
+    if (association_) {
+      sctp_task_queue_->PostTask(
+          [association = association_.get()] { association->ResetSocket(); });
+      // Buffered messages are gone with the socket.
+      for (auto& [sid, stream_state] : stream_states_) {
+        stream_state.buffered_amount = 0;
+        stream_state.unreported_sent_bytes = 0;
+      }
+    }
     socket_.reset();
     Start(options.local_port, options.remote_port, options.max_message_size);
   }
@@ -737,15 +1070,54 @@ void DcSctpTransport::OnTransportReadPacket(
 
   RTC_DLOG(LS_VERBOSE) << debug_name_ << "->OnTransportReadPacket(), length="
                        << packet.payload().size();
+  if (association_) {
+    RunOnSocket([payload = rtc::CopyOnWriteBuffer(packet.payload())](
+                    dcsctp::DcSctpSocketInterface& socket) {
+      socket.ReceivePacket(payload);
+    });
+    return;
+  }
   if (socket_) {
     socket_->ReceivePacket(packet.payload());
   }
 }
 
 void DcSctpTransport::MaybeConnectSocket() {
-  if (transport_ && transport_->writable() && socket_ &&
-      socket_->state() == dcsctp::SocketState::kClosed) {
-    socket_->Connect();
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (transport_ && transport_->writable()) {
+    RunOnSocket([](dcsctp::DcSctpSocketInterface& socket) {
+      if (socket.state() == dcsctp::SocketState::kClosed) {
+        socket.Connect();
+      }
+    });
+  }
+}
+
+void DcSctpTransport::RunOnSocket(
+    absl::AnyInvocable<void(dcsctp::DcSctpSocketInterface&) &&> task) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (association_) {
+    sctp_task_queue_->PostTask(
+        [association = association_.get(), task = std::move(task)]() mutable {
+          if (association->socket()) {
+            std::move(task)(*association->socket());
+          }
+        });
+  } else if (socket_) {
+    std::move(task)(*socket_);
   }
 }
+
+void DcSctpTransport::OnBufferedAmountReported(dcsctp::StreamID stream_id,
+                                               size_t buffered_amount,
+                                               size_t sent_bytes) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  auto it = stream_states_.find(stream_id);
+  if (it == stream_states_.end())
+    return;
+  StreamState& stream_state = it->second;
+  stream_state.buffered_amount = buffered_amount;
+  stream_state.unreported_sent_bytes -=
+      std::min(sent_bytes, stream_state.unreported_sent_bytes);
+}
 }  // namespace webrtc
@@ -15,16 +15,19 @@
 #include <optional>
 #include <string>
 
+#include "absl/functional/any_invocable.h"
 #include "absl/strings/string_view.h"
 #include "api/array_view.h"
 #include "api/environment/environment.h"
 #include "api/priority.h"
+#include "api/task_queue/pending_task_safety_flag.h"
 #include "api/task_queue/task_queue_base.h"
 #include "media/sctp/sctp_transport_internal.h"
 #include "net/dcsctp/public/dcsctp_options.h"
 #include "net/dcsctp/public/dcsctp_socket.h"
 #include "net/dcsctp/public/dcsctp_socket_factory.h"
 #include "net/dcsctp/public/types.h"
+#include "net/dcsctp/timer/shared_timeout_service.h"
 #include "net/dcsctp/timer/task_queue_timeout.h"
 #include "p2p/base/packet_transport_internal.h"
 #include "p2p/dtls/dtls_transport_internal.h"
@@ -46,10 +49,22 @@ class DcSctpTransport : public cricket::SctpTransportInternal,
   DcSctpTransport(const Environment& env,
                   rtc::Thread* network_thread,
                   cricket::DtlsTransportInternal* transport);
+  // If `sctp_task_queue` is set, the SCTP association is run on that task
+  // queue instead of on the network thread. Received packets and calls into
+  // the socket are then posted to it, and sent packets and `DataChannelSink`
+  // callbacks are posted back to the network thread, which never blocks on
+  // the task queue. The socket is destroyed on the task queue after this
+  // object, so the task queue must outlive this object and process its tasks
+  // before it's deleted. If `timeout_service` is set as well, the timeouts of
+  // the socket are created by it, so that all associations run on the task
+  // queue share its timer task. It must be used on the task queue, and be
+  // destroyed there after the socket.
   DcSctpTransport(const Environment& env,
                   rtc::Thread* network_thread,
                   cricket::DtlsTransportInternal* transport,
-                  std::unique_ptr<dcsctp::DcSctpSocketFactory> socket_factory);
+                  std::unique_ptr<dcsctp::DcSctpSocketFactory> socket_factory,
+                  TaskQueueBase* sctp_task_queue = nullptr,
+                  dcsctp::SharedTimeoutService* timeout_service = nullptr);
   ~DcSctpTransport() override;
 
   // cricket::SctpTransportInternal
@@ -74,6 +89,8 @@ class DcSctpTransport : public cricket::SctpTransportInternal,
   void set_debug_name_for_testing(const char* debug_name) override;
 
  private:
+  class Association;
+
   // dcsctp::DcSctpSocketCallbacks
   dcsctp::SendPacketStatus SendPacketWithStatus(
       rtc::ArrayView<const uint8_t> data) override;
@@ -106,8 +123,18 @@ class DcSctpTransport : public cricket::SctpTransportInternal,
   void OnDtlsTransportState(cricket::DtlsTransportInternal* transport,
                             webrtc::DtlsTransportState);
   void MaybeConnectSocket();
+  // Runs `task` with the socket, if there is one, on the thread or task queue
+  // that the socket is run on.
+  void RunOnSocket(
+      absl::AnyInvocable<void(dcsctp::DcSctpSocketInterface&) &&> task);
+  // Called with the buffered amount of `stream_id` of the socket run on
+  // `sctp_task_queue_`, after `sent_bytes` more were given to it.
+  void OnBufferedAmountReported(dcsctp::StreamID stream_id,
+                                size_t buffered_amount,
+                                size_t sent_bytes);
 
   rtc::Thread* network_thread_;
+  TaskQueueBase* const sctp_task_queue_;
   cricket::DtlsTransportInternal* transport_;
   Environment env_;
   Random random_;
@@ -115,8 +142,11 @@ class DcSctpTransport : public cricket::SctpTransportInternal,
   std::unique_ptr<dcsctp::DcSctpSocketFactory> socket_factory_;
   dcsctp::TaskQueueTimeoutFactory task_queue_timeout_factory_;
   std::unique_ptr<dcsctp::DcSctpSocketInterface> socket_;
+  // Owns the socket instead, if it's run on `sctp_task_queue_`.
+  std::unique_ptr<Association> association_;
+  // The options of the socket, set when started.
+  std::optional<dcsctp::DcSctpOptions> options_ RTC_GUARDED_BY(network_thread_);
   std::string debug_name_ = "DcSctpTransport";
-  rtc::CopyOnWriteBuffer receive_buffer_;
 
   // Used to keep track of the state of data channels.
   // Reset needs to happen both ways before signaling the transport
@@ -134,6 +164,12 @@ class DcSctpTransport : public cricket::SctpTransportInternal,
     // Priority of the stream according to RFC 8831, section 6.4
     dcsctp::StreamPriority priority =
         dcsctp::StreamPriority(PriorityValue(webrtc::Priority::kLow).value());
+    // If the socket is run on `sctp_task_queue_`: The buffered amount last
+    // reported by the socket, the size of the messages sent since, and the
+    // buffered amount low threshold.
+    size_t buffered_amount = 0;
+    size_t unreported_sent_bytes = 0;
+    size_t buffered_amount_low_threshold = 0;
   };
 
   // Map of all currently open or closing data channels
@@ -142,6 +178,7 @@ class DcSctpTransport : public cricket::SctpTransportInternal,
   bool ready_to_send_data_ RTC_GUARDED_BY(network_thread_) = false;
   std::function<void()> on_connected_callback_ RTC_GUARDED_BY(network_thread_);
   DataChannelSink* data_channel_sink_ RTC_GUARDED_BY(network_thread_) = nullptr;
+  ScopedTaskSafety network_safety_;
 };
 
 }  // namespace webrtc
@@ -14,30 +14,38 @@
 #include <type_traits>
 #include <utility>
 
+#include "absl/strings/string_view.h"
+#include "api/data_channel_interface.h"
 #include "api/environment/environment.h"
 #include "api/environment/environment_factory.h"
 #include "api/priority.h"
 #include "api/rtc_error.h"
 #include "api/transport/data_channel_transport_interface.h"
+#include "api/units/timestamp.h"
+#include "net/dcsctp/public/dcsctp_message.h"
 #include "net/dcsctp/public/dcsctp_options.h"
 #include "net/dcsctp/public/dcsctp_socket.h"
 #include "net/dcsctp/public/mock_dcsctp_socket.h"
 #include "net/dcsctp/public/mock_dcsctp_socket_factory.h"
+#include "net/dcsctp/public/payload.h"
 #include "net/dcsctp/public/types.h"
+#include "net/dcsctp/timer/shared_timeout_service.h"
 #include "p2p/dtls/fake_dtls_transport.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/event.h"
+#include "rtc_base/task_queue_for_test.h"
 #include "rtc_base/thread.h"
+#include "system_wrappers/include/clock.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
 using ::testing::_;
-using ::testing::ByMove;
 using ::testing::ElementsAre;
 using ::testing::InSequence;
 using ::testing::Invoke;
 using ::testing::NiceMock;
 using ::testing::Return;
-using ::testing::ReturnPointee;
 
 namespace webrtc {
 
@@ -67,8 +75,10 @@ static_assert(!std::is_abstract_v<MockDataChannelSink>);
 
 class Peer {
  public:
-  Peer()
-      : fake_dtls_transport_(kTransportName, kComponent),
+  explicit Peer(TaskQueueBase* sctp_task_queue = nullptr,
+                dcsctp::SharedTimeoutService* timeout_service = nullptr)
+      : sctp_task_queue_(sctp_task_queue),
+        fake_dtls_transport_(kTransportName, kComponent),
         simulated_clock_(1000),
         env_(CreateEnvironment(&simulated_clock_)) {
     auto socket_ptr = std::make_unique<dcsctp::MockDcSctpSocket>();
@@ -78,19 +88,38 @@ class Peer {
         std::make_unique<dcsctp::MockDcSctpSocketFactory>();
     EXPECT_CALL(*mock_dcsctp_socket_factory, Create)
         .Times(1)
-        .WillOnce(Return(ByMove(std::move(socket_ptr))));
+        .WillOnce([this, socket_ptr = std::move(socket_ptr)](
+                      absl::string_view,
+                      dcsctp::DcSctpSocketCallbacks& callbacks,
+                      std::unique_ptr<dcsctp::PacketObserver>,
+                      const dcsctp::DcSctpOptions&) mutable {
+          callbacks_ = &callbacks;
+          return std::move(socket_ptr);
+        });
 
     sctp_transport_ = std::make_unique<webrtc::DcSctpTransport>(
         env_, rtc::Thread::Current(), &fake_dtls_transport_,
-        std::move(mock_dcsctp_socket_factory));
+        std::move(mock_dcsctp_socket_factory), sctp_task_queue,
+        timeout_service);
     sctp_transport_->SetDataChannelSink(&sink_);
     sctp_transport_->SetOnConnectedCallback([this]() { sink_.OnConnected(); });
   }
+  ~Peer() {
+    sctp_transport_ = nullptr;
+    if (sctp_task_queue_) {
+      // Lets the socket be destroyed on the task queue.
+      SendTask(sctp_task_queue_, [] {});
+    }
+  }
 
+  TaskQueueBase* const sctp_task_queue_;
   cricket::FakeDtlsTransport fake_dtls_transport_;
   webrtc::SimulatedClock simulated_clock_;
   Environment env_;
   dcsctp::MockDcSctpSocket* socket_;
+  // The callbacks given to the socket, which are set when it's created, on
+  // the SCTP task queue if there is one.
+  dcsctp::DcSctpSocketCallbacks* callbacks_ = nullptr;
   std::unique_ptr<webrtc::DcSctpTransport> sctp_transport_;
   NiceMock<MockDataChannelSink> sink_;
 };
@@ -254,10 +283,8 @@ TEST(DcSctpTransportTest, DiscardMessageClosingChannel) {
 TEST(DcSctpTransportTest, SendDataOpenChannel) {
   rtc::AutoThread main_thread;
   Peer peer_a;
-  dcsctp::DcSctpOptions options;
 
   EXPECT_CALL(*peer_a.socket_, Send(_, _)).Times(1);
-  EXPECT_CALL(*peer_a.socket_, options()).WillOnce(ReturnPointee(&options));
 
   peer_a.sctp_transport_->OpenStream(1, kDefaultPriority);
   peer_a.sctp_transport_->Start(5000, 5000, 256 * 1024);
@@ -283,6 +310,29 @@ TEST(DcSctpTransportTest, DeliversMessage) {
           dcsctp::DcSctpMessage(dcsctp::StreamID(1), dcsctp::PPID(53), {0}));
 }
 
+TEST(DcSctpTransportTest, DeliversReceivedMessageWithoutCopyingPayload) {
+  rtc::AutoThread main_thread;
+  Peer peer_a;
+
+  const uint8_t kPayload[] = {1, 2, 3, 4};
+  rtc::Buffer payload(kPayload);
+  const uint8_t* data = payload.data();
+  EXPECT_CALL(peer_a.sink_,
+              OnDataReceived(1, webrtc::DataMessageType::kBinary, _))
+      .WillOnce([&](int, DataMessageType, const rtc::CopyOnWriteBuffer& buf) {
+        EXPECT_EQ(buf.cdata(), data);
+        EXPECT_EQ(buf, rtc::CopyOnWriteBuffer(kPayload));
+      });
+
+  peer_a.sctp_transport_->OpenStream(1, kDefaultPriority);
+  peer_a.sctp_transport_->Start(5000, 5000, 256 * 1024);
+
+  static_cast<dcsctp::DcSctpSocketCallbacks*>(peer_a.sctp_transport_.get())
+      ->OnMessageReceived(dcsctp::DcSctpMessage(
+          dcsctp::StreamID(1), dcsctp::PPID(53),
+          dcsctp::Payload(std::move(payload))));
+}
+
 TEST(DcSctpTransportTest, DropMessageWithUnknownPpid) {
   rtc::AutoThread main_thread;
   Peer peer_a;
@@ -296,4 +346,147 @@ TEST(DcSctpTransportTest, DropMessageWithUnknownPpid) {
       ->OnMessageReceived(
           dcsctp::DcSctpMessage(dcsctp::StreamID(1), dcsctp::PPID(1337), {0}));
 }
+
+TEST(DcSctpTransportTest, DeliversMessageOnNetworkThreadWithSctpTaskQueue) {
+  rtc::AutoThread main_thread;
+  TaskQueueForTest sctp_task_queue("sctp");
+  Peer peer_a(sctp_task_queue.Get());
+
+  peer_a.sctp_transport_->OpenStream(1, kDefaultPriority);
+  peer_a.sctp_transport_->Start(5000, 5000, 256 * 1024);
+
+  EXPECT_CALL(peer_a.sink_, OnDataReceived).Times(0);
+  sctp_task_queue.SendTask([&] {
+    ASSERT_NE(peer_a.callbacks_, nullptr);
+    peer_a.callbacks_->OnMessageReceived(
+        dcsctp::DcSctpMessage(dcsctp::StreamID(1), dcsctp::PPID(53), {0}));
+  });
+
+  EXPECT_CALL(peer_a.sink_,
+              OnDataReceived(1, webrtc::DataMessageType::kBinary, _))
+      .WillOnce([&] { EXPECT_TRUE(main_thread.IsCurrent()); });
+  main_thread.ProcessMessages(0);
+}
+
+TEST(DcSctpTransportTest, SendsDataOnSctpTaskQueue) {
+  rtc::AutoThread main_thread;
+  TaskQueueForTest sctp_task_queue("sctp");
+  Peer peer_a(sctp_task_queue.Get());
+
+  peer_a.sctp_transport_->OpenStream(1, kDefaultPriority);
+  peer_a.sctp_transport_->Start(5000, 5000, 256 * 1024);
+
+  EXPECT_CALL(*peer_a.socket_, Send).WillOnce([&] {
+    EXPECT_TRUE(sctp_task_queue.IsCurrent());
+    return dcsctp::SendStatus::kSuccess;
+  });
+  EXPECT_CALL(*peer_a.socket_, buffered_amount(dcsctp::StreamID(1)))
+      .WillRepeatedly(Return(60));
+  SendDataParams params;
+  params.type = DataMessageType::kBinary;
+  rtc::CopyOnWriteBuffer payload(100);
+  EXPECT_TRUE(peer_a.sctp_transport_->SendData(1, params, payload).ok());
+  // Until the socket has reported the buffered amount, the message is assumed
+  // to be buffered.
+  EXPECT_EQ(peer_a.sctp_transport_->buffered_amount(1), 100u);
+
+  sctp_task_queue.SendTask([] {});
+  main_thread.ProcessMessages(0);
+  EXPECT_EQ(peer_a.sctp_transport_->buffered_amount(1), 60u);
+}
+
+TEST(DcSctpTransportTest, RejectsDataWhenSendQueueIsFullWithSctpTaskQueue) {
+  rtc::AutoThread main_thread;
+  TaskQueueForTest sctp_task_queue("sctp");
+  Peer peer_a(sctp_task_queue.Get());
+
+  peer_a.sctp_transport_->OpenStream(1, kDefaultPriority);
+  peer_a.sctp_transport_->Start(5000, 5000, 256 * 1024);
+  static_cast<dcsctp::DcSctpSocketCallbacks*>(peer_a.sctp_transport_.get())
+      ->OnConnected();
+  ASSERT_TRUE(peer_a.sctp_transport_->ReadyToSendData());
+
+  EXPECT_CALL(*peer_a.socket_, Send).Times(0);
+  ON_CALL(*peer_a.socket_, buffered_amount(dcsctp::StreamID(1)))
+      .WillByDefault(Return(DataChannelInterface::MaxSendQueueSize()));
+  sctp_task_queue.SendTask([&] {
+    peer_a.callbacks_->OnBufferedAmountLow(dcsctp::StreamID(1));
+  });
+  main_thread.ProcessMessages(0);
+
+  SendDataParams params;
+  params.type = DataMessageType::kBinary;
+  rtc::CopyOnWriteBuffer payload(100);
+  EXPECT_EQ(peer_a.sctp_transport_->SendData(1, params, payload).type(),
+            RTCErrorType::RESOURCE_EXHAUSTED);
+  EXPECT_FALSE(peer_a.sctp_transport_->ReadyToSendData());
+
+  ON_CALL(*peer_a.socket_, buffered_amount(dcsctp::StreamID(1)))
+      .WillByDefault(Return(0));
+  EXPECT_CALL(peer_a.sink_, OnReadyToSend);
+  sctp_task_queue.SendTask([&] {
+    peer_a.callbacks_->OnBufferedAmountLow(dcsctp::StreamID(1));
+    peer_a.callbacks_->OnTotalBufferedAmountLow();
+  });
+  main_thread.ProcessMessages(0);
+  EXPECT_TRUE(peer_a.sctp_transport_->ReadyToSendData());
+  EXPECT_EQ(peer_a.sctp_transport_->buffered_amount(1), 0u);
+}
+
+TEST(DcSctpTransportTest, ExpiresTimeoutsOnSctpTaskQueue) {
+  rtc::AutoThread main_thread;
+  TaskQueueForTest sctp_task_queue("sctp");
+  Peer peer_a(sctp_task_queue.Get());
+
+  peer_a.sctp_transport_->Start(5000, 5000, 256 * 1024);
+
+  rtc::Event expired;
+  EXPECT_CALL(*peer_a.socket_, HandleTimeout(dcsctp::TimeoutID(1)))
+      .WillOnce([&] {
+        EXPECT_TRUE(sctp_task_queue.IsCurrent());
+        expired.Set();
+      });
+  std::unique_ptr<dcsctp::Timeout> timeout;
+  sctp_task_queue.SendTask([&] {
+    ASSERT_NE(peer_a.callbacks_, nullptr);
+    timeout =
+        peer_a.callbacks_->CreateTimeout(TaskQueueBase::DelayPrecision::kLow);
+    timeout->Start(dcsctp::DurationMs(10), dcsctp::TimeoutID(1));
+  });
+  peer_a.simulated_clock_.AdvanceTimeMilliseconds(10);
+  EXPECT_TRUE(expired.Wait(TimeDelta::Seconds(5)));
+  sctp_task_queue.SendTask([&] { timeout = nullptr; });
+}
+
+TEST(DcSctpTransportTest, ExpiresTimeoutsOfSharedTimeoutService) {
+  rtc::AutoThread main_thread;
+  TaskQueueForTest sctp_task_queue("sctp");
+  SimulatedClock clock(Timestamp::Seconds(1));
+  auto timeout_service = std::make_unique<dcsctp::SharedTimeoutService>(
+      *sctp_task_queue.Get(),
+      [&clock]() { return dcsctp::TimeMs(clock.TimeInMilliseconds()); });
+  {
+    Peer peer_a(sctp_task_queue.Get(), timeout_service.get());
+    peer_a.sctp_transport_->Start(5000, 5000, 256 * 1024);
+
+    rtc::Event expired;
+    EXPECT_CALL(*peer_a.socket_, HandleTimeout(dcsctp::TimeoutID(1)))
+        .WillOnce([&] {
+          EXPECT_TRUE(sctp_task_queue.IsCurrent());
+          expired.Set();
+        });
+    std::unique_ptr<dcsctp::Timeout> timeout;
+    sctp_task_queue.SendTask([&] {
+      ASSERT_NE(peer_a.callbacks_, nullptr);
+      timeout = peer_a.callbacks_->CreateTimeout(
+          TaskQueueBase::DelayPrecision::kLow);
+      timeout->Start(dcsctp::DurationMs(10), dcsctp::TimeoutID(1));
+      EXPECT_EQ(timeout_service->running_timeouts(), 1u);
+    });
+    clock.AdvanceTimeMilliseconds(10);
+    EXPECT_TRUE(expired.Wait(TimeDelta::Seconds(5)));
+    sctp_task_queue.SendTask([&] { timeout = nullptr; });
+  }
+  sctp_task_queue.SendTask([&] { timeout_service = nullptr; });
+}
 }  // namespace webrtc
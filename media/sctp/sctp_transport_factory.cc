@@ -10,30 +10,114 @@
 
 #include "media/sctp/sctp_transport_factory.h"
 
+#include <memory>
+#include <string>
+#include <utility>
+
 #include "api/environment/environment.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "p2p/dtls/dtls_transport_internal.h"
+#include "rtc_base/event.h"
+#include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/system/unused.h"
 
 #ifdef WEBRTC_HAVE_DCSCTP
 #include "media/sctp/dcsctp_transport.h"  // nogncheck
+#include "net/dcsctp/public/dcsctp_socket_factory.h"  // nogncheck
+#include "net/dcsctp/public/types.h"                   // nogncheck
+#include "net/dcsctp/timer/shared_timeout_service.h"   // nogncheck
 #endif
 
 namespace cricket {
+namespace {
+
+// Runs the SCTP associations of data channels on a pool of task queues instead
+// of on the network thread, which isolates the processing of RTP and RTCP from
+// heavy data channel traffic. Enabled with e.g.
+// "WebRTC-DataChannelTaskQueues/Enabled,queues:2/".
+constexpr char kDataChannelTaskQueuesFieldTrial[] =
+    "WebRTC-DataChannelTaskQueues";
+constexpr int kDefaultNumDataChannelTaskQueues = 2;
+
+}  // namespace
+
+struct SctpTransportFactory::SctpTaskQueue {
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter> task_queue;
+#ifdef WEBRTC_HAVE_DCSCTP
+  // Used and destroyed on `task_queue`.
+  std::unique_ptr<dcsctp::SharedTimeoutService> timeout_service;
+#endif
+};
 
 SctpTransportFactory::SctpTransportFactory(rtc::Thread* network_thread)
     : network_thread_(network_thread) {
   RTC_UNUSED(network_thread_);
 }
 
+SctpTransportFactory::~SctpTransportFactory() {
+  for (const auto& sctp_task_queue : sctp_task_queues_) {
+    rtc::Event done;
+    sctp_task_queue->task_queue->PostTask([&sctp_task_queue, &done] {
+#ifdef WEBRTC_HAVE_DCSCTP
+      sctp_task_queue->timeout_service = nullptr;
+#endif
+      done.Set();
+    });
+    done.Wait(rtc::Event::kForever);
+  }
+}
+
 std::unique_ptr<SctpTransportInternal>
 SctpTransportFactory::CreateSctpTransport(const webrtc::Environment& env,
                                           DtlsTransportInternal* transport) {
   std::unique_ptr<SctpTransportInternal> result;
 #ifdef WEBRTC_HAVE_DCSCTP
-  result = std::unique_ptr<SctpTransportInternal>(
-      new webrtc::DcSctpTransport(env, network_thread_, transport));
+  SctpTaskQueue* sctp_task_queue = GetSctpTaskQueue(env);
+  result = std::unique_ptr<SctpTransportInternal>(new webrtc::DcSctpTransport(
+      env, network_thread_, transport,
+      std::make_unique<dcsctp::DcSctpSocketFactory>(),
+      sctp_task_queue ? sctp_task_queue->task_queue.get() : nullptr,
+      sctp_task_queue ? sctp_task_queue->timeout_service.get() : nullptr));
 #endif
   return result;
 }
 
+SctpTransportFactory::SctpTaskQueue* SctpTransportFactory::GetSctpTaskQueue(
+    const webrtc::Environment& env) {
+  webrtc::FieldTrialFlag enabled("Enabled");
+  webrtc::FieldTrialParameter<int> num_queues(
+      "queues", kDefaultNumDataChannelTaskQueues);
+  webrtc::ParseFieldTrial(
+      {&enabled, &num_queues},
+      env.field_trials().Lookup(kDataChannelTaskQueuesFieldTrial));
+  if (!enabled || num_queues.Get() <= 0) {
+    return nullptr;
+  }
+
+  if (sctp_task_queues_.empty()) {
+    for (int i = 0; i < num_queues.Get(); ++i) {
+      auto sctp_task_queue = std::make_unique<SctpTaskQueue>();
+      sctp_task_queue->task_queue = env.task_queue_factory().CreateTaskQueue(
+          "DataChannelSctp" + std::to_string(i),
+          webrtc::TaskQueueFactory::Priority::NORMAL);
+#ifdef WEBRTC_HAVE_DCSCTP
+      // The timers of all associations on the task queue are handled by a
+      // single task per tick, instead of a delayed task per timer.
+      sctp_task_queue->timeout_service =
+          std::make_unique<dcsctp::SharedTimeoutService>(
+              *sctp_task_queue->task_queue, [env]() {
+                return dcsctp::TimeMs(env.clock().TimeInMilliseconds());
+              });
+#endif
+      sctp_task_queues_.push_back(std::move(sctp_task_queue));
+    }
+  }
+  SctpTaskQueue* sctp_task_queue =
+      sctp_task_queues_[next_sctp_task_queue_].get();
+  next_sctp_task_queue_ =
+      (next_sctp_task_queue_ + 1) % sctp_task_queues_.size();
+  return sctp_task_queue;
+}
+
 }  // namespace cricket
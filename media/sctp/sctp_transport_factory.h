@@ -11,9 +11,12 @@
 #ifndef MEDIA_SCTP_SCTP_TRANSPORT_FACTORY_H_
 #define MEDIA_SCTP_SCTP_TRANSPORT_FACTORY_H_
 
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 #include "api/environment/environment.h"
+#include "api/task_queue/task_queue_base.h"
 #include "api/transport/sctp_transport_factory_interface.h"
 #include "media/sctp/sctp_transport_internal.h"
 #include "rtc_base/thread.h"
@@ -23,13 +26,27 @@ namespace cricket {
 class SctpTransportFactory : public webrtc::SctpTransportFactoryInterface {
  public:
   explicit SctpTransportFactory(rtc::Thread* network_thread);
+  ~SctpTransportFactory() override;
 
   std::unique_ptr<SctpTransportInternal> CreateSctpTransport(
       const webrtc::Environment& env,
       DtlsTransportInternal* transport) override;
 
  private:
+  // A task queue, and the timeout service shared by the associations on it.
+  struct SctpTaskQueue;
+
+  // Returns the task queue that the next transport runs its SCTP association
+  // on, or null if it should run on the network thread.
+  SctpTaskQueue* GetSctpTaskQueue(const webrtc::Environment& env);
+
   rtc::Thread* network_thread_;
+  // Task queues shared by all transports created by this factory, which must
+  // outlive them, and assigned round robin. Created when the first transport
+  // that uses them is created, and drained before they are deleted, as the
+  // transports destroy their SCTP associations on them.
+  std::vector<std::unique_ptr<SctpTaskQueue>> sctp_task_queues_;
+  size_t next_sctp_task_queue_ = 0;
 };
 
 }  // namespace cricket
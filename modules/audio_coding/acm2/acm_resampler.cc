@@ -20,6 +20,8 @@ namespace acm2 {
 
 ACMResampler::ACMResampler() {}
 
+ACMResampler::ACMResampler(bool use_polyphase) : resampler_(use_polyphase) {}
+
 ACMResampler::~ACMResampler() {}
 
 int ACMResampler::Resample10Msec(const int16_t* in_audio,
@@ -56,7 +58,10 @@ int ACMResampler::Resample10Msec(const int16_t* in_audio,
   return static_cast<int>(dst.samples_per_channel());
 }
 
-ResamplerHelper::ResamplerHelper() {
+ResamplerHelper::ResamplerHelper() : ResamplerHelper(false) {}
+
+ResamplerHelper::ResamplerHelper(bool use_polyphase)
+    : resampler_(use_polyphase) {
   ClearSamples(last_audio_buffer_);
 }
 
@@ -23,6 +23,8 @@ namespace acm2 {
 class ACMResampler {
  public:
   ACMResampler();
+  // See `PushResampler` for `use_polyphase`.
+  explicit ACMResampler(bool use_polyphase);
   ~ACMResampler();
 
   // TODO: b/335805780 - Change to accept InterleavedView<>.
@@ -43,6 +45,8 @@ class ACMResampler {
 class ResamplerHelper {
  public:
   ResamplerHelper();
+  // See `PushResampler` for `use_polyphase`.
+  explicit ResamplerHelper(bool use_polyphase);
 
   // Resamples audio_frame if it is not already in desired_sample_rate_hz.
   bool MaybeResample(int desired_sample_rate_hz, AudioFrame* audio_frame);
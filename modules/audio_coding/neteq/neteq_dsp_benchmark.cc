@@ -0,0 +1,209 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of the NetEq DSP under heavy jitter, where expand, merge,
+// accelerate and preemptive expand run frequently, and the cost of the signal
+// processing library functions they rely on.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "api/audio_codecs/L16/audio_decoder_L16.h"
+#include "api/audio_codecs/audio_decoder_factory_template.h"
+#include "api/environment/environment.h"
+#include "api/environment/environment_factory.h"
+#include "api/neteq/default_neteq_factory.h"
+#include "api/neteq/neteq.h"
+#include "api/rtp_headers.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_coding/codecs/pcm16b/pcm16b.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kPayloadType = 96;
+constexpr int kPacketDurationMs = 20;
+constexpr int kOutputDurationMs = 10;
+constexpr int kSimulationDurationMs = 10000;
+
+struct Packet {
+  int64_t arrival_time_ms;
+  RTPHeader header;
+  rtc::Buffer payload;
+};
+
+// Creates the packets of a voiced signal with a varying pitch. The packets
+// have a delay of up to 60 ms, with frequent spikes of up to 300 ms, and 5% of
+// them are lost, so that NetEq expands, merges, accelerates and decelerates
+// throughout the simulation.
+std::vector<Packet> CreatePackets(int sample_rate_hz) {
+  Random random(42);
+  const size_t samples_per_packet = sample_rate_hz * kPacketDurationMs / 1000;
+  std::vector<int16_t> audio(samples_per_packet);
+  std::vector<Packet> packets;
+  double phase = 0.0;
+  for (int n = 0; n < kSimulationDurationMs / kPacketDurationMs; ++n) {
+    const double pitch_hz = 150.0 + 50.0 * std::sin(2.0 * M_PI * n / 50.0);
+    for (int16_t& sample : audio) {
+      phase += 2.0 * M_PI * pitch_hz / sample_rate_hz;
+      const double value = 6000.0 * std::sin(phase) +
+                           3000.0 * std::sin(2.0 * phase) +
+                           random.Gaussian(0.0, 300.0);
+      sample = static_cast<int16_t>(std::clamp(value, -32768.0, 32767.0));
+    }
+    if (random.Rand(0, 19) == 0) {
+      continue;
+    }
+    Packet packet;
+    int64_t delay_ms = random.Rand(0, 60);
+    if (random.Rand(0, 24) == 0) {
+      delay_ms += random.Rand(100, 300);
+    }
+    packet.arrival_time_ms = n * kPacketDurationMs + delay_ms;
+    packet.header.payloadType = kPayloadType;
+    packet.header.sequenceNumber = static_cast<uint16_t>(n);
+    packet.header.timestamp = static_cast<uint32_t>(n * samples_per_packet);
+    packet.header.ssrc = 0x1234;
+    packet.payload.SetSize(samples_per_packet * sizeof(int16_t));
+    WebRtcPcm16b_Encode(audio.data(), audio.size(), packet.payload.data());
+    packets.push_back(std::move(packet));
+  }
+  std::stable_sort(packets.begin(), packets.end(),
+                   [](const Packet& a, const Packet& b) {
+                     return a.arrival_time_ms < b.arrival_time_ms;
+                   });
+  return packets;
+}
+
+// Simulates 10 s of audio. The argument is the sample rate.
+void BM_NetEqHeavyJitter(benchmark::State& state) {
+  const int sample_rate_hz = state.range(0);
+  const std::vector<Packet> packets = CreatePackets(sample_rate_hz);
+  const Environment env = CreateEnvironment();
+  NetEq::Config config;
+  config.sample_rate_hz = sample_rate_hz;
+  NetEqLifetimeStatistics stats;
+  AudioFrame frame;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<NetEq> neteq = DefaultNetEqFactory().Create(
+        env, config, CreateAudioDecoderFactory<AudioDecoderL16>());
+    RTC_CHECK(neteq->RegisterPayloadType(
+        kPayloadType, SdpAudioFormat("l16", sample_rate_hz, 1)));
+    state.ResumeTiming();
+
+    size_t next_packet = 0;
+    for (int64_t time_ms = 0; time_ms < kSimulationDurationMs;
+         time_ms += kOutputDurationMs) {
+      for (; next_packet < packets.size() &&
+             packets[next_packet].arrival_time_ms <= time_ms;
+           ++next_packet) {
+        const Packet& packet = packets[next_packet];
+        neteq->InsertPacket(packet.header, packet.payload,
+                            Timestamp::Millis(time_ms));
+      }
+      bool muted;
+      RTC_CHECK_EQ(neteq->GetAudio(&frame, &muted), NetEq::kOK);
+    }
+    benchmark::DoNotOptimize(frame.data());
+    stats = neteq->GetLifetimeStatistics();
+  }
+  // Shares of the output produced by the time-stretching operations.
+  const double total_samples = stats.total_samples_received;
+  state.counters["concealed"] = stats.concealed_samples / total_samples;
+  state.counters["accelerated"] =
+      stats.removed_samples_for_acceleration / total_samples;
+  state.counters["decelerated"] =
+      stats.inserted_samples_for_deceleration / total_samples;
+}
+BENCHMARK(BM_NetEqHeavyJitter)
+    ->ArgName("sample_rate_hz")
+    ->Arg(16000)
+    ->Arg(48000)
+    ->Unit(benchmark::kMillisecond);
+
+std::vector<int16_t> CreateSignal(size_t length) {
+  Random random(42);
+  std::vector<int16_t> signal(length);
+  for (int16_t& sample : signal) {
+    sample = random.Rand(-16000, 16000);
+  }
+  return signal;
+}
+
+// Runs the cross-correlation of the pitch search of Expand, and that of its
+// LPC analysis at 48 kHz. The arguments are the length of the correlated
+// sequences, the number of lags, and 1 for the optimized version and 0 for the
+// C version.
+void BM_CrossCorrelation(benchmark::State& state) {
+  const size_t length = state.range(0);
+  const size_t num_lags = state.range(1);
+  const CrossCorrelation cross_correlation =
+      state.range(2) ? WebRtcSpl_CrossCorrelation : WebRtcSpl_CrossCorrelationC;
+  const std::vector<int16_t> signal = CreateSignal(length + num_lags);
+  std::vector<int32_t> correlation(num_lags);
+  for (auto _ : state) {
+    cross_correlation(correlation.data(), &signal[num_lags],
+                      &signal[num_lags - 1], length, num_lags,
+                      /*right_shifts=*/2, /*step_seq2=*/-1);
+    benchmark::DoNotOptimize(correlation.data());
+  }
+}
+BENCHMARK(BM_CrossCorrelation)
+    ->ArgNames({"length", "lags", "optimized"})
+    ->Args({60, 54, 0})
+    ->Args({60, 54, 1})
+    ->Args({480, 7, 0})
+    ->Args({480, 7, 1});
+
+// The arguments are the length, and 1 for the optimized version and 0 for the
+// C version.
+void BM_DotProductWithScale(benchmark::State& state) {
+  const size_t length = state.range(0);
+  auto dot_product_with_scale = state.range(1)
+                                    ? WebRtcSpl_DotProductWithScale
+                                    : WebRtcSpl_DotProductWithScaleC;
+  const std::vector<int16_t> signal = CreateSignal(2 * length);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dot_product_with_scale(
+        signal.data(), &signal[length], length, /*scaling=*/6));
+  }
+}
+BENCHMARK(BM_DotProductWithScale)
+    ->ArgNames({"length", "optimized"})
+    ->Args({480, 0})
+    ->Args({480, 1});
+
+// The arguments are the length, and 1 for the optimized version and 0 for the
+// C version.
+void BM_MaxAbsValueW16(benchmark::State& state) {
+  const size_t length = state.range(0);
+  const MaxAbsValueW16 max_abs_value =
+      state.range(1) ? WebRtcSpl_MaxAbsValueW16 : WebRtcSpl_MaxAbsValueW16C;
+  const std::vector<int16_t> signal = CreateSignal(length);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(max_abs_value(signal.data(), length));
+  }
+}
+BENCHMARK(BM_MaxAbsValueW16)
+    ->ArgNames({"length", "optimized"})
+    ->Args({480, 0})
+    ->Args({480, 1});
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Replays recorded RTP dumps, pcap files and RTC event logs through NetEq as
+// fast as possible, and reports the time it takes to decode and process one
+// second of audio, the peak memory use and the jitter buffer delay, in order
+// to catch CPU and latency regressions of NetEq.
+//
+// Usage:
+//   neteq_simulation_benchmark [--input_files=a.rtp,b.rtc] [--benchmark_...]
+//
+// The peak memory use is that of the whole process, which is never reset. Use
+// --benchmark_filter to measure one input per process.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/strings/string_view.h"
+#include "api/audio/audio_frame.h"
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/neteq/neteq.h"
+#include "benchmark/benchmark.h"
+#include "modules/audio_coding/neteq/tools/audio_sink.h"
+#include "modules/audio_coding/neteq/tools/neteq_input.h"
+#include "modules/audio_coding/neteq/tools/neteq_rtp_dump_input.h"
+#include "modules/audio_coding/neteq/tools/neteq_test.h"
+#include "modules/audio_coding/neteq/tools/rtp_file_source.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "rtc_base/checks.h"
+#include "test/testsupport/file_utils.h"
+
+#if WEBRTC_ENABLE_PROTOBUF
+#include "logging/rtc_event_log/rtc_event_log_parser.h"
+#include "modules/audio_coding/neteq/tools/neteq_event_log_input.h"
+#endif
+
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#endif
+
+ABSL_FLAG(std::vector<std::string>,
+          input_files,
+          {},
+          "Comma-separated list of RTP dumps, pcap files or RTC event logs "
+          "to replay. Defaults to the NetEq test resources.");
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// The header extension IDs used by neteq_rtpplay by default.
+const std::map<int, RTPExtensionType> kRtpExtensionMap = {
+    {1, kRtpExtensionAudioLevel},
+    {3, kRtpExtensionAbsoluteSendTime},
+    {5, kRtpExtensionTransportSequenceNumber},
+    {7, kRtpExtensionVideoContentType},
+    {8, kRtpExtensionVideoTiming}};
+
+std::vector<std::string> DefaultInputFiles() {
+  return {ResourcePath("audio_coding/neteq_universal_new", "rtp"),
+          ResourcePath("audio_coding/neteq_opus", "rtp"),
+          ResourcePath("audio_coding/neteq_opus_dtx", "rtp")};
+}
+
+std::unique_ptr<NetEqInput> CreateInput(absl::string_view file_name) {
+  if (RtpFileSource::ValidRtpDump(file_name) ||
+      RtpFileSource::ValidPcap(file_name)) {
+    return CreateNetEqRtpDumpInput(file_name, kRtpExtensionMap,
+                                   /*ssrc_filter=*/std::nullopt);
+  }
+#if WEBRTC_ENABLE_PROTOBUF
+  ParsedRtcEventLog parsed_log;
+  if (parsed_log.ParseFile(file_name).ok()) {
+    return CreateNetEqEventLogInput(parsed_log, /*ssrc=*/std::nullopt);
+  }
+#endif
+  return nullptr;
+}
+
+// Returns the peak resident set size of the process, in bytes.
+std::optional<double> PeakResidentSizeBytes() {
+#if defined(WEBRTC_POSIX)
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(WEBRTC_MAC)
+    return usage.ru_maxrss;
+#else
+    return 1024.0 * usage.ru_maxrss;
+#endif
+  }
+#endif
+  return std::nullopt;
+}
+
+// Samples the jitter buffer delay after every 10 ms of output.
+class DelayCollector : public NetEqGetAudioCallback {
+ public:
+  void BeforeGetAudio(NetEq* neteq) override {}
+  void AfterGetAudio(int64_t time_now_ms,
+                     const AudioFrame& audio_frame,
+                     bool muted,
+                     NetEq* neteq) override {
+    delays_ms_.push_back(neteq->FilteredCurrentDelayMs());
+  }
+
+  // Returns the `percentile`th percentile of the delays, and clears them.
+  int Percentile(int percentile) {
+    if (delays_ms_.empty()) {
+      return 0;
+    }
+    const size_t index = (delays_ms_.size() - 1) * percentile / 100;
+    std::nth_element(delays_ms_.begin(), delays_ms_.begin() + index,
+                     delays_ms_.end());
+    return delays_ms_[index];
+  }
+
+  void Reset() { delays_ms_.clear(); }
+
+ private:
+  std::vector<int> delays_ms_;
+};
+
+void BM_NetEqSimulation(benchmark::State& state, std::string file_name) {
+  DelayCollector delay_collector;
+  NetEqTest::Callbacks callbacks;
+  callbacks.get_audio_callback = &delay_collector;
+  int64_t audio_duration_ms = 0;
+  NetEqLifetimeStatistics stats;
+  int p50_delay_ms = 0;
+  int p95_delay_ms = 0;
+  int max_delay_ms = 0;
+  for (auto _ : state) {
+    // Parsing the input is not part of the measurement.
+    state.PauseTiming();
+    std::unique_ptr<NetEqInput> input = CreateInput(file_name);
+    if (!input || input->ended()) {
+      state.SkipWithError(("Cannot read " + file_name).c_str());
+      return;
+    }
+    NetEq::Config config;
+    config.sample_rate_hz = 48000;
+    delay_collector.Reset();
+    NetEqTest test(config, CreateBuiltinAudioDecoderFactory(),
+                   NetEqTest::StandardDecoderMap(), /*text_log=*/nullptr,
+                   /*neteq_factory=*/nullptr, std::move(input),
+                   std::make_unique<VoidAudioSink>(), callbacks);
+    state.ResumeTiming();
+
+    audio_duration_ms += test.Run();
+
+    state.PauseTiming();
+    stats = test.LifetimeStats();
+    p50_delay_ms = delay_collector.Percentile(50);
+    p95_delay_ms = delay_collector.Percentile(95);
+    max_delay_ms = delay_collector.Percentile(100);
+    state.ResumeTiming();
+  }
+
+  // Time spent per second of audio, on which a regression of the decoders
+  // or the DSP shows.
+  state.counters["time_per_audio_s"] =
+      benchmark::Counter(audio_duration_ms / 1000.0,
+                         benchmark::Counter::kIsRate |
+                             benchmark::Counter::kInvert);
+  if (std::optional<double> peak_bytes = PeakResidentSizeBytes()) {
+    state.counters["peak_rss"] = benchmark::Counter(
+        *peak_bytes, benchmark::Counter::kDefaults,
+        benchmark::Counter::kIs1024);
+  }
+  // Delay statistics of the last replay, on which a regression of
+  // `DecisionLogic` or `DelayManager` shows.
+  if (stats.jitter_buffer_emitted_count > 0) {
+    state.counters["mean_delay_ms"] =
+        static_cast<double>(stats.jitter_buffer_delay_ms) /
+        stats.jitter_buffer_emitted_count;
+    state.counters["mean_target_delay_ms"] =
+        static_cast<double>(stats.jitter_buffer_target_delay_ms) /
+        stats.jitter_buffer_emitted_count;
+  }
+  state.counters["p50_delay_ms"] = p50_delay_ms;
+  state.counters["p95_delay_ms"] = p95_delay_ms;
+  state.counters["max_delay_ms"] = max_delay_ms;
+  if (stats.total_samples_received > 0) {
+    state.counters["concealed"] =
+        static_cast<double>(stats.concealed_samples) /
+        stats.total_samples_received;
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  benchmark::Initialize(&argc, argv);
+  absl::ParseCommandLine(argc, argv);
+  std::vector<std::string> input_files = absl::GetFlag(FLAGS_input_files);
+  if (input_files.empty()) {
+    input_files = webrtc::test::DefaultInputFiles();
+  }
+  for (const std::string& file_name : input_files) {
+    const std::string name =
+        "BM_NetEqSimulation/" +
+        file_name.substr(file_name.find_last_of("/\\") + 1);
+    benchmark::RegisterBenchmark(name.c_str(),
+                                 webrtc::test::BM_NetEqSimulation, file_name)
+        ->Unit(benchmark::kMillisecond);
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
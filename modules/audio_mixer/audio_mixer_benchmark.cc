@@ -0,0 +1,235 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of producing a personalized "N-1" mix for each of the 50
+// participants of a conference, which is what a conferencing server does every
+// 10 ms, the cost of mixing a large room in which few participants speak, and
+// the cost of pulling the audio of many receive streams on several threads.
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "api/audio/audio_mixer.h"
+#include "api/rtp_headers.h"
+#include "api/scoped_refptr.h"
+#include "benchmark/benchmark.h"
+#include "modules/audio_mixer/audio_mixer_impl.h"
+#include "modules/audio_mixer/frame_combiner.h"
+#include "modules/audio_processing/agc2/cpu_features.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kSamplesPerChannel = kSampleRateHz / 100;
+constexpr int kNumParticipants = 50;
+constexpr int kNumActiveSpeakers = 3;
+
+void FillRandom(Random& random, size_t num_channels, AudioFrame& frame) {
+  frame.UpdateFrame(0, nullptr, kSamplesPerChannel, kSampleRateHz,
+                    AudioFrame::kNormalSpeech, AudioFrame::kVadActive,
+                    num_channels);
+  InterleavedView<int16_t> data =
+      frame.mutable_data(kSamplesPerChannel, num_channels);
+  for (size_t i = 0; i < data.size(); ++i) {
+    // Speech-like levels, so that the limiter rarely kicks in.
+    data[i] = random.Rand(-2000, 2000);
+  }
+}
+
+class Participant : public AudioMixer::Source {
+ public:
+  Participant(Random& random, int ssrc, size_t num_channels) : ssrc_(ssrc) {
+    FillRandom(random, num_channels, frame_);
+  }
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    if (muted_) {
+      return AudioFrameInfo::kMuted;
+    }
+    audio_frame->CopyFrom(frame_);
+    // Emulates the decoding and post-processing of a jitter buffer.
+    InterleavedView<int16_t> data = audio_frame->mutable_data(
+        audio_frame->samples_per_channel_, audio_frame->num_channels_);
+    for (int k = 0; k < pull_cost_; ++k) {
+      int state = 0;
+      for (size_t i = 0; i < data.size(); ++i) {
+        state = (3 * state + data[i]) / 4;
+        data[i] = static_cast<int16_t>(state);
+      }
+    }
+    return AudioFrameInfo::kNormal;
+  }
+  int Ssrc() const override { return ssrc_; }
+  int PreferredSampleRate() const override { return kSampleRateHz; }
+  std::optional<AudioLevel> LatestAudioLevel() const override {
+    return audio_level_;
+  }
+
+  void set_audio_level(AudioLevel audio_level) { audio_level_ = audio_level; }
+  void set_muted(bool muted) { muted_ = muted; }
+  // Number of filtering passes over the frame on every pull.
+  void set_pull_cost(int pull_cost) { pull_cost_ = pull_cost; }
+
+ private:
+  const int ssrc_;
+  AudioFrame frame_;
+  std::optional<AudioLevel> audio_level_;
+  bool muted_ = false;
+  int pull_cost_ = 0;
+};
+
+std::vector<std::unique_ptr<Participant>> CreateParticipants(
+    size_t num_channels) {
+  Random random(42);
+  std::vector<std::unique_ptr<Participant>> participants;
+  for (int i = 0; i < kNumParticipants; ++i) {
+    participants.push_back(
+        std::make_unique<Participant>(random, i, num_channels));
+  }
+  return participants;
+}
+
+// The argument is the number of channels.
+void BM_MixerPerParticipant(benchmark::State& state) {
+  const size_t num_channels = state.range(0);
+  auto participants = CreateParticipants(num_channels);
+  // One mixer per participant, which mixes the audio of all others.
+  std::vector<rtc::scoped_refptr<AudioMixerImpl>> mixers;
+  for (int i = 0; i < kNumParticipants; ++i) {
+    mixers.push_back(AudioMixerImpl::Create());
+    for (int j = 0; j < kNumParticipants; ++j) {
+      if (j != i) {
+        mixers[i]->AddSource(participants[j].get());
+      }
+    }
+  }
+  std::vector<AudioFrame> mixes(kNumParticipants);
+  for (auto _ : state) {
+    for (int i = 0; i < kNumParticipants; ++i) {
+      mixers[i]->Mix(num_channels, &mixes[i]);
+    }
+    benchmark::DoNotOptimize(mixes.back().data());
+  }
+}
+BENCHMARK(BM_MixerPerParticipant)->ArgName("channels")->Arg(1)->Arg(2);
+
+// The argument is the number of channels.
+void BM_MixerExcludingEachParticipant(benchmark::State& state) {
+  const size_t num_channels = state.range(0);
+  auto participants = CreateParticipants(num_channels);
+  auto mixer = AudioMixerImpl::Create();
+  std::vector<AudioMixer::Source*> sources;
+  for (auto& participant : participants) {
+    mixer->AddSource(participant.get());
+    sources.push_back(participant.get());
+  }
+  std::vector<AudioFrame> mixes(kNumParticipants);
+  std::vector<AudioFrame*> mix_ptrs;
+  for (AudioFrame& mix : mixes) {
+    mix_ptrs.push_back(&mix);
+  }
+  for (auto _ : state) {
+    mixer->MixExcludingEachSource(num_channels, sources, mix_ptrs);
+    benchmark::DoNotOptimize(mixes.back().data());
+  }
+}
+BENCHMARK(BM_MixerExcludingEachParticipant)
+    ->ArgName("channels")
+    ->Arg(1)
+    ->Arg(2);
+
+// Mixes a room in which `kNumActiveSpeakers` participants speak. The argument
+// is 1 if sparse mixing is enabled.
+void BM_MixerLargeRoom(benchmark::State& state) {
+  auto participants = CreateParticipants(/*num_channels=*/1);
+  auto mixer = AudioMixerImpl::Create();
+  if (state.range(0)) {
+    mixer->EnableSparseMixing(/*max_active_speakers=*/kNumActiveSpeakers);
+  }
+  for (int i = 0; i < kNumParticipants; ++i) {
+    participants[i]->set_audio_level(
+        AudioLevel(/*voice_activity=*/i < kNumActiveSpeakers, /*level=*/30));
+    mixer->AddSource(participants[i].get());
+  }
+  AudioFrame mix;
+  for (auto _ : state) {
+    mixer->Mix(/*number_of_channels=*/1, &mix);
+    benchmark::DoNotOptimize(mix.data());
+  }
+}
+BENCHMARK(BM_MixerLargeRoom)->ArgName("sparse")->Arg(0)->Arg(1);
+
+// Mixes the receive streams of a server, one in five of which is muted, and
+// the others cost about as much to pull as a jitter buffer decoding a packet.
+// The argument is the number of pulling threads. The CPU time is that of the
+// whole process, helper threads included.
+void BM_MixerParallelPulling(benchmark::State& state) {
+  auto participants = CreateParticipants(/*num_channels=*/1);
+  auto mixer = AudioMixerImpl::Create();
+  mixer->EnableParallelPulling(/*num_threads=*/state.range(0));
+  for (int i = 0; i < kNumParticipants; ++i) {
+    participants[i]->set_muted(i % 5 == 0);
+    participants[i]->set_pull_cost(/*pull_cost=*/5);
+    mixer->AddSource(participants[i].get());
+  }
+  AudioFrame mix;
+  for (auto _ : state) {
+    mixer->Mix(/*number_of_channels=*/1, &mix);
+    benchmark::DoNotOptimize(mix.data());
+  }
+}
+BENCHMARK(BM_MixerParallelPulling)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+
+// Mixes the frames of all participants but one, without and with the SIMD
+// sum and conversion kernels.
+void RunFrameCombiner(benchmark::State& state,
+                      AvailableCpuFeatures cpu_features) {
+  const size_t num_channels = state.range(0);
+  Random random(42);
+  std::vector<AudioFrame> frames(kNumParticipants - 1);
+  std::vector<AudioFrame*> frame_ptrs;
+  for (AudioFrame& frame : frames) {
+    FillRandom(random, num_channels, frame);
+    frame_ptrs.push_back(&frame);
+  }
+  FrameCombiner combiner(/*use_limiter=*/true, cpu_features);
+  AudioFrame mix;
+  for (auto _ : state) {
+    combiner.Combine(frame_ptrs, num_channels, kSampleRateHz,
+                     frame_ptrs.size(), &mix);
+    benchmark::DoNotOptimize(mix.data());
+  }
+}
+
+// The argument is the number of channels.
+void BM_FrameCombinerScalar(benchmark::State& state) {
+  RunFrameCombiner(state, NoAvailableCpuFeatures());
+}
+BENCHMARK(BM_FrameCombinerScalar)->ArgName("channels")->Arg(1)->Arg(2);
+
+// The argument is the number of channels.
+void BM_FrameCombinerOptimized(benchmark::State& state) {
+  RunFrameCombiner(state, GetAvailableCpuFeatures());
+}
+BENCHMARK(BM_FrameCombinerOptimized)->ArgName("channels")->Arg(1)->Arg(2);
+
+}  // namespace
+}  // namespace webrtc
@@ -14,9 +14,11 @@
 
 #include <algorithm>
 #include <iterator>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
+#include "api/rtp_headers.h"
 #include "modules/audio_mixer/audio_frame_manipulator.h"
 #include "modules/audio_mixer/default_output_rate_calculator.h"
 #include "rtc_base/checks.h"
@@ -27,15 +29,36 @@
 namespace webrtc {
 
 struct AudioMixerImpl::SourceStatus {
-  explicit SourceStatus(Source* audio_source) : audio_source(audio_source) {}
+  SourceStatus(Source* audio_source, size_t pull_slot)
+      : audio_source(audio_source), pull_slot(pull_slot) {}
   Source* audio_source = nullptr;
 
+  // Decides the slice of parallel pulling which pulls this source, so that
+  // the source is pulled by the same thread on every mixing pass.
+  const size_t pull_slot;
+
   // A frame that will be passed to audio_source->GetAudioFrameWithInfo.
   AudioFrame audio_frame;
+
+  // Combiner of the mix excluding this source, created on the first
+  // `MixExcludingEachSource()` call.
+  std::unique_ptr<FrameCombiner> excluding_frame_combiner;
+
+  // Whether the source is mixed in the current and in the previous call. A
+  // source is not mixed only in sparse mixing mode.
+  bool is_mixed = true;
+  bool was_mixed = true;
+
+  // Result of the latest pull, and whether it was muted or comfort noise.
+  Source::AudioFrameInfo audio_frame_info = Source::AudioFrameInfo::kError;
+  bool was_quiet = false;
 };
 
 namespace {
 
+// Audio level of digital silence, in -dBov.
+constexpr int kDigitalSilenceLevel = 127;
+
 std::vector<std::unique_ptr<AudioMixerImpl::SourceStatus>>::const_iterator
 FindSourceInList(
     AudioMixerImpl::Source const* audio_source,
@@ -47,16 +70,37 @@ FindSourceInList(
         return p->audio_source == audio_source;
       });
 }
+
+void PullAudio(int output_frequency,
+               AudioMixerImpl::SourceStatus& source_status) {
+  source_status.audio_frame_info =
+      source_status.audio_source->GetAudioFrameWithInfo(
+          output_frequency, &source_status.audio_frame);
+  source_status.was_quiet =
+      source_status.audio_frame_info ==
+          AudioMixerImpl::Source::AudioFrameInfo::kMuted ||
+      (source_status.audio_frame_info ==
+           AudioMixerImpl::Source::AudioFrameInfo::kNormal &&
+       source_status.audio_frame.speech_type_ == AudioFrame::kCNG);
+}
 }  // namespace
 
 struct AudioMixerImpl::HelperContainers {
   void resize(size_t size) {
     audio_to_mix.resize(size);
     preferred_rates.resize(size);
+    active_speakers.reserve(size);
+    sources_to_pull.reserve(size);
   }
 
   std::vector<AudioFrame*> audio_to_mix;
   std::vector<int> preferred_rates;
+  // Audio levels of the sources reporting voice activity, in -dBov.
+  std::vector<std::pair<int, SourceStatus*>> active_speakers;
+  // Sources asked for audio in the current call, in the order of the source
+  // list, and split by pull slice when pulled in parallel.
+  std::vector<SourceStatus*> sources_to_pull;
+  std::vector<std::vector<SourceStatus*>> sources_per_slice;
 };
 
 AudioMixerImpl::AudioMixerImpl(
@@ -65,6 +109,7 @@ AudioMixerImpl::AudioMixerImpl(
     : output_rate_calculator_(std::move(output_rate_calculator)),
       audio_source_list_(),
       helper_containers_(std::make_unique<HelperContainers>()),
+      use_limiter_(use_limiter),
       frame_combiner_(use_limiter) {}
 
 AudioMixerImpl::~AudioMixerImpl() {}
@@ -89,29 +134,64 @@ void AudioMixerImpl::Mix(size_t number_of_channels,
   MutexLock lock(&mutex_);
 
   size_t number_of_streams = audio_source_list_.size();
-
-  std::transform(audio_source_list_.begin(), audio_source_list_.end(),
-                 helper_containers_->preferred_rates.begin(),
-                 [&](std::unique_ptr<SourceStatus>& a) {
-                   return a->audio_source->PreferredSampleRate();
-                 });
-
-  int output_frequency = output_rate_calculator_->CalculateOutputRateFromRange(
-      rtc::ArrayView<const int>(helper_containers_->preferred_rates.data(),
-                                number_of_streams));
+  int output_frequency = CalculateOutputFrequency();
 
   frame_combiner_.Combine(GetAudioFromSources(output_frequency),
                           number_of_channels, output_frequency,
                           number_of_streams, audio_frame_for_mixing);
 }
 
+void AudioMixerImpl::MixExcludingEachSource(
+    size_t number_of_channels,
+    rtc::ArrayView<Source* const> sources,
+    rtc::ArrayView<AudioFrame* const> audio_frames_for_mixing) {
+  TRACE_EVENT0("webrtc", "AudioMixerImpl::MixExcludingEachSource");
+  RTC_DCHECK(number_of_channels >= 1);
+  RTC_DCHECK_EQ(sources.size(), audio_frames_for_mixing.size());
+  MutexLock lock(&mutex_);
+
+  size_t number_of_streams = audio_source_list_.size();
+  int output_frequency = CalculateOutputFrequency();
+
+  shared_mix_.Mix(GetAudioFromSources(output_frequency), number_of_channels,
+                  output_frequency);
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    const auto iter = FindSourceInList(sources[i], &audio_source_list_);
+    RTC_DCHECK(iter != audio_source_list_.end())
+        << "Source not present in mixer";
+    SourceStatus& source_status = **iter;
+    if (!source_status.excluding_frame_combiner) {
+      source_status.excluding_frame_combiner =
+          std::make_unique<FrameCombiner>(use_limiter_);
+    }
+    // The mix corresponds to that of a mixer without the excluded source.
+    source_status.excluding_frame_combiner->CombineExcluding(
+        shared_mix_, &source_status.audio_frame, number_of_streams - 1,
+        audio_frames_for_mixing[i]);
+  }
+}
+
+void AudioMixerImpl::EnableSparseMixing(size_t max_active_speakers) {
+  MutexLock lock(&mutex_);
+  max_active_speakers_ = max_active_speakers;
+}
+
+void AudioMixerImpl::EnableParallelPulling(int num_threads) {
+  RTC_DCHECK_GE(num_threads, 1);
+  MutexLock lock(&mutex_);
+  pull_pool_ = num_threads > 1 ? std::make_unique<SourcePullPool>(num_threads)
+                               : nullptr;
+}
+
 bool AudioMixerImpl::AddSource(Source* audio_source) {
   RTC_DCHECK(audio_source);
   MutexLock lock(&mutex_);
   RTC_DCHECK(FindSourceInList(audio_source, &audio_source_list_) ==
              audio_source_list_.end())
       << "Source already added to mixer";
-  audio_source_list_.emplace_back(new SourceStatus(audio_source));
+  audio_source_list_.emplace_back(
+      new SourceStatus(audio_source, next_pull_slot_++));
   helper_containers_->resize(audio_source_list_.size());
   UpdateSourceCountStats();
   return true;
@@ -125,14 +205,72 @@ void AudioMixerImpl::RemoveSource(Source* audio_source) {
   audio_source_list_.erase(iter);
 }
 
+void AudioMixerImpl::SelectActiveSpeakers() {
+  std::vector<std::pair<int, SourceStatus*>>& active_speakers =
+      helper_containers_->active_speakers;
+  active_speakers.clear();
+  for (auto& source_and_status : audio_source_list_) {
+    source_and_status->was_mixed = source_and_status->is_mixed;
+    const std::optional<AudioLevel> audio_level =
+        source_and_status->audio_source->LatestAudioLevel();
+    source_and_status->is_mixed = !audio_level.has_value();
+    if (audio_level && audio_level->voice_activity() &&
+        audio_level->level() < kDigitalSilenceLevel) {
+      active_speakers.emplace_back(audio_level->level(),
+                                   source_and_status.get());
+    }
+  }
+
+  // The loudest sources have the lowest levels. Among equally loud sources,
+  // those already mixed are kept, so that the mix does not flicker.
+  const size_t number_of_mixed_speakers =
+      std::min(*max_active_speakers_, active_speakers.size());
+  std::partial_sort(
+      active_speakers.begin(),
+      active_speakers.begin() + number_of_mixed_speakers,
+      active_speakers.end(),
+      [](const std::pair<int, SourceStatus*>& a,
+         const std::pair<int, SourceStatus*>& b) {
+        return std::make_pair(a.first, !a.second->was_mixed) <
+               std::make_pair(b.first, !b.second->was_mixed);
+      });
+  for (size_t i = 0; i < number_of_mixed_speakers; ++i) {
+    active_speakers[i].second->is_mixed = true;
+  }
+}
+
 rtc::ArrayView<AudioFrame* const> AudioMixerImpl::GetAudioFromSources(
     int output_frequency) {
-  int audio_to_mix_count = 0;
+  if (max_active_speakers_) {
+    SelectActiveSpeakers();
+  }
+  std::vector<SourceStatus*>& sources_to_pull =
+      helper_containers_->sources_to_pull;
+  sources_to_pull.clear();
   for (auto& source_and_status : audio_source_list_) {
-    const auto audio_frame_info =
-        source_and_status->audio_source->GetAudioFrameWithInfo(
-            output_frequency, &source_and_status->audio_frame);
-    switch (audio_frame_info) {
+    if (source_and_status->is_mixed && !source_and_status->was_mixed) {
+      source_and_status->audio_source->SetDeselected(false);
+    }
+    // A source leaving the mix is asked for audio one last time, to be
+    // ramped out.
+    if (source_and_status->is_mixed || source_and_status->was_mixed) {
+      sources_to_pull.push_back(source_and_status.get());
+    }
+  }
+  if (pull_pool_) {
+    PullAudioInParallel(output_frequency);
+  } else {
+    for (SourceStatus* source_status : sources_to_pull) {
+      PullAudio(output_frequency, *source_status);
+    }
+  }
+
+  int audio_to_mix_count = 0;
+  for (SourceStatus* source_status : sources_to_pull) {
+    if (!source_status->is_mixed) {
+      source_status->audio_source->SetDeselected(true);
+    }
+    switch (source_status->audio_frame_info) {
       case Source::AudioFrameInfo::kError:
         RTC_LOG_F(LS_WARNING)
             << "failed to GetAudioFrameWithInfo() from source";
@@ -140,14 +278,66 @@ rtc::ArrayView<AudioFrame* const> AudioMixerImpl::GetAudioFromSources(
       case Source::AudioFrameInfo::kMuted:
         break;
       case Source::AudioFrameInfo::kNormal:
+        if (source_status->is_mixed != source_status->was_mixed) {
+          Ramp(source_status->was_mixed ? 1.f : 0.f,
+               source_status->is_mixed ? 1.f : 0.f,
+               &source_status->audio_frame);
+        }
         helper_containers_->audio_to_mix[audio_to_mix_count++] =
-            &source_and_status->audio_frame;
+            &source_status->audio_frame;
     }
   }
   return rtc::ArrayView<AudioFrame* const>(
       helper_containers_->audio_to_mix.data(), audio_to_mix_count);
 }
 
+void AudioMixerImpl::PullAudioInParallel(int output_frequency) {
+  const size_t num_slices = pull_pool_->num_threads();
+  std::vector<std::vector<SourceStatus*>>& sources_per_slice =
+      helper_containers_->sources_per_slice;
+  sources_per_slice.resize(num_slices);
+  for (std::vector<SourceStatus*>& slice_sources : sources_per_slice) {
+    slice_sources.clear();
+  }
+  size_t num_busy_sources = 0;
+  for (SourceStatus* source_status : helper_containers_->sources_to_pull) {
+    // Producing a muted or comfort noise frame is cheap, so sources whose
+    // last frame was one are pulled by the mixing thread instead of being
+    // handed to a helper thread.
+    if (source_status->was_quiet) {
+      sources_per_slice[0].push_back(source_status);
+      continue;
+    }
+    sources_per_slice[source_status->pull_slot % num_slices].push_back(
+        source_status);
+    ++num_busy_sources;
+  }
+  if (num_busy_sources < num_slices) {
+    // Waking up the helper threads would cost more than it saves.
+    for (SourceStatus* source_status : helper_containers_->sources_to_pull) {
+      PullAudio(output_frequency, *source_status);
+    }
+    return;
+  }
+  pull_pool_->Run([&](int slice) {
+    for (SourceStatus* source_status : sources_per_slice[slice]) {
+      PullAudio(output_frequency, *source_status);
+    }
+  });
+}
+
+int AudioMixerImpl::CalculateOutputFrequency() {
+  std::transform(audio_source_list_.begin(), audio_source_list_.end(),
+                 helper_containers_->preferred_rates.begin(),
+                 [&](std::unique_ptr<SourceStatus>& a) {
+                   return a->audio_source->PreferredSampleRate();
+                 });
+
+  return output_rate_calculator_->CalculateOutputRateFromRange(
+      rtc::ArrayView<const int>(helper_containers_->preferred_rates.data(),
+                                audio_source_list_.size()));
+}
+
 void AudioMixerImpl::UpdateSourceCountStats() {
   size_t current_source_count = audio_source_list_.size();
   // Log to the histogram whenever the maximum number of sources increases.
@@ -14,6 +14,7 @@
 #include <stddef.h>
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "api/array_view.h"
@@ -22,6 +23,7 @@
 #include "api/scoped_refptr.h"
 #include "modules/audio_mixer/frame_combiner.h"
 #include "modules/audio_mixer/output_rate_calculator.h"
+#include "modules/audio_mixer/source_pull_pool.h"
 #include "rtc_base/race_checker.h"
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/thread_annotations.h"
@@ -54,6 +56,41 @@ class AudioMixerImpl : public AudioMixer {
            AudioFrame* audio_frame_for_mixing) override
       RTC_LOCKS_EXCLUDED(mutex_);
 
+  // Produces "N-1" mixes for conferencing servers: for every source in
+  // `sources`, writes the mix of all other sources to the corresponding frame
+  // of `audio_frames_for_mixing`. The audio of the sources is fetched and
+  // mixed once, and every mix is derived from the shared one by subtracting
+  // the audio of the excluded source. Every source has its own limiter.
+  void MixExcludingEachSource(
+      size_t number_of_channels,
+      rtc::ArrayView<Source* const> sources,
+      rtc::ArrayView<AudioFrame* const> audio_frames_for_mixing)
+      RTC_LOCKS_EXCLUDED(mutex_);
+
+  // Enables sparse mixing, in which the mixer asks for audio only from the
+  // `max_active_speakers` loudest of the sources whose latest audio level
+  // reports voice activity, see `Source::LatestAudioLevel()`. The other
+  // sources reporting a level are neither asked for audio nor mixed, which
+  // makes the cost of mixing proportional to the number of active speakers
+  // rather than to the number of sources. Sources which do not report a
+  // level are always mixed. Sources entering or leaving the mix are ramped
+  // in or out over one frame.
+  void EnableSparseMixing(size_t max_active_speakers)
+      RTC_LOCKS_EXCLUDED(mutex_);
+
+  // Spreads the pulls of the audio of the sources over `num_threads`
+  // threads, the mixing thread included, so that a mixing pass over the many
+  // receive streams of a server, each running its own jitter buffer and
+  // decoder, finishes sooner on the mixing thread when other cores are idle.
+  // It does not lower the total CPU time of a pass, which grows slightly
+  // with the cost of waking up and joining the helper threads, which is why
+  // it is disabled by default. Sources whose last frame was muted or comfort
+  // noise are pulled on the mixing thread; every other source is pulled by
+  // the same thread on every pass, sources being dealt to the threads in the
+  // order they are added. Passes with fewer such sources than threads are
+  // pulled on the mixing thread alone. Does nothing if `num_threads` is 1.
+  void EnableParallelPulling(int num_threads) RTC_LOCKS_EXCLUDED(mutex_);
+
  protected:
   AudioMixerImpl(std::unique_ptr<OutputRateCalculator> output_rate_calculator,
                  bool use_limiter);
@@ -63,10 +100,21 @@ class AudioMixerImpl : public AudioMixer {
 
   void UpdateSourceCountStats() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Computes the output rate from the preferred rates of the sources.
+  int CalculateOutputFrequency() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Decides which sources to mix in sparse mixing mode.
+  void SelectActiveSpeakers() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // Fetches audio frames to mix from sources.
   rtc::ArrayView<AudioFrame* const> GetAudioFromSources(int output_frequency)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Pulls the audio of the sources in `sources_to_pull` on the threads of
+  // `pull_pool_`.
+  void PullAudioInParallel(int output_frequency)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // The critical section lock guards audio source insertion and
   // removal, which can be done from any thread. The race checker
   // checks that mixing is done sequentially.
@@ -80,9 +128,22 @@ class AudioMixerImpl : public AudioMixer {
   const std::unique_ptr<HelperContainers> helper_containers_
       RTC_GUARDED_BY(mutex_);
 
+  const bool use_limiter_;
+
+  // Set if sparse mixing is enabled.
+  std::optional<size_t> max_active_speakers_ RTC_GUARDED_BY(mutex_);
+
+  // Set if parallel pulling is enabled.
+  std::unique_ptr<SourcePullPool> pull_pool_ RTC_GUARDED_BY(mutex_);
+  // Pull slot of the next source added.
+  size_t next_pull_slot_ RTC_GUARDED_BY(mutex_) = 0;
+
   // Component that handles actual adding of audio frames.
   FrameCombiner frame_combiner_;
 
+  // Mix of all sources shared by the mixes of `MixExcludingEachSource()`.
+  FrameCombiner::SharedMix shared_mix_ RTC_GUARDED_BY(mutex_);
+
   // The highest source count this mixer has ever had. Used for UMA stats.
   size_t max_source_count_ever_ = 0;
 };
@@ -21,11 +21,13 @@
 #include <vector>
 
 #include "api/audio/audio_mixer.h"
+#include "api/rtp_headers.h"
 #include "api/rtp_packet_info.h"
 #include "api/rtp_packet_infos.h"
 #include "api/units/timestamp.h"
 #include "modules/audio_mixer/default_output_rate_calculator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/platform_thread_types.h"
 #include "rtc_base/strings/string_builder.h"
 #include "rtc_base/task_queue_for_test.h"
 #include "system_wrappers/include/metrics.h"
@@ -34,9 +36,11 @@
 
 using ::testing::_;
 using ::testing::Exactly;
+using ::testing::InSequence;
 using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::UnorderedElementsAre;
+using ::testing::UnorderedElementsAreArray;
 
 namespace webrtc {
 
@@ -90,6 +94,11 @@ class MockMixerAudioSource : public ::testing::NiceMock<AudioMixer::Source> {
 
   MOCK_METHOD(int, PreferredSampleRate, (), (const, override));
   MOCK_METHOD(int, Ssrc, (), (const, override));
+  MOCK_METHOD(std::optional<AudioLevel>,
+              LatestAudioLevel,
+              (),
+              (const, override));
+  MOCK_METHOD(void, SetDeselected, (bool deselected), (override));
 
   AudioFrame* fake_frame() { return &fake_frame_; }
   AudioFrameInfo fake_info() { return fake_audio_frame_info_; }
@@ -479,6 +488,239 @@ TEST(AudioMixer, ShouldIncludeRtpPacketInfoFromAllMixedSources) {
   EXPECT_THAT(frame_for_mixing.packet_infos_, UnorderedElementsAre(p0, p1, p2));
 }
 
+TEST(AudioMixer, MixExcludingEachSourceMatchesMixOfOtherSources) {
+  constexpr int kNumSources = 4;
+  const auto mixer = AudioMixerImpl::Create();
+  MockMixerAudioSource sources[kNumSources];
+  std::vector<AudioMixer::Source*> source_ptrs;
+  for (int i = 0; i < kNumSources; ++i) {
+    ResetFrame(sources[i].fake_frame());
+    int16_t* data = sources[i].fake_frame()->mutable_data();
+    for (size_t j = 0; j < sources[i].fake_frame()->samples_per_channel_;
+         ++j) {
+      data[j] = static_cast<int16_t>(1000 * (i + 1) + j);
+    }
+    sources[i].set_packet_infos(RtpPacketInfos({RtpPacketInfo(
+        /*ssrc=*/i, /*csrcs=*/{}, /*rtp_timestamp=*/0, Timestamp::Millis(0))}));
+    EXPECT_TRUE(mixer->AddSource(&sources[i]));
+    source_ptrs.push_back(&sources[i]);
+  }
+  // One source does not contribute to the mixes.
+  sources[kNumSources - 1].set_fake_info(
+      AudioMixer::Source::AudioFrameInfo::kMuted);
+
+  // Reference mixers of all sources but one.
+  std::vector<rtc::scoped_refptr<AudioMixerImpl>> reference_mixers;
+  for (int i = 0; i < kNumSources; ++i) {
+    reference_mixers.push_back(AudioMixerImpl::Create());
+    for (int j = 0; j < kNumSources; ++j) {
+      if (j != i) {
+        reference_mixers[i]->AddSource(&sources[j]);
+      }
+    }
+  }
+
+  std::vector<AudioFrame> mixes(kNumSources);
+  std::vector<AudioFrame*> mix_ptrs;
+  for (AudioFrame& mix : mixes) {
+    mix_ptrs.push_back(&mix);
+  }
+  // Several iterations in order to compare the limiter states as well.
+  for (int k = 0; k < 3; ++k) {
+    mixer->MixExcludingEachSource(/*number_of_channels=*/1, source_ptrs,
+                                  mix_ptrs);
+    for (int i = 0; i < kNumSources; ++i) {
+      SCOPED_TRACE(i);
+      AudioFrame reference;
+      reference_mixers[i]->Mix(/*number_of_channels=*/1, &reference);
+      EXPECT_EQ(0, memcmp(reference.data(), mixes[i].data(),
+                          reference.samples_per_channel_ * sizeof(int16_t)));
+      EXPECT_THAT(mixes[i].packet_infos_,
+                  UnorderedElementsAreArray(reference.packet_infos_));
+    }
+  }
+}
+
+TEST(AudioMixer, SparseMixingOnlyAsksLoudestActiveSpeakersForAudio) {
+  const auto mixer = AudioMixerImpl::Create();
+  mixer->EnableSparseMixing(/*max_active_speakers=*/2);
+  MockMixerAudioSource loudest, second_loudest, third_loudest, no_vad,
+      silent, no_level;
+  ON_CALL(loudest, LatestAudioLevel())
+      .WillByDefault(Return(AudioLevel(/*voice_activity=*/true, 10)));
+  ON_CALL(second_loudest, LatestAudioLevel())
+      .WillByDefault(Return(AudioLevel(/*voice_activity=*/true, 20)));
+  ON_CALL(third_loudest, LatestAudioLevel())
+      .WillByDefault(Return(AudioLevel(/*voice_activity=*/true, 30)));
+  ON_CALL(no_vad, LatestAudioLevel())
+      .WillByDefault(Return(AudioLevel(/*voice_activity=*/false, 5)));
+  ON_CALL(silent, LatestAudioLevel())
+      .WillByDefault(Return(AudioLevel(/*voice_activity=*/true, 127)));
+  for (MockMixerAudioSource* source : {&loudest, &second_loudest,
+                                       &third_loudest, &no_vad, &silent,
+                                       &no_level}) {
+    ResetFrame(source->fake_frame());
+    EXPECT_TRUE(mixer->AddSource(source));
+  }
+
+  // The sources leaving the mix are asked for audio once more, to be ramped
+  // out.
+  EXPECT_CALL(loudest, GetAudioFrameWithInfo).Times(3);
+  EXPECT_CALL(second_loudest, GetAudioFrameWithInfo).Times(3);
+  EXPECT_CALL(third_loudest, GetAudioFrameWithInfo).Times(1);
+  EXPECT_CALL(no_vad, GetAudioFrameWithInfo).Times(1);
+  EXPECT_CALL(silent, GetAudioFrameWithInfo).Times(1);
+  EXPECT_CALL(no_level, GetAudioFrameWithInfo).Times(3);
+  for (int i = 0; i < 3; ++i) {
+    mixer->Mix(/*number_of_channels=*/1, &frame_for_mixing);
+  }
+}
+
+TEST(AudioMixer, SparseMixingRampsInSourcesEnteringTheMix) {
+  constexpr int16_t kValue = 10000;
+  const auto mixer = AudioMixerImpl::Create();
+  mixer->EnableSparseMixing(/*max_active_speakers=*/1);
+  MockMixerAudioSource source;
+  ResetFrame(source.fake_frame());
+  int16_t* data = source.fake_frame()->mutable_data();
+  for (size_t i = 0; i < source.fake_frame()->samples_per_channel_; ++i) {
+    data[i] = kValue;
+  }
+  EXPECT_TRUE(mixer->AddSource(&source));
+
+  EXPECT_CALL(source, LatestAudioLevel())
+      .WillOnce(Return(AudioLevel(/*voice_activity=*/false, 20)))
+      .WillOnce(Return(AudioLevel(/*voice_activity=*/false, 20)))
+      .WillRepeatedly(Return(AudioLevel(/*voice_activity=*/true, 20)));
+  // Ramped out.
+  mixer->Mix(/*number_of_channels=*/1, &frame_for_mixing);
+  EXPECT_EQ(frame_for_mixing.data()[0], kValue);
+  EXPECT_LT(frame_for_mixing.data()[frame_for_mixing.samples_per_channel_ - 1],
+            kValue / 10);
+  // Not mixed.
+  mixer->Mix(/*number_of_channels=*/1, &frame_for_mixing);
+  EXPECT_TRUE(frame_for_mixing.muted());
+  // Ramped in.
+  mixer->Mix(/*number_of_channels=*/1, &frame_for_mixing);
+  EXPECT_EQ(frame_for_mixing.data()[0], 0);
+  EXPECT_GT(frame_for_mixing.data()[frame_for_mixing.samples_per_channel_ - 1],
+            kValue - kValue / 10);
+  // Mixed.
+  mixer->Mix(/*number_of_channels=*/1, &frame_for_mixing);
+  EXPECT_EQ(frame_for_mixing.data()[0], kValue);
+}
+
+TEST(AudioMixer, SparseMixingTellsSourcesWhenTheyAreDeselected) {
+  const auto mixer = AudioMixerImpl::Create();
+  mixer->EnableSparseMixing(/*max_active_speakers=*/1);
+  MockMixerAudioSource source;
+  ResetFrame(source.fake_frame());
+  EXPECT_TRUE(mixer->AddSource(&source));
+
+  EXPECT_CALL(source, LatestAudioLevel())
+      .WillOnce(Return(AudioLevel(/*voice_activity=*/false, 20)))
+      .WillOnce(Return(AudioLevel(/*voice_activity=*/false, 20)))
+      .WillRepeatedly(Return(AudioLevel(/*voice_activity=*/true, 20)));
+  {
+    InSequence s;
+    // Once the source has been ramped out.
+    EXPECT_CALL(source, GetAudioFrameWithInfo);
+    EXPECT_CALL(source, SetDeselected(true));
+    // Before it is ramped in.
+    EXPECT_CALL(source, SetDeselected(false));
+    EXPECT_CALL(source, GetAudioFrameWithInfo).Times(2);
+  }
+  for (int i = 0; i < 4; ++i) {
+    mixer->Mix(/*number_of_channels=*/1, &frame_for_mixing);
+  }
+}
+
+TEST(AudioMixer, MixerDoesNotDeselectSourcesWithoutSparseMixing) {
+  const auto mixer = AudioMixerImpl::Create();
+  MockMixerAudioSource source;
+  ResetFrame(source.fake_frame());
+  ON_CALL(source, LatestAudioLevel())
+      .WillByDefault(Return(AudioLevel(/*voice_activity=*/false, 20)));
+  EXPECT_TRUE(mixer->AddSource(&source));
+
+  EXPECT_CALL(source, SetDeselected).Times(0);
+  EXPECT_CALL(source, GetAudioFrameWithInfo).Times(3);
+  for (int i = 0; i < 3; ++i) {
+    mixer->Mix(/*number_of_channels=*/1, &frame_for_mixing);
+  }
+}
+
+TEST(AudioMixer, ParallelPullingMatchesSerialMix) {
+  constexpr int kNumSources = 12;
+  const auto serial_mixer = AudioMixerImpl::Create();
+  const auto parallel_mixer = AudioMixerImpl::Create();
+  parallel_mixer->EnableParallelPulling(/*num_threads=*/3);
+  MockMixerAudioSource sources[kNumSources];
+  for (int i = 0; i < kNumSources; ++i) {
+    ResetFrame(sources[i].fake_frame());
+    int16_t* data = sources[i].fake_frame()->mutable_data();
+    for (size_t j = 0; j < sources[i].fake_frame()->samples_per_channel_;
+         ++j) {
+      data[j] = static_cast<int16_t>(100 * (i + 1) + j);
+    }
+    EXPECT_TRUE(serial_mixer->AddSource(&sources[i]));
+    EXPECT_TRUE(parallel_mixer->AddSource(&sources[i]));
+  }
+  sources[2].set_fake_info(AudioMixer::Source::AudioFrameInfo::kMuted);
+  sources[5].fake_frame()->speech_type_ = AudioFrame::kCNG;
+  sources[7].set_fake_info(AudioMixer::Source::AudioFrameInfo::kError);
+
+  for (int k = 0; k < 3; ++k) {
+    SCOPED_TRACE(k);
+    for (MockMixerAudioSource& source : sources) {
+      EXPECT_CALL(source, GetAudioFrameWithInfo).Times(2);
+    }
+    AudioFrame serial_mix, parallel_mix;
+    serial_mixer->Mix(/*number_of_channels=*/1, &serial_mix);
+    parallel_mixer->Mix(/*number_of_channels=*/1, &parallel_mix);
+    ASSERT_EQ(serial_mix.samples_per_channel_,
+              parallel_mix.samples_per_channel_);
+    EXPECT_EQ(0, memcmp(serial_mix.data(), parallel_mix.data(),
+                        serial_mix.samples_per_channel_ * sizeof(int16_t)));
+  }
+}
+
+TEST(AudioMixer, ParallelPullingPullsEachSourceOnTheSameThread) {
+  constexpr int kNumSources = 8;
+  const auto mixer = AudioMixerImpl::Create();
+  mixer->EnableParallelPulling(/*num_threads=*/2);
+  MockMixerAudioSource sources[kNumSources];
+  for (MockMixerAudioSource& source : sources) {
+    ResetFrame(source.fake_frame());
+    EXPECT_TRUE(mixer->AddSource(&source));
+  }
+
+  // The sources are dealt to the mixing and the helper thread in turn, except
+  // that a source muted on the previous pass is pulled on the mixing thread.
+  const rtc::PlatformThreadRef mixing_thread = rtc::CurrentThreadRef();
+  for (int k = 0; k < 4; ++k) {
+    SCOPED_TRACE(k);
+    for (int i = 0; i < kNumSources; ++i) {
+      const bool muted = i == kNumSources - 1 && k == 1;
+      const bool was_muted = i == kNumSources - 1 && k == 2;
+      const bool on_mixing_thread = i % 2 == 0 || was_muted;
+      MockMixerAudioSource& source = sources[i];
+      EXPECT_CALL(source, GetAudioFrameWithInfo)
+          .WillOnce([=, &source](int sample_rate_hz, AudioFrame* audio_frame) {
+            EXPECT_EQ(on_mixing_thread,
+                      rtc::IsThreadRefEqual(rtc::CurrentThreadRef(),
+                                            mixing_thread));
+            audio_frame->CopyFrom(*source.fake_frame());
+            audio_frame->sample_rate_hz_ = sample_rate_hz;
+            audio_frame->samples_per_channel_ = sample_rate_hz / 100;
+            return muted ? AudioMixer::Source::AudioFrameInfo::kMuted
+                         : AudioMixer::Source::AudioFrameInfo::kNormal;
+          });
+    }
+    mixer->Mix(/*number_of_channels=*/1, &frame_for_mixing);
+  }
+}
+
 class HighOutputRateCalculator : public OutputRateCalculator {
  public:
   static const int kDefaultFrequency = 76000;
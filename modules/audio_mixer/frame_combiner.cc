@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "api/array_view.h"
 #include "api/audio/audio_processing.h"
 #include "api/rtp_packet_info.h"
@@ -31,15 +32,25 @@
 #include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/system/arch.h"
 #include "system_wrappers/include/metrics.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace webrtc {
 namespace {
 
+// Sets the fields of `audio_frame_for_mixing` from those of the frames in
+// `mix_list` other than `excluded_frame`, which may be null.
 void SetAudioFrameFields(rtc::ArrayView<const AudioFrame* const> mix_list,
+                         const AudioFrame* excluded_frame,
                          size_t number_of_channels,
                          int sample_rate,
-                         size_t /* number_of_streams */,
                          AudioFrame* audio_frame_for_mixing) {
   const size_t samples_per_channel =
       SampleRateToDefaultChannelSize(sample_rate);
@@ -52,57 +63,248 @@ void SetAudioFrameFields(rtc::ArrayView<const AudioFrame* const> mix_list,
       0, nullptr, samples_per_channel, sample_rate, AudioFrame::kUndefined,
       AudioFrame::kVadUnknown, number_of_channels);
 
-  if (mix_list.empty()) {
+  bool first_frame = true;
+  std::vector<RtpPacketInfo> packet_infos;
+  for (const auto& frame : mix_list) {
+    if (frame == excluded_frame) {
+      continue;
+    }
+    if (first_frame) {
+      audio_frame_for_mixing->timestamp_ = frame->timestamp_;
+      audio_frame_for_mixing->elapsed_time_ms_ = frame->elapsed_time_ms_;
+      audio_frame_for_mixing->ntp_time_ms_ = frame->ntp_time_ms_;
+      first_frame = false;
+    }
+    audio_frame_for_mixing->timestamp_ =
+        std::min(audio_frame_for_mixing->timestamp_, frame->timestamp_);
+    audio_frame_for_mixing->ntp_time_ms_ =
+        std::min(audio_frame_for_mixing->ntp_time_ms_, frame->ntp_time_ms_);
+    audio_frame_for_mixing->elapsed_time_ms_ = std::max(
+        audio_frame_for_mixing->elapsed_time_ms_, frame->elapsed_time_ms_);
+    packet_infos.insert(packet_infos.end(), frame->packet_infos_.begin(),
+                        frame->packet_infos_.end());
+  }
+
+  if (first_frame) {
     audio_frame_for_mixing->elapsed_time_ms_ = -1;
   } else {
-    audio_frame_for_mixing->timestamp_ = mix_list[0]->timestamp_;
-    audio_frame_for_mixing->elapsed_time_ms_ = mix_list[0]->elapsed_time_ms_;
-    audio_frame_for_mixing->ntp_time_ms_ = mix_list[0]->ntp_time_ms_;
-    std::vector<RtpPacketInfo> packet_infos;
-    for (const auto& frame : mix_list) {
-      audio_frame_for_mixing->timestamp_ =
-          std::min(audio_frame_for_mixing->timestamp_, frame->timestamp_);
-      audio_frame_for_mixing->ntp_time_ms_ =
-          std::min(audio_frame_for_mixing->ntp_time_ms_, frame->ntp_time_ms_);
-      audio_frame_for_mixing->elapsed_time_ms_ = std::max(
-          audio_frame_for_mixing->elapsed_time_ms_, frame->elapsed_time_ms_);
-      packet_infos.insert(packet_infos.end(), frame->packet_infos_.begin(),
-                          frame->packet_infos_.end());
-    }
     audio_frame_for_mixing->packet_infos_ =
         RtpPacketInfos(std::move(packet_infos));
   }
 }
 
-void MixFewFramesWithNoLimiter(rtc::ArrayView<const AudioFrame* const> mix_list,
+// Copies `frame` to `audio_frame_for_mixing`, or mutes the latter if `frame`
+// is null.
+void MixFewFramesWithNoLimiter(const AudioFrame* frame,
                                AudioFrame* audio_frame_for_mixing) {
-  if (mix_list.empty()) {
+  if (!frame) {
     audio_frame_for_mixing->Mute();
     return;
   }
-  RTC_DCHECK_LE(mix_list.size(), 1);
   InterleavedView<int16_t> dst = audio_frame_for_mixing->mutable_data(
-      mix_list[0]->samples_per_channel_, mix_list[0]->num_channels_);
-  CopySamples(dst, mix_list[0]->data_view());
+      frame->samples_per_channel_, frame->num_channels_);
+  CopySamples(dst, frame->data_view());
+}
+
+// The SIMD versions of the sample conversions below process the frames in
+// blocks and return the number of processed samples per channel; the
+// remaining ones are processed by the scalar code. The results are identical.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Converts the 4 int16 samples in the lower half of `x` to float.
+__m128 LowS16ToFloatSse2(__m128i x) {
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+}
+
+__m128 HighS16ToFloatSse2(__m128i x) {
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+}
+
+__m128 Accumulate(__m128 sum, __m128 x, bool subtract) {
+  return subtract ? _mm_sub_ps(sum, x) : _mm_add_ps(sum, x);
+}
+
+size_t AccumulateFrameSse2(InterleavedView<const int16_t> frame,
+                           bool subtract,
+                           DeinterleavedView<float> mixing_buffer) {
+  const size_t samples_per_channel = mixing_buffer.samples_per_channel();
+  const int16_t* src = frame.data().data();
+  size_t k = 0;
+  if (mixing_buffer.num_channels() == 1) {
+    float* dst = mixing_buffer[0].data();
+    for (; k + 8 <= samples_per_channel; k += 8) {
+      const __m128i x =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[k]));
+      _mm_storeu_ps(&dst[k], Accumulate(_mm_loadu_ps(&dst[k]),
+                                        LowS16ToFloatSse2(x), subtract));
+      _mm_storeu_ps(&dst[k + 4], Accumulate(_mm_loadu_ps(&dst[k + 4]),
+                                            HighS16ToFloatSse2(x), subtract));
+    }
+  } else if (mixing_buffer.num_channels() == 2) {
+    float* left = mixing_buffer[0].data();
+    float* right = mixing_buffer[1].data();
+    for (; k + 4 <= samples_per_channel; k += 4) {
+      // Each 32 bit lane holds an interleaved left and right sample.
+      const __m128i x =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[2 * k]));
+      const __m128 l =
+          _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(x, 16), 16));
+      const __m128 r = _mm_cvtepi32_ps(_mm_srai_epi32(x, 16));
+      _mm_storeu_ps(&left[k], Accumulate(_mm_loadu_ps(&left[k]), l, subtract));
+      _mm_storeu_ps(&right[k],
+                    Accumulate(_mm_loadu_ps(&right[k]), r, subtract));
+    }
+  }
+  return k;
+}
+
+// Same as `FloatS16ToS16()`.
+__m128i FloatS16ToS16Sse2(__m128 v) {
+  v = _mm_min_ps(v, _mm_set1_ps(32767.f));
+  v = _mm_max_ps(v, _mm_set1_ps(-32768.f));
+  const __m128 sign = _mm_and_ps(v, _mm_set1_ps(-0.f));
+  const __m128 half = _mm_or_ps(sign, _mm_set1_ps(0.5f));
+  return _mm_cvttps_epi32(_mm_add_ps(v, half));
+}
+
+size_t InterleaveSse2(DeinterleavedView<float> deinterleaved,
+                      InterleavedView<int16_t> interleaved) {
+  const size_t samples_per_channel = deinterleaved.samples_per_channel();
+  int16_t* dst = interleaved.data().data();
+  size_t k = 0;
+  if (deinterleaved.num_channels() == 1) {
+    const float* src = deinterleaved[0].data();
+    for (; k + 8 <= samples_per_channel; k += 8) {
+      const __m128i lo = FloatS16ToS16Sse2(_mm_loadu_ps(&src[k]));
+      const __m128i hi = FloatS16ToS16Sse2(_mm_loadu_ps(&src[k + 4]));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[k]),
+                       _mm_packs_epi32(lo, hi));
+    }
+  } else if (deinterleaved.num_channels() == 2) {
+    const float* left = deinterleaved[0].data();
+    const float* right = deinterleaved[1].data();
+    for (; k + 4 <= samples_per_channel; k += 4) {
+      const __m128i l = FloatS16ToS16Sse2(_mm_loadu_ps(&left[k]));
+      const __m128i r = FloatS16ToS16Sse2(_mm_loadu_ps(&right[k]));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(&dst[2 * k]),
+          _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r)));
+    }
+  }
+  return k;
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+float32x4_t Accumulate(float32x4_t sum, float32x4_t x, bool subtract) {
+  return subtract ? vsubq_f32(sum, x) : vaddq_f32(sum, x);
+}
+
+float32x4_t S16ToFloatNeon(int16x4_t x) {
+  return vcvtq_f32_s32(vmovl_s16(x));
+}
+
+size_t AccumulateFrameNeon(InterleavedView<const int16_t> frame,
+                           bool subtract,
+                           DeinterleavedView<float> mixing_buffer) {
+  const size_t samples_per_channel = mixing_buffer.samples_per_channel();
+  const int16_t* src = frame.data().data();
+  size_t k = 0;
+  if (mixing_buffer.num_channels() == 1) {
+    float* dst = mixing_buffer[0].data();
+    for (; k + 4 <= samples_per_channel; k += 4) {
+      vst1q_f32(&dst[k], Accumulate(vld1q_f32(&dst[k]),
+                                    S16ToFloatNeon(vld1_s16(&src[k])),
+                                    subtract));
+    }
+  } else if (mixing_buffer.num_channels() == 2) {
+    float* left = mixing_buffer[0].data();
+    float* right = mixing_buffer[1].data();
+    for (; k + 4 <= samples_per_channel; k += 4) {
+      const int16x4x2_t x = vld2_s16(&src[2 * k]);
+      vst1q_f32(&left[k], Accumulate(vld1q_f32(&left[k]),
+                                     S16ToFloatNeon(x.val[0]), subtract));
+      vst1q_f32(&right[k], Accumulate(vld1q_f32(&right[k]),
+                                      S16ToFloatNeon(x.val[1]), subtract));
+    }
+  }
+  return k;
+}
+
+// Same as `FloatS16ToS16()`.
+int16x4_t FloatS16ToS16Neon(float32x4_t v) {
+  v = vminq_f32(v, vdupq_n_f32(32767.f));
+  v = vmaxq_f32(v, vdupq_n_f32(-32768.f));
+  const float32x4_t half =
+      vbslq_f32(vdupq_n_u32(0x80000000), v, vdupq_n_f32(0.5f));
+  return vmovn_s32(vcvtq_s32_f32(vaddq_f32(v, half)));
+}
+
+size_t InterleaveNeon(DeinterleavedView<float> deinterleaved,
+                      InterleavedView<int16_t> interleaved) {
+  const size_t samples_per_channel = deinterleaved.samples_per_channel();
+  int16_t* dst = interleaved.data().data();
+  size_t k = 0;
+  if (deinterleaved.num_channels() == 1) {
+    const float* src = deinterleaved[0].data();
+    for (; k + 4 <= samples_per_channel; k += 4) {
+      vst1_s16(&dst[k], FloatS16ToS16Neon(vld1q_f32(&src[k])));
+    }
+  } else if (deinterleaved.num_channels() == 2) {
+    const float* left = deinterleaved[0].data();
+    const float* right = deinterleaved[1].data();
+    for (; k + 4 <= samples_per_channel; k += 4) {
+      int16x4x2_t x;
+      x.val[0] = FloatS16ToS16Neon(vld1q_f32(&left[k]));
+      x.val[1] = FloatS16ToS16Neon(vld1q_f32(&right[k]));
+      vst2_s16(&dst[2 * k], x);
+    }
+  }
+  return k;
+}
+#endif
+
+// Converts `frame` to FloatS16 and adds it to, or subtracts it from,
+// `mixing_buffer`.
+void AccumulateFrame(InterleavedView<const int16_t> frame,
+                     bool subtract,
+                     const AvailableCpuFeatures& cpu_features,
+                     DeinterleavedView<float> mixing_buffer) {
+  const size_t number_of_channels = NumChannels(mixing_buffer);
+  RTC_CHECK(!frame.empty());
+  RTC_DCHECK_EQ(frame.num_channels(), number_of_channels);
+  RTC_DCHECK_GE(frame.samples_per_channel(),
+                mixing_buffer.samples_per_channel());
+  size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (cpu_features.sse2) {
+    k = AccumulateFrameSse2(frame, subtract, mixing_buffer);
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  if (cpu_features.neon) {
+    k = AccumulateFrameNeon(frame, subtract, mixing_buffer);
+  }
+#endif
+  const float sign = subtract ? -1.f : 1.f;
+  for (size_t j = 0; j < number_of_channels; ++j) {
+    MonoView<float> channel = mixing_buffer[j];
+    for (size_t i = k; i < SamplesPerChannel(channel); ++i) {
+      channel[i] += sign * frame[number_of_channels * i + j];
+    }
+  }
 }
 
 void MixToFloatFrame(rtc::ArrayView<const AudioFrame* const> mix_list,
+                     const AvailableCpuFeatures& cpu_features,
                      DeinterleavedView<float>& mixing_buffer) {
-  const size_t number_of_channels = NumChannels(mixing_buffer);
   // Clear the mixing buffer.
   rtc::ArrayView<float> raw_data = mixing_buffer.data();
   ClearSamples(raw_data);
 
   // Convert to FloatS16 and mix.
-  for (size_t i = 0; i < mix_list.size(); ++i) {
-    InterleavedView<const int16_t> frame_data = mix_list[i]->data_view();
-    RTC_CHECK(!frame_data.empty());
-    for (size_t j = 0; j < number_of_channels; ++j) {
-      MonoView<float> channel = mixing_buffer[j];
-      for (size_t k = 0; k < SamplesPerChannel(channel); ++k) {
-        channel[k] += frame_data[number_of_channels * k + j];
-      }
-    }
+  for (const AudioFrame* frame : mix_list) {
+    AccumulateFrame(frame->data_view(), /*subtract=*/false, cpu_features,
+                    mixing_buffer);
   }
 }
 
@@ -113,13 +315,25 @@ void RunLimiter(DeinterleavedView<float> deinterleaved, Limiter* limiter) {
 
 // Both interleaves and rounds.
 void InterleaveToAudioFrame(DeinterleavedView<float> deinterleaved,
+                            const AvailableCpuFeatures& cpu_features,
                             AudioFrame* audio_frame_for_mixing) {
   InterleavedView<int16_t> mixing_data = audio_frame_for_mixing->mutable_data(
       deinterleaved.samples_per_channel(), deinterleaved.num_channels());
+  size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (cpu_features.sse2) {
+    k = InterleaveSse2(deinterleaved, mixing_data);
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  if (cpu_features.neon) {
+    k = InterleaveNeon(deinterleaved, mixing_data);
+  }
+#endif
   // Put data in the result frame.
   for (size_t i = 0; i < mixing_data.num_channels(); ++i) {
     auto channel = deinterleaved[i];
-    for (size_t j = 0; j < mixing_data.samples_per_channel(); ++j) {
+    for (size_t j = k; j < mixing_data.samples_per_channel(); ++j) {
       mixing_data[mixing_data.num_channels() * j + i] =
           FloatS16ToS16(channel[j]);
     }
@@ -130,10 +344,43 @@ void InterleaveToAudioFrame(DeinterleavedView<float> deinterleaved,
 constexpr size_t FrameCombiner::kMaximumNumberOfChannels;
 constexpr size_t FrameCombiner::kMaximumChannelSize;
 
+FrameCombiner::SharedMix::SharedMix()
+    : cpu_features_(GetAvailableCpuFeatures()) {}
+
+FrameCombiner::SharedMix::~SharedMix() = default;
+
+void FrameCombiner::SharedMix::Mix(rtc::ArrayView<AudioFrame* const> mix_list,
+                                   size_t number_of_channels,
+                                   int sample_rate) {
+  RTC_DCHECK_GT(sample_rate, 0);
+  number_of_channels_ = std::min(number_of_channels, kMaximumNumberOfChannels);
+  sample_rate_ = sample_rate;
+  samples_per_channel_ = SampleRateToDefaultChannelSize(sample_rate);
+  RTC_DCHECK_LE(samples_per_channel_, kMaximumChannelSize);
+  samples_per_channel_ = std::min(samples_per_channel_, kMaximumChannelSize);
+
+  for (auto* frame : mix_list) {
+    RTC_DCHECK_EQ(SampleRateToDefaultChannelSize(sample_rate),
+                  frame->samples_per_channel_);
+    RTC_DCHECK_EQ(sample_rate, frame->sample_rate_hz_);
+    RemixFrame(number_of_channels_, frame);
+  }
+  mix_list_.assign(mix_list.begin(), mix_list.end());
+
+  DeinterleavedView<float> deinterleaved(
+      mixing_buffer_.data(), samples_per_channel_, number_of_channels_);
+  MixToFloatFrame(mix_list_, cpu_features_, deinterleaved);
+}
+
 FrameCombiner::FrameCombiner(bool use_limiter)
+    : FrameCombiner(use_limiter, GetAvailableCpuFeatures()) {}
+
+FrameCombiner::FrameCombiner(bool use_limiter,
+                             AvailableCpuFeatures cpu_features)
     : data_dumper_(new ApmDataDumper(0)),
       limiter_(data_dumper_.get(), kMaximumChannelSize, "AudioMixer"),
-      use_limiter_(use_limiter) {
+      use_limiter_(use_limiter),
+      cpu_features_(cpu_features) {
   static_assert(kMaximumChannelSize * kMaximumNumberOfChannels <=
                     AudioFrame::kMaxDataSizeSamples,
                 "");
@@ -156,8 +403,8 @@ void FrameCombiner::Combine(rtc::ArrayView<AudioFrame* const> mix_list,
   // limits since processing from hereon out will be bound by them.
   number_of_channels = std::min(number_of_channels, kMaximumNumberOfChannels);
 
-  SetAudioFrameFields(mix_list, number_of_channels, sample_rate,
-                      number_of_streams, audio_frame_for_mixing);
+  SetAudioFrameFields(mix_list, /*excluded_frame=*/nullptr, number_of_channels,
+                      sample_rate, audio_frame_for_mixing);
 
   size_t samples_per_channel = SampleRateToDefaultChannelSize(sample_rate);
 
@@ -175,7 +422,9 @@ void FrameCombiner::Combine(rtc::ArrayView<AudioFrame* const> mix_list,
   }
 
   if (number_of_streams <= 1) {
-    MixFewFramesWithNoLimiter(mix_list, audio_frame_for_mixing);
+    RTC_DCHECK_LE(mix_list.size(), 1);
+    MixFewFramesWithNoLimiter(mix_list.empty() ? nullptr : mix_list[0],
+                              audio_frame_for_mixing);
     return;
   }
 
@@ -189,13 +438,61 @@ void FrameCombiner::Combine(rtc::ArrayView<AudioFrame* const> mix_list,
   samples_per_channel = std::min(samples_per_channel, kMaximumChannelSize);
   DeinterleavedView<float> deinterleaved(
       mixing_buffer_.data(), samples_per_channel, number_of_channels);
-  MixToFloatFrame(mix_list, deinterleaved);
+  MixToFloatFrame(mix_list, cpu_features_, deinterleaved);
+
+  if (use_limiter_) {
+    RunLimiter(deinterleaved, &limiter_);
+  }
+
+  InterleaveToAudioFrame(deinterleaved, cpu_features_, audio_frame_for_mixing);
+}
+
+void FrameCombiner::CombineExcluding(const SharedMix& shared_mix,
+                                     const AudioFrame* excluded_frame,
+                                     size_t number_of_streams,
+                                     AudioFrame* audio_frame_for_mixing) {
+  RTC_DCHECK(audio_frame_for_mixing);
+  RTC_DCHECK_GT(shared_mix.sample_rate_, 0);
+  const std::vector<const AudioFrame*>& mix_list = shared_mix.mix_list_;
+
+  SetAudioFrameFields(mix_list, excluded_frame,
+                      shared_mix.number_of_channels_, shared_mix.sample_rate_,
+                      audio_frame_for_mixing);
+
+  const bool frame_excluded =
+      absl::c_linear_search(mix_list, excluded_frame);
+
+  if (number_of_streams <= 1) {
+    RTC_DCHECK_LE(mix_list.size() - (frame_excluded ? 1 : 0), 1);
+    const AudioFrame* frame = nullptr;
+    for (const AudioFrame* f : mix_list) {
+      if (f != excluded_frame) {
+        frame = f;
+        break;
+      }
+    }
+    MixFewFramesWithNoLimiter(frame, audio_frame_for_mixing);
+    return;
+  }
+
+  // Derive the mix from the shared one by subtracting the excluded frame.
+  DeinterleavedView<float> deinterleaved(mixing_buffer_.data(),
+                                         shared_mix.samples_per_channel_,
+                                         shared_mix.number_of_channels_);
+  rtc::ArrayView<const float> shared_data(
+      shared_mix.mixing_buffer_.data(), deinterleaved.data().size());
+  std::copy(shared_data.begin(), shared_data.end(),
+            deinterleaved.data().begin());
+  if (frame_excluded) {
+    AccumulateFrame(excluded_frame->data_view(), /*subtract=*/true,
+                    cpu_features_, deinterleaved);
+  }
 
   if (use_limiter_) {
     RunLimiter(deinterleaved, &limiter_);
   }
 
-  InterleaveToAudioFrame(deinterleaved, audio_frame_for_mixing);
+  InterleaveToAudioFrame(deinterleaved, cpu_features_, audio_frame_for_mixing);
 }
 
 }  // namespace webrtc
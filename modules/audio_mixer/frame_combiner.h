@@ -11,11 +11,13 @@
 #ifndef MODULES_AUDIO_MIXER_FRAME_COMBINER_H_
 #define MODULES_AUDIO_MIXER_FRAME_COMBINER_H_
 
+#include <array>
 #include <memory>
 #include <vector>
 
 #include "api/array_view.h"
 #include "api/audio/audio_frame.h"
+#include "modules/audio_processing/agc2/cpu_features.h"
 #include "modules/audio_processing/agc2/limiter.h"
 
 namespace webrtc {
@@ -23,7 +25,41 @@ class ApmDataDumper;
 
 class FrameCombiner {
  public:
+  // Stereo, 48 kHz, 10 ms.
+  static constexpr size_t kMaximumNumberOfChannels = 8;
+  static constexpr size_t kMaximumChannelSize = 48 * 10;
+
+  // Sum of a list of frames, which is computed once and shared by several
+  // `CombineExcluding()` calls. This allows producing a personalized "N-1"
+  // mix for every participant of a conference, i.e. the mix of all frames
+  // except the participant's own, with one subtraction per output instead
+  // of re-mixing N-1 frames per output.
+  class SharedMix {
+   public:
+    SharedMix();
+    ~SharedMix();
+
+    // Mixes the frames of `mix_list`, which are remixed to
+    // `number_of_channels` like in `Combine()`. The frames must outlive the
+    // `CombineExcluding()` calls using this mix.
+    void Mix(rtc::ArrayView<AudioFrame* const> mix_list,
+             size_t number_of_channels,
+             int sample_rate);
+
+   private:
+    friend class FrameCombiner;
+
+    const AvailableCpuFeatures cpu_features_;
+    std::vector<const AudioFrame*> mix_list_;
+    size_t number_of_channels_ = 0;
+    size_t samples_per_channel_ = 0;
+    int sample_rate_ = 0;
+    std::array<float, kMaximumChannelSize * kMaximumNumberOfChannels>
+        mixing_buffer_ = {};
+  };
+
   explicit FrameCombiner(bool use_limiter);
+  FrameCombiner(bool use_limiter, AvailableCpuFeatures cpu_features);
   ~FrameCombiner();
 
   // Combine several frames into one. Assumes sample_rate,
@@ -38,14 +74,21 @@ class FrameCombiner {
                size_t number_of_streams,
                AudioFrame* audio_frame_for_mixing);
 
-  // Stereo, 48 kHz, 10 ms.
-  static constexpr size_t kMaximumNumberOfChannels = 8;
-  static constexpr size_t kMaximumChannelSize = 48 * 10;
+  // Combines all frames of `shared_mix` except `excluded_frame`, which is
+  // allowed to be null or not part of the mix. Since the mix is computed
+  // from integer samples, the float sums are exact for up to 512 frames and
+  // the result is identical to that of `Combine()` called with the remaining
+  // frames.
+  void CombineExcluding(const SharedMix& shared_mix,
+                        const AudioFrame* excluded_frame,
+                        size_t number_of_streams,
+                        AudioFrame* audio_frame_for_mixing);
 
  private:
   std::unique_ptr<ApmDataDumper> data_dumper_;
   Limiter limiter_;
   const bool use_limiter_;
+  const AvailableCpuFeatures cpu_features_;
   std::array<float, kMaximumChannelSize * kMaximumNumberOfChannels>
       mixing_buffer_ = {};
 };
@@ -12,6 +12,7 @@
 
 #include <cstdint>
 #include <initializer_list>
+#include <memory>
 #include <numeric>
 #include <optional>
 #include <string>
@@ -25,7 +26,9 @@
 #include "audio/utility/audio_frame_operations.h"
 #include "modules/audio_mixer/gain_change_calculator.h"
 #include "modules/audio_mixer/sine_wave_generator.h"
+#include "modules/audio_processing/agc2/cpu_features.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/random.h"
 #include "rtc_base/strings/string_builder.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -67,6 +70,21 @@ std::string ProduceDebugText(const FrameCombinerConfig& config) {
 AudioFrame frame1;
 AudioFrame frame2;
 
+// Fills `frame` with random samples, including full scale ones.
+void SetUpRandomFrame(Random& random,
+                      int sample_rate_hz,
+                      int number_of_channels,
+                      AudioFrame& frame) {
+  frame.UpdateFrame(0, nullptr, rtc::CheckedDivExact(sample_rate_hz, 100),
+                    sample_rate_hz, AudioFrame::kNormalSpeech,
+                    AudioFrame::kVadActive, number_of_channels);
+  InterleavedView<int16_t> data = frame.mutable_data(
+      frame.samples_per_channel_, frame.num_channels_);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = random.Rand(-32768, 32767);
+  }
+}
+
 void SetUpFrames(int sample_rate_hz, int number_of_channels) {
   RtpPacketInfo packet_info1(/*ssrc=*/1001, /*csrcs=*/{},
                              /*rtp_timestamp=*/1000,
@@ -333,4 +351,98 @@ TEST(FrameCombiner, GainCurveIsSmoothForAlternatingNumberOfStreams) {
     EXPECT_LT(change_calculator.LatestGain(), 1.01f);
   }
 }
+
+// Verifies that the SIMD mixing and conversion produce the same output as the
+// scalar code.
+TEST(FrameCombiner, OptimizedCombineIsBitExact) {
+  constexpr int kNumFrames = 5;
+  Random random(42);
+  for (const int rate : {8000, 16000, 32000, 48000}) {
+    for (const int number_of_channels : {1, 2, 3}) {
+      SCOPED_TRACE(ProduceDebugText(rate, number_of_channels, kNumFrames));
+      FrameCombiner reference(/*use_limiter=*/true, NoAvailableCpuFeatures());
+      FrameCombiner optimized(/*use_limiter=*/true, GetAvailableCpuFeatures());
+      std::vector<AudioFrame> frames(kNumFrames);
+      std::vector<AudioFrame*> frame_ptrs;
+      for (AudioFrame& frame : frames) {
+        frame_ptrs.push_back(&frame);
+      }
+      for (int k = 0; k < 10; ++k) {
+        for (AudioFrame& frame : frames) {
+          SetUpRandomFrame(random, rate, number_of_channels, frame);
+        }
+        AudioFrame expected, output;
+        reference.Combine(frame_ptrs, number_of_channels, rate, kNumFrames,
+                          &expected);
+        optimized.Combine(frame_ptrs, number_of_channels, rate, kNumFrames,
+                          &output);
+        EXPECT_THAT(output.data_view().data(),
+                    ElementsAreArray(expected.data_view().data()));
+      }
+    }
+  }
+}
+
+// Verifies that the N-1 mixes derived from a shared mix are identical to
+// mixing the remaining frames.
+TEST(FrameCombiner, CombineExcludingMatchesCombineOfRemainingFrames) {
+  constexpr int kNumFrames = 4;
+  Random random(42);
+  for (const bool use_limiter : {true, false}) {
+    for (const int number_of_channels : {1, 2}) {
+      SCOPED_TRACE(ProduceDebugText(48000, number_of_channels, kNumFrames));
+      std::vector<AudioFrame> frames(kNumFrames);
+      std::vector<AudioFrame*> frame_ptrs;
+      for (AudioFrame& frame : frames) {
+        frame_ptrs.push_back(&frame);
+      }
+      std::vector<std::unique_ptr<FrameCombiner>> reference_combiners;
+      std::vector<std::unique_ptr<FrameCombiner>> excluding_combiners;
+      for (int i = 0; i < kNumFrames; ++i) {
+        reference_combiners.push_back(
+            std::make_unique<FrameCombiner>(use_limiter));
+        excluding_combiners.push_back(
+            std::make_unique<FrameCombiner>(use_limiter));
+      }
+      FrameCombiner::SharedMix shared_mix;
+      for (int k = 0; k < 10; ++k) {
+        for (int i = 0; i < kNumFrames; ++i) {
+          SetUpRandomFrame(random, 48000, number_of_channels, frames[i]);
+          frames[i].packet_infos_ = RtpPacketInfos({RtpPacketInfo(
+              /*ssrc=*/i, /*csrcs=*/{}, /*rtp_timestamp=*/k,
+              Timestamp::Millis(k))});
+        }
+        shared_mix.Mix(frame_ptrs, number_of_channels, 48000);
+        for (int i = 0; i < kNumFrames; ++i) {
+          SCOPED_TRACE(i);
+          std::vector<AudioFrame*> remaining_frames = frame_ptrs;
+          remaining_frames.erase(remaining_frames.begin() + i);
+          AudioFrame expected, output;
+          reference_combiners[i]->Combine(remaining_frames, number_of_channels,
+                                          48000, kNumFrames - 1, &expected);
+          excluding_combiners[i]->CombineExcluding(shared_mix, &frames[i],
+                                                   kNumFrames - 1, &output);
+          EXPECT_THAT(output.data_view().data(),
+                      ElementsAreArray(expected.data_view().data()));
+          EXPECT_THAT(output.packet_infos_,
+                      UnorderedElementsAreArray(expected.packet_infos_));
+        }
+      }
+    }
+  }
+}
+
+TEST(FrameCombiner, CombineExcludingOneOfTwoFramesCopiesTheOtherFrame) {
+  SetUpFrames(16000, 1);
+  std::vector<AudioFrame*> frames = {&frame1, &frame2};
+  FrameCombiner::SharedMix shared_mix;
+  shared_mix.Mix(frames, 1, 16000);
+  FrameCombiner combiner(/*use_limiter=*/true);
+  AudioFrame output;
+  combiner.CombineExcluding(shared_mix, &frame1, /*number_of_streams=*/1,
+                            &output);
+  EXPECT_THAT(output.data_view().data(),
+              ElementsAreArray(frame2.data_view().data()));
+}
+
 }  // namespace webrtc
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/source_pull_pool.h"
+
+#include <string>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+SourcePullPool::SourcePullPool(int num_threads) {
+  RTC_DCHECK_GE(num_threads, 1);
+  for (int slice = 1; slice < num_threads; ++slice) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // The workers are started once all exist, since `workers_` is not
+  // synchronized.
+  for (int slice = 1; slice < num_threads; ++slice) {
+    workers_[slice - 1]->thread = rtc::PlatformThread::SpawnJoinable(
+        [this, slice] { RunWorker(slice); },
+        "SourcePull" + std::to_string(slice),
+        rtc::ThreadAttributes().SetPriority(rtc::ThreadPriority::kRealtime));
+  }
+}
+
+SourcePullPool::~SourcePullPool() {
+  quit_ = true;
+  for (auto& worker : workers_) {
+    worker->start.Set();
+  }
+  for (auto& worker : workers_) {
+    worker->thread.Finalize();
+  }
+}
+
+void SourcePullPool::Run(rtc::FunctionView<void(int)> task) {
+  RTC_DCHECK(!task_);
+  if (workers_.empty()) {
+    task(0);
+    return;
+  }
+  task_ = &task;
+  pending_workers_.store(static_cast<int>(workers_.size()),
+                         std::memory_order_relaxed);
+  for (auto& worker : workers_) {
+    worker->start.Set();
+  }
+  task(0);
+  done_.Wait(rtc::Event::kForever);
+  task_ = nullptr;
+}
+
+void SourcePullPool::RunWorker(int slice) {
+  Worker& worker = *workers_[slice - 1];
+  while (true) {
+    // Helper threads are idle between mixing passes, or while the mixer is
+    // not used at all, which is not worth a warning.
+    worker.start.Wait(rtc::Event::kForever,
+                      /*warn_after=*/rtc::Event::kForever);
+    if (quit_) {
+      return;
+    }
+    (*task_)(slice);
+    if (pending_workers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      done_.Set();
+    }
+  }
+}
+
+}  // namespace webrtc
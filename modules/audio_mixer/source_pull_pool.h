@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_MIXER_SOURCE_PULL_POOL_H_
+#define MODULES_AUDIO_MIXER_SOURCE_PULL_POOL_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "api/function_view.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+
+namespace webrtc {
+
+// Fixed set of real-time threads which help the mixing thread to pull the
+// audio of many sources within one mixing pass. `Run()` splits the work in
+// one slice per thread and blocks until all slices are done; slice 0 runs on
+// the calling thread and slice k on the same helper thread on every call, so
+// that the state of the sources of a slice stays in the cache of one core.
+class SourcePullPool {
+ public:
+  // Creates `num_threads - 1` helper threads.
+  explicit SourcePullPool(int num_threads);
+  ~SourcePullPool();
+
+  SourcePullPool(const SourcePullPool&) = delete;
+  SourcePullPool& operator=(const SourcePullPool&) = delete;
+
+  int num_threads() const { return static_cast<int>(workers_.size()) + 1; }
+
+  // Calls `task(k)` for every slice k in [0, num_threads()), in parallel,
+  // and returns when all calls have returned. Must not be called
+  // concurrently.
+  void Run(rtc::FunctionView<void(int)> task);
+
+ private:
+  struct Worker {
+    rtc::Event start;
+    rtc::PlatformThread thread;
+  };
+
+  void RunWorker(int slice);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Set while `Run()` waits for the helper threads.
+  rtc::FunctionView<void(int)>* task_ = nullptr;
+  std::atomic<int> pending_workers_{0};
+  rtc::Event done_;
+  bool quit_ = false;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_MIXER_SOURCE_PULL_POOL_H_
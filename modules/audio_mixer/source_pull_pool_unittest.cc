@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/source_pull_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include "rtc_base/platform_thread_types.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumThreads = 4;
+constexpr int kNumRuns = 100;
+
+TEST(SourcePullPool, RunsEverySliceOncePerRun) {
+  SourcePullPool pool(kNumThreads);
+  EXPECT_EQ(pool.num_threads(), kNumThreads);
+  std::vector<std::atomic<int>> calls(kNumThreads);
+  for (int run = 1; run <= kNumRuns; ++run) {
+    pool.Run([&](int slice) { ++calls[slice]; });
+    for (int slice = 0; slice < kNumThreads; ++slice) {
+      // All slices have returned when `Run()` returns.
+      ASSERT_EQ(calls[slice], run) << "slice " << slice;
+    }
+  }
+}
+
+TEST(SourcePullPool, RunsEachSliceOnTheSameThread) {
+  SourcePullPool pool(kNumThreads);
+  std::vector<rtc::PlatformThreadRef> threads(kNumThreads);
+  pool.Run([&](int slice) { threads[slice] = rtc::CurrentThreadRef(); });
+  EXPECT_TRUE(rtc::IsThreadRefEqual(threads[0], rtc::CurrentThreadRef()));
+  for (int i = 0; i < kNumThreads; ++i) {
+    for (int j = i + 1; j < kNumThreads; ++j) {
+      EXPECT_FALSE(rtc::IsThreadRefEqual(threads[i], threads[j]));
+    }
+  }
+  for (int run = 0; run < kNumRuns; ++run) {
+    pool.Run([&](int slice) {
+      EXPECT_TRUE(
+          rtc::IsThreadRefEqual(threads[slice], rtc::CurrentThreadRef()));
+    });
+  }
+}
+
+TEST(SourcePullPool, RunsOnTheCallingThreadWithOneThread) {
+  SourcePullPool pool(/*num_threads=*/1);
+  int calls = 0;
+  pool.Run([&](int slice) {
+    EXPECT_EQ(slice, 0);
+    ++calls;
+  });
+  EXPECT_EQ(calls, 1);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -439,6 +439,7 @@ AudioProcessingImpl::AudioProcessingImpl(
       render_runtime_settings_enqueuer_(&render_runtime_settings_),
       echo_control_factory_(std::move(echo_control_factory)),
       config_(config),
+      config_snapshot_(config),
       submodule_states_(!!capture_post_processor,
                         !!render_pre_processor,
                         !!capture_analyzer),
@@ -486,6 +487,7 @@ int AudioProcessingImpl::Initialize() {
   // Run in a single-threaded manner during initialization.
   MutexLock lock_render(&mutex_render_);
   MutexLock lock_capture(&mutex_capture_);
+  ApplyPendingConfigLocked();
   InitializeLocked();
   return kNoError;
 }
@@ -494,6 +496,7 @@ int AudioProcessingImpl::Initialize(const ProcessingConfig& processing_config) {
   // Run in a single-threaded manner during initialization.
   MutexLock lock_render(&mutex_render_);
   MutexLock lock_capture(&mutex_capture_);
+  ApplyPendingConfigLocked();
   InitializeLocked(processing_config);
   return kNoError;
 }
@@ -666,11 +669,35 @@ void AudioProcessingImpl::InitializeLocked(const ProcessingConfig& config) {
 }
 
 void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
+  RTC_LOG(LS_INFO) << "AudioProcessing::ApplyConfig: " << config.ToString();
+
+  AudioProcessing::Config pending_config = config;
+  if (!GainController2::Validate(pending_config.gain_controller2)) {
+    RTC_LOG(LS_ERROR)
+        << "Invalid Gain Controller 2 config; using the default config.";
+    pending_config.gain_controller2 =
+        AudioProcessing::Config::GainController2();
+  }
+  config_snapshot_.SetPending(pending_config);
+}
+
+void AudioProcessingImpl::MaybeApplyPendingConfig() {
+  if (!config_snapshot_.HasPending()) {
+    return;
+  }
   // Run in a single-threaded manner when applying the settings.
   MutexLock lock_render(&mutex_render_);
   MutexLock lock_capture(&mutex_capture_);
+  ApplyPendingConfigLocked();
+}
 
-  RTC_LOG(LS_INFO) << "AudioProcessing::ApplyConfig: " << config.ToString();
+void AudioProcessingImpl::ApplyPendingConfigLocked() {
+  std::optional<AudioProcessing::Config> pending_config =
+      config_snapshot_.TakePending();
+  if (!pending_config) {
+    return;
+  }
+  const AudioProcessing::Config& config = *pending_config;
 
   const bool pipeline_config_changed =
       config_.pipeline.multi_channel_render !=
@@ -720,13 +747,6 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
     InitializeGainController1();
   }
 
-  const bool config_ok = GainController2::Validate(config_.gain_controller2);
-  if (!config_ok) {
-    RTC_LOG(LS_ERROR)
-        << "Invalid Gain Controller 2 config; using the default config.";
-    config_.gain_controller2 = AudioProcessing::Config::GainController2();
-  }
-
   if (agc2_config_changed) {
     InitializeGainController2();
   }
@@ -735,6 +755,8 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
     InitializeCaptureLevelsAdjuster();
   }
 
+  config_snapshot_.Set(config_);
+
   // Reinitialization must happen after all submodule configuration to avoid
   // additional reinitializations on the next capture / render processing call.
   if (pipeline_config_changed) {
@@ -784,6 +806,7 @@ size_t AudioProcessingImpl::num_output_channels() const {
 }
 
 void AudioProcessingImpl::set_output_will_be_muted(bool muted) {
+  MaybeApplyPendingConfig();
   MutexLock lock(&mutex_capture_);
   HandleCaptureOutputUsedSetting(!muted);
 }
@@ -864,37 +887,25 @@ bool AudioProcessingImpl::RuntimeSettingEnqueuer::Enqueue(
   return successful_insert;
 }
 
-void AudioProcessingImpl::MaybeInitializeCapture(
+bool AudioProcessingImpl::CaptureReinitializationRequired(
     const StreamConfig& input_config,
     const StreamConfig& output_config) {
-  ProcessingConfig processing_config;
-  bool reinitialization_required = false;
-  {
-    // Acquire the capture lock in order to access api_format. The lock is
-    // released immediately, as we may need to acquire the render lock as part
-    // of the conditional reinitialization.
-    MutexLock lock_capture(&mutex_capture_);
-    processing_config = formats_.api_format;
-    reinitialization_required = UpdateActiveSubmoduleStates();
-  }
-
-  if (processing_config.input_stream() != input_config) {
-    reinitialization_required = true;
-  }
-
-  if (processing_config.output_stream() != output_config) {
-    reinitialization_required = true;
-  }
+  // Note that the submodule states must always be updated.
+  const bool submodule_states_changed = UpdateActiveSubmoduleStates();
+  return submodule_states_changed ||
+         formats_.api_format.input_stream() != input_config ||
+         formats_.api_format.output_stream() != output_config;
+}
 
-  if (reinitialization_required) {
-    MutexLock lock_render(&mutex_render_);
-    MutexLock lock_capture(&mutex_capture_);
-    // Reread the API format since the render format may have changed.
-    processing_config = formats_.api_format;
-    processing_config.input_stream() = input_config;
-    processing_config.output_stream() = output_config;
-    InitializeLocked(processing_config);
-  }
+void AudioProcessingImpl::InitializeCapture(const StreamConfig& input_config,
+                                            const StreamConfig& output_config) {
+  MutexLock lock_render(&mutex_render_);
+  MutexLock lock_capture(&mutex_capture_);
+  // Reread the API format since the render format may have changed.
+  ProcessingConfig processing_config = formats_.api_format;
+  processing_config.input_stream() = input_config;
+  processing_config.output_stream() = output_config;
+  InitializeLocked(processing_config);
 }
 
 int AudioProcessingImpl::ProcessStream(const float* const* src,
@@ -905,10 +916,24 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
   DenormalDisabler denormal_disabler;
   RETURN_ON_ERR(
       HandleUnsupportedAudioFormats(src, input_config, output_config, dest));
-  MaybeInitializeCapture(input_config, output_config);
+  MaybeApplyPendingConfig();
+  {
+    // In the steady state, the frame is processed while holding the capture
+    // lock acquired for checking the format. Otherwise, the lock is released
+    // since the render lock must be acquired for the reinitialization.
+    MutexLock lock_capture(&mutex_capture_);
+    if (!CaptureReinitializationRequired(input_config, output_config)) {
+      return ProcessStreamLocked(src, dest);
+    }
+  }
+  InitializeCapture(input_config, output_config);
 
   MutexLock lock_capture(&mutex_capture_);
+  return ProcessStreamLocked(src, dest);
+}
 
+int AudioProcessingImpl::ProcessStreamLocked(const float* const* src,
+                                             float* const* dest) {
   if (aec_dump_) {
     RecordUnprocessedCaptureStream(src);
   }
@@ -935,6 +960,7 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
 void AudioProcessingImpl::HandleCaptureRuntimeSettings() {
   RuntimeSetting setting;
   int num_settings_processed = 0;
+  bool config_changed = false;
   while (capture_runtime_settings_.Remove(&setting)) {
     if (aec_dump_) {
       aec_dump_->WriteRuntimeSetting(setting);
@@ -954,6 +980,7 @@ void AudioProcessingImpl::HandleCaptureRuntimeSettings() {
           } else {
             config_.capture_level_adjustment.pre_gain_factor = value;
           }
+          config_changed = true;
 
           // Use both the pre-amplifier and the capture level adjustment gains
           // as pre-gains.
@@ -974,6 +1001,7 @@ void AudioProcessingImpl::HandleCaptureRuntimeSettings() {
           float value;
           setting.GetFloat(&value);
           config_.capture_level_adjustment.post_gain_factor = value;
+          config_changed = true;
           submodules_.capture_levels_adjuster->SetPostGain(
               config_.capture_level_adjustment.post_gain_factor);
         }
@@ -987,6 +1015,7 @@ void AudioProcessingImpl::HandleCaptureRuntimeSettings() {
           setting.GetFloat(&value);
           int int_value = static_cast<int>(value + .5f);
           config_.gain_controller1.compression_gain_db = int_value;
+          config_changed = true;
           if (submodules_.gain_control) {
             int error =
                 submodules_.gain_control->set_compression_gain_db(int_value);
@@ -1000,6 +1029,7 @@ void AudioProcessingImpl::HandleCaptureRuntimeSettings() {
           float value;
           setting.GetFloat(&value);
           config_.gain_controller2.fixed_digital.gain_db = value;
+          config_changed = true;
           submodules_.gain_controller2->SetFixedGainDb(value);
         }
         break;
@@ -1028,6 +1058,10 @@ void AudioProcessingImpl::HandleCaptureRuntimeSettings() {
     ++num_settings_processed;
   }
 
+  if (config_changed) {
+    config_snapshot_.Set(config_);
+  }
+
   if (num_settings_processed >= RuntimeSettingQueueSize()) {
     // Handle overrun of the runtime settings queue, which likely will has
     // caused settings to be discarded.
@@ -1204,9 +1238,23 @@ int AudioProcessingImpl::ProcessStream(const int16_t* const src,
 
   RETURN_ON_ERR(
       HandleUnsupportedAudioFormats(src, input_config, output_config, dest));
-  MaybeInitializeCapture(input_config, output_config);
+  MaybeApplyPendingConfig();
+  {
+    MutexLock lock_capture(&mutex_capture_);
+    if (!CaptureReinitializationRequired(input_config, output_config)) {
+      return ProcessStreamLocked(src, input_config, output_config, dest);
+    }
+  }
+  InitializeCapture(input_config, output_config);
 
   MutexLock lock_capture(&mutex_capture_);
+  return ProcessStreamLocked(src, input_config, output_config, dest);
+}
+
+int AudioProcessingImpl::ProcessStreamLocked(const int16_t* const src,
+                                             const StreamConfig& input_config,
+                                             const StreamConfig& output_config,
+                                             int16_t* const dest) {
   DenormalDisabler denormal_disabler;
 
   if (aec_dump_) {
@@ -1534,6 +1582,7 @@ int AudioProcessingImpl::AnalyzeReverseStream(
     const float* const* data,
     const StreamConfig& reverse_config) {
   TRACE_EVENT0("webrtc", "AudioProcessing::AnalyzeReverseStream_StreamConfig");
+  MaybeApplyPendingConfig();
   MutexLock lock(&mutex_render_);
   DenormalDisabler denormal_disabler;
   RTC_DCHECK(data);
@@ -1552,6 +1601,7 @@ int AudioProcessingImpl::ProcessReverseStream(const float* const* src,
                                               const StreamConfig& output_config,
                                               float* const* dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessReverseStream_StreamConfig");
+  MaybeApplyPendingConfig();
   MutexLock lock(&mutex_render_);
   DenormalDisabler denormal_disabler;
   RETURN_ON_ERR(
@@ -1600,6 +1650,7 @@ int AudioProcessingImpl::ProcessReverseStream(const int16_t* const src,
                                               int16_t* const dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessReverseStream_AudioFrame");
 
+  MaybeApplyPendingConfig();
   MutexLock lock(&mutex_render_);
   DenormalDisabler denormal_disabler;
 
@@ -1713,6 +1764,7 @@ void AudioProcessingImpl::set_stream_key_pressed(bool key_pressed) {
 }
 
 void AudioProcessingImpl::set_stream_analog_level(int level) {
+  MaybeApplyPendingConfig();
   MutexLock lock_capture(&mutex_capture_);
   set_stream_analog_level_locked(level);
 }
@@ -1816,6 +1868,7 @@ void AudioProcessingImpl::AttachAecDump(std::unique_ptr<AecDump> aec_dump) {
   RTC_DCHECK(aec_dump);
   MutexLock lock_render(&mutex_render_);
   MutexLock lock_capture(&mutex_capture_);
+  ApplyPendingConfigLocked();
 
   // The previously attached AecDump will be destroyed with the
   // 'aec_dump' parameter, which is after locks are released.
@@ -1837,9 +1890,7 @@ void AudioProcessingImpl::DetachAecDump() {
 }
 
 AudioProcessing::Config AudioProcessingImpl::GetConfig() const {
-  MutexLock lock_render(&mutex_render_);
-  MutexLock lock_capture(&mutex_capture_);
-  return config_;
+  return config_snapshot_.Get();
 }
 
 bool AudioProcessingImpl::UpdateActiveSubmoduleStates() {
@@ -2286,4 +2337,35 @@ void AudioProcessingImpl::ApmStatsReporter::UpdateStatistics(
   static_cast<void>(stats_message_passed);
 }
 
+AudioProcessingImpl::ApmConfigSnapshot::ApmConfigSnapshot(
+    const AudioProcessing::Config& config)
+    : config_(config) {}
+
+AudioProcessingImpl::ApmConfigSnapshot::~ApmConfigSnapshot() = default;
+
+AudioProcessing::Config AudioProcessingImpl::ApmConfigSnapshot::Get() const {
+  MutexLock lock_config(&mutex_config_);
+  return pending_config_.value_or(config_);
+}
+
+void AudioProcessingImpl::ApmConfigSnapshot::Set(
+    const AudioProcessing::Config& config) {
+  MutexLock lock_config(&mutex_config_);
+  config_ = config;
+}
+
+void AudioProcessingImpl::ApmConfigSnapshot::SetPending(
+    const AudioProcessing::Config& config) {
+  MutexLock lock_config(&mutex_config_);
+  pending_config_ = config;
+  has_pending_config_.store(true, std::memory_order_release);
+}
+
+std::optional<AudioProcessing::Config>
+AudioProcessingImpl::ApmConfigSnapshot::TakePending() {
+  MutexLock lock_config(&mutex_config_);
+  has_pending_config_.store(false, std::memory_order_relaxed);
+  return std::exchange(pending_config_, std::nullopt);
+}
+
 }  // namespace webrtc
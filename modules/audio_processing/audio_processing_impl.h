@@ -70,6 +70,8 @@ class AudioProcessingImpl : public AudioProcessing {
   ~AudioProcessingImpl() override;
   int Initialize() override;
   int Initialize(const ProcessingConfig& processing_config) override;
+  // Does not acquire any of the render and capture locks: `config` is swapped
+  // in by the next call processing audio, see `MaybeApplyPendingConfig()`.
   void ApplyConfig(const AudioProcessing::Config& config) override;
   bool CreateAndAttachAecDump(
       absl::string_view file_name,
@@ -235,20 +237,35 @@ class AudioProcessingImpl : public AudioProcessing {
   void MaybeInitializeRender(const StreamConfig& input_config,
                              const StreamConfig& output_config)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_);
-  // Called by capture: Acquires and releases the capture lock to read the
-  // format struct and acquires both locks if reinitialization is needed.
-  void MaybeInitializeCapture(const StreamConfig& input_config,
-                              const StreamConfig& output_config);
+  // Called by capture: Holds the capture lock when checking whether
+  // reinitialization is required, so that a single lock acquisition suffices
+  // for processing a frame in the steady state. If reinitialization is
+  // required, the capture lock must be released and `InitializeCapture()`
+  // called, which acquires both locks.
+  bool CaptureReinitializationRequired(const StreamConfig& input_config,
+                                       const StreamConfig& output_config)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_);
+  void InitializeCapture(const StreamConfig& input_config,
+                         const StreamConfig& output_config)
+      RTC_LOCKS_EXCLUDED(mutex_render_, mutex_capture_);
 
   // Method for updating the state keeping track of the active submodules.
   // Returns a bool indicating whether the state has changed.
   bool UpdateActiveSubmoduleStates()
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_);
 
+  // Applies the config passed to `ApplyConfig()`, if any, acquiring both the
+  // render and the capture lock only when there is one. Must be called before
+  // acquiring any of the two locks.
+  void MaybeApplyPendingConfig()
+      RTC_LOCKS_EXCLUDED(mutex_render_, mutex_capture_);
+
   // Methods requiring APM running in a single-threaded manner, requiring both
   // the render and capture lock to be acquired.
   void InitializeLocked(const ProcessingConfig& config)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_, mutex_capture_);
+  void ApplyPendingConfigLocked()
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_, mutex_capture_);
   void InitializeResidualEchoDetector()
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_, mutex_capture_);
   void InitializeEchoController()
@@ -295,6 +312,13 @@ class AudioProcessingImpl : public AudioProcessing {
   // Capture-side exclusive methods possibly running APM in a multi-threaded
   // manner that are called with the render lock already acquired.
   int ProcessCaptureStreamLocked() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_);
+  int ProcessStreamLocked(const int16_t* const src,
+                          const StreamConfig& input_config,
+                          const StreamConfig& output_config,
+                          int16_t* const dest)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_);
+  int ProcessStreamLocked(const float* const* src, float* const* dest)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_);
 
   // Render-side exclusive methods possibly running APM in a multi-threaded
   // manner that are called with the render lock already acquired.
@@ -356,6 +380,39 @@ class AudioProcessingImpl : public AudioProcessing {
   // Struct containing the Config specifying the behavior of APM.
   AudioProcessing::Config config_;
 
+  // Double buffer for the config, holding the config in use by the audio
+  // processing and the one passed to `ApplyConfig()` that has yet to be swapped
+  // in. Its lock is never held while processing audio, hence neither applying
+  // nor reading the config contends with the render and capture threads, which
+  // only check an atomic flag for a pending config in the steady state. The
+  // class is thread-safe.
+  class ApmConfigSnapshot {
+   public:
+    explicit ApmConfigSnapshot(const AudioProcessing::Config& config);
+    ~ApmConfigSnapshot();
+
+    // Returns the pending config if there is one, otherwise the config in use.
+    AudioProcessing::Config Get() const;
+
+    // Publishes `config` as the config in use.
+    void Set(const AudioProcessing::Config& config);
+
+    // Stores `config` until it is taken by `TakePending()`, replacing any
+    // config stored before.
+    void SetPending(const AudioProcessing::Config& config);
+    bool HasPending() const {
+      return has_pending_config_.load(std::memory_order_acquire);
+    }
+    std::optional<AudioProcessing::Config> TakePending();
+
+   private:
+    mutable Mutex mutex_config_;
+    AudioProcessing::Config config_ RTC_GUARDED_BY(mutex_config_);
+    std::optional<AudioProcessing::Config> pending_config_
+        RTC_GUARDED_BY(mutex_config_);
+    std::atomic<bool> has_pending_config_{false};
+  } config_snapshot_;
+
   // Class containing information about what submodules are active.
   SubmoduleStates submodule_states_;
 
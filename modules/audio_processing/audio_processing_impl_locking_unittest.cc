@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "api/array_view.h"
@@ -992,6 +993,28 @@ void RenderProcessor::ApplyRuntimeSettingScheme() {
                frame_data_.input_number_of_channels);
 }
 
+// Capture post-processor which blocks the capture thread, while it holds the
+// capture lock, until released.
+class BlockingCaptureProcessing : public CustomProcessing {
+ public:
+  BlockingCaptureProcessing(rtc::Event* processing_started,
+                            rtc::Event* release_processing)
+      : processing_started_(processing_started),
+        release_processing_(release_processing) {}
+
+  void Initialize(int sample_rate_hz, int num_channels) override {}
+  void Process(AudioBuffer* audio) override {
+    processing_started_->Set();
+    release_processing_->Wait(rtc::Event::kForever);
+  }
+  std::string ToString() const override { return "BlockingCaptureProcessing"; }
+  void SetRuntimeSetting(AudioProcessing::RuntimeSetting setting) override {}
+
+ private:
+  rtc::Event* const processing_started_;
+  rtc::Event* const release_processing_;
+};
+
 }  // namespace
 
 TEST_P(AudioProcessingImplLockTest, LockTest) {
@@ -1010,4 +1033,41 @@ INSTANTIATE_TEST_SUITE_P(
     AudioProcessingImplLockTest,
     ::testing::ValuesIn(TestConfig::GenerateBriefTestConfigs()));
 
+// Verifies that reading the config does not wait for the capture processing.
+TEST(AudioProcessingImplConfigLockTest,
+     GetConfigDoesNotBlockOnCaptureProcessing) {
+  rtc::Event processing_started;
+  rtc::Event release_processing;
+  AudioProcessing::Config apm_config;
+  apm_config.noise_suppression.enabled = true;
+  rtc::scoped_refptr<AudioProcessing> apm =
+      BuiltinAudioProcessingBuilder(apm_config)
+          .SetCapturePostProcessing(std::make_unique<BlockingCaptureProcessing>(
+              &processing_started, &release_processing))
+          .Build(CreateEnvironment());
+
+  rtc::PlatformThread capture_thread = rtc::PlatformThread::SpawnJoinable(
+      [&] {
+        std::vector<float> frame(160, 0.f);
+        float* channel = frame.data();
+        const StreamConfig stream_config(16000, 1);
+        apm->ProcessStream(&channel, stream_config, stream_config, &channel);
+      },
+      "capture");
+  ASSERT_TRUE(processing_started.Wait(kTestTimeOutLimit));
+
+  rtc::Event config_read;
+  rtc::PlatformThread stats_thread = rtc::PlatformThread::SpawnJoinable(
+      [&] {
+        EXPECT_TRUE(apm->GetConfig().noise_suppression.enabled);
+        config_read.Set();
+      },
+      "stats");
+  EXPECT_TRUE(config_read.Wait(TimeDelta::Seconds(5)));
+
+  release_processing.Set();
+  capture_thread.Finalize();
+  stats_thread.Finalize();
+}
+
 }  // namespace webrtc
@@ -223,6 +223,39 @@ TEST(AudioProcessingImplTest, UpdateCapturePreGainRuntimeSetting) {
   apm->SetRuntimeSetting(
       AudioProcessing::RuntimeSetting::CreateCapturePreGain(kGainFactor));
 
+  // Process for two frames to have time to ramp up gain.
+  for (int i = 0; i < 2; ++i) {
+    frame.fill(kAudioLevel);
+    apm->ProcessStream(frame.data(), config, config, frame.data());
+  }
+  EXPECT_EQ(frame[100], kGainFactor * kAudioLevel)
+      << "Frame should be amplified.";
+  EXPECT_EQ(apm->GetConfig().pre_amplifier.fixed_gain_factor, kGainFactor);
+}
+
+TEST(AudioProcessingImplTest, AppliedConfigIsUsedFromNextProcessStreamCall) {
+  scoped_refptr<AudioProcessing> apm =
+      BuiltinAudioProcessingBuilder().Build(CreateEnvironment());
+
+  constexpr int kSampleRateHz = 48000;
+  constexpr int16_t kAudioLevel = 10000;
+  constexpr size_t kNumChannels = 2;
+
+  std::array<int16_t, kNumChannels * kSampleRateHz / 100> frame;
+  StreamConfig config(kSampleRateHz, kNumChannels);
+  frame.fill(kAudioLevel);
+  apm->ProcessStream(frame.data(), config, config, frame.data());
+  EXPECT_EQ(frame[100], kAudioLevel);
+
+  constexpr float kGainFactor = 2.f;
+  webrtc::AudioProcessing::Config apm_config;
+  apm_config.pre_amplifier.enabled = true;
+  apm_config.pre_amplifier.fixed_gain_factor = kGainFactor;
+  apm->ApplyConfig(apm_config);
+  // The config is reported before it is swapped in.
+  EXPECT_TRUE(apm->GetConfig().pre_amplifier.enabled);
+  EXPECT_EQ(apm->GetConfig().pre_amplifier.fixed_gain_factor, kGainFactor);
+
   // Process for two frames to have time to ramp up gain.
   for (int i = 0; i < 2; ++i) {
     frame.fill(kAudioLevel);
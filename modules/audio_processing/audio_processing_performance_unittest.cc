@@ -28,6 +28,7 @@
 #include "rtc_base/platform_thread.h"
 #include "rtc_base/random.h"
 #include "system_wrappers/include/clock.h"
+#include "system_wrappers/include/sleep.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -40,8 +41,8 @@ using ::webrtc::test::Unit;
 
 class CallSimulator;
 
-// Type of the render thread APM API call to use in the test.
-enum class ProcessorType { kRender, kCapture };
+// Type of the thread APM API call to use in the test.
+enum class ProcessorType { kRender, kCapture, kStats };
 
 // Variant of APM processing settings to use in the test.
 enum class SettingsType {
@@ -268,6 +269,21 @@ class TimedThreadApiProcessor {
     return result;
   }
 
+  int ProcessStats() {
+    // Poll the config and the statistics at a rate much higher than the
+    // typical one of a signaling thread. Neither call is allowed to contend
+    // with the render and capture processing.
+    SleepMs(1);
+    const int64_t start_time = clock_->TimeInMicroseconds();
+    apm_->GetConfig();
+    apm_->GetStatistics();
+    const int64_t end_time = clock_->TimeInMicroseconds();
+
+    AddDuration(end_time - start_time);
+
+    return AudioProcessing::kNoError;
+  }
+
   bool ReadyToProcessCapture() {
     return (frame_counters_->CaptureMinusRenderCounters() <=
             kMaxCallDifference);
@@ -340,6 +356,9 @@ class TimedThreadApiProcessor {
 
       case ProcessorType::kCapture:
         return ReadyToProcessCapture();
+
+      case ProcessorType::kStats:
+        return true;
     }
 
     // Should not be reached, but the return statement is needed for the code to
@@ -384,6 +403,8 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
         simulation_config_.SettingsDescription() + "_render");
     capture_thread_state_->print_processor_statistics(
         simulation_config_.SettingsDescription() + "_capture");
+    stats_thread_state_->print_processor_statistics(
+        simulation_config_.SettingsDescription() + "_stats");
 
     return result;
   }
@@ -409,6 +430,7 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
   void StopThreads() {
     render_thread_.Finalize();
     capture_thread_.Finalize();
+    stats_thread_.Finalize();
   }
 
   // Simulator and APM setup.
@@ -488,6 +510,10 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
         ProcessorType::kCapture, &rand_gen_, &frame_counters_,
         &capture_call_checker_, this, &simulation_config_, apm_.get(),
         kMinNumFramesToProcess, kCaptureInputFloatLevel, num_capture_channels));
+    stats_thread_state_.reset(new TimedThreadApiProcessor(
+        ProcessorType::kStats, &rand_gen_, &frame_counters_,
+        &capture_call_checker_, this, &simulation_config_, apm_.get(),
+        kMinNumFramesToProcess, /*input_level=*/0.f, /*num_channels=*/1));
   }
 
   // Start the threads used in the test.
@@ -506,6 +532,12 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
           }
         },
         "capture", attributes);
+    stats_thread_ = rtc::PlatformThread::SpawnJoinable(
+        [this] {
+          while (stats_thread_state_->Process()) {
+          }
+        },
+        "stats");
   }
 
   // Event handler for the test.
@@ -520,13 +552,17 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
   LockedFlag capture_call_checker_;
   std::unique_ptr<TimedThreadApiProcessor> render_thread_state_;
   std::unique_ptr<TimedThreadApiProcessor> capture_thread_state_;
+  std::unique_ptr<TimedThreadApiProcessor> stats_thread_state_;
   rtc::PlatformThread render_thread_;
   rtc::PlatformThread capture_thread_;
+  rtc::PlatformThread stats_thread_;
 };
 
 // Implements the callback functionality for the threads.
 bool TimedThreadApiProcessor::Process() {
-  PrepareFrame();
+  if (processor_type_ != ProcessorType::kStats) {
+    PrepareFrame();
+  }
 
   // Wait in a spinlock manner until it is ok to start processing.
   // Note that SleepMs is not applicable since it only allows sleeping
@@ -544,6 +580,9 @@ bool TimedThreadApiProcessor::Process() {
     case ProcessorType::kCapture:
       result = ProcessCapture();
       break;
+    case ProcessorType::kStats:
+      result = ProcessStats();
+      break;
   }
 
   EXPECT_EQ(result, AudioProcessing::kNoError);
@@ -10,6 +10,8 @@
 
 #include "modules/audio_processing/high_pass_filter.h"
 
+#include <algorithm>
+
 #include "api/array_view.h"
 #include "modules/audio_processing/audio_buffer.h"
 #include "rtc_base/checks.h"
@@ -112,4 +114,70 @@ void HighPassFilter::Reset(size_t num_channels) {
   }
 }
 
+BatchedHighPassFilter::BatchedHighPassFilter(int sample_rate_hz,
+                                             size_t num_streams)
+    : sample_rate_hz_(sample_rate_hz),
+      coefficients_(ChooseCoefficients(sample_rate_hz)),
+      x0_(num_streams, 0.f),
+      x1_(num_streams, 0.f),
+      y0_(num_streams, 0.f),
+      y1_(num_streams, 0.f) {
+  // Only a single biquad is applied.
+  static_assert(kNumberOfHighPassBiQuads == 1);
+}
+
+BatchedHighPassFilter::~BatchedHighPassFilter() = default;
+
+void BatchedHighPassFilter::Process(rtc::ArrayView<float* const> streams,
+                                    size_t num_frames) {
+  const size_t num_streams = x0_.size();
+  RTC_DCHECK_EQ(streams.size(), num_streams);
+  samples_.resize(num_frames * num_streams);
+  for (size_t s = 0; s < num_streams; ++s) {
+    const float* stream = streams[s];
+    for (size_t k = 0; k < num_frames; ++k) {
+      samples_[k * num_streams + s] = stream[k];
+    }
+  }
+
+  const float c_a_0 = coefficients_.a[0];
+  const float c_a_1 = coefficients_.a[1];
+  const float c_b_0 = coefficients_.b[0];
+  const float c_b_1 = coefficients_.b[1];
+  const float c_b_2 = coefficients_.b[2];
+  float* const m_x_0 = x0_.data();
+  float* const m_x_1 = x1_.data();
+  float* const m_y_0 = y0_.data();
+  float* const m_y_1 = y1_.data();
+  for (size_t k = 0; k < num_frames; ++k) {
+    float* const y = &samples_[k * num_streams];
+    // The streams are independent, so this loop has no loop-carried
+    // dependencies. The expression matches `CascadedBiQuadFilter`, so that
+    // the output is the same as for `HighPassFilter`.
+    for (size_t s = 0; s < num_streams; ++s) {
+      const float tmp = y[s];
+      y[s] = c_b_0 * tmp + c_b_1 * m_x_0[s] + c_b_2 * m_x_1[s] -
+             c_a_0 * m_y_0[s] - c_a_1 * m_y_1[s];
+      m_x_1[s] = m_x_0[s];
+      m_x_0[s] = tmp;
+      m_y_1[s] = m_y_0[s];
+      m_y_0[s] = y[s];
+    }
+  }
+
+  for (size_t s = 0; s < num_streams; ++s) {
+    float* stream = streams[s];
+    for (size_t k = 0; k < num_frames; ++k) {
+      stream[k] = samples_[k * num_streams + s];
+    }
+  }
+}
+
+void BatchedHighPassFilter::Reset() {
+  std::fill(x0_.begin(), x0_.end(), 0.f);
+  std::fill(x1_.begin(), x1_.end(), 0.f);
+  std::fill(y0_.begin(), y0_.end(), 0.f);
+  std::fill(y1_.begin(), y1_.end(), 0.f);
+}
+
 }  // namespace webrtc
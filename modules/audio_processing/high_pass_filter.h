@@ -40,6 +40,39 @@ class HighPassFilter {
   const int sample_rate_hz_;
   std::vector<std::unique_ptr<CascadedBiQuadFilter>> filters_;
 };
+
+// Applies the same high-pass filter as `HighPassFilter` to many independent
+// mono streams. The filter states are stored as arrays over the streams, and
+// the samples of all streams are filtered in lockstep, so that the filtering
+// can be vectorized across streams instead of being serial over the samples
+// of each stream.
+class BatchedHighPassFilter {
+ public:
+  BatchedHighPassFilter(int sample_rate_hz, size_t num_streams);
+  ~BatchedHighPassFilter();
+  BatchedHighPassFilter(const BatchedHighPassFilter&) = delete;
+  BatchedHighPassFilter& operator=(const BatchedHighPassFilter&) = delete;
+
+  // Filters `num_frames` samples of each of the `num_streams()` streams in
+  // place.
+  void Process(rtc::ArrayView<float* const> streams, size_t num_frames);
+  void Reset();
+
+  int sample_rate_hz() const { return sample_rate_hz_; }
+  size_t num_streams() const { return x0_.size(); }
+
+ private:
+  const int sample_rate_hz_;
+  const CascadedBiQuadFilter::BiQuadCoefficients coefficients_;
+  // The filter states, indexed by stream.
+  std::vector<float> x0_;
+  std::vector<float> x1_;
+  std::vector<float> y0_;
+  std::vector<float> y1_;
+  // The samples being filtered, indexed by sample and then by stream.
+  std::vector<float> samples_;
+};
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_HIGH_PASS_FILTER_H_
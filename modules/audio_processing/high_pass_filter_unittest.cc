@@ -9,12 +9,15 @@
  */
 #include "modules/audio_processing/high_pass_filter.h"
 
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "api/array_view.h"
 #include "modules/audio_processing/audio_buffer.h"
 #include "modules/audio_processing/test/audio_buffer_tools.h"
 #include "modules/audio_processing/test/bitexactness_tools.h"
+#include "rtc_base/random.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -298,4 +301,60 @@ TEST(HighPassFilterAccuracyTest, MonoConverged) {
   }
 }
 
+TEST(BatchedHighPassFilterTest, MatchesHighPassFilterPerStream) {
+  constexpr size_t kNumStreams = 13;
+  for (int sample_rate_hz : {16000, 32000, 48000}) {
+    const size_t num_frames = sample_rate_hz / 100;
+    BatchedHighPassFilter batched_hpf(sample_rate_hz, kNumStreams);
+    std::vector<std::unique_ptr<HighPassFilter>> hpfs;
+    for (size_t s = 0; s < kNumStreams; ++s) {
+      hpfs.push_back(std::make_unique<HighPassFilter>(sample_rate_hz, 1));
+    }
+
+    Random random(42);
+    std::vector<std::vector<float>> streams(kNumStreams,
+                                            std::vector<float>(num_frames));
+    std::vector<float*> stream_ptrs;
+    for (auto& stream : streams) {
+      stream_ptrs.push_back(stream.data());
+    }
+    for (int frame = 0; frame < 10; ++frame) {
+      // Every stream is processed by its own filter, as a single channel.
+      std::vector<std::vector<std::vector<float>>> expected(kNumStreams);
+      for (size_t s = 0; s < kNumStreams; ++s) {
+        for (float& sample : streams[s]) {
+          // With a DC offset, which is removed by the filter.
+          sample = random.Rand<float>() * 2.f - 0.5f;
+        }
+        expected[s] = {streams[s]};
+        hpfs[s]->Process(&expected[s]);
+      }
+      batched_hpf.Process(stream_ptrs, num_frames);
+      for (size_t s = 0; s < kNumStreams; ++s) {
+        for (size_t k = 0; k < num_frames; ++k) {
+          EXPECT_FLOAT_EQ(streams[s][k], expected[s][0][k]);
+        }
+      }
+    }
+  }
+}
+
+TEST(BatchedHighPassFilterTest, Reset) {
+  constexpr size_t kNumFrames = 160;
+  BatchedHighPassFilter batched_hpf(16000, 2);
+  std::vector<float> first(kNumFrames, 1.f);
+  std::vector<float> second(kNumFrames, 1.f);
+  float* streams[] = {first.data(), second.data()};
+  batched_hpf.Process(streams, kNumFrames);
+  batched_hpf.Reset();
+
+  std::vector<float> after_reset(kNumFrames, 1.f);
+  std::vector<float> second_after_reset(kNumFrames, 1.f);
+  float* streams_after_reset[] = {after_reset.data(),
+                                  second_after_reset.data()};
+  batched_hpf.Process(streams_after_reset, kNumFrames);
+  EXPECT_EQ(after_reset, first);
+  EXPECT_EQ(second_after_reset, second);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/multi_stream_audio_processing.h"
+
+#include <memory>
+#include <optional>
+
+#include "modules/audio_processing/agc2/input_volume_controller.h"
+#include "modules/audio_processing/ns/ns_config.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+NsConfig::SuppressionLevel MapNoiseSuppressionLevel(
+    AudioProcessing::Config::NoiseSuppression::Level level) {
+  using NoiseSuppressionConfig = AudioProcessing::Config::NoiseSuppression;
+  switch (level) {
+    case NoiseSuppressionConfig::kLow:
+      return NsConfig::SuppressionLevel::k6dB;
+    case NoiseSuppressionConfig::kModerate:
+      return NsConfig::SuppressionLevel::k12dB;
+    case NoiseSuppressionConfig::kHigh:
+      return NsConfig::SuppressionLevel::k18dB;
+    case NoiseSuppressionConfig::kVeryHigh:
+      return NsConfig::SuppressionLevel::k21dB;
+  }
+  RTC_CHECK_NOTREACHED();
+}
+
+bool SampleRateSupportsMultiBand(int sample_rate_hz) {
+  return sample_rate_hz == AudioProcessing::kSampleRate32kHz ||
+         sample_rate_hz == AudioProcessing::kSampleRate48kHz;
+}
+
+// As in `AudioProcessingImpl`, the noise suppressor requires the high-pass
+// filter.
+bool HighPassFilteringRequired(const AudioProcessing::Config& config) {
+  return config.high_pass_filter.enabled || config.noise_suppression.enabled;
+}
+
+}  // namespace
+
+MultiStreamAudioProcessing::Stream::Stream(int sample_rate_hz)
+    : audio(sample_rate_hz,
+            /*input_num_channels=*/1,
+            sample_rate_hz,
+            /*buffer_num_channels=*/1,
+            sample_rate_hz,
+            /*output_num_channels=*/1) {}
+
+bool MultiStreamAudioProcessing::Validate(
+    const AudioProcessing::Config& config) {
+  return !config.pre_amplifier.enabled &&
+         !config.capture_level_adjustment.enabled &&
+         !config.echo_canceller.enabled && !config.gain_controller1.enabled &&
+         (!HighPassFilteringRequired(config) ||
+          config.high_pass_filter.apply_in_full_band) &&
+         (!config.gain_controller2.enabled ||
+          (!config.gain_controller2.input_volume_controller.enabled &&
+           GainController2::Validate(config.gain_controller2)));
+}
+
+MultiStreamAudioProcessing::MultiStreamAudioProcessing(
+    const AudioProcessing::Config& config,
+    int sample_rate_hz,
+    size_t num_streams)
+    : stream_config_(sample_rate_hz, /*num_channels=*/1),
+      // As in `AudioProcessingImpl`, the bands are split whenever the
+      // high-pass filter is applied, which changes the signal slightly even
+      // if only the high-pass filter runs.
+      split_bands_(HighPassFilteringRequired(config) &&
+                   SampleRateSupportsMultiBand(sample_rate_hz)) {
+  RTC_DCHECK(Validate(config));
+  RTC_DCHECK(sample_rate_hz == AudioProcessing::kSampleRate16kHz ||
+             SampleRateSupportsMultiBand(sample_rate_hz));
+
+  if (HighPassFilteringRequired(config)) {
+    high_pass_filter_ =
+        std::make_unique<BatchedHighPassFilter>(sample_rate_hz, num_streams);
+  }
+
+  NsConfig ns_config;
+  ns_config.target_level =
+      MapNoiseSuppressionLevel(config.noise_suppression.level);
+  for (size_t i = 0; i < num_streams; ++i) {
+    auto stream = std::make_unique<Stream>(sample_rate_hz);
+    if (config.noise_suppression.enabled) {
+      stream->noise_suppressor = std::make_unique<NoiseSuppressor>(
+          ns_config, sample_rate_hz, /*num_channels=*/1);
+    }
+    if (config.gain_controller2.enabled) {
+      stream->gain_controller2 = std::make_unique<GainController2>(
+          config.gain_controller2, InputVolumeController::Config{},
+          sample_rate_hz, /*num_channels=*/1, /*use_internal_vad=*/true);
+    }
+    channels_.push_back(stream->audio.channels()[0]);
+    streams_.push_back(std::move(stream));
+  }
+}
+
+MultiStreamAudioProcessing::~MultiStreamAudioProcessing() = default;
+
+void MultiStreamAudioProcessing::ProcessStreams(
+    rtc::ArrayView<const float* const> src,
+    rtc::ArrayView<float* const> dest) {
+  RTC_DCHECK_EQ(src.size(), streams_.size());
+  RTC_DCHECK_EQ(dest.size(), streams_.size());
+
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    streams_[i]->audio.CopyFrom(&src[i], stream_config_);
+  }
+
+  if (high_pass_filter_) {
+    high_pass_filter_->Process(channels_, num_frames());
+  }
+
+  // Running each stage over all streams in turn is slower, since the state of
+  // a stream is evicted from the cache between its stages.
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    Stream& stream = *streams_[i];
+    if (split_bands_) {
+      stream.audio.SplitIntoFrequencyBands();
+    }
+    if (stream.noise_suppressor) {
+      stream.noise_suppressor->Analyze(stream.audio);
+      stream.noise_suppressor->Process(&stream.audio);
+    }
+    if (split_bands_) {
+      stream.audio.MergeFrequencyBands();
+    }
+    if (stream.gain_controller2) {
+      stream.gain_controller2->Process(/*speech_probability=*/std::nullopt,
+                                       /*input_volume_changed=*/false,
+                                       &stream.audio);
+    }
+    stream.audio.CopyTo(stream_config_, &dest[i]);
+  }
+}
+
+}  // namespace webrtc
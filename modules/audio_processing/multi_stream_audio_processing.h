@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_MULTI_STREAM_AUDIO_PROCESSING_H_
+#define MODULES_AUDIO_PROCESSING_MULTI_STREAM_AUDIO_PROCESSING_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/audio/audio_processing.h"
+#include "modules/audio_processing/audio_buffer.h"
+#include "modules/audio_processing/gain_controller2.h"
+#include "modules/audio_processing/high_pass_filter.h"
+#include "modules/audio_processing/ns/noise_suppressor.h"
+
+namespace webrtc {
+
+// Applies the same capture processing to many independent mono streams, e.g.
+// one per participant on a server, processing one 10 ms frame of every stream
+// per call.
+//
+// Compared to one `AudioProcessing` instance per stream, there is no locking
+// and no per-call format or runtime setting handling, and the high-pass
+// filter is vectorized across streams with `BatchedHighPassFilter`. The
+// noise suppressor and AGC2 are not vectorized: every stream keeps its own
+// instances, whose state and control flow diverge between streams, and a
+// stream is run through both before the next one, which keeps its state in
+// the cache. Beyond the high-pass filter, the gain over separate instances
+// comes from the skipped locking and per-call checks only.
+//
+// Only the high-pass filter (in full band), the noise suppressor and AGC2
+// (without the input volume controller) are supported. For streams at the
+// processing rate, the output is the same as that of `AudioProcessing` with
+// the same config.
+//
+// This class is not thread safe.
+class MultiStreamAudioProcessing {
+ public:
+  // Returns true if `config` only enables supported submodules.
+  static bool Validate(const AudioProcessing::Config& config);
+
+  // `config` must be valid and `sample_rate_hz` must be 16000, 32000 or
+  // 48000.
+  MultiStreamAudioProcessing(const AudioProcessing::Config& config,
+                         int sample_rate_hz,
+                         size_t num_streams);
+  ~MultiStreamAudioProcessing();
+  MultiStreamAudioProcessing(const MultiStreamAudioProcessing&) = delete;
+  MultiStreamAudioProcessing& operator=(const MultiStreamAudioProcessing&) =
+      delete;
+
+  // Processes one frame of every stream. `src` and `dest` have one pointer per
+  // stream, to `num_frames()` samples in the [-1, 1] range, and may point to
+  // the same samples.
+  void ProcessStreams(rtc::ArrayView<const float* const> src,
+                      rtc::ArrayView<float* const> dest);
+
+  int sample_rate_hz() const { return stream_config_.sample_rate_hz(); }
+  size_t num_frames() const { return stream_config_.num_frames(); }
+  size_t num_streams() const { return streams_.size(); }
+
+ private:
+  struct Stream {
+    explicit Stream(int sample_rate_hz);
+
+    AudioBuffer audio;
+    std::unique_ptr<NoiseSuppressor> noise_suppressor;
+    std::unique_ptr<GainController2> gain_controller2;
+  };
+
+  const StreamConfig stream_config_;
+  const bool split_bands_;
+  std::unique_ptr<BatchedHighPassFilter> high_pass_filter_;
+  std::vector<std::unique_ptr<Stream>> streams_;
+  // The full band data of every stream, for the high-pass filter.
+  std::vector<float*> channels_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_MULTI_STREAM_AUDIO_PROCESSING_H_
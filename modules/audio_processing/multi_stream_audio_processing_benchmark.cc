@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how many mono 48 kHz streams a single core can process in real
+// time with the high-pass filter, noise suppression and AGC2, as on a server
+// with one stream per participant, with one `AudioProcessing` instance per
+// stream and with `MultiStreamAudioProcessing`.
+
+#include <vector>
+
+#include "api/audio/audio_processing.h"
+#include "api/audio/builtin_audio_processing_builder.h"
+#include "api/environment/environment_factory.h"
+#include "api/scoped_refptr.h"
+#include "benchmark/benchmark.h"
+#include "modules/audio_processing/multi_stream_audio_processing.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr int kNumFrames = kSampleRateHz / 100;
+// The number of different frames that are processed in turn.
+constexpr int kNumInputFrames = 10;
+
+AudioProcessing::Config CreateConfig() {
+  AudioProcessing::Config config;
+  config.high_pass_filter.enabled = true;
+  config.noise_suppression.enabled = true;
+  config.gain_controller2.enabled = true;
+  config.gain_controller2.adaptive_digital.enabled = true;
+  return config;
+}
+
+// Returns noisy input frames, which are the same for all streams.
+std::vector<std::vector<float>> CreateInputFrames() {
+  Random random(42);
+  std::vector<std::vector<float>> frames(kNumInputFrames,
+                                         std::vector<float>(kNumFrames));
+  for (auto& frame : frames) {
+    for (float& sample : frame) {
+      sample = 0.1f * (random.Rand<float>() - 0.5f);
+    }
+  }
+  return frames;
+}
+
+void SetStreamsPerCore(benchmark::State& state, int num_streams) {
+  // Every iteration processes 10 ms of every stream.
+  state.counters["streams_per_core"] = benchmark::Counter(
+      state.iterations() * num_streams / 100.0, benchmark::Counter::kIsRate);
+}
+
+// The argument is the number of streams.
+void BM_SeparateAudioProcessing(benchmark::State& state) {
+  const int num_streams = state.range(0);
+  std::vector<scoped_refptr<AudioProcessing>> apms;
+  for (int i = 0; i < num_streams; ++i) {
+    apms.push_back(BuiltinAudioProcessingBuilder(CreateConfig())
+                       .Build(CreateEnvironment()));
+  }
+  const StreamConfig stream_config(kSampleRateHz, /*num_channels=*/1);
+  const std::vector<std::vector<float>> input = CreateInputFrames();
+  std::vector<float> output(kNumFrames);
+  float* output_ptr = output.data();
+  int frame = 0;
+  for (auto _ : state) {
+    const float* input_ptr = input[frame].data();
+    for (auto& apm : apms) {
+      RTC_CHECK_EQ(apm->ProcessStream(&input_ptr, stream_config,
+                                      stream_config, &output_ptr),
+                   AudioProcessing::kNoError);
+    }
+    benchmark::DoNotOptimize(output.data());
+    frame = (frame + 1) % kNumInputFrames;
+  }
+  SetStreamsPerCore(state, num_streams);
+}
+BENCHMARK(BM_SeparateAudioProcessing)
+    ->ArgName("streams")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(100);
+
+// The argument is the number of streams.
+void BM_MultiStreamAudioProcessing(benchmark::State& state) {
+  const int num_streams = state.range(0);
+  MultiStreamAudioProcessing processing(CreateConfig(), kSampleRateHz,
+                                        num_streams);
+  const std::vector<std::vector<float>> input = CreateInputFrames();
+  std::vector<std::vector<float>> output(num_streams,
+                                         std::vector<float>(kNumFrames));
+  std::vector<float*> output_ptrs;
+  for (auto& stream : output) {
+    output_ptrs.push_back(stream.data());
+  }
+  std::vector<const float*> input_ptrs(num_streams);
+  int frame = 0;
+  for (auto _ : state) {
+    for (const float*& input_ptr : input_ptrs) {
+      input_ptr = input[frame].data();
+    }
+    processing.ProcessStreams(input_ptrs, output_ptrs);
+    benchmark::DoNotOptimize(output_ptrs.data());
+    frame = (frame + 1) % kNumInputFrames;
+  }
+  SetStreamsPerCore(state, num_streams);
+}
+BENCHMARK(BM_MultiStreamAudioProcessing)
+    ->ArgName("streams")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(100);
+
+}  // namespace
+}  // namespace webrtc
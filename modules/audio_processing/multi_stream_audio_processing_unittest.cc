@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/multi_stream_audio_processing.h"
+
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "api/audio/audio_processing.h"
+#include "api/audio/builtin_audio_processing_builder.h"
+#include "api/environment/environment_factory.h"
+#include "api/scoped_refptr.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kNumStreams = 5;
+constexpr int kNumFramesToProcess = 100;
+constexpr float kPi = 3.14159265f;
+
+AudioProcessing::Config CreateConfig(bool hpf, bool ns, bool agc2) {
+  AudioProcessing::Config config;
+  config.high_pass_filter.enabled = hpf;
+  config.noise_suppression.enabled = ns;
+  config.noise_suppression.level =
+      AudioProcessing::Config::NoiseSuppression::kHigh;
+  config.gain_controller2.enabled = agc2;
+  config.gain_controller2.adaptive_digital.enabled = agc2;
+  return config;
+}
+
+// Fills `frame` with a tone with a different frequency and level for every
+// stream, plus noise.
+void GenerateFrame(Random& random,
+                   int frame_index,
+                   size_t stream_index,
+                   std::vector<float>& frame) {
+  const float frequency_hz = 200.f + 150.f * stream_index;
+  const float amplitude = 0.05f + 0.1f * stream_index;
+  const int sample_rate_hz = frame.size() * 100;
+  for (size_t k = 0; k < frame.size(); ++k) {
+    const float t =
+        static_cast<float>(frame_index * frame.size() + k) / sample_rate_hz;
+    frame[k] = amplitude * std::sin(2 * kPi * frequency_hz * t) +
+               0.02f * (random.Rand<float>() - 0.5f);
+  }
+}
+
+class MultiStreamAudioProcessingTest
+    : public ::testing::TestWithParam<std::tuple<int, bool, bool, bool>> {};
+
+TEST_P(MultiStreamAudioProcessingTest, MatchesAudioProcessingPerStream) {
+  auto [sample_rate_hz, hpf, ns, agc2] = GetParam();
+  const AudioProcessing::Config config = CreateConfig(hpf, ns, agc2);
+  ASSERT_TRUE(MultiStreamAudioProcessing::Validate(config));
+
+  MultiStreamAudioProcessing processing(config, sample_rate_hz, kNumStreams);
+  ASSERT_EQ(processing.num_streams(), kNumStreams);
+  ASSERT_EQ(processing.num_frames(), static_cast<size_t>(sample_rate_hz / 100));
+
+  std::vector<scoped_refptr<AudioProcessing>> apms;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    apms.push_back(BuiltinAudioProcessingBuilder(config).Build(
+        CreateEnvironment()));
+  }
+
+  const StreamConfig stream_config(sample_rate_hz, /*num_channels=*/1);
+  Random random(42);
+  std::vector<std::vector<float>> frames(
+      kNumStreams, std::vector<float>(processing.num_frames()));
+  std::vector<float*> frame_ptrs;
+  for (auto& frame : frames) {
+    frame_ptrs.push_back(frame.data());
+  }
+  for (int frame_index = 0; frame_index < kNumFramesToProcess; ++frame_index) {
+    std::vector<std::vector<float>> expected(kNumStreams);
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      GenerateFrame(random, frame_index, i, frames[i]);
+      expected[i] = frames[i];
+      float* channel = expected[i].data();
+      ASSERT_EQ(apms[i]->ProcessStream(&channel, stream_config, stream_config,
+                                       &channel),
+                AudioProcessing::kNoError);
+    }
+
+    processing.ProcessStreams(frame_ptrs, frame_ptrs);
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      for (size_t k = 0; k < processing.num_frames(); ++k) {
+        ASSERT_NEAR(frames[i][k], expected[i][k], 1e-6f)
+            << "stream " << i << ", frame " << frame_index;
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    MultiStreamAudioProcessingTest,
+    MultiStreamAudioProcessingTest,
+    ::testing::Combine(::testing::Values(16000, 32000, 48000),
+                       ::testing::Bool(),
+                       ::testing::Bool(),
+                       ::testing::Bool()));
+
+TEST(MultiStreamAudioProcessingConfigTest, RejectsUnsupportedSubmodules) {
+  AudioProcessing::Config config;
+  EXPECT_TRUE(MultiStreamAudioProcessing::Validate(config));
+
+  config.echo_canceller.enabled = true;
+  EXPECT_FALSE(MultiStreamAudioProcessing::Validate(config));
+
+  config = AudioProcessing::Config();
+  config.gain_controller1.enabled = true;
+  EXPECT_FALSE(MultiStreamAudioProcessing::Validate(config));
+
+  config = AudioProcessing::Config();
+  config.high_pass_filter.enabled = true;
+  config.high_pass_filter.apply_in_full_band = false;
+  EXPECT_FALSE(MultiStreamAudioProcessing::Validate(config));
+
+  config = AudioProcessing::Config();
+  config.gain_controller2.enabled = true;
+  config.gain_controller2.input_volume_controller.enabled = true;
+  EXPECT_FALSE(MultiStreamAudioProcessing::Validate(config));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -16,7 +16,6 @@
 
 #include <algorithm>
 
-#include "modules/audio_processing/ns/fast_math.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -146,6 +145,7 @@ float ComputeEnergyOfExtendedFrame(
 
 // Computes the magnitude spectrum based on an FFT output.
 void ComputeMagnitudeSpectrum(
+    const NsVectorMath& vector_math,
     rtc::ArrayView<const float, kFftSize> real,
     rtc::ArrayView<const float, kFftSize> imag,
     rtc::ArrayView<float, kFftSizeBy2Plus1> signal_spectrum) {
@@ -153,10 +153,10 @@ void ComputeMagnitudeSpectrum(
   signal_spectrum[kFftSizeBy2Plus1 - 1] =
       fabsf(real[kFftSizeBy2Plus1 - 1]) + 1.f;
 
-  for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
-    signal_spectrum[i] =
-        SqrtFastApproximation(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
-  }
+  constexpr size_t kNumInnerBins = kFftSizeBy2Plus1 - 2;
+  vector_math.Magnitude(real.subview(1, kNumInnerBins),
+                        imag.subview(1, kNumInnerBins),
+                        signal_spectrum.subview(1, kNumInnerBins));
 }
 
 // Compute prior and post SNR.
@@ -240,9 +240,11 @@ float ComputeUpperBandsGain(
 
 NoiseSuppressor::ChannelState::ChannelState(
     const SuppressionParams& suppression_params,
-    size_t num_bands)
-    : wiener_filter(suppression_params),
-      noise_estimator(suppression_params),
+    size_t num_bands,
+    AvailableCpuFeatures cpu_features)
+    : speech_probability_estimator(cpu_features),
+      wiener_filter(suppression_params, cpu_features),
+      noise_estimator(suppression_params, cpu_features),
       process_delay_memory(num_bands > 1 ? num_bands - 1 : 0) {
   analyze_analysis_memory.fill(0.f);
   prev_analysis_signal_spectrum.fill(1.f);
@@ -256,17 +258,27 @@ NoiseSuppressor::ChannelState::ChannelState(
 NoiseSuppressor::NoiseSuppressor(const NsConfig& config,
                                  size_t sample_rate_hz,
                                  size_t num_channels)
+    : NoiseSuppressor(config,
+                      sample_rate_hz,
+                      num_channels,
+                      GetAvailableCpuFeatures()) {}
+
+NoiseSuppressor::NoiseSuppressor(const NsConfig& config,
+                                 size_t sample_rate_hz,
+                                 size_t num_channels,
+                                 AvailableCpuFeatures cpu_features)
     : num_bands_(NumBandsForRate(sample_rate_hz)),
       num_channels_(num_channels),
       suppression_params_(config.target_level),
+      vector_math_(cpu_features),
       filter_bank_states_heap_(NumChannelsOnHeap(num_channels_)),
       upper_band_gains_heap_(NumChannelsOnHeap(num_channels_)),
       energies_before_filtering_heap_(NumChannelsOnHeap(num_channels_)),
       gain_adjustments_heap_(NumChannelsOnHeap(num_channels_)),
       channels_(num_channels_) {
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    channels_[ch] =
-        std::make_unique<ChannelState>(suppression_params_, num_bands_);
+    channels_[ch] = std::make_unique<ChannelState>(suppression_params_,
+                                                   num_bands_, cpu_features);
   }
 }
 
@@ -339,7 +351,7 @@ void NoiseSuppressor::Analyze(const AudioBuffer& audio) {
     fft_.Fft(extended_frame, real, imag);
 
     std::array<float, kFftSizeBy2Plus1> signal_spectrum;
-    ComputeMagnitudeSpectrum(real, imag, signal_spectrum);
+    ComputeMagnitudeSpectrum(vector_math_, real, imag, signal_spectrum);
 
     // Compute energies.
     float signal_energy = 0.f;
@@ -426,7 +438,7 @@ void NoiseSuppressor::Process(AudioBuffer* audio) {
              filter_bank_states[ch].imag);
 
     std::array<float, kFftSizeBy2Plus1> signal_spectrum;
-    ComputeMagnitudeSpectrum(filter_bank_states[ch].real,
+    ComputeMagnitudeSpectrum(vector_math_, filter_bank_states[ch].real,
                              filter_bank_states[ch].imag, signal_spectrum);
 
     // Compute the frequency domain gain filter for noise attenuation.
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of analyzing and processing one 10 ms frame with the noise
+// suppressor, with and without the optimized per-bin computations.
+
+#include <algorithm>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "modules/audio_processing/agc2/cpu_features.h"
+#include "modules/audio_processing/audio_buffer.h"
+#include "modules/audio_processing/ns/noise_suppressor.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kNumBands = 3;
+constexpr size_t kNumBandFrames = 160;
+// The number of different frames that are processed in turn.
+constexpr int kNumInputFrames = 10;
+
+void RunNoiseSuppressor(benchmark::State& state,
+                        AvailableCpuFeatures cpu_features) {
+  const size_t num_channels = state.range(0);
+  Random random(42);
+  std::vector<std::vector<float>> input(
+      kNumInputFrames, std::vector<float>(kNumBands * kNumBandFrames));
+  for (auto& frame : input) {
+    for (float& sample : frame) {
+      sample = 1000.f * (random.Rand<float>() - 0.5f);
+    }
+  }
+  AudioBuffer audio(kSampleRateHz, num_channels, kSampleRateHz, num_channels,
+                    kSampleRateHz, num_channels);
+  NoiseSuppressor ns(NsConfig(), kSampleRateHz, num_channels, cpu_features);
+  int frame = 0;
+  for (auto _ : state) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      for (size_t b = 0; b < kNumBands; ++b) {
+        std::copy(input[frame].begin() + b * kNumBandFrames,
+                  input[frame].begin() + (b + 1) * kNumBandFrames,
+                  audio.split_bands(ch)[b]);
+      }
+    }
+    ns.Analyze(audio);
+    ns.Process(&audio);
+    benchmark::DoNotOptimize(audio.split_bands(0)[0]);
+    frame = (frame + 1) % kNumInputFrames;
+  }
+}
+
+// The argument is the number of channels.
+void BM_NoiseSuppressorScalar(benchmark::State& state) {
+  RunNoiseSuppressor(state, NoAvailableCpuFeatures());
+}
+BENCHMARK(BM_NoiseSuppressorScalar)->ArgName("channels")->Arg(1)->Arg(2);
+
+// The argument is the number of channels.
+void BM_NoiseSuppressorOptimized(benchmark::State& state) {
+  RunNoiseSuppressor(state, GetAvailableCpuFeatures());
+}
+BENCHMARK(BM_NoiseSuppressorOptimized)->ArgName("channels")->Arg(1)->Arg(2);
+
+}  // namespace
+}  // namespace webrtc
@@ -16,6 +16,8 @@
 #include <utility>
 #include <vector>
 
+#include "modules/audio_processing/agc2/cpu_features.h"
+#include "rtc_base/random.h"
 #include "rtc_base/strings/string_builder.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -61,8 +63,62 @@ void VerifyIdenticalChannels(size_t num_channels,
   }
 }
 
+void PopulateInputFrameWithNoisyTone(size_t num_bands,
+                                     size_t frame_index,
+                                     Random& random,
+                                     AudioBuffer* audio) {
+  for (size_t b = 0; b < num_bands; ++b) {
+    for (size_t i = 0; i < 160; ++i) {
+      // Alternate between 1 s of a square wave in noise and 1 s of noise.
+      float tone = (frame_index * 160 + i) % 40 < 20 ? 1000.f : -1000.f;
+      if ((frame_index / 100) % 2 == 1) {
+        tone = 0.f;
+      }
+      audio->split_bands(0)[b][i] =
+          tone + 300.f * (random.Rand<float>() - 0.5f);
+    }
+  }
+}
+
 }  // namespace
 
+// Verifies that the output does not depend on which CPU features are used.
+TEST(NoiseSuppressor, BitExactWithAndWithoutCpuFeatures) {
+  for (auto rate : {16000, 48000}) {
+    SCOPED_TRACE(rate);
+    const size_t num_bands = rate / 16000;
+    AudioBuffer reference_audio(rate, 1, rate, 1, rate, 1);
+    AudioBuffer audio(rate, 1, rate, 1, rate, 1);
+    NsConfig cfg;
+    NoiseSuppressor reference_ns(cfg, rate, /*num_channels=*/1,
+                                 NoAvailableCpuFeatures());
+    NoiseSuppressor ns(cfg, rate, /*num_channels=*/1,
+                       GetAvailableCpuFeatures());
+    Random reference_random(42);
+    Random random(42);
+    for (size_t frame_index = 0; frame_index < 500; ++frame_index) {
+      if (rate > 16000) {
+        reference_audio.SplitIntoFrequencyBands();
+        audio.SplitIntoFrequencyBands();
+      }
+      PopulateInputFrameWithNoisyTone(num_bands, frame_index, reference_random,
+                                      &reference_audio);
+      PopulateInputFrameWithNoisyTone(num_bands, frame_index, random, &audio);
+
+      reference_ns.Analyze(reference_audio);
+      reference_ns.Process(&reference_audio);
+      ns.Analyze(audio);
+      ns.Process(&audio);
+      for (size_t b = 0; b < num_bands; ++b) {
+        for (size_t i = 0; i < 160; ++i) {
+          ASSERT_EQ(audio.split_bands_const(0)[b][i],
+                    reference_audio.split_bands_const(0)[b][i]);
+        }
+      }
+    }
+  }
+}
+
 // Verifies that the same noise reduction effect is applied to all channels.
 TEST(NoiseSuppressor, IdenticalChannelEffects) {
   for (auto rate : {16000, 32000, 48000}) {
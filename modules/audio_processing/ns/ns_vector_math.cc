@@ -0,0 +1,448 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/ns/ns_vector_math.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#include <math.h>
+
+#include <algorithm>
+
+#include "modules/audio_processing/ns/fast_math.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+// Constants of `LogApproximation()`, see fast_math.cc.
+constexpr float kOneBy2Pow23 = 1.1920929e-7f;
+constexpr float kLog2Bias = 126.942695f;
+constexpr float kLogOf2 = 0.69314718056f;
+
+// Width of the density estimate of the quantile noise estimator.
+constexpr float kWidth = 0.01f;
+constexpr float kOneByWidthPlus2 = 1.f / (2.f * kWidth);
+
+float WienerFilterGain(float prev_signal_spectrum,
+                       float prev_noise_spectrum,
+                       float signal_spectrum,
+                       float noise_spectrum,
+                       float prev_filter,
+                       float over_subtraction_factor,
+                       float minimum_attenuating_gain) {
+  // Previous estimate based on previous frame with gain filter.
+  float prev_tsa =
+      prev_signal_spectrum / (prev_noise_spectrum + 0.0001f) * prev_filter;
+
+  // Current estimate.
+  float current_tsa;
+  if (signal_spectrum > noise_spectrum) {
+    current_tsa = signal_spectrum / (noise_spectrum + 0.0001f) - 1.f;
+  } else {
+    current_tsa = 0.f;
+  }
+
+  // Directed decision estimate is sum of two terms: current estimate and
+  // previous estimate.
+  float snr_prior = 0.98f * prev_tsa + (1.f - 0.98f) * current_tsa;
+  float filter = snr_prior / (over_subtraction_factor + snr_prior);
+  return std::max(std::min(filter, 1.f), minimum_attenuating_gain);
+}
+
+void UpdateQuantile(float log_spectrum,
+                    float counter,
+                    float one_by_counter_plus_1,
+                    float& log_quantile,
+                    float& density) {
+  // Update log quantile estimate.
+  const float delta = density > 1.f ? 40.f / density : 40.f;
+
+  const float multiplier = delta * one_by_counter_plus_1;
+  if (log_spectrum > log_quantile) {
+    log_quantile += 0.25f * multiplier;
+  } else {
+    log_quantile -= 0.75f * multiplier;
+  }
+
+  // Update density estimate.
+  if (fabsf(log_spectrum - log_quantile) < kWidth) {
+    density = (counter * density + kOneByWidthPlus2) * one_by_counter_plus_1;
+  }
+}
+
+float UpdatedAvgLogLrt(float prior_snr, float post_snr, float avg_log_lrt) {
+  float tmp1 = 1.f + 2.f * prior_snr;
+  float tmp2 = 2.f * prior_snr / (tmp1 + 0.0001f);
+  float bessel_tmp = (post_snr + 1.f) * tmp2;
+  return avg_log_lrt +
+         .5f * (bessel_tmp - LogApproximation(tmp1) - avg_log_lrt);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Returns `a` where `mask` is set and `b` elsewhere.
+__m128 Select(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+__m128 LogSse2(__m128 x) {
+  // Interpret the float bits as an integer, which is converted to float.
+  __m128 log = _mm_cvtepi32_ps(_mm_castps_si128(x));
+  log = _mm_mul_ps(log, _mm_set1_ps(kOneBy2Pow23));
+  log = _mm_sub_ps(log, _mm_set1_ps(kLog2Bias));
+  return _mm_mul_ps(log, _mm_set1_ps(kLogOf2));
+}
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+float32x4_t LogNeon(float32x4_t x) {
+  // Interpret the float bits as an integer, which is converted to float.
+  float32x4_t log = vcvtq_f32_u32(vreinterpretq_u32_f32(x));
+  log = vmulq_f32(log, vdupq_n_f32(kOneBy2Pow23));
+  log = vsubq_f32(log, vdupq_n_f32(kLog2Bias));
+  return vmulq_f32(log, vdupq_n_f32(kLogOf2));
+}
+#endif
+
+}  // namespace
+
+void NsVectorMath::Log(rtc::ArrayView<const float> x,
+                       rtc::ArrayView<float> y) const {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (cpu_features_.avx2) {
+    i = LogAvx2(x, y);
+  } else if (cpu_features_.sse2) {
+    for (; i + 4 <= x.size(); i += 4) {
+      _mm_storeu_ps(&y[i], LogSse2(_mm_loadu_ps(&x[i])));
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  if (cpu_features_.neon) {
+    for (; i + 4 <= x.size(); i += 4) {
+      vst1q_f32(&y[i], LogNeon(vld1q_f32(&x[i])));
+    }
+  }
+#endif
+  for (; i < x.size(); ++i) {
+    y[i] = LogApproximation(x[i]);
+  }
+}
+
+void NsVectorMath::Magnitude(rtc::ArrayView<const float> real,
+                             rtc::ArrayView<const float> imag,
+                             rtc::ArrayView<float> magnitude) const {
+  RTC_DCHECK_EQ(real.size(), magnitude.size());
+  RTC_DCHECK_EQ(imag.size(), magnitude.size());
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (cpu_features_.avx2) {
+    i = MagnitudeAvx2(real, imag, magnitude);
+  } else if (cpu_features_.sse2) {
+    const __m128 one = _mm_set1_ps(1.f);
+    for (; i + 4 <= magnitude.size(); i += 4) {
+      const __m128 re = _mm_loadu_ps(&real[i]);
+      const __m128 im = _mm_loadu_ps(&imag[i]);
+      const __m128 power = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+      _mm_storeu_ps(&magnitude[i], _mm_add_ps(_mm_sqrt_ps(power), one));
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  if (cpu_features_.neon) {
+    const float32x4_t one = vdupq_n_f32(1.f);
+    for (; i + 4 <= magnitude.size(); i += 4) {
+      const float32x4_t re = vld1q_f32(&real[i]);
+      const float32x4_t im = vld1q_f32(&imag[i]);
+      const float32x4_t power =
+          vaddq_f32(vmulq_f32(re, re), vmulq_f32(im, im));
+      vst1q_f32(&magnitude[i], vaddq_f32(vsqrtq_f32(power), one));
+    }
+  }
+#endif
+  for (; i < magnitude.size(); ++i) {
+    magnitude[i] =
+        SqrtFastApproximation(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+void NsVectorMath::UpdateWienerFilter(
+    rtc::ArrayView<const float> prev_signal_spectrum,
+    rtc::ArrayView<const float> prev_noise_spectrum,
+    rtc::ArrayView<const float> signal_spectrum,
+    rtc::ArrayView<const float> noise_spectrum,
+    float over_subtraction_factor,
+    float minimum_attenuating_gain,
+    rtc::ArrayView<float> filter) const {
+  RTC_DCHECK_EQ(prev_signal_spectrum.size(), filter.size());
+  RTC_DCHECK_EQ(prev_noise_spectrum.size(), filter.size());
+  RTC_DCHECK_EQ(signal_spectrum.size(), filter.size());
+  RTC_DCHECK_EQ(noise_spectrum.size(), filter.size());
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (cpu_features_.avx2) {
+    i = UpdateWienerFilterAvx2(prev_signal_spectrum, prev_noise_spectrum,
+                               signal_spectrum, noise_spectrum,
+                               over_subtraction_factor,
+                               minimum_attenuating_gain, filter);
+  } else if (cpu_features_.sse2) {
+    const __m128 regularization = _mm_set1_ps(0.0001f);
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 prev_weight = _mm_set1_ps(0.98f);
+    const __m128 current_weight = _mm_set1_ps(1.f - 0.98f);
+    const __m128 over_subtraction = _mm_set1_ps(over_subtraction_factor);
+    const __m128 min_gain = _mm_set1_ps(minimum_attenuating_gain);
+    for (; i + 4 <= filter.size(); i += 4) {
+      const __m128 signal = _mm_loadu_ps(&signal_spectrum[i]);
+      const __m128 noise = _mm_loadu_ps(&noise_spectrum[i]);
+      const __m128 prev_tsa = _mm_mul_ps(
+          _mm_div_ps(_mm_loadu_ps(&prev_signal_spectrum[i]),
+                     _mm_add_ps(_mm_loadu_ps(&prev_noise_spectrum[i]),
+                                regularization)),
+          _mm_loadu_ps(&filter[i]));
+      __m128 current_tsa = _mm_sub_ps(
+          _mm_div_ps(signal, _mm_add_ps(noise, regularization)), one);
+      current_tsa = _mm_and_ps(_mm_cmpgt_ps(signal, noise), current_tsa);
+      const __m128 snr_prior =
+          _mm_add_ps(_mm_mul_ps(prev_weight, prev_tsa),
+                     _mm_mul_ps(current_weight, current_tsa));
+      __m128 gain =
+          _mm_div_ps(snr_prior, _mm_add_ps(over_subtraction, snr_prior));
+      gain = _mm_max_ps(_mm_min_ps(gain, one), min_gain);
+      _mm_storeu_ps(&filter[i], gain);
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  if (cpu_features_.neon) {
+    const float32x4_t regularization = vdupq_n_f32(0.0001f);
+    const float32x4_t one = vdupq_n_f32(1.f);
+    const float32x4_t prev_weight = vdupq_n_f32(0.98f);
+    const float32x4_t current_weight = vdupq_n_f32(1.f - 0.98f);
+    const float32x4_t over_subtraction = vdupq_n_f32(over_subtraction_factor);
+    const float32x4_t min_gain = vdupq_n_f32(minimum_attenuating_gain);
+    for (; i + 4 <= filter.size(); i += 4) {
+      const float32x4_t signal = vld1q_f32(&signal_spectrum[i]);
+      const float32x4_t noise = vld1q_f32(&noise_spectrum[i]);
+      const float32x4_t prev_tsa = vmulq_f32(
+          vdivq_f32(vld1q_f32(&prev_signal_spectrum[i]),
+                    vaddq_f32(vld1q_f32(&prev_noise_spectrum[i]),
+                              regularization)),
+          vld1q_f32(&filter[i]));
+      float32x4_t current_tsa =
+          vsubq_f32(vdivq_f32(signal, vaddq_f32(noise, regularization)), one);
+      current_tsa = vreinterpretq_f32_u32(vandq_u32(
+          vcgtq_f32(signal, noise), vreinterpretq_u32_f32(current_tsa)));
+      const float32x4_t snr_prior =
+          vaddq_f32(vmulq_f32(prev_weight, prev_tsa),
+                    vmulq_f32(current_weight, current_tsa));
+      float32x4_t gain =
+          vdivq_f32(snr_prior, vaddq_f32(over_subtraction, snr_prior));
+      gain = vmaxq_f32(vminq_f32(gain, one), min_gain);
+      vst1q_f32(&filter[i], gain);
+    }
+  }
+#endif
+  for (; i < filter.size(); ++i) {
+    filter[i] = WienerFilterGain(prev_signal_spectrum[i],
+                                 prev_noise_spectrum[i], signal_spectrum[i],
+                                 noise_spectrum[i], filter[i],
+                                 over_subtraction_factor,
+                                 minimum_attenuating_gain);
+  }
+}
+
+void NsVectorMath::UpdateQuantiles(rtc::ArrayView<const float> log_spectrum,
+                                   float counter,
+                                   rtc::ArrayView<float> log_quantile,
+                                   rtc::ArrayView<float> density) const {
+  RTC_DCHECK_EQ(log_spectrum.size(), log_quantile.size());
+  RTC_DCHECK_EQ(log_spectrum.size(), density.size());
+  const float one_by_counter_plus_1 = 1.f / (counter + 1.f);
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (cpu_features_.avx2) {
+    i = UpdateQuantilesAvx2(log_spectrum, counter, log_quantile, density);
+  } else if (cpu_features_.sse2) {
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 forty = _mm_set1_ps(40.f);
+    const __m128 up_step = _mm_set1_ps(0.25f);
+    const __m128 down_step = _mm_set1_ps(0.75f);
+    const __m128 width = _mm_set1_ps(kWidth);
+    const __m128 one_by_width_plus_2 = _mm_set1_ps(kOneByWidthPlus2);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 counter_ps = _mm_set1_ps(counter);
+    const __m128 one_by_counter_plus_1_ps = _mm_set1_ps(one_by_counter_plus_1);
+    for (; i + 4 <= log_spectrum.size(); i += 4) {
+      const __m128 log_spectrum_i = _mm_loadu_ps(&log_spectrum[i]);
+      __m128 log_quantile_i = _mm_loadu_ps(&log_quantile[i]);
+      __m128 density_i = _mm_loadu_ps(&density[i]);
+
+      // Update log quantile estimate.
+      const __m128 delta = Select(_mm_cmpgt_ps(density_i, one),
+                                  _mm_div_ps(forty, density_i), forty);
+      const __m128 multiplier = _mm_mul_ps(delta, one_by_counter_plus_1_ps);
+      log_quantile_i =
+          Select(_mm_cmpgt_ps(log_spectrum_i, log_quantile_i),
+                 _mm_add_ps(log_quantile_i, _mm_mul_ps(up_step, multiplier)),
+                 _mm_sub_ps(log_quantile_i, _mm_mul_ps(down_step, multiplier)));
+
+      // Update density estimate.
+      const __m128 distance =
+          _mm_and_ps(_mm_sub_ps(log_spectrum_i, log_quantile_i), abs_mask);
+      const __m128 updated_density = _mm_mul_ps(
+          _mm_add_ps(_mm_mul_ps(counter_ps, density_i), one_by_width_plus_2),
+          one_by_counter_plus_1_ps);
+      density_i =
+          Select(_mm_cmplt_ps(distance, width), updated_density, density_i);
+
+      _mm_storeu_ps(&log_quantile[i], log_quantile_i);
+      _mm_storeu_ps(&density[i], density_i);
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  if (cpu_features_.neon) {
+    const float32x4_t one = vdupq_n_f32(1.f);
+    const float32x4_t forty = vdupq_n_f32(40.f);
+    const float32x4_t up_step = vdupq_n_f32(0.25f);
+    const float32x4_t down_step = vdupq_n_f32(0.75f);
+    const float32x4_t width = vdupq_n_f32(kWidth);
+    const float32x4_t one_by_width_plus_2 = vdupq_n_f32(kOneByWidthPlus2);
+    const float32x4_t counter_f32 = vdupq_n_f32(counter);
+    const float32x4_t one_by_counter_plus_1_f32 =
+        vdupq_n_f32(one_by_counter_plus_1);
+    for (; i + 4 <= log_spectrum.size(); i += 4) {
+      const float32x4_t log_spectrum_i = vld1q_f32(&log_spectrum[i]);
+      float32x4_t log_quantile_i = vld1q_f32(&log_quantile[i]);
+      float32x4_t density_i = vld1q_f32(&density[i]);
+
+      // Update log quantile estimate.
+      const float32x4_t delta = vbslq_f32(vcgtq_f32(density_i, one),
+                                          vdivq_f32(forty, density_i), forty);
+      const float32x4_t multiplier =
+          vmulq_f32(delta, one_by_counter_plus_1_f32);
+      log_quantile_i = vbslq_f32(
+          vcgtq_f32(log_spectrum_i, log_quantile_i),
+          vaddq_f32(log_quantile_i, vmulq_f32(up_step, multiplier)),
+          vsubq_f32(log_quantile_i, vmulq_f32(down_step, multiplier)));
+
+      // Update density estimate.
+      const float32x4_t distance =
+          vabsq_f32(vsubq_f32(log_spectrum_i, log_quantile_i));
+      const float32x4_t updated_density = vmulq_f32(
+          vaddq_f32(vmulq_f32(counter_f32, density_i), one_by_width_plus_2),
+          one_by_counter_plus_1_f32);
+      density_i =
+          vbslq_f32(vcltq_f32(distance, width), updated_density, density_i);
+
+      vst1q_f32(&log_quantile[i], log_quantile_i);
+      vst1q_f32(&density[i], density_i);
+    }
+  }
+#endif
+  for (; i < log_spectrum.size(); ++i) {
+    UpdateQuantile(log_spectrum[i], counter, one_by_counter_plus_1,
+                   log_quantile[i], density[i]);
+  }
+}
+
+void NsVectorMath::UpdateAvgLogLrt(rtc::ArrayView<const float> prior_snr,
+                                   rtc::ArrayView<const float> post_snr,
+                                   rtc::ArrayView<float> avg_log_lrt) const {
+  RTC_DCHECK_EQ(prior_snr.size(), avg_log_lrt.size());
+  RTC_DCHECK_EQ(post_snr.size(), avg_log_lrt.size());
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (cpu_features_.avx2) {
+    i = UpdateAvgLogLrtAvx2(prior_snr, post_snr, avg_log_lrt);
+  } else if (cpu_features_.sse2) {
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 two = _mm_set1_ps(2.f);
+    const __m128 half = _mm_set1_ps(.5f);
+    const __m128 regularization = _mm_set1_ps(0.0001f);
+    for (; i + 4 <= avg_log_lrt.size(); i += 4) {
+      const __m128 prior_snr_i = _mm_loadu_ps(&prior_snr[i]);
+      __m128 avg_log_lrt_i = _mm_loadu_ps(&avg_log_lrt[i]);
+      const __m128 tmp1 = _mm_add_ps(one, _mm_mul_ps(two, prior_snr_i));
+      const __m128 tmp2 = _mm_div_ps(_mm_mul_ps(two, prior_snr_i),
+                                     _mm_add_ps(tmp1, regularization));
+      const __m128 bessel_tmp =
+          _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&post_snr[i]), one), tmp2);
+      const __m128 update = _mm_sub_ps(
+          _mm_sub_ps(bessel_tmp, LogSse2(tmp1)), avg_log_lrt_i);
+      avg_log_lrt_i = _mm_add_ps(avg_log_lrt_i, _mm_mul_ps(half, update));
+      _mm_storeu_ps(&avg_log_lrt[i], avg_log_lrt_i);
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  if (cpu_features_.neon) {
+    const float32x4_t one = vdupq_n_f32(1.f);
+    const float32x4_t two = vdupq_n_f32(2.f);
+    const float32x4_t half = vdupq_n_f32(.5f);
+    const float32x4_t regularization = vdupq_n_f32(0.0001f);
+    for (; i + 4 <= avg_log_lrt.size(); i += 4) {
+      const float32x4_t prior_snr_i = vld1q_f32(&prior_snr[i]);
+      float32x4_t avg_log_lrt_i = vld1q_f32(&avg_log_lrt[i]);
+      const float32x4_t tmp1 = vaddq_f32(one, vmulq_f32(two, prior_snr_i));
+      const float32x4_t tmp2 = vdivq_f32(vmulq_f32(two, prior_snr_i),
+                                         vaddq_f32(tmp1, regularization));
+      const float32x4_t bessel_tmp =
+          vmulq_f32(vaddq_f32(vld1q_f32(&post_snr[i]), one), tmp2);
+      const float32x4_t update =
+          vsubq_f32(vsubq_f32(bessel_tmp, LogNeon(tmp1)), avg_log_lrt_i);
+      avg_log_lrt_i = vaddq_f32(avg_log_lrt_i, vmulq_f32(half, update));
+      vst1q_f32(&avg_log_lrt[i], avg_log_lrt_i);
+    }
+  }
+#endif
+  for (; i < avg_log_lrt.size(); ++i) {
+    avg_log_lrt[i] =
+        UpdatedAvgLogLrt(prior_snr[i], post_snr[i], avg_log_lrt[i]);
+  }
+}
+
+void NsVectorMath::SpeechProbability(float gain_prior,
+                                     rtc::ArrayView<const float> inv_lrt,
+                                     rtc::ArrayView<float> probability) const {
+  RTC_DCHECK_EQ(inv_lrt.size(), probability.size());
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (cpu_features_.avx2) {
+    i = SpeechProbabilityAvx2(gain_prior, inv_lrt, probability);
+  } else if (cpu_features_.sse2) {
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 gain = _mm_set1_ps(gain_prior);
+    for (; i + 4 <= probability.size(); i += 4) {
+      const __m128 denominator =
+          _mm_add_ps(one, _mm_mul_ps(gain, _mm_loadu_ps(&inv_lrt[i])));
+      _mm_storeu_ps(&probability[i], _mm_div_ps(one, denominator));
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  if (cpu_features_.neon) {
+    const float32x4_t one = vdupq_n_f32(1.f);
+    const float32x4_t gain = vdupq_n_f32(gain_prior);
+    for (; i + 4 <= probability.size(); i += 4) {
+      const float32x4_t denominator =
+          vaddq_f32(one, vmulq_f32(gain, vld1q_f32(&inv_lrt[i])));
+      vst1q_f32(&probability[i], vdivq_f32(one, denominator));
+    }
+  }
+#endif
+  for (; i < probability.size(); ++i) {
+    probability[i] = 1.f / (1.f + gain_prior * inv_lrt[i]);
+  }
+}
+
+}  // namespace webrtc
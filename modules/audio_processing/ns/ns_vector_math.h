@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_NS_NS_VECTOR_MATH_H_
+#define MODULES_AUDIO_PROCESSING_NS_NS_VECTOR_MATH_H_
+
+#include <stddef.h>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/agc2/cpu_features.h"
+
+namespace webrtc {
+
+// Provides optimized versions of the per-bin computations of the noise
+// suppressor. The optimized versions produce the same results, bit by bit, as
+// the scalar code.
+class NsVectorMath {
+ public:
+  explicit NsVectorMath(AvailableCpuFeatures cpu_features)
+      : cpu_features_(cpu_features) {}
+
+  // Computes y = LogApproximation(x) elementwise.
+  void Log(rtc::ArrayView<const float> x, rtc::ArrayView<float> y) const;
+
+  // Computes magnitude = sqrt(real^2 + imag^2) + 1 elementwise.
+  void Magnitude(rtc::ArrayView<const float> real,
+                 rtc::ArrayView<const float> imag,
+                 rtc::ArrayView<float> magnitude) const;
+
+  // Updates `filter` with the decision directed estimate of the prior SNR,
+  // limited to [`minimum_attenuating_gain`, 1].
+  void UpdateWienerFilter(rtc::ArrayView<const float> prev_signal_spectrum,
+                          rtc::ArrayView<const float> prev_noise_spectrum,
+                          rtc::ArrayView<const float> signal_spectrum,
+                          rtc::ArrayView<const float> noise_spectrum,
+                          float over_subtraction_factor,
+                          float minimum_attenuating_gain,
+                          rtc::ArrayView<float> filter) const;
+
+  // Updates one of the simultaneous log quantile and density estimates of the
+  // quantile noise estimator, which has been updated `counter` times.
+  void UpdateQuantiles(rtc::ArrayView<const float> log_spectrum,
+                       float counter,
+                       rtc::ArrayView<float> log_quantile,
+                       rtc::ArrayView<float> density) const;
+
+  // Updates the time-averaged log likelihood ratio per bin.
+  void UpdateAvgLogLrt(rtc::ArrayView<const float> prior_snr,
+                       rtc::ArrayView<const float> post_snr,
+                       rtc::ArrayView<float> avg_log_lrt) const;
+
+  // Computes probability = 1 / (1 + gain_prior * inv_lrt) elementwise.
+  void SpeechProbability(float gain_prior,
+                         rtc::ArrayView<const float> inv_lrt,
+                         rtc::ArrayView<float> probability) const;
+
+ private:
+  // The AVX2 versions process the elements in blocks of 8 and return the
+  // number of processed elements; the remaining ones are processed by the
+  // scalar code.
+  size_t LogAvx2(rtc::ArrayView<const float> x, rtc::ArrayView<float> y) const;
+  size_t MagnitudeAvx2(rtc::ArrayView<const float> real,
+                       rtc::ArrayView<const float> imag,
+                       rtc::ArrayView<float> magnitude) const;
+  size_t UpdateWienerFilterAvx2(
+      rtc::ArrayView<const float> prev_signal_spectrum,
+      rtc::ArrayView<const float> prev_noise_spectrum,
+      rtc::ArrayView<const float> signal_spectrum,
+      rtc::ArrayView<const float> noise_spectrum,
+      float over_subtraction_factor,
+      float minimum_attenuating_gain,
+      rtc::ArrayView<float> filter) const;
+  size_t UpdateQuantilesAvx2(rtc::ArrayView<const float> log_spectrum,
+                             float counter,
+                             rtc::ArrayView<float> log_quantile,
+                             rtc::ArrayView<float> density) const;
+  size_t UpdateAvgLogLrtAvx2(rtc::ArrayView<const float> prior_snr,
+                             rtc::ArrayView<const float> post_snr,
+                             rtc::ArrayView<float> avg_log_lrt) const;
+  size_t SpeechProbabilityAvx2(float gain_prior,
+                               rtc::ArrayView<const float> inv_lrt,
+                               rtc::ArrayView<float> probability) const;
+
+  const AvailableCpuFeatures cpu_features_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_NS_NS_VECTOR_MATH_H_
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/ns/ns_vector_math.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+// Constants of `LogApproximation()`, see fast_math.cc.
+constexpr float kOneBy2Pow23 = 1.1920929e-7f;
+constexpr float kLog2Bias = 126.942695f;
+constexpr float kLogOf2 = 0.69314718056f;
+
+// Width of the density estimate of the quantile noise estimator.
+constexpr float kWidth = 0.01f;
+constexpr float kOneByWidthPlus2 = 1.f / (2.f * kWidth);
+
+// Note that no fused multiply-add instructions are used, since they would
+// change the results compared to the scalar code.
+
+__m256 LogApproximationAvx2(__m256 x) {
+  // Interpret the float bits as an integer, which is converted to float.
+  __m256 log = _mm256_cvtepi32_ps(_mm256_castps_si256(x));
+  log = _mm256_mul_ps(log, _mm256_set1_ps(kOneBy2Pow23));
+  log = _mm256_sub_ps(log, _mm256_set1_ps(kLog2Bias));
+  return _mm256_mul_ps(log, _mm256_set1_ps(kLogOf2));
+}
+
+}  // namespace
+
+size_t NsVectorMath::LogAvx2(rtc::ArrayView<const float> x,
+                             rtc::ArrayView<float> y) const {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  size_t i = 0;
+  for (; i + 8 <= x.size(); i += 8) {
+    _mm256_storeu_ps(&y[i], LogApproximationAvx2(_mm256_loadu_ps(&x[i])));
+  }
+  return i;
+}
+
+size_t NsVectorMath::MagnitudeAvx2(rtc::ArrayView<const float> real,
+                                   rtc::ArrayView<const float> imag,
+                                   rtc::ArrayView<float> magnitude) const {
+  RTC_DCHECK_EQ(real.size(), magnitude.size());
+  RTC_DCHECK_EQ(imag.size(), magnitude.size());
+  const __m256 one = _mm256_set1_ps(1.f);
+  size_t i = 0;
+  for (; i + 8 <= magnitude.size(); i += 8) {
+    const __m256 re = _mm256_loadu_ps(&real[i]);
+    const __m256 im = _mm256_loadu_ps(&imag[i]);
+    const __m256 power =
+        _mm256_add_ps(_mm256_mul_ps(re, re), _mm256_mul_ps(im, im));
+    _mm256_storeu_ps(&magnitude[i], _mm256_add_ps(_mm256_sqrt_ps(power), one));
+  }
+  return i;
+}
+
+size_t NsVectorMath::UpdateWienerFilterAvx2(
+    rtc::ArrayView<const float> prev_signal_spectrum,
+    rtc::ArrayView<const float> prev_noise_spectrum,
+    rtc::ArrayView<const float> signal_spectrum,
+    rtc::ArrayView<const float> noise_spectrum,
+    float over_subtraction_factor,
+    float minimum_attenuating_gain,
+    rtc::ArrayView<float> filter) const {
+  const __m256 regularization = _mm256_set1_ps(0.0001f);
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 prev_weight = _mm256_set1_ps(0.98f);
+  const __m256 current_weight = _mm256_set1_ps(1.f - 0.98f);
+  const __m256 over_subtraction = _mm256_set1_ps(over_subtraction_factor);
+  const __m256 min_gain = _mm256_set1_ps(minimum_attenuating_gain);
+  size_t i = 0;
+  for (; i + 8 <= filter.size(); i += 8) {
+    const __m256 signal = _mm256_loadu_ps(&signal_spectrum[i]);
+    const __m256 noise = _mm256_loadu_ps(&noise_spectrum[i]);
+    const __m256 prev_tsa = _mm256_mul_ps(
+        _mm256_div_ps(_mm256_loadu_ps(&prev_signal_spectrum[i]),
+                      _mm256_add_ps(_mm256_loadu_ps(&prev_noise_spectrum[i]),
+                                    regularization)),
+        _mm256_loadu_ps(&filter[i]));
+    __m256 current_tsa = _mm256_sub_ps(
+        _mm256_div_ps(signal, _mm256_add_ps(noise, regularization)), one);
+    current_tsa = _mm256_and_ps(_mm256_cmp_ps(signal, noise, _CMP_GT_OQ),
+                                current_tsa);
+    const __m256 snr_prior =
+        _mm256_add_ps(_mm256_mul_ps(prev_weight, prev_tsa),
+                      _mm256_mul_ps(current_weight, current_tsa));
+    __m256 gain =
+        _mm256_div_ps(snr_prior, _mm256_add_ps(over_subtraction, snr_prior));
+    gain = _mm256_max_ps(_mm256_min_ps(gain, one), min_gain);
+    _mm256_storeu_ps(&filter[i], gain);
+  }
+  return i;
+}
+
+size_t NsVectorMath::UpdateQuantilesAvx2(
+    rtc::ArrayView<const float> log_spectrum,
+    float counter,
+    rtc::ArrayView<float> log_quantile,
+    rtc::ArrayView<float> density) const {
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 forty = _mm256_set1_ps(40.f);
+  const __m256 up_step = _mm256_set1_ps(0.25f);
+  const __m256 down_step = _mm256_set1_ps(0.75f);
+  const __m256 width = _mm256_set1_ps(kWidth);
+  const __m256 one_by_width_plus_2 = _mm256_set1_ps(kOneByWidthPlus2);
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  const __m256 counter_ps = _mm256_set1_ps(counter);
+  const __m256 one_by_counter_plus_1 = _mm256_set1_ps(1.f / (counter + 1.f));
+  size_t i = 0;
+  for (; i + 8 <= log_spectrum.size(); i += 8) {
+    const __m256 log_spectrum_i = _mm256_loadu_ps(&log_spectrum[i]);
+    __m256 log_quantile_i = _mm256_loadu_ps(&log_quantile[i]);
+    __m256 density_i = _mm256_loadu_ps(&density[i]);
+
+    // Update log quantile estimate.
+    const __m256 delta =
+        _mm256_blendv_ps(forty, _mm256_div_ps(forty, density_i),
+                         _mm256_cmp_ps(density_i, one, _CMP_GT_OQ));
+    const __m256 multiplier = _mm256_mul_ps(delta, one_by_counter_plus_1);
+    log_quantile_i = _mm256_blendv_ps(
+        _mm256_sub_ps(log_quantile_i, _mm256_mul_ps(down_step, multiplier)),
+        _mm256_add_ps(log_quantile_i, _mm256_mul_ps(up_step, multiplier)),
+        _mm256_cmp_ps(log_spectrum_i, log_quantile_i, _CMP_GT_OQ));
+
+    // Update density estimate.
+    const __m256 distance =
+        _mm256_and_ps(_mm256_sub_ps(log_spectrum_i, log_quantile_i), abs_mask);
+    const __m256 updated_density = _mm256_mul_ps(
+        _mm256_add_ps(_mm256_mul_ps(counter_ps, density_i),
+                      one_by_width_plus_2),
+        one_by_counter_plus_1);
+    density_i = _mm256_blendv_ps(density_i, updated_density,
+                                 _mm256_cmp_ps(distance, width, _CMP_LT_OQ));
+
+    _mm256_storeu_ps(&log_quantile[i], log_quantile_i);
+    _mm256_storeu_ps(&density[i], density_i);
+  }
+  return i;
+}
+
+size_t NsVectorMath::UpdateAvgLogLrtAvx2(
+    rtc::ArrayView<const float> prior_snr,
+    rtc::ArrayView<const float> post_snr,
+    rtc::ArrayView<float> avg_log_lrt) const {
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 two = _mm256_set1_ps(2.f);
+  const __m256 half = _mm256_set1_ps(.5f);
+  const __m256 regularization = _mm256_set1_ps(0.0001f);
+  size_t i = 0;
+  for (; i + 8 <= avg_log_lrt.size(); i += 8) {
+    const __m256 prior_snr_i = _mm256_loadu_ps(&prior_snr[i]);
+    __m256 avg_log_lrt_i = _mm256_loadu_ps(&avg_log_lrt[i]);
+    const __m256 tmp1 = _mm256_add_ps(one, _mm256_mul_ps(two, prior_snr_i));
+    const __m256 tmp2 = _mm256_div_ps(_mm256_mul_ps(two, prior_snr_i),
+                                      _mm256_add_ps(tmp1, regularization));
+    const __m256 bessel_tmp =
+        _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&post_snr[i]), one), tmp2);
+    const __m256 update = _mm256_sub_ps(
+        _mm256_sub_ps(bessel_tmp, LogApproximationAvx2(tmp1)), avg_log_lrt_i);
+    avg_log_lrt_i = _mm256_add_ps(avg_log_lrt_i, _mm256_mul_ps(half, update));
+    _mm256_storeu_ps(&avg_log_lrt[i], avg_log_lrt_i);
+  }
+  return i;
+}
+
+size_t NsVectorMath::SpeechProbabilityAvx2(
+    float gain_prior,
+    rtc::ArrayView<const float> inv_lrt,
+    rtc::ArrayView<float> probability) const {
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 gain = _mm256_set1_ps(gain_prior);
+  size_t i = 0;
+  for (; i + 8 <= probability.size(); i += 8) {
+    const __m256 denominator =
+        _mm256_add_ps(one, _mm256_mul_ps(gain, _mm256_loadu_ps(&inv_lrt[i])));
+    _mm256_storeu_ps(&probability[i], _mm256_div_ps(one, denominator));
+  }
+  return i;
+}
+
+}  // namespace webrtc
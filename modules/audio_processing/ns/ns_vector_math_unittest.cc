@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/ns/ns_vector_math.h"
+
+#include <array>
+#include <vector>
+
+#include "modules/audio_processing/agc2/cpu_features.h"
+#include "modules/audio_processing/ns/ns_common.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// Tests a size which is not a multiple of the SIMD widths, as in the noise
+// suppressor.
+constexpr size_t kSize = kFftSizeBy2Plus1;
+constexpr int kNumIterations = 100;
+
+using Vector = std::array<float, kSize>;
+
+void FillRandom(Random& random, float min, float max, Vector& v) {
+  for (float& x : v) {
+    x = min + (max - min) * random.Rand<float>();
+  }
+}
+
+class NsVectorMathParametrization
+    : public ::testing::TestWithParam<AvailableCpuFeatures> {};
+
+// Verifies that the optimized versions produce the same results as the scalar
+// code, bit by bit.
+
+TEST_P(NsVectorMathParametrization, LogIsBitExact) {
+  const NsVectorMath scalar(NoAvailableCpuFeatures());
+  const NsVectorMath optimized(/*cpu_features=*/GetParam());
+  Random random(42);
+  Vector x, expected, y;
+  for (int k = 0; k < kNumIterations; ++k) {
+    FillRandom(random, 1e-3f, 1e6f, x);
+    scalar.Log(x, expected);
+    optimized.Log(x, y);
+    for (size_t i = 0; i < kSize; ++i) {
+      ASSERT_EQ(y[i], expected[i]) << "index " << i;
+    }
+  }
+}
+
+TEST_P(NsVectorMathParametrization, MagnitudeIsBitExact) {
+  const NsVectorMath scalar(NoAvailableCpuFeatures());
+  const NsVectorMath optimized(/*cpu_features=*/GetParam());
+  Random random(42);
+  Vector real, imag, expected, magnitude;
+  for (int k = 0; k < kNumIterations; ++k) {
+    FillRandom(random, -3e4f, 3e4f, real);
+    FillRandom(random, -3e4f, 3e4f, imag);
+    scalar.Magnitude(real, imag, expected);
+    optimized.Magnitude(real, imag, magnitude);
+    for (size_t i = 0; i < kSize; ++i) {
+      ASSERT_EQ(magnitude[i], expected[i]) << "index " << i;
+    }
+  }
+}
+
+TEST_P(NsVectorMathParametrization, UpdateWienerFilterIsBitExact) {
+  const NsVectorMath scalar(NoAvailableCpuFeatures());
+  const NsVectorMath optimized(/*cpu_features=*/GetParam());
+  Random random(42);
+  Vector prev_signal, prev_noise, signal, noise, expected, filter;
+  FillRandom(random, 0.f, 1.f, expected);
+  filter = expected;
+  for (int k = 0; k < kNumIterations; ++k) {
+    FillRandom(random, 1.f, 1e4f, prev_signal);
+    FillRandom(random, 1.f, 1e4f, prev_noise);
+    FillRandom(random, 1.f, 1e4f, signal);
+    FillRandom(random, 1.f, 1e4f, noise);
+    scalar.UpdateWienerFilter(prev_signal, prev_noise, signal, noise,
+                              /*over_subtraction_factor=*/1.3f,
+                              /*minimum_attenuating_gain=*/0.1f, expected);
+    optimized.UpdateWienerFilter(prev_signal, prev_noise, signal, noise,
+                                 /*over_subtraction_factor=*/1.3f,
+                                 /*minimum_attenuating_gain=*/0.1f, filter);
+    for (size_t i = 0; i < kSize; ++i) {
+      ASSERT_EQ(filter[i], expected[i]) << "index " << i;
+    }
+  }
+}
+
+TEST_P(NsVectorMathParametrization, UpdateQuantilesIsBitExact) {
+  const NsVectorMath scalar(NoAvailableCpuFeatures());
+  const NsVectorMath optimized(/*cpu_features=*/GetParam());
+  Random random(42);
+  Vector log_spectrum;
+  Vector expected_log_quantile, expected_density, log_quantile, density;
+  expected_log_quantile.fill(8.f);
+  expected_density.fill(0.3f);
+  log_quantile = expected_log_quantile;
+  density = expected_density;
+  for (int k = 0; k < kNumIterations; ++k) {
+    // Keep the log spectrum close to the quantiles, so that the density is
+    // updated as well.
+    FillRandom(random, 7.f, 9.f, log_spectrum);
+    const float counter = k % kLongStartupPhaseBlocks;
+    scalar.UpdateQuantiles(log_spectrum, counter, expected_log_quantile,
+                           expected_density);
+    optimized.UpdateQuantiles(log_spectrum, counter, log_quantile, density);
+    for (size_t i = 0; i < kSize; ++i) {
+      ASSERT_EQ(log_quantile[i], expected_log_quantile[i]) << "index " << i;
+      ASSERT_EQ(density[i], expected_density[i]) << "index " << i;
+    }
+  }
+}
+
+TEST_P(NsVectorMathParametrization, UpdateAvgLogLrtIsBitExact) {
+  const NsVectorMath scalar(NoAvailableCpuFeatures());
+  const NsVectorMath optimized(/*cpu_features=*/GetParam());
+  Random random(42);
+  Vector prior_snr, post_snr, expected, avg_log_lrt;
+  expected.fill(kLtrFeatureThr);
+  avg_log_lrt = expected;
+  for (int k = 0; k < kNumIterations; ++k) {
+    FillRandom(random, 0.f, 100.f, prior_snr);
+    FillRandom(random, 0.f, 100.f, post_snr);
+    scalar.UpdateAvgLogLrt(prior_snr, post_snr, expected);
+    optimized.UpdateAvgLogLrt(prior_snr, post_snr, avg_log_lrt);
+    for (size_t i = 0; i < kSize; ++i) {
+      ASSERT_EQ(avg_log_lrt[i], expected[i]) << "index " << i;
+    }
+  }
+}
+
+TEST_P(NsVectorMathParametrization, SpeechProbabilityIsBitExact) {
+  const NsVectorMath scalar(NoAvailableCpuFeatures());
+  const NsVectorMath optimized(/*cpu_features=*/GetParam());
+  Random random(42);
+  Vector inv_lrt, expected, probability;
+  for (int k = 0; k < kNumIterations; ++k) {
+    FillRandom(random, 0.f, 10.f, inv_lrt);
+    const float gain_prior = 100.f * random.Rand<float>();
+    scalar.SpeechProbability(gain_prior, inv_lrt, expected);
+    optimized.SpeechProbability(gain_prior, inv_lrt, probability);
+    for (size_t i = 0; i < kSize; ++i) {
+      ASSERT_EQ(probability[i], expected[i]) << "index " << i;
+    }
+  }
+}
+
+// Finds the relevant CPU features combinations to test.
+std::vector<AvailableCpuFeatures> GetCpuFeaturesToTest() {
+  std::vector<AvailableCpuFeatures> v;
+  v.push_back(NoAvailableCpuFeatures());
+  AvailableCpuFeatures available = GetAvailableCpuFeatures();
+  if (available.avx2) {
+    v.push_back({/*sse2=*/false, /*avx2=*/true, /*neon=*/false});
+  }
+  if (available.sse2) {
+    v.push_back({/*sse2=*/true, /*avx2=*/false, /*neon=*/false});
+  }
+  if (available.neon) {
+    v.push_back({/*sse2=*/false, /*avx2=*/false, /*neon=*/true});
+  }
+  return v;
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    NoiseSuppressor,
+    NsVectorMathParametrization,
+    ::testing::ValuesIn(GetCpuFeaturesToTest()),
+    [](const ::testing::TestParamInfo<AvailableCpuFeatures>& info) {
+      return info.param.ToString();
+    });
+
+}  // namespace
+}  // namespace webrtc
@@ -10,6 +10,8 @@
 
 #include "modules/audio_processing/ns/signal_model_estimator.h"
 
+#include <array>
+
 #include "modules/audio_processing/ns/fast_math.h"
 
 namespace webrtc {
@@ -61,6 +63,7 @@ float ComputeSpectralDiff(
 
 // Updates the spectral flatness based on the input spectrum.
 void UpdateSpectralFlatness(
+    const NsVectorMath& vector_math,
     rtc::ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
     float signal_spectral_sum,
     float* spectral_flatness) {
@@ -77,8 +80,10 @@ void UpdateSpectralFlatness(
     }
   }
 
-  for (size_t i = 1; i < kFftSizeBy2Plus1; ++i) {
-    avg_spect_flatness_num += LogApproximation(signal_spectrum[i]);
+  std::array<float, kFftSizeBy2Plus1 - 1> log_signal_spectrum;
+  vector_math.Log(signal_spectrum.subview(1), log_signal_spectrum);
+  for (float log_signal : log_signal_spectrum) {
+    avg_spect_flatness_num += log_signal;
   }
 
   float avg_spect_flatness_denom = signal_spectral_sum - signal_spectrum[0];
@@ -94,19 +99,14 @@ void UpdateSpectralFlatness(
 }
 
 // Updates the log LRT measures.
-void UpdateSpectralLrt(rtc::ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
+void UpdateSpectralLrt(const NsVectorMath& vector_math,
+                       rtc::ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
                        rtc::ArrayView<const float, kFftSizeBy2Plus1> post_snr,
                        rtc::ArrayView<float, kFftSizeBy2Plus1> avg_log_lrt,
                        float* lrt) {
   RTC_DCHECK(lrt);
 
-  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-    float tmp1 = 1.f + 2.f * prior_snr[i];
-    float tmp2 = 2.f * prior_snr[i] / (tmp1 + 0.0001f);
-    float bessel_tmp = (post_snr[i] + 1.f) * tmp2;
-    avg_log_lrt[i] +=
-        .5f * (bessel_tmp - LogApproximation(tmp1) - avg_log_lrt[i]);
-  }
+  vector_math.UpdateAvgLogLrt(prior_snr, post_snr, avg_log_lrt);
 
   float log_lrt_time_avg_k_sum = 0.f;
   for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
@@ -117,8 +117,8 @@ void UpdateSpectralLrt(rtc::ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
 
 }  // namespace
 
-SignalModelEstimator::SignalModelEstimator()
-    : prior_model_estimator_(kLtrFeatureThr) {}
+SignalModelEstimator::SignalModelEstimator(AvailableCpuFeatures cpu_features)
+    : vector_math_(cpu_features), prior_model_estimator_(kLtrFeatureThr) {}
 
 void SignalModelEstimator::AdjustNormalization(int32_t num_analyzed_frames,
                                                float signal_energy) {
@@ -136,7 +136,7 @@ void SignalModelEstimator::Update(
     float signal_spectral_sum,
     float signal_energy) {
   // Compute spectral flatness on input spectrum.
-  UpdateSpectralFlatness(signal_spectrum, signal_spectral_sum,
+  UpdateSpectralFlatness(vector_math_, signal_spectrum, signal_spectral_sum,
                          &features_.spectral_flatness);
 
   // Compute difference of input spectrum with learned/estimated noise spectrum.
@@ -169,7 +169,8 @@ void SignalModelEstimator::Update(
   }
 
   // Compute the LRT.
-  UpdateSpectralLrt(prior_snr, post_snr, features_.avg_log_lrt, &features_.lrt);
+  UpdateSpectralLrt(vector_math_, prior_snr, post_snr, features_.avg_log_lrt,
+                    &features_.lrt);
 }
 
 }  // namespace webrtc
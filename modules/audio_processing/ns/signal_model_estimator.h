@@ -14,8 +14,10 @@
 #include <array>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/cpu_features.h"
 #include "modules/audio_processing/ns/histograms.h"
 #include "modules/audio_processing/ns/ns_common.h"
+#include "modules/audio_processing/ns/ns_vector_math.h"
 #include "modules/audio_processing/ns/prior_signal_model.h"
 #include "modules/audio_processing/ns/prior_signal_model_estimator.h"
 #include "modules/audio_processing/ns/signal_model.h"
@@ -24,7 +26,7 @@ namespace webrtc {
 
 class SignalModelEstimator {
  public:
-  SignalModelEstimator();
+  explicit SignalModelEstimator(AvailableCpuFeatures cpu_features);
   SignalModelEstimator(const SignalModelEstimator&) = delete;
   SignalModelEstimator& operator=(const SignalModelEstimator&) = delete;
 
@@ -45,6 +47,7 @@ class SignalModelEstimator {
   const SignalModel& get_model() { return features_; }
 
  private:
+  const NsVectorMath vector_math_;
   float diff_normalization_ = 0.f;
   float signal_energy_sum_ = 0.f;
   Histograms histograms_;
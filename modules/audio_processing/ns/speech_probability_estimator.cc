@@ -19,7 +19,9 @@
 
 namespace webrtc {
 
-SpeechProbabilityEstimator::SpeechProbabilityEstimator() {
+SpeechProbabilityEstimator::SpeechProbabilityEstimator(
+    AvailableCpuFeatures cpu_features)
+    : vector_math_(cpu_features), signal_model_estimator_(cpu_features) {
   speech_probability_.fill(0.f);
 }
 
@@ -96,9 +98,7 @@ void SpeechProbabilityEstimator::Update(
 
   std::array<float, kFftSizeBy2Plus1> inv_lrt;
   ExpApproximationSignFlip(model.avg_log_lrt, inv_lrt);
-  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-    speech_probability_[i] = 1.f / (1.f + gain_prior * inv_lrt[i]);
-  }
+  vector_math_.SpeechProbability(gain_prior, inv_lrt, speech_probability_);
 }
 
 }  // namespace webrtc
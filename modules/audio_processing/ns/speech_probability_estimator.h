@@ -14,7 +14,9 @@
 #include <array>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/cpu_features.h"
 #include "modules/audio_processing/ns/ns_common.h"
+#include "modules/audio_processing/ns/ns_vector_math.h"
 #include "modules/audio_processing/ns/signal_model_estimator.h"
 
 namespace webrtc {
@@ -22,7 +24,7 @@ namespace webrtc {
 // Class for estimating the probability of speech.
 class SpeechProbabilityEstimator {
  public:
-  SpeechProbabilityEstimator();
+  explicit SpeechProbabilityEstimator(AvailableCpuFeatures cpu_features);
   SpeechProbabilityEstimator(const SpeechProbabilityEstimator&) = delete;
   SpeechProbabilityEstimator& operator=(const SpeechProbabilityEstimator&) =
       delete;
@@ -41,6 +43,7 @@ class SpeechProbabilityEstimator {
   rtc::ArrayView<const float> get_probability() { return speech_probability_; }
 
  private:
+  const NsVectorMath vector_math_;
   SignalModelEstimator signal_model_estimator_;
   float prior_speech_prob_ = .5f;
   std::array<float, kFftSizeBy2Plus1> speech_probability_;
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Compares building and parsing a typical receiver-side compound RTCP packet
+// (receiver report, SDES CNAME, NACK and transport feedback) using the
+// RtcpPacket classes against the CompoundPacketWriter and ParseCompoundPacket.
+
+#include <algorithm>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_parser.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_writer.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kSenderSsrc = 0x12345678;
+constexpr uint32_t kMediaSsrc = 0x23456789;
+constexpr char kCname[] = "benchmark-cname";
+constexpr size_t kMaxPacketSize = 1200;
+
+struct PacketContent {
+  std::vector<rtcp::ReportBlock> report_blocks;
+  std::vector<uint16_t> nack_list;
+  rtcp::TransportFeedback feedback;
+};
+
+// `num_report_blocks` is the first benchmark argument.
+PacketContent CreateContent(int num_report_blocks) {
+  PacketContent content;
+  for (int i = 0; i < num_report_blocks; ++i) {
+    rtcp::ReportBlock block;
+    block.SetMediaSsrc(kMediaSsrc + i);
+    block.SetExtHighestSeqNum(1000 + i);
+    block.SetJitter(i);
+    content.report_blocks.push_back(block);
+  }
+  for (uint16_t seq_num = 100; seq_num < 200; seq_num += 3) {
+    content.nack_list.push_back(seq_num);
+  }
+  content.feedback.SetSenderSsrc(kSenderSsrc);
+  content.feedback.SetMediaSsrc(kMediaSsrc);
+  content.feedback.SetBase(/*base_sequence=*/1, Timestamp::Millis(100));
+  for (uint16_t seq_num = 1; seq_num < 50; ++seq_num) {
+    RTC_CHECK(content.feedback.AddReceivedPacket(
+        seq_num, Timestamp::Millis(100 + seq_num)));
+  }
+  return content;
+}
+
+void BuildWithRtcpPackets(const PacketContent& content,
+                          rtcp::RtcpPacket::PacketReadyCallback callback) {
+  // Appends RtcpPacket objects into a shared buffer, one by one.
+  uint8_t buffer[IP_PACKET_SIZE];
+  size_t index = 0;
+  rtc::ArrayView<const rtcp::ReportBlock> blocks = content.report_blocks;
+  do {
+    size_t num_blocks = std::min<size_t>(
+        blocks.size(), rtcp::ReceiverReport::kMaxNumberOfReportBlocks);
+    rtcp::ReceiverReport rr;
+    rr.SetSenderSsrc(kSenderSsrc);
+    rr.SetReportBlocks(
+        std::vector<rtcp::ReportBlock>(blocks.begin(),
+                                       blocks.begin() + num_blocks));
+    rr.Create(buffer, &index, kMaxPacketSize, callback);
+    blocks = blocks.subview(num_blocks);
+  } while (!blocks.empty());
+  rtcp::Sdes sdes;
+  sdes.AddCName(kSenderSsrc, kCname);
+  sdes.Create(buffer, &index, kMaxPacketSize, callback);
+  rtcp::Nack nack;
+  nack.SetSenderSsrc(kSenderSsrc);
+  nack.SetMediaSsrc(kMediaSsrc);
+  nack.SetPacketIds(content.nack_list);
+  nack.Create(buffer, &index, kMaxPacketSize, callback);
+  content.feedback.Create(buffer, &index, kMaxPacketSize, callback);
+  callback(rtc::ArrayView<const uint8_t>(buffer, index));
+}
+
+void BuildWithWriter(const PacketContent& content,
+                     rtcp::RtcpPacket::PacketReadyCallback callback) {
+  rtcp::CompoundPacketWriter writer(callback, kMaxPacketSize);
+  writer.AddReceiverReport(kSenderSsrc, content.report_blocks);
+  writer.AddSdesCname(kSenderSsrc, kCname);
+  writer.AddNack(kSenderSsrc, kMediaSsrc, content.nack_list);
+  writer.AddPacket(content.feedback);
+  writer.Send();
+}
+
+std::vector<rtc::Buffer> BuildPackets(const PacketContent& content) {
+  std::vector<rtc::Buffer> packets;
+  BuildWithWriter(content, [&](rtc::ArrayView<const uint8_t> packet) {
+    packets.emplace_back(packet.data(), packet.size());
+  });
+  return packets;
+}
+
+void BM_BuildCompoundWithRtcpPackets(benchmark::State& state) {
+  PacketContent content = CreateContent(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    BuildWithRtcpPackets(content, [&](rtc::ArrayView<const uint8_t> packet) {
+      bytes += packet.size();
+      benchmark::DoNotOptimize(packet.data());
+    });
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+void BM_BuildCompoundWithWriter(benchmark::State& state) {
+  PacketContent content = CreateContent(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    BuildWithWriter(content, [&](rtc::ArrayView<const uint8_t> packet) {
+      bytes += packet.size();
+      benchmark::DoNotOptimize(packet.data());
+    });
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+void BM_ParseCompoundWithRtcpPackets(benchmark::State& state) {
+  std::vector<rtc::Buffer> packets =
+      BuildPackets(CreateContent(state.range(0)));
+  for (auto _ : state) {
+    // Mimics RTCPReceiver::ParseCompoundPacket.
+    for (const rtc::Buffer& packet : packets) {
+      rtcp::CommonHeader header;
+      for (const uint8_t* next = packet.data();
+           next != packet.data() + packet.size(); next = header.NextPacket()) {
+        RTC_CHECK(header.Parse(next, packet.data() + packet.size() - next));
+        switch (header.type()) {
+          case rtcp::ReceiverReport::kPacketType: {
+            rtcp::ReceiverReport rr;
+            RTC_CHECK(rr.Parse(header));
+            benchmark::DoNotOptimize(rr.report_blocks().data());
+            break;
+          }
+          case rtcp::Sdes::kPacketType: {
+            rtcp::Sdes sdes;
+            RTC_CHECK(sdes.Parse(header));
+            benchmark::DoNotOptimize(sdes.chunks().data());
+            break;
+          }
+          case rtcp::Rtpfb::kPacketType: {
+            if (header.fmt() != rtcp::Nack::kFeedbackMessageType)
+              break;
+            rtcp::Nack nack;
+            RTC_CHECK(nack.Parse(header));
+            benchmark::DoNotOptimize(nack.packet_ids().data());
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+class CountingVisitor : public rtcp::CompoundPacketVisitor {
+ public:
+  void OnReportBlock(uint32_t /* sender_ssrc */,
+                     const rtcp::ReportBlockView& report_block) override {
+    sum_ += report_block.extended_high_seq_num();
+  }
+  void OnSdesCname(uint32_t /* ssrc */, absl::string_view cname) override {
+    sum_ += cname.size();
+  }
+  void OnNackItem(uint32_t /* sender_ssrc */,
+                  uint32_t /* media_ssrc */,
+                  uint16_t first_pid,
+                  uint16_t bitmask) override {
+    rtcp::ForEachNackedPacket(first_pid, bitmask,
+                              [&](uint16_t seq_num) { sum_ += seq_num; });
+  }
+
+  uint64_t sum() const { return sum_; }
+
+ private:
+  uint64_t sum_ = 0;
+};
+
+void BM_ParseCompoundWithVisitor(benchmark::State& state) {
+  std::vector<rtc::Buffer> packets =
+      BuildPackets(CreateContent(state.range(0)));
+  CountingVisitor visitor;
+  for (auto _ : state) {
+    for (const rtc::Buffer& packet : packets) {
+      RTC_CHECK(rtcp::ParseCompoundPacket(packet, visitor));
+    }
+  }
+  benchmark::DoNotOptimize(visitor.sum());
+}
+
+// Number of report blocks, i.e. number of received streams.
+BENCHMARK(BM_BuildCompoundWithRtcpPackets)->Arg(1)->Arg(8)->Arg(31)->Arg(100);
+BENCHMARK(BM_BuildCompoundWithWriter)->Arg(1)->Arg(8)->Arg(31)->Arg(100);
+BENCHMARK(BM_ParseCompoundWithRtcpPackets)->Arg(1)->Arg(8)->Arg(31)->Arg(100);
+BENCHMARK(BM_ParseCompoundWithVisitor)->Arg(1)->Arg(8)->Arg(31)->Arg(100);
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,244 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_parser.h"
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/psfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace rtcp {
+namespace {
+
+constexpr size_t kSenderBaseLength = 24;
+constexpr size_t kReceiverBaseLength = 4;
+constexpr size_t kCommonFeedbackLength = 8;
+constexpr size_t kNackItemLength = 4;
+constexpr uint8_t kSdesTerminatorTag = 0;
+constexpr uint8_t kSdesCnameTag = 1;
+
+bool ParseSenderReport(const CommonHeader& header,
+                       CompoundPacketVisitor& visitor) {
+  const uint8_t* const payload = header.payload();
+  if (header.payload_size_bytes() <
+      kSenderBaseLength + header.count() * ReportBlock::kLength) {
+    return false;
+  }
+  uint32_t sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+  visitor.OnSenderReport(
+      sender_ssrc,
+      NtpTime(ByteReader<uint32_t>::ReadBigEndian(&payload[4]),
+              ByteReader<uint32_t>::ReadBigEndian(&payload[8])),
+      ByteReader<uint32_t>::ReadBigEndian(&payload[12]),
+      ByteReader<uint32_t>::ReadBigEndian(&payload[16]),
+      ByteReader<uint32_t>::ReadBigEndian(&payload[20]));
+  const uint8_t* next_block = payload + kSenderBaseLength;
+  for (size_t i = 0; i < header.count(); ++i) {
+    visitor.OnReportBlock(sender_ssrc, ReportBlockView(next_block));
+    next_block += ReportBlock::kLength;
+  }
+  return true;
+}
+
+bool ParseReceiverReport(const CommonHeader& header,
+                         CompoundPacketVisitor& visitor) {
+  const uint8_t* const payload = header.payload();
+  if (header.payload_size_bytes() <
+      kReceiverBaseLength + header.count() * ReportBlock::kLength) {
+    return false;
+  }
+  uint32_t sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+  visitor.OnReceiverReport(sender_ssrc);
+  const uint8_t* next_block = payload + kReceiverBaseLength;
+  for (size_t i = 0; i < header.count(); ++i) {
+    visitor.OnReportBlock(sender_ssrc, ReportBlockView(next_block));
+    next_block += ReportBlock::kLength;
+  }
+  return true;
+}
+
+// Walks the SDES chunks, reporting CNAMEs to `visitor` when it is not null.
+// Follows the same validation rules as Sdes::Parse.
+bool ParseSdes(const CommonHeader& header, CompoundPacketVisitor* visitor) {
+  const uint8_t* const payload_end =
+      header.payload() + header.payload_size_bytes();
+  const uint8_t* looking_at = header.payload();
+  for (size_t i = 0; i < header.count(); ++i) {
+    // Each chunk consumes at least 8 bytes.
+    if (payload_end - looking_at < 8) {
+      return false;
+    }
+    uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(looking_at);
+    looking_at += sizeof(uint32_t);
+    const uint8_t* cname = nullptr;
+    uint8_t cname_length = 0;
+
+    uint8_t item_type;
+    while ((item_type = *(looking_at++)) != kSdesTerminatorTag) {
+      if (looking_at >= payload_end) {
+        return false;
+      }
+      uint8_t item_length = *(looking_at++);
+      const size_t kTerminatorSize = 1;
+      if (looking_at + item_length + kTerminatorSize > payload_end) {
+        return false;
+      }
+      if (item_type == kSdesCnameTag) {
+        if (cname != nullptr) {
+          return false;
+        }
+        cname = looking_at;
+        cname_length = item_length;
+      }
+      looking_at += item_length;
+    }
+    if (cname != nullptr && visitor != nullptr) {
+      visitor->OnSdesCname(
+          ssrc, absl::string_view(reinterpret_cast<const char*>(cname),
+                                  cname_length));
+    }
+    // Adjust to 32bit boundary.
+    looking_at += (payload_end - looking_at) % 4;
+  }
+  return true;
+}
+
+bool ParseBye(const CommonHeader& header, CompoundPacketVisitor& visitor) {
+  if (header.count() == 0 ||
+      header.payload_size_bytes() < header.count() * sizeof(uint32_t)) {
+    return false;
+  }
+  visitor.OnBye(ByteReader<uint32_t>::ReadBigEndian(header.payload()));
+  return true;
+}
+
+bool ParseNack(const CommonHeader& header, CompoundPacketVisitor& visitor) {
+  if (header.payload_size_bytes() < kCommonFeedbackLength + kNackItemLength) {
+    return false;
+  }
+  const uint8_t* const payload = header.payload();
+  uint32_t sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+  uint32_t media_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[4]);
+  size_t num_items =
+      (header.payload_size_bytes() - kCommonFeedbackLength) / kNackItemLength;
+  const uint8_t* next_item = payload + kCommonFeedbackLength;
+  for (size_t i = 0; i < num_items; ++i) {
+    visitor.OnNackItem(sender_ssrc, media_ssrc,
+                       ByteReader<uint16_t>::ReadBigEndian(&next_item[0]),
+                       ByteReader<uint16_t>::ReadBigEndian(&next_item[2]));
+    next_item += kNackItemLength;
+  }
+  return true;
+}
+
+bool ParsePli(const CommonHeader& header, CompoundPacketVisitor& visitor) {
+  if (header.payload_size_bytes() < kCommonFeedbackLength) {
+    return false;
+  }
+  visitor.OnPli(ByteReader<uint32_t>::ReadBigEndian(&header.payload()[0]),
+                ByteReader<uint32_t>::ReadBigEndian(&header.payload()[4]));
+  return true;
+}
+
+// Returns false if the block has known type, but is malformed.
+bool ParseBlock(const CommonHeader& header, CompoundPacketVisitor& visitor) {
+  switch (header.type()) {
+    case SenderReport::kPacketType:
+      return ParseSenderReport(header, visitor);
+    case ReceiverReport::kPacketType:
+      return ParseReceiverReport(header, visitor);
+    case Sdes::kPacketType:
+      // Validate first so that malformed packet is reported atomically.
+      return ParseSdes(header, /*visitor=*/nullptr) &&
+             ParseSdes(header, &visitor);
+    case Bye::kPacketType:
+      return ParseBye(header, visitor);
+    case Rtpfb::kPacketType:
+      if (header.fmt() == Nack::kFeedbackMessageType) {
+        return ParseNack(header, visitor);
+      }
+      break;
+    case Psfb::kPacketType:
+      if (header.fmt() == Pli::kFeedbackMessageType) {
+        return ParsePli(header, visitor);
+      }
+      break;
+  }
+  visitor.OnOtherPacket(header);
+  return true;
+}
+
+}  // namespace
+
+uint32_t ReportBlockView::source_ssrc() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[0]);
+}
+
+uint8_t ReportBlockView::fraction_lost() const {
+  return buffer_[4];
+}
+
+int32_t ReportBlockView::cumulative_lost() const {
+  return ByteReader<int32_t, 3>::ReadBigEndian(&buffer_[5]);
+}
+
+uint32_t ReportBlockView::extended_high_seq_num() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[8]);
+}
+
+uint32_t ReportBlockView::jitter() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[12]);
+}
+
+uint32_t ReportBlockView::last_sr() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[16]);
+}
+
+uint32_t ReportBlockView::delay_since_last_sr() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[20]);
+}
+
+ReportBlock ReportBlockView::ToReportBlock() const {
+  ReportBlock report_block;
+  bool parsed = report_block.Parse(buffer_, ReportBlock::kLength);
+  RTC_DCHECK(parsed);
+  return report_block;
+}
+
+bool ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
+                         CompoundPacketVisitor& visitor) {
+  CommonHeader header;
+  for (const uint8_t* next_packet = packet.data();
+       next_packet != packet.data() + packet.size();
+       next_packet = header.NextPacket()) {
+    size_t remaining_size = packet.data() + packet.size() - next_packet;
+    if (!header.Parse(next_packet, remaining_size)) {
+      return false;
+    }
+    if (!ParseBlock(header, visitor)) {
+      RTC_LOG(LS_WARNING) << "Malformed rtcp packet of type "
+                          << static_cast<int>(header.type());
+      visitor.OnMalformedPacket(header);
+    }
+  }
+  return true;
+}
+
+}  // namespace rtcp
+}  // namespace webrtc
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_PARSER_H_
+#define MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_PARSER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "absl/strings/string_view.h"
+#include "api/array_view.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "system_wrappers/include/ntp_time.h"
+
+namespace webrtc {
+namespace rtcp {
+
+// Non-owning view of a report block inside a received RTCP packet.
+// Fields are decoded on access.
+class ReportBlockView {
+ public:
+  // `buffer` should point to at least ReportBlock::kLength bytes.
+  explicit ReportBlockView(const uint8_t* buffer) : buffer_(buffer) {}
+
+  uint32_t source_ssrc() const;
+  uint8_t fraction_lost() const;
+  int32_t cumulative_lost() const;
+  uint32_t extended_high_seq_num() const;
+  uint32_t jitter() const;
+  uint32_t last_sr() const;
+  uint32_t delay_since_last_sr() const;
+
+  ReportBlock ToReportBlock() const;
+
+ private:
+  const uint8_t* buffer_;
+};
+
+// Receives blocks of the compound RTCP packet as they are parsed. All
+// arguments are views into the parsed buffer and are only valid for the
+// duration of the call. Default implementations ignore the block.
+class CompoundPacketVisitor {
+ public:
+  virtual ~CompoundPacketVisitor() = default;
+
+  virtual void OnSenderReport(uint32_t /* sender_ssrc */,
+                              NtpTime /* ntp */,
+                              uint32_t /* rtp_timestamp */,
+                              uint32_t /* packet_count */,
+                              uint32_t /* octet_count */) {}
+  virtual void OnReceiverReport(uint32_t /* sender_ssrc */) {}
+  // Called for each report block attached to a sender or receiver report,
+  // right after the corresponding OnSenderReport or OnReceiverReport.
+  virtual void OnReportBlock(uint32_t /* sender_ssrc */,
+                             const ReportBlockView& /* report_block */) {}
+  virtual void OnSdesCname(uint32_t /* ssrc */,
+                           absl::string_view /* cname */) {}
+  virtual void OnBye(uint32_t /* sender_ssrc */) {}
+  // Called for each packed generic NACK item, see RFC 4585 section 6.2.1.
+  // Use `ForEachNackedPacket` to expand the item into sequence numbers.
+  virtual void OnNackItem(uint32_t /* sender_ssrc */,
+                          uint32_t /* media_ssrc */,
+                          uint16_t /* first_pid */,
+                          uint16_t /* bitmask */) {}
+  virtual void OnPli(uint32_t /* sender_ssrc */, uint32_t /* media_ssrc */) {}
+  // Called for blocks of the types not listed above, e.g. transport feedback.
+  virtual void OnOtherPacket(const CommonHeader& /* header */) {}
+  // Called for blocks of the types listed above that failed validation.
+  virtual void OnMalformedPacket(const CommonHeader& /* header */) {}
+};
+
+// Invokes `callback` for each sequence number described by a NACK item.
+template <typename Callback>
+void ForEachNackedPacket(uint16_t first_pid,
+                         uint16_t bitmask,
+                         Callback&& callback) {
+  callback(first_pid);
+  uint16_t pid = first_pid + 1;
+  for (; bitmask != 0; bitmask >>= 1, ++pid) {
+    if (bitmask & 1)
+      callback(pid);
+  }
+}
+
+// Parses a compound RTCP packet without allocating, reporting each block to
+// the `visitor`. Returns false if the common header of any block is invalid,
+// in which case blocks before the invalid one are already reported.
+bool ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
+                         CompoundPacketVisitor& visitor);
+
+}  // namespace rtcp
+}  // namespace webrtc
+#endif  // MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_PARSER_H_
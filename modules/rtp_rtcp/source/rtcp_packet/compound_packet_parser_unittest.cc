@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_parser.h"
+
+#include <vector>
+
+#include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/psfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "rtc_base/buffer.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::Eq;
+using ::testing::InSequence;
+using ::testing::StrictMock;
+using rtcp::CompoundPacketVisitor;
+using rtcp::ParseCompoundPacket;
+using rtcp::ReportBlockView;
+
+constexpr uint32_t kSenderSsrc = 0x12345678;
+constexpr uint32_t kMediaSsrc = 0x23456789;
+
+class MockVisitor : public CompoundPacketVisitor {
+ public:
+  MOCK_METHOD(void,
+              OnSenderReport,
+              (uint32_t, NtpTime, uint32_t, uint32_t, uint32_t),
+              (override));
+  MOCK_METHOD(void, OnReceiverReport, (uint32_t), (override));
+  MOCK_METHOD(void,
+              OnReportBlock,
+              (uint32_t, const ReportBlockView&),
+              (override));
+  MOCK_METHOD(void, OnSdesCname, (uint32_t, absl::string_view), (override));
+  MOCK_METHOD(void, OnBye, (uint32_t), (override));
+  MOCK_METHOD(void,
+              OnNackItem,
+              (uint32_t, uint32_t, uint16_t, uint16_t),
+              (override));
+  MOCK_METHOD(void, OnPli, (uint32_t, uint32_t), (override));
+  MOCK_METHOD(void, OnOtherPacket, (const rtcp::CommonHeader&), (override));
+  MOCK_METHOD(void,
+              OnMalformedPacket,
+              (const rtcp::CommonHeader&),
+              (override));
+};
+
+TEST(RtcpCompoundPacketParserTest, ReportsBlocksInOrder) {
+  rtcp::ReportBlock report_block;
+  report_block.SetMediaSsrc(kMediaSsrc);
+  report_block.SetFractionLost(12);
+  ASSERT_TRUE(report_block.SetCumulativeLost(-3));
+  report_block.SetExtHighestSeqNum(0x10002);
+  report_block.SetJitter(7);
+  report_block.SetLastSr(0x11223344);
+  report_block.SetDelayLastSr(0x55667788);
+  rtcp::SenderReport sr;
+  sr.SetSenderSsrc(kSenderSsrc);
+  sr.SetNtp(NtpTime(1, 2));
+  sr.SetRtpTimestamp(3);
+  sr.SetPacketCount(4);
+  sr.SetOctetCount(5);
+  sr.AddReportBlock(report_block);
+  rtcp::Sdes sdes;
+  sdes.AddCName(kSenderSsrc, "cname");
+  rtcp::Pli pli;
+  pli.SetSenderSsrc(kSenderSsrc);
+  pli.SetMediaSsrc(kMediaSsrc);
+  rtcp::Bye bye;
+  bye.SetSenderSsrc(kSenderSsrc);
+  rtc::Buffer packet;
+  packet.AppendData(sr.Build());
+  packet.AppendData(sdes.Build());
+  packet.AppendData(pli.Build());
+  packet.AppendData(bye.Build());
+
+  StrictMock<MockVisitor> visitor;
+  InSequence s;
+  EXPECT_CALL(visitor, OnSenderReport(kSenderSsrc, NtpTime(1, 2), 3, 4, 5));
+  EXPECT_CALL(visitor, OnReportBlock(kSenderSsrc, _))
+      .WillOnce([](uint32_t, const ReportBlockView& view) {
+        EXPECT_EQ(view.source_ssrc(), kMediaSsrc);
+        EXPECT_EQ(view.fraction_lost(), 12);
+        EXPECT_EQ(view.cumulative_lost(), -3);
+        EXPECT_EQ(view.extended_high_seq_num(), 0x10002u);
+        EXPECT_EQ(view.jitter(), 7u);
+        EXPECT_EQ(view.last_sr(), 0x11223344u);
+        EXPECT_EQ(view.delay_since_last_sr(), 0x55667788u);
+        EXPECT_EQ(view.ToReportBlock().source_ssrc(), kMediaSsrc);
+      });
+  EXPECT_CALL(visitor, OnSdesCname(kSenderSsrc, Eq("cname")));
+  EXPECT_CALL(visitor, OnPli(kSenderSsrc, kMediaSsrc));
+  EXPECT_CALL(visitor, OnBye(kSenderSsrc));
+
+  EXPECT_TRUE(ParseCompoundPacket(packet, visitor));
+}
+
+TEST(RtcpCompoundPacketParserTest, ReportsNackItems) {
+  const std::vector<uint16_t> kNackList = {1, 2, 5, 30, 31, 60};
+  rtcp::ReceiverReport rr;
+  rr.SetSenderSsrc(kSenderSsrc);
+  rtcp::Nack nack;
+  nack.SetSenderSsrc(kSenderSsrc);
+  nack.SetMediaSsrc(kMediaSsrc);
+  nack.SetPacketIds(kNackList);
+  rtc::Buffer packet;
+  packet.AppendData(rr.Build());
+  packet.AppendData(nack.Build());
+
+  std::vector<uint16_t> parsed_nacks;
+  StrictMock<MockVisitor> visitor;
+  EXPECT_CALL(visitor, OnReceiverReport(kSenderSsrc));
+  EXPECT_CALL(visitor, OnNackItem(kSenderSsrc, kMediaSsrc, _, _))
+      .Times(3)
+      .WillRepeatedly([&](uint32_t, uint32_t, uint16_t pid, uint16_t bitmask) {
+        rtcp::ForEachNackedPacket(pid, bitmask, [&](uint16_t seq_num) {
+          parsed_nacks.push_back(seq_num);
+        });
+      });
+
+  EXPECT_TRUE(ParseCompoundPacket(packet, visitor));
+  EXPECT_EQ(parsed_nacks, kNackList);
+}
+
+TEST(RtcpCompoundPacketParserTest, ReportsUnknownBlocksAsOther) {
+  rtcp::Remb remb;
+  remb.SetSenderSsrc(kSenderSsrc);
+  remb.SetBitrateBps(300'000);
+  rtc::Buffer packet = remb.Build();
+
+  StrictMock<MockVisitor> visitor;
+  EXPECT_CALL(visitor, OnOtherPacket)
+      .WillOnce([&](const rtcp::CommonHeader& header) {
+        EXPECT_EQ(header.type(), rtcp::Remb::kPacketType);
+        EXPECT_EQ(header.fmt(), rtcp::Psfb::kAfbMessageType);
+        EXPECT_EQ(header.packet_size(), packet.size());
+      });
+
+  EXPECT_TRUE(ParseCompoundPacket(packet, visitor));
+}
+
+TEST(RtcpCompoundPacketParserTest, SkipsMalformedBlock) {
+  // Receiver report claims to have one report block, but has none.
+  const uint8_t kPacket[] = {0x81, 201,  0x00, 0x01, 0x12, 0x34,
+                             0x56, 0x78, 0x81, 206,  0x00, 0x02,
+                             0x12, 0x34, 0x56, 0x78, 0x23, 0x45,
+                             0x67, 0x89};
+
+  StrictMock<MockVisitor> visitor;
+  EXPECT_CALL(visitor, OnMalformedPacket);
+  EXPECT_CALL(visitor, OnPli(kSenderSsrc, kMediaSsrc));
+
+  EXPECT_TRUE(ParseCompoundPacket(kPacket, visitor));
+}
+
+TEST(RtcpCompoundPacketParserTest, FailsOnInvalidHeader) {
+  // Second block is truncated.
+  const uint8_t kPacket[] = {0x80, 201,  0x00, 0x01, 0x12, 0x34,
+                             0x56, 0x78, 0x81, 206,  0x00, 0x02,
+                             0x12, 0x34, 0x56, 0x78};
+
+  StrictMock<MockVisitor> visitor;
+  EXPECT_CALL(visitor, OnReceiverReport(kSenderSsrc));
+
+  EXPECT_FALSE(ParseCompoundPacket(kPacket, visitor));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_writer.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/psfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace rtcp {
+namespace {
+
+constexpr size_t kHeaderLength = 4;
+constexpr size_t kSenderBaseLength = 24;
+constexpr size_t kReceiverBaseLength = 4;
+constexpr size_t kCommonFeedbackLength = 8;
+constexpr size_t kNackItemLength = 4;
+constexpr size_t kMaxNumberOfReportBlocks =
+    ReceiverReport::kMaxNumberOfReportBlocks;
+constexpr uint8_t kSdesCnameTag = 1;
+
+static_assert(ReceiverReport::kMaxNumberOfReportBlocks ==
+              SenderReport::kMaxNumberOfReportBlocks);
+
+// Writes RTCP common header, see RtcpPacket::CreateHeader.
+void WriteHeaderAt(uint8_t* buffer,
+                   uint8_t count_or_format,
+                   uint8_t packet_type,
+                   size_t payload_size_bytes) {
+  RTC_DCHECK_EQ(payload_size_bytes % 4, 0);
+  RTC_DCHECK_LE(payload_size_bytes / 4, 0xffffU);
+  RTC_DCHECK_LE(count_or_format, 0x1f);
+  constexpr uint8_t kVersionBits = 2 << 6;
+  buffer[0] = kVersionBits | count_or_format;
+  buffer[1] = packet_type;
+  ByteWriter<uint16_t>::WriteBigEndian(&buffer[2], payload_size_bytes / 4);
+}
+
+}  // namespace
+
+CompoundPacketWriter::CompoundPacketWriter(
+    RtcpPacket::PacketReadyCallback callback,
+    size_t max_packet_size)
+    : callback_(callback), max_packet_size_(max_packet_size) {
+  RTC_CHECK_LE(max_packet_size, IP_PACKET_SIZE);
+  // Smallest packet that should always fit is a report with one report block.
+  RTC_CHECK_GE(max_packet_size,
+               kHeaderLength + kSenderBaseLength + ReportBlock::kLength);
+}
+
+CompoundPacketWriter::~CompoundPacketWriter() {
+  RTC_DCHECK_EQ(index_, 0) << "Unsent rtcp packet.";
+}
+
+void CompoundPacketWriter::Reserve(size_t bytes) {
+  RTC_DCHECK_LE(bytes, max_packet_size_);
+  if (bytes_left() < bytes) {
+    Send();
+  }
+}
+
+void CompoundPacketWriter::WriteHeader(uint8_t count_or_format,
+                                       uint8_t packet_type,
+                                       size_t payload_size_bytes) {
+  WriteHeaderAt(&buffer_[index_], count_or_format, packet_type,
+                payload_size_bytes);
+  index_ += kHeaderLength;
+}
+
+void CompoundPacketWriter::WriteReports(
+    uint8_t packet_type,
+    size_t fixed_payload_size,
+    const uint8_t* fixed_payload,
+    rtc::ArrayView<const ReportBlock>& report_blocks) {
+  const size_t min_size = kHeaderLength + fixed_payload_size +
+                          (report_blocks.empty() ? 0 : ReportBlock::kLength);
+  Reserve(min_size);
+  size_t num_blocks = std::min(
+      {kMaxNumberOfReportBlocks, report_blocks.size(),
+       (bytes_left() - kHeaderLength - fixed_payload_size) /
+           ReportBlock::kLength});
+
+  WriteHeader(static_cast<uint8_t>(num_blocks), packet_type,
+              fixed_payload_size + num_blocks * ReportBlock::kLength);
+  memcpy(&buffer_[index_], fixed_payload, fixed_payload_size);
+  index_ += fixed_payload_size;
+  for (size_t i = 0; i < num_blocks; ++i) {
+    report_blocks[i].Create(&buffer_[index_]);
+    index_ += ReportBlock::kLength;
+  }
+  report_blocks = report_blocks.subview(num_blocks);
+  RTC_DCHECK_LE(index_, max_packet_size_);
+}
+
+//    Sender report (SR) (RFC 3550).
+//     0                   1                   2                   3
+//     0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |V=2|P|    RC   |   PT=SR=200   |             length            |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  0 |                         SSRC of sender                        |
+//    +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//  4 |              NTP timestamp, most significant word             |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  8 |             NTP timestamp, least significant word             |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// 12 |                         RTP timestamp                         |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// 16 |                     sender's packet count                     |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// 20 |                      sender's octet count                     |
+// 24 +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+void CompoundPacketWriter::AddSenderReport(
+    uint32_t sender_ssrc,
+    NtpTime ntp,
+    uint32_t rtp_timestamp,
+    uint32_t packet_count,
+    uint32_t octet_count,
+    rtc::ArrayView<const ReportBlock> report_blocks) {
+  uint8_t fixed_payload[kSenderBaseLength];
+  ByteWriter<uint32_t>::WriteBigEndian(&fixed_payload[0], sender_ssrc);
+  ByteWriter<uint32_t>::WriteBigEndian(&fixed_payload[4], ntp.seconds());
+  ByteWriter<uint32_t>::WriteBigEndian(&fixed_payload[8], ntp.fractions());
+  ByteWriter<uint32_t>::WriteBigEndian(&fixed_payload[12], rtp_timestamp);
+  ByteWriter<uint32_t>::WriteBigEndian(&fixed_payload[16], packet_count);
+  ByteWriter<uint32_t>::WriteBigEndian(&fixed_payload[20], octet_count);
+  WriteReports(SenderReport::kPacketType, kSenderBaseLength, fixed_payload,
+               report_blocks);
+  if (!report_blocks.empty()) {
+    AddReceiverReport(sender_ssrc, report_blocks);
+  }
+}
+
+//    RTCP receiver report (RFC 3550).
+//
+//     0                   1                   2                   3
+//     0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |V=2|P|    RC   |   PT=RR=201   |             length            |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |                     SSRC of packet sender                     |
+//    +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//    |                         report block(s)                       |
+//    |                            ....                               |
+void CompoundPacketWriter::AddReceiverReport(
+    uint32_t sender_ssrc,
+    rtc::ArrayView<const ReportBlock> report_blocks) {
+  uint8_t fixed_payload[kReceiverBaseLength];
+  ByteWriter<uint32_t>::WriteBigEndian(&fixed_payload[0], sender_ssrc);
+  do {
+    WriteReports(ReceiverReport::kPacketType, kReceiverBaseLength,
+                 fixed_payload, report_blocks);
+  } while (!report_blocks.empty());
+}
+
+// Source Description (SDES) (RFC 3550) with a single CNAME chunk.
+//
+//         0                   1                   2                   3
+//         0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//        +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// header |V=2|P|    SC   |  PT=SDES=202  |             length            |
+//        +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+// chunk  |                          SSRC/CSRC_1                          |
+//   1    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//        |    CNAME=1    |     length    | user and domain name        ...
+//        +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+void CompoundPacketWriter::AddSdesCname(uint32_t ssrc,
+                                        absl::string_view cname) {
+  RTC_DCHECK_LE(cname.size(), 0xffu);
+  // Items are terminated by at least one null octet and the chunk is padded to
+  // the 32-bit boundary.
+  const size_t padding_size = 4 - ((6 + cname.size()) % 4);
+  const size_t chunk_size = 6 + cname.size() + padding_size;
+  Reserve(kHeaderLength + chunk_size);
+
+  WriteHeader(/*count_or_format=*/1, Sdes::kPacketType, chunk_size);
+  ByteWriter<uint32_t>::WriteBigEndian(&buffer_[index_], ssrc);
+  buffer_[index_ + 4] = kSdesCnameTag;
+  buffer_[index_ + 5] = static_cast<uint8_t>(cname.size());
+  memcpy(&buffer_[index_ + 6], cname.data(), cname.size());
+  memset(&buffer_[index_ + 6 + cname.size()], 0, padding_size);
+  index_ += chunk_size;
+}
+
+// Generic NACK (RFC 4585).
+//
+// FCI:
+//    0                   1                   2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |            PID                |             BLP               |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+void CompoundPacketWriter::AddNack(uint32_t sender_ssrc,
+                                   uint32_t media_ssrc,
+                                   rtc::ArrayView<const uint16_t> packet_ids) {
+  RTC_DCHECK(!packet_ids.empty());
+  size_t i = 0;
+  while (i < packet_ids.size()) {
+    Reserve(kHeaderLength + kCommonFeedbackLength + kNackItemLength);
+    // Header is written once number of nack items is known.
+    const size_t header_index = index_;
+    index_ += kHeaderLength;
+    ByteWriter<uint32_t>::WriteBigEndian(&buffer_[index_], sender_ssrc);
+    ByteWriter<uint32_t>::WriteBigEndian(&buffer_[index_ + 4], media_ssrc);
+    index_ += kCommonFeedbackLength;
+
+    while (i < packet_ids.size() && bytes_left() >= kNackItemLength) {
+      uint16_t first_pid = packet_ids[i++];
+      // Bitmask specifies losses in any of the 16 packets following the pid.
+      uint16_t bitmask = 0;
+      while (i < packet_ids.size()) {
+        uint16_t shift = static_cast<uint16_t>(packet_ids[i] - first_pid - 1);
+        if (shift > 15)
+          break;
+        bitmask |= (1 << shift);
+        ++i;
+      }
+      ByteWriter<uint16_t>::WriteBigEndian(&buffer_[index_], first_pid);
+      ByteWriter<uint16_t>::WriteBigEndian(&buffer_[index_ + 2], bitmask);
+      index_ += kNackItemLength;
+    }
+    WriteHeaderAt(&buffer_[header_index], Nack::kFeedbackMessageType,
+                  Rtpfb::kPacketType, index_ - header_index - kHeaderLength);
+  }
+}
+
+// Picture loss indication (PLI) (RFC 4585).
+// FCI: no feedback control information.
+void CompoundPacketWriter::AddPli(uint32_t sender_ssrc, uint32_t media_ssrc) {
+  Reserve(kHeaderLength + kCommonFeedbackLength);
+  WriteHeader(Pli::kFeedbackMessageType, Psfb::kPacketType,
+              kCommonFeedbackLength);
+  ByteWriter<uint32_t>::WriteBigEndian(&buffer_[index_], sender_ssrc);
+  ByteWriter<uint32_t>::WriteBigEndian(&buffer_[index_ + 4], media_ssrc);
+  index_ += kCommonFeedbackLength;
+}
+
+void CompoundPacketWriter::AddPacket(const RtcpPacket& packet) {
+  packet.Create(buffer_, &index_, max_packet_size_, callback_);
+}
+
+void CompoundPacketWriter::Send() {
+  if (index_ > 0) {
+    callback_(rtc::ArrayView<const uint8_t>(buffer_, index_));
+    index_ = 0;
+  }
+}
+
+}  // namespace rtcp
+}  // namespace webrtc
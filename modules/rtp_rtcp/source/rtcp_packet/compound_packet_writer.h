@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_WRITER_H_
+#define MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "absl/strings/string_view.h"
+#include "api/array_view.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "system_wrappers/include/ntp_time.h"
+
+namespace webrtc {
+namespace rtcp {
+
+// Serializes RTCP blocks directly into a fixed size buffer without creating
+// intermediate RtcpPacket objects. When the next block doesn't fit into the
+// buffer, the pending compound packet is passed to `callback` and the buffer
+// is reused. Blocks that carry lists (report blocks, nack items) are split
+// across several packets when needed. `callback` must outlive the writer.
+//
+// Example:
+//  CompoundPacketWriter writer(send_callback, max_packet_size);
+//  writer.AddReceiverReport(sender_ssrc, report_blocks);
+//  writer.AddSdesCname(sender_ssrc, cname);
+//  writer.AddNack(sender_ssrc, media_ssrc, missing_sequence_numbers);
+//  writer.Send();
+class CompoundPacketWriter {
+ public:
+  CompoundPacketWriter(RtcpPacket::PacketReadyCallback callback,
+                       size_t max_packet_size);
+  CompoundPacketWriter(const CompoundPacketWriter&) = delete;
+  CompoundPacketWriter& operator=(const CompoundPacketWriter&) = delete;
+  ~CompoundPacketWriter();
+
+  // Writes a sender report with up to 31 report blocks. Remaining blocks are
+  // written as additional receiver reports from the same `sender_ssrc`.
+  void AddSenderReport(uint32_t sender_ssrc,
+                       NtpTime ntp,
+                       uint32_t rtp_timestamp,
+                       uint32_t packet_count,
+                       uint32_t octet_count,
+                       rtc::ArrayView<const ReportBlock> report_blocks);
+
+  // Writes as many receiver reports as needed to carry all `report_blocks`.
+  // Writes a single empty receiver report when `report_blocks` is empty.
+  void AddReceiverReport(uint32_t sender_ssrc,
+                         rtc::ArrayView<const ReportBlock> report_blocks);
+
+  // Writes SDES packet with a single CNAME chunk.
+  void AddSdesCname(uint32_t ssrc, absl::string_view cname);
+
+  // Writes generic NACK for the `packet_ids`, which are expected to be sorted
+  // in ascending order (taking wrap around into account).
+  void AddNack(uint32_t sender_ssrc,
+               uint32_t media_ssrc,
+               rtc::ArrayView<const uint16_t> packet_ids);
+
+  void AddPli(uint32_t sender_ssrc, uint32_t media_ssrc);
+
+  // Fallback for the blocks without dedicated writer function. The packet is
+  // serialized straight into the writer buffer.
+  void AddPacket(const RtcpPacket& packet);
+
+  // Sends pending compound packet, if any.
+  void Send();
+
+  bool IsEmpty() const { return index_ == 0; }
+  size_t size() const { return index_; }
+  size_t bytes_left() const { return max_packet_size_ - index_; }
+
+ private:
+  // Ensures at least `bytes` are available in the buffer, sending pending
+  // packet if needed.
+  void Reserve(size_t bytes);
+  void WriteHeader(uint8_t count_or_format,
+                   uint8_t packet_type,
+                   size_t payload_size_bytes);
+  // Writes a single report of the given type with as many `report_blocks` as
+  // fit and removes written blocks from `report_blocks`.
+  void WriteReports(uint8_t packet_type,
+                    size_t fixed_payload_size,
+                    const uint8_t* fixed_payload,
+                    rtc::ArrayView<const ReportBlock>& report_blocks);
+
+  const RtcpPacket::PacketReadyCallback callback_;
+  const size_t max_packet_size_;
+  size_t index_ = 0;
+  uint8_t buffer_[IP_PACKET_SIZE];
+};
+
+}  // namespace rtcp
+}  // namespace webrtc
+#endif  // MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_WRITER_H_
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_writer.h"
+
+#include <vector>
+
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/buffer.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/rtcp_packet_parser.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAreArray;
+using ::testing::MockFunction;
+using ::testing::SizeIs;
+using rtcp::CompoundPacketWriter;
+using rtcp::ReportBlock;
+using test::RtcpPacketParser;
+
+constexpr uint32_t kSenderSsrc = 0x12345678;
+constexpr uint32_t kMediaSsrc = 0x23456789;
+constexpr size_t kMaxPacketSize = 1200;
+
+std::vector<ReportBlock> CreateReportBlocks(size_t num_blocks) {
+  std::vector<ReportBlock> blocks(num_blocks);
+  for (size_t i = 0; i < num_blocks; ++i) {
+    blocks[i].SetMediaSsrc(kMediaSsrc + i);
+    blocks[i].SetExtHighestSeqNum(i);
+  }
+  return blocks;
+}
+
+TEST(RtcpCompoundPacketWriterTest, WritesSameBytesAsRtcpPackets) {
+  std::vector<ReportBlock> report_blocks = CreateReportBlocks(3);
+  const std::vector<uint16_t> kNackList = {1, 2, 5, 30, 31, 60};
+
+  rtcp::ReceiverReport rr;
+  rr.SetSenderSsrc(kSenderSsrc);
+  rr.SetReportBlocks(report_blocks);
+  rtcp::Sdes sdes;
+  sdes.AddCName(kSenderSsrc, "cname");
+  rtcp::Nack nack;
+  nack.SetSenderSsrc(kSenderSsrc);
+  nack.SetMediaSsrc(kMediaSsrc);
+  nack.SetPacketIds(kNackList);
+  rtcp::Pli pli;
+  pli.SetSenderSsrc(kSenderSsrc);
+  pli.SetMediaSsrc(kMediaSsrc);
+  rtc::Buffer expected;
+  expected.AppendData(rr.Build());
+  expected.AppendData(sdes.Build());
+  expected.AppendData(nack.Build());
+  expected.AppendData(pli.Build());
+
+  MockFunction<void(rtc::ArrayView<const uint8_t>)> callback;
+  EXPECT_CALL(callback, Call(ElementsAreArray(expected)));
+  auto send = callback.AsStdFunction();
+  CompoundPacketWriter writer(send, kMaxPacketSize);
+  writer.AddReceiverReport(kSenderSsrc, report_blocks);
+  writer.AddSdesCname(kSenderSsrc, "cname");
+  writer.AddNack(kSenderSsrc, kMediaSsrc, kNackList);
+  writer.AddPli(kSenderSsrc, kMediaSsrc);
+  EXPECT_EQ(writer.size(), expected.size());
+  writer.Send();
+  EXPECT_TRUE(writer.IsEmpty());
+}
+
+TEST(RtcpCompoundPacketWriterTest, WritesSenderReport) {
+  const NtpTime kNtp(0x11223344, 0x55667788);
+  std::vector<ReportBlock> report_blocks = CreateReportBlocks(2);
+
+  RtcpPacketParser parser;
+  MockFunction<void(rtc::ArrayView<const uint8_t>)> callback;
+  EXPECT_CALL(callback, Call).WillOnce(
+      [&](rtc::ArrayView<const uint8_t> packet) { parser.Parse(packet); });
+  auto send = callback.AsStdFunction();
+  CompoundPacketWriter writer(send, kMaxPacketSize);
+  writer.AddSenderReport(kSenderSsrc, kNtp, /*rtp_timestamp=*/0x01020304,
+                         /*packet_count=*/10, /*octet_count=*/1000,
+                         report_blocks);
+  writer.Send();
+
+  ASSERT_EQ(parser.sender_report()->num_packets(), 1);
+  EXPECT_EQ(parser.sender_report()->sender_ssrc(), kSenderSsrc);
+  EXPECT_EQ(parser.sender_report()->ntp(), kNtp);
+  EXPECT_EQ(parser.sender_report()->rtp_timestamp(), 0x01020304u);
+  EXPECT_EQ(parser.sender_report()->sender_packet_count(), 10u);
+  EXPECT_EQ(parser.sender_report()->sender_octet_count(), 1000u);
+  EXPECT_THAT(parser.sender_report()->report_blocks(), SizeIs(2));
+  EXPECT_EQ(parser.receiver_report()->num_packets(), 0);
+}
+
+TEST(RtcpCompoundPacketWriterTest, SplitsReportBlocksIntoSeveralReports) {
+  std::vector<ReportBlock> report_blocks = CreateReportBlocks(40);
+
+  RtcpPacketParser parser;
+  MockFunction<void(rtc::ArrayView<const uint8_t>)> callback;
+  EXPECT_CALL(callback, Call).WillOnce(
+      [&](rtc::ArrayView<const uint8_t> packet) { parser.Parse(packet); });
+  auto send = callback.AsStdFunction();
+  CompoundPacketWriter writer(send, kMaxPacketSize);
+  writer.AddSenderReport(kSenderSsrc, NtpTime(), 0, 0, 0, report_blocks);
+  writer.Send();
+
+  EXPECT_EQ(parser.sender_report()->num_packets(), 1);
+  EXPECT_THAT(parser.sender_report()->report_blocks(),
+              SizeIs(rtcp::SenderReport::kMaxNumberOfReportBlocks));
+  EXPECT_EQ(parser.receiver_report()->num_packets(), 1);
+  EXPECT_EQ(parser.receiver_report()->sender_ssrc(), kSenderSsrc);
+  EXPECT_THAT(parser.receiver_report()->report_blocks(), SizeIs(9));
+}
+
+TEST(RtcpCompoundPacketWriterTest, WritesEmptyReceiverReport) {
+  RtcpPacketParser parser;
+  MockFunction<void(rtc::ArrayView<const uint8_t>)> callback;
+  EXPECT_CALL(callback, Call).WillOnce(
+      [&](rtc::ArrayView<const uint8_t> packet) { parser.Parse(packet); });
+  auto send = callback.AsStdFunction();
+  CompoundPacketWriter writer(send, kMaxPacketSize);
+  writer.AddReceiverReport(kSenderSsrc, {});
+  writer.Send();
+
+  EXPECT_EQ(parser.receiver_report()->num_packets(), 1);
+  EXPECT_THAT(parser.receiver_report()->report_blocks(), SizeIs(0));
+}
+
+TEST(RtcpCompoundPacketWriterTest, SendsWhenBufferIsFull) {
+  // Fits a receiver report with up to 3 report blocks.
+  constexpr size_t kSmallPacketSize = 4 + 4 + 3 * ReportBlock::kLength;
+  std::vector<ReportBlock> report_blocks = CreateReportBlocks(5);
+
+  int num_report_blocks = 0;
+  MockFunction<void(rtc::ArrayView<const uint8_t>)> callback;
+  EXPECT_CALL(callback, Call)
+      .Times(2)
+      .WillRepeatedly([&](rtc::ArrayView<const uint8_t> packet) {
+        EXPECT_LE(packet.size(), kSmallPacketSize);
+        RtcpPacketParser parser;
+        EXPECT_TRUE(parser.Parse(packet));
+        num_report_blocks += parser.receiver_report()->report_blocks().size();
+      });
+  auto send = callback.AsStdFunction();
+  CompoundPacketWriter writer(send, kSmallPacketSize);
+  writer.AddReceiverReport(kSenderSsrc, report_blocks);
+  writer.AddPli(kSenderSsrc, kMediaSsrc);
+  writer.Send();
+
+  EXPECT_EQ(num_report_blocks, 5);
+}
+
+TEST(RtcpCompoundPacketWriterTest, FragmentsNack) {
+  // Smallest allowed packet size fits nack with up to 10 items.
+  constexpr size_t kSmallPacketSize = 4 + 24 + ReportBlock::kLength;
+  std::vector<uint16_t> nack_list;
+  for (uint16_t i = 0; i < 15; ++i) {
+    // Use sequence numbers that can't be packed into same nack item.
+    nack_list.push_back(i * 100);
+  }
+
+  std::vector<uint16_t> parsed_nacks;
+  MockFunction<void(rtc::ArrayView<const uint8_t>)> callback;
+  EXPECT_CALL(callback, Call)
+      .Times(2)
+      .WillRepeatedly([&](rtc::ArrayView<const uint8_t> packet) {
+        RtcpPacketParser parser;
+        EXPECT_TRUE(parser.Parse(packet));
+        EXPECT_EQ(parser.nack()->media_ssrc(), kMediaSsrc);
+        for (uint16_t seq_num : parser.nack()->packet_ids()) {
+          parsed_nacks.push_back(seq_num);
+        }
+      });
+  auto send = callback.AsStdFunction();
+  CompoundPacketWriter writer(send, kSmallPacketSize);
+  writer.AddNack(kSenderSsrc, kMediaSsrc, nack_list);
+  writer.Send();
+
+  EXPECT_EQ(parsed_nacks, nack_list);
+}
+
+TEST(RtcpCompoundPacketWriterTest, AddsRtcpPacketDirectly) {
+  rtcp::TransportFeedback feedback;
+  feedback.SetSenderSsrc(kSenderSsrc);
+  feedback.SetMediaSsrc(kMediaSsrc);
+  feedback.SetBase(/*base_sequence=*/10, Timestamp::Millis(100));
+  ASSERT_TRUE(feedback.AddReceivedPacket(10, Timestamp::Millis(100)));
+
+  RtcpPacketParser parser;
+  MockFunction<void(rtc::ArrayView<const uint8_t>)> callback;
+  EXPECT_CALL(callback, Call).WillOnce(
+      [&](rtc::ArrayView<const uint8_t> packet) { parser.Parse(packet); });
+  auto send = callback.AsStdFunction();
+  CompoundPacketWriter writer(send, kMaxPacketSize);
+  writer.AddReceiverReport(kSenderSsrc, {});
+  writer.AddPacket(feedback);
+  writer.Send();
+
+  EXPECT_EQ(parser.receiver_report()->num_packets(), 1);
+  EXPECT_EQ(parser.transport_feedback()->num_packets(), 1);
+}
+
+TEST(RtcpCompoundPacketWriterTest, DoesNotSendEmptyPacket) {
+  MockFunction<void(rtc::ArrayView<const uint8_t>)> callback;
+  EXPECT_CALL(callback, Call).Times(0);
+  auto send = callback.AsStdFunction();
+  CompoundPacketWriter writer(send, kMaxPacketSize);
+  writer.Send();
+}
+
+}  // namespace
+}  // namespace webrtc
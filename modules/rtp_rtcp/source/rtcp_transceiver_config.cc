@@ -61,6 +61,15 @@ bool RtcpTransceiverConfig::Validate() const {
                       << "missing task queue for periodic compound packets";
     return false;
   }
+  if (max_feedback_delay < TimeDelta::Zero()) {
+    RTC_LOG(LS_ERROR) << debug_id << "max feedback delay "
+                      << max_feedback_delay.ms() << "ms shouldn't be negative.";
+    return false;
+  }
+  if (max_feedback_delay > TimeDelta::Zero() && task_queue == nullptr) {
+    RTC_LOG(LS_ERROR) << debug_id << "missing task queue for delayed feedback";
+    return false;
+  }
   if (rtcp_mode != RtcpMode::kCompound && rtcp_mode != RtcpMode::kReducedSize) {
     RTC_LOG(LS_ERROR) << debug_id << "unsupported rtcp mode";
     return false;
@@ -146,6 +146,13 @@ struct RtcpTransceiverConfig {
   // Period between periodic compound packets.
   TimeDelta report_period = TimeDelta::Seconds(1);
 
+  // When positive, NACK and PLI requests are not sent immediately, but queued
+  // for up to this delay so that requests for all media streams sharing the
+  // transport are packed together into as few RTCP packets as possible.
+  // Queued requests are also sent earlier with any other outgoing compound
+  // packet. Zero sends every request in its own packet.
+  TimeDelta max_feedback_delay = TimeDelta::Zero();
+
   //
   // Flags for features and experiments.
   //
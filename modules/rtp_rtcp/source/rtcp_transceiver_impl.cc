@@ -23,6 +23,7 @@
 #include "modules/rtp_rtcp/source/rtcp_packet.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_writer.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
@@ -35,8 +36,9 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/containers/flat_map.h"
+#include "rtc_base/containers/flat_set.h"
 #include "rtc_base/logging.h"
-#include "rtc_base/numerics/divide_round.h"
+#include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/task_utils/repeating_task.h"
 #include "rtc_base/time_utils.h"
 #include "system_wrappers/include/clock.h"
@@ -83,43 +85,6 @@ struct RtcpTransceiverImpl::LocalSenderState {
   RtpStreamRtcpHandler* handler = nullptr;
 };
 
-// Helper to put several RTCP packets into lower layer datagram composing
-// Compound or Reduced-Size RTCP packet, as defined by RFC 5506 section 2.
-// TODO(bugs.webrtc.org/8239): When in compound mode and packets are so many
-// that several compound RTCP packets need to be generated, ensure each packet
-// is compound.
-class RtcpTransceiverImpl::PacketSender {
- public:
-  PacketSender(rtcp::RtcpPacket::PacketReadyCallback callback,
-               size_t max_packet_size)
-      : callback_(callback), max_packet_size_(max_packet_size) {
-    RTC_CHECK_LE(max_packet_size, IP_PACKET_SIZE);
-  }
-  ~PacketSender() { RTC_DCHECK_EQ(index_, 0) << "Unsent rtcp packet."; }
-
-  // Appends a packet to pending compound packet.
-  // Sends rtcp compound packet if buffer was already full and resets buffer.
-  void AppendPacket(const rtcp::RtcpPacket& packet) {
-    packet.Create(buffer_, &index_, max_packet_size_, callback_);
-  }
-
-  // Sends pending rtcp compound packet.
-  void Send() {
-    if (index_ > 0) {
-      callback_(rtc::ArrayView<const uint8_t>(buffer_, index_));
-      index_ = 0;
-    }
-  }
-
-  bool IsEmpty() const { return index_ == 0; }
-
- private:
-  const rtcp::RtcpPacket::PacketReadyCallback callback_;
-  const size_t max_packet_size_;
-  size_t index_ = 0;
-  uint8_t buffer_[IP_PACKET_SIZE];
-};
-
 RtcpTransceiverImpl::RtcpTransceiverImpl(const RtcpTransceiverConfig& config)
     : config_(config),
       rtcp_transport_(GetRtcpTransport(config_)),
@@ -185,6 +150,12 @@ bool RtcpTransceiverImpl::RemoveMediaSender(uint32_t local_ssrc) {
 }
 
 void RtcpTransceiverImpl::SetReadyToSend(bool ready) {
+  if (ready_to_send_ && !ready) {
+    // Feedback would be outdated by the time transport is ready again.
+    pending_feedback_task_handle_.Stop();
+    pending_nacks_.clear();
+    pending_plis_.clear();
+  }
   if (config_.schedule_periodic_compound_packets) {
     if (ready_to_send_ && !ready)
       periodic_task_handle_.Stop();
@@ -252,6 +223,12 @@ void RtcpTransceiverImpl::SendNack(uint32_t ssrc,
   RTC_DCHECK(!sequence_numbers.empty());
   if (!ready_to_send_)
     return;
+  if (config_.max_feedback_delay > TimeDelta::Zero()) {
+    pending_nacks_[ssrc].insert(sequence_numbers.begin(),
+                                sequence_numbers.end());
+    SchedulePendingFeedback();
+    return;
+  }
   rtcp::Nack nack;
   nack.SetSenderSsrc(config_.feedback_ssrc);
   nack.SetMediaSsrc(ssrc);
@@ -262,6 +239,11 @@ void RtcpTransceiverImpl::SendNack(uint32_t ssrc,
 void RtcpTransceiverImpl::SendPictureLossIndication(uint32_t ssrc) {
   if (!ready_to_send_)
     return;
+  if (config_.max_feedback_delay > TimeDelta::Zero()) {
+    pending_plis_.insert(ssrc);
+    SchedulePendingFeedback();
+    return;
+  }
   rtcp::Pli pli;
   pli.SetSenderSsrc(config_.feedback_ssrc);
   pli.SetMediaSsrc(ssrc);
@@ -628,7 +610,7 @@ void RtcpTransceiverImpl::SchedulePeriodicCompoundPackets(TimeDelta delay) {
 std::vector<uint32_t> RtcpTransceiverImpl::FillReports(
     Timestamp now,
     ReservedBytes reserved,
-    PacketSender& rtcp_sender) {
+    rtcp::CompoundPacketWriter& rtcp_sender) {
   // Sender/receiver reports should be first in the RTCP packet.
   RTC_DCHECK(rtcp_sender.IsEmpty());
 
@@ -667,7 +649,7 @@ std::vector<uint32_t> RtcpTransceiverImpl::FillReports(
       sender_report_size_bytes;
 
   auto last_handled_sender_it = local_senders_.end();
-  auto report_block_it = report_blocks.begin();
+  rtc::ArrayView<const rtcp::ReportBlock> remaining_blocks = report_blocks;
   std::vector<uint32_t> sender_ssrcs;
   for (auto it = local_senders_.begin();
        it != local_senders_.end() && sender_ssrcs.size() < max_sender_reports;
@@ -687,26 +669,18 @@ std::vector<uint32_t> RtcpTransceiverImpl::FillReports(
     rtp_sender.last_num_sent_bytes = stats.num_sent_bytes();
 
     last_handled_sender_it = it;
-    rtcp::SenderReport sender_report;
-    sender_report.SetSenderSsrc(rtp_sender.ssrc);
-    sender_report.SetPacketCount(stats.num_sent_packets());
-    sender_report.SetOctetCount(stats.num_sent_bytes());
-    sender_report.SetNtp(config_.clock->ConvertTimestampToNtpTime(now));
     RTC_DCHECK_GE(now, stats.last_capture_time());
-    sender_report.SetRtpTimestamp(
+    uint32_t rtp_timestamp =
         stats.last_rtp_timestamp() +
         ((now - stats.last_capture_time()) * stats.last_clock_rate())
-            .seconds());
-    if (report_block_it != report_blocks.end()) {
-      size_t num_blocks =
-          std::min<size_t>(rtcp::SenderReport::kMaxNumberOfReportBlocks,
-                           report_blocks.end() - report_block_it);
-      std::vector<rtcp::ReportBlock> sub_blocks(report_block_it,
-                                                report_block_it + num_blocks);
-      sender_report.SetReportBlocks(std::move(sub_blocks));
-      report_block_it += num_blocks;
-    }
-    rtcp_sender.AppendPacket(sender_report);
+            .seconds();
+    size_t num_blocks = std::min<size_t>(
+        rtcp::SenderReport::kMaxNumberOfReportBlocks, remaining_blocks.size());
+    rtcp_sender.AddSenderReport(
+        rtp_sender.ssrc, config_.clock->ConvertTimestampToNtpTime(now),
+        rtp_timestamp, stats.num_sent_packets(), stats.num_sent_bytes(),
+        remaining_blocks.subview(0, num_blocks));
+    remaining_blocks = remaining_blocks.subview(num_blocks);
     sender_ssrcs.push_back(rtp_sender.ssrc);
   }
   if (last_handled_sender_it != local_senders_.end()) {
@@ -718,40 +692,25 @@ std::vector<uint32_t> RtcpTransceiverImpl::FillReports(
                           std::next(last_handled_sender_it));
   }
 
-  // Calculcate number of receiver reports to attach remaining report blocks to.
-  size_t num_receiver_reports =
-      DivideRoundUp(report_blocks.end() - report_block_it,
-                    rtcp::ReceiverReport::kMaxNumberOfReportBlocks);
-
+  // Attach remaining report blocks to as many receiver reports as needed.
   // In compound mode each RTCP packet has to start with a sender or receiver
-  // report.
-  if (config_.rtcp_mode == RtcpMode::kCompound && sender_ssrcs.empty() &&
-      num_receiver_reports == 0) {
-    num_receiver_reports = 1;
+  // report, so an empty receiver report is written when there is nothing else.
+  if (!remaining_blocks.empty() ||
+      (config_.rtcp_mode == RtcpMode::kCompound && sender_ssrcs.empty())) {
+    uint32_t sender_ssrc =
+        sender_ssrcs.empty() ? config_.feedback_ssrc : sender_ssrcs.front();
+    rtcp_sender.AddReceiverReport(sender_ssrc, remaining_blocks);
   }
-
-  uint32_t sender_ssrc =
-      sender_ssrcs.empty() ? config_.feedback_ssrc : sender_ssrcs.front();
-  for (size_t i = 0; i < num_receiver_reports; ++i) {
-    rtcp::ReceiverReport receiver_report;
-    receiver_report.SetSenderSsrc(sender_ssrc);
-    size_t num_blocks =
-        std::min<size_t>(rtcp::ReceiverReport::kMaxNumberOfReportBlocks,
-                         report_blocks.end() - report_block_it);
-    std::vector<rtcp::ReportBlock> sub_blocks(report_block_it,
-                                              report_block_it + num_blocks);
-    receiver_report.SetReportBlocks(std::move(sub_blocks));
-    report_block_it += num_blocks;
-    rtcp_sender.AppendPacket(receiver_report);
-  }
-  // All report blocks should be attached at this point.
-  RTC_DCHECK_EQ(report_blocks.end() - report_block_it, 0);
   return sender_ssrcs;
 }
 
-void RtcpTransceiverImpl::CreateCompoundPacket(Timestamp now,
-                                               size_t reserved_bytes,
-                                               PacketSender& sender) {
+// TODO(bugs.webrtc.org/8239): When in compound mode and packets are so many
+// that several compound RTCP packets need to be generated, ensure each packet
+// is compound.
+void RtcpTransceiverImpl::CreateCompoundPacket(
+    Timestamp now,
+    size_t reserved_bytes,
+    rtcp::CompoundPacketWriter& sender) {
   RTC_DCHECK(sender.IsEmpty());
   ReservedBytes reserved = {.per_packet = reserved_bytes};
   std::optional<rtcp::Sdes> sdes;
@@ -802,11 +761,11 @@ void RtcpTransceiverImpl::CreateCompoundPacket(Timestamp now,
       has_sender_report ? sender_ssrcs.front() : config_.feedback_ssrc;
 
   if (sdes.has_value() && !sender.IsEmpty()) {
-    sender.AppendPacket(*sdes);
+    sender.AddPacket(*sdes);
   }
   if (remb_.has_value()) {
     remb_->SetSenderSsrc(sender_ssrc);
-    sender.AppendPacket(*remb_);
+    sender.AddPacket(*remb_);
   }
   if (!has_sender_report && config_.non_sender_rtt_measurement) {
     rtcp::ExtendedReports xr_with_rrtr;
@@ -814,7 +773,7 @@ void RtcpTransceiverImpl::CreateCompoundPacket(Timestamp now,
     rtcp::Rrtr rrtr;
     rrtr.SetNtp(config_.clock->ConvertTimestampToNtpTime(now));
     xr_with_rrtr.SetRrtr(rrtr);
-    sender.AppendPacket(xr_with_rrtr);
+    sender.AddPacket(xr_with_rrtr);
   }
   if (xr_with_dlrr.has_value()) {
     rtc::ArrayView<const uint32_t> ssrcs(&sender_ssrc, 1);
@@ -825,32 +784,33 @@ void RtcpTransceiverImpl::CreateCompoundPacket(Timestamp now,
     RTC_DCHECK(!ssrcs.empty());
     for (uint32_t ssrc : ssrcs) {
       xr_with_dlrr->SetSenderSsrc(ssrc);
-      sender.AppendPacket(*xr_with_dlrr);
+      sender.AddPacket(*xr_with_dlrr);
     }
   }
 }
 
 void RtcpTransceiverImpl::SendPeriodicCompoundPacket() {
   Timestamp now = config_.clock->CurrentTime();
-  PacketSender sender(rtcp_transport_, config_.max_packet_size);
+  rtcp::CompoundPacketWriter sender(rtcp_transport_, config_.max_packet_size);
   CreateCompoundPacket(now, /*reserved_bytes=*/0, sender);
+  MaybeAppendPendingFeedback(sender);
   sender.Send();
 }
 
 void RtcpTransceiverImpl::SendCombinedRtcpPacket(
     std::vector<std::unique_ptr<rtcp::RtcpPacket>> rtcp_packets) {
-  PacketSender sender(rtcp_transport_, config_.max_packet_size);
+  rtcp::CompoundPacketWriter sender(rtcp_transport_, config_.max_packet_size);
 
   for (auto& rtcp_packet : rtcp_packets) {
     rtcp_packet->SetSenderSsrc(config_.feedback_ssrc);
-    sender.AppendPacket(*rtcp_packet);
+    sender.AddPacket(*rtcp_packet);
   }
   sender.Send();
 }
 
 void RtcpTransceiverImpl::SendImmediateFeedback(
     const rtcp::RtcpPacket& rtcp_packet) {
-  PacketSender sender(rtcp_transport_, config_.max_packet_size);
+  rtcp::CompoundPacketWriter sender(rtcp_transport_, config_.max_packet_size);
   // Compound mode requires every sent rtcp packet to be compound, i.e. start
   // with a sender or receiver report.
   if (config_.rtcp_mode == RtcpMode::kCompound) {
@@ -859,7 +819,8 @@ void RtcpTransceiverImpl::SendImmediateFeedback(
                          sender);
   }
 
-  sender.AppendPacket(rtcp_packet);
+  sender.AddPacket(rtcp_packet);
+  MaybeAppendPendingFeedback(sender);
   sender.Send();
 
   // If compound packet was sent, delay (reschedule) the periodic one.
@@ -867,6 +828,78 @@ void RtcpTransceiverImpl::SendImmediateFeedback(
     ReschedulePeriodicCompoundPackets();
 }
 
+void RtcpTransceiverImpl::SendPendingFeedback() {
+  if (pending_nacks_.empty() && pending_plis_.empty())
+    return;
+  rtcp::CompoundPacketWriter sender(rtcp_transport_, config_.max_packet_size);
+  if (config_.rtcp_mode == RtcpMode::kCompound) {
+    Timestamp now = config_.clock->CurrentTime();
+    CreateCompoundPacket(now, /*reserved_bytes=*/PendingFeedbackSize(), sender);
+  }
+  AppendPendingFeedback(sender);
+  sender.Send();
+
+  if (config_.rtcp_mode == RtcpMode::kCompound)
+    ReschedulePeriodicCompoundPackets();
+}
+
+void RtcpTransceiverImpl::SchedulePendingFeedback() {
+  RTC_DCHECK(config_.task_queue);
+  if (pending_feedback_task_handle_.Running())
+    return;
+  // Feedback is latency sensitive, thus unlike periodic reports it uses high
+  // precision delay.
+  pending_feedback_task_handle_ = RepeatingTaskHandle::DelayedStart(
+      config_.task_queue, config_.max_feedback_delay,
+      [this] {
+        RTC_DCHECK(ready_to_send_);
+        SendPendingFeedback();
+        return TimeDelta::PlusInfinity();
+      },
+      TaskQueueBase::DelayPrecision::kHigh, config_.clock);
+}
+
+size_t RtcpTransceiverImpl::PendingFeedbackSize() const {
+  // Common header, sender and media ssrc.
+  constexpr size_t kFeedbackHeaderSize = 12;
+  size_t size = kFeedbackHeaderSize * pending_plis_.size();
+  for (const auto& [media_ssrc, sequence_numbers] : pending_nacks_) {
+    // Upper bound: assumes none of the sequence numbers share a nack item.
+    size += kFeedbackHeaderSize + 4 * sequence_numbers.size();
+  }
+  return size;
+}
+
+void RtcpTransceiverImpl::MaybeAppendPendingFeedback(
+    rtcp::CompoundPacketWriter& rtcp_sender) {
+  if (pending_nacks_.empty() && pending_plis_.empty())
+    return;
+  // Reports are not squeezed out for the queued feedback: it is only attached
+  // when it fits into the space left, otherwise its own timer sends it.
+  if (PendingFeedbackSize() <= rtcp_sender.bytes_left())
+    AppendPendingFeedback(rtcp_sender);
+}
+
+void RtcpTransceiverImpl::AppendPendingFeedback(
+    rtcp::CompoundPacketWriter& rtcp_sender) {
+  pending_feedback_task_handle_.Stop();
+  std::vector<uint16_t> packet_ids;
+  for (const auto& [media_ssrc, sequence_numbers] : pending_nacks_) {
+    // Order the sequence numbers taking wrap around into account, so that
+    // they can be packed into as few nack items as possible.
+    packet_ids.assign(sequence_numbers.begin(), sequence_numbers.end());
+    absl::c_sort(packet_ids, [](uint16_t a, uint16_t b) {
+      return AheadOf<uint16_t>(b, a);
+    });
+    rtcp_sender.AddNack(config_.feedback_ssrc, media_ssrc, packet_ids);
+  }
+  for (uint32_t media_ssrc : pending_plis_) {
+    rtcp_sender.AddPli(config_.feedback_ssrc, media_ssrc);
+  }
+  pending_nacks_.clear();
+  pending_plis_.clear();
+}
+
 std::vector<rtcp::ReportBlock> RtcpTransceiverImpl::CreateReportBlocks(
     Timestamp now,
     size_t num_max_blocks) {
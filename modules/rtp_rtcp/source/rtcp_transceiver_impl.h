@@ -20,12 +20,14 @@
 #include "api/array_view.h"
 #include "api/units/timestamp.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_writer.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/target_bitrate.h"
 #include "modules/rtp_rtcp/source/rtcp_transceiver_config.h"
 #include "rtc_base/containers/flat_map.h"
+#include "rtc_base/containers/flat_set.h"
 #include "rtc_base/task_utils/repeating_task.h"
 #include "system_wrappers/include/ntp_time.h"
 
@@ -41,7 +43,10 @@ class RtcpTransceiverImpl {
   RtcpTransceiverImpl& operator=(const RtcpTransceiverImpl&) = delete;
   ~RtcpTransceiverImpl();
 
-  void StopPeriodicTask() { periodic_task_handle_.Stop(); }
+  void StopPeriodicTask() {
+    periodic_task_handle_.Stop();
+    pending_feedback_task_handle_.Stop();
+  }
 
   void AddMediaReceiverRtcpObserver(uint32_t remote_ssrc,
                                     MediaReceiverRtcpObserver* observer);
@@ -76,7 +81,6 @@ class RtcpTransceiverImpl {
       std::vector<std::unique_ptr<rtcp::RtcpPacket>> rtcp_packets);
 
  private:
-  class PacketSender;
   struct RemoteSenderState;
   struct LocalSenderState;
   struct RrtrTimes {
@@ -138,17 +142,29 @@ class RtcpTransceiverImpl {
   };
   std::vector<uint32_t> FillReports(Timestamp now,
                                     ReservedBytes reserved_bytes,
-                                    PacketSender& rtcp_sender);
+                                    rtcp::CompoundPacketWriter& rtcp_sender);
 
   // Creates compound RTCP packet, as defined in
   // https://tools.ietf.org/html/rfc5506#section-2
   void CreateCompoundPacket(Timestamp now,
                             size_t reserved_bytes,
-                            PacketSender& rtcp_sender);
+                            rtcp::CompoundPacketWriter& rtcp_sender);
 
   // Sends RTCP packets.
   void SendPeriodicCompoundPacket();
   void SendImmediateFeedback(const rtcp::RtcpPacket& rtcp_packet);
+  void SendPendingFeedback();
+
+  // Feedback aggregation, used when `config_.max_feedback_delay` is positive.
+  void SchedulePendingFeedback();
+  // Number of bytes `AppendPendingFeedback` would write.
+  size_t PendingFeedbackSize() const;
+  // Appends queued NACKs and PLIs for all media streams to the `rtcp_sender`
+  // and clears the queue.
+  void AppendPendingFeedback(rtcp::CompoundPacketWriter& rtcp_sender);
+  // Same, but only if the queued feedback fits into the pending packet of
+  // `rtcp_sender`, so that it doesn't spill into another packet.
+  void MaybeAppendPendingFeedback(rtcp::CompoundPacketWriter& rtcp_sender);
   // Generate Report Blocks to be send in Sender or Receiver Reports.
   std::vector<rtcp::ReportBlock> CreateReportBlocks(Timestamp now,
                                                     size_t num_max_blocks);
@@ -166,6 +182,11 @@ class RtcpTransceiverImpl {
       local_senders_by_ssrc_;
   flat_map<uint32_t, RrtrTimes> received_rrtrs_;
   RepeatingTaskHandle periodic_task_handle_;
+
+  // Feedback queued for the aggregated sending, per media ssrc.
+  flat_map<uint32_t, flat_set<uint16_t>> pending_nacks_;
+  flat_set<uint32_t> pending_plis_;
+  RepeatingTaskHandle pending_feedback_task_handle_;
 };
 
 }  // namespace webrtc
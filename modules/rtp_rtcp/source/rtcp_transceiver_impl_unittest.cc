@@ -11,6 +11,7 @@
 #include "modules/rtp_rtcp/source/rtcp_transceiver_impl.h"
 
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -40,6 +41,7 @@ namespace webrtc {
 namespace {
 
 using ::testing::_;
+using ::testing::AnyNumber;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::Ge;
@@ -1188,6 +1190,133 @@ TEST_F(RtcpTransceiverImplTest, KeyFrameRequestCreatesReducedSizePacket) {
   EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 0);
 }
 
+TEST_F(RtcpTransceiverImplTest, AggregatesFeedbackForAllMediaStreams) {
+  static constexpr uint32_t kRemoteSsrc1 = 4321;
+  static constexpr uint32_t kRemoteSsrc2 = 5321;
+  auto queue = CreateTaskQueue();
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  config.task_queue = queue.get();
+  config.max_feedback_delay = TimeDelta::Millis(5);
+  RtcpPacketParser rtcp_parser;
+  config.rtcp_transport = RtcpParserTransport(rtcp_parser);
+  std::optional<RtcpTransceiverImpl> rtcp_transceiver;
+  queue->PostTask([&] {
+    rtcp_transceiver.emplace(config);
+    rtcp_transceiver->SendNack(kRemoteSsrc1, {34, 37});
+    rtcp_transceiver->SendPictureLossIndication(kRemoteSsrc1);
+    rtcp_transceiver->SendNack(kRemoteSsrc2, {38, 40});
+    rtcp_transceiver->SendNack(kRemoteSsrc2, {40, 39});
+    rtcp_transceiver->SendPictureLossIndication(kRemoteSsrc1);
+  });
+
+  AdvanceTime(TimeDelta::Millis(4));
+  EXPECT_EQ(rtcp_parser.processed_rtcp_packets(), size_t{0});
+
+  AdvanceTime(TimeDelta::Millis(1));
+  EXPECT_EQ(rtcp_parser.processed_rtcp_packets(), size_t{1});
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.nack()->num_packets(), 2);
+  EXPECT_EQ(rtcp_parser.nack()->media_ssrc(), kRemoteSsrc2);
+  EXPECT_THAT(rtcp_parser.nack()->packet_ids(), ElementsAre(38, 39, 40));
+  EXPECT_EQ(rtcp_parser.pli()->num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.pli()->media_ssrc(), kRemoteSsrc1);
+
+  // Nothing left to send.
+  AdvanceTime(TimeDelta::Millis(10));
+  EXPECT_EQ(rtcp_parser.processed_rtcp_packets(), size_t{1});
+
+  // Cleanup.
+  bool done = false;
+  queue->PostTask([&] {
+    rtcp_transceiver->StopPeriodicTask();
+    rtcp_transceiver.reset();
+    done = true;
+  });
+  ASSERT_TRUE(time_controller().Wait([&] { return done; }, kAlmostForever));
+}
+
+TEST_F(RtcpTransceiverImplTest, SendsQueuedFeedbackWithNextCompoundPacket) {
+  static constexpr uint32_t kRemoteSsrc = 4321;
+  auto queue = CreateTaskQueue();
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  config.task_queue = queue.get();
+  config.max_feedback_delay = TimeDelta::Millis(5);
+  RtcpPacketParser rtcp_parser;
+  config.rtcp_transport = RtcpParserTransport(rtcp_parser);
+  std::optional<RtcpTransceiverImpl> rtcp_transceiver;
+  queue->PostTask([&] {
+    rtcp_transceiver.emplace(config);
+    rtcp_transceiver->SendNack(kRemoteSsrc, {34, 37});
+    rtcp_transceiver->SendCompoundPacket();
+  });
+
+  AdvanceTime(TimeDelta::Zero());
+  EXPECT_EQ(rtcp_parser.processed_rtcp_packets(), size_t{1});
+  EXPECT_EQ(rtcp_parser.nack()->num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.nack()->media_ssrc(), kRemoteSsrc);
+
+  AdvanceTime(TimeDelta::Millis(10));
+  EXPECT_EQ(rtcp_parser.processed_rtcp_packets(), size_t{1});
+
+  // Cleanup.
+  bool done = false;
+  queue->PostTask([&] {
+    rtcp_transceiver->StopPeriodicTask();
+    rtcp_transceiver.reset();
+    done = true;
+  });
+  ASSERT_TRUE(time_controller().Wait([&] { return done; }, kAlmostForever));
+}
+
+TEST_F(RtcpTransceiverImplTest, QueuedFeedbackDoesNotSqueezeOutReportBlocks) {
+  static constexpr uint32_t kRemoteSsrc = 4321;
+  std::vector<ReportBlock> statistics_report_blocks(40);
+  NiceMock<MockReceiveStatisticsProvider> receive_statistics;
+  EXPECT_CALL(receive_statistics, RtcpReportBlocks).Times(AnyNumber());
+  // The compound packet still has room for all report blocks.
+  EXPECT_CALL(receive_statistics, RtcpReportBlocks(/*max_blocks=*/Ge(40u)))
+      .WillOnce(Return(statistics_report_blocks));
+  auto queue = CreateTaskQueue();
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  config.task_queue = queue.get();
+  config.max_feedback_delay = TimeDelta::Millis(5);
+  config.receive_statistics = &receive_statistics;
+  RtcpPacketParser rtcp_parser;
+  config.rtcp_transport = RtcpParserTransport(rtcp_parser);
+  // Sequence numbers too far apart to share nack items, too many to fit into
+  // the packet next to the reports.
+  std::vector<uint16_t> sequence_numbers;
+  for (uint16_t i = 0; i < 300; ++i) {
+    sequence_numbers.push_back(i * 17);
+  }
+  std::optional<RtcpTransceiverImpl> rtcp_transceiver;
+  queue->PostTask([&] {
+    rtcp_transceiver.emplace(config);
+    rtcp_transceiver->SendNack(kRemoteSsrc, sequence_numbers);
+    rtcp_transceiver->SendCompoundPacket();
+  });
+
+  AdvanceTime(TimeDelta::Zero());
+  EXPECT_EQ(rtcp_parser.processed_rtcp_packets(), size_t{1});
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 2);
+  EXPECT_THAT(rtcp_parser.receiver_report()->report_blocks(), SizeIs(9));
+  EXPECT_EQ(rtcp_parser.nack()->num_packets(), 0);
+
+  // The feedback is sent on its own when the aggregation delay expires.
+  AdvanceTime(TimeDelta::Millis(5));
+  EXPECT_GT(rtcp_parser.nack()->num_packets(), 0);
+  EXPECT_EQ(rtcp_parser.nack()->media_ssrc(), kRemoteSsrc);
+
+  // Cleanup.
+  bool done = false;
+  queue->PostTask([&] {
+    rtcp_transceiver->StopPeriodicTask();
+    rtcp_transceiver.reset();
+    done = true;
+  });
+  ASSERT_TRUE(time_controller().Wait([&] { return done; }, kAlmostForever));
+}
+
 TEST_F(RtcpTransceiverImplTest, SendsXrRrtrWhenEnabled) {
   const uint32_t kSenderSsrc = 4321;
   RtcpTransceiverConfig config = DefaultTestConfig();
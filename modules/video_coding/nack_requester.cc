@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <utility>
 
 #include "api/sequence_checker.h"
 #include "api/units/timestamp.h"
@@ -23,6 +24,11 @@ namespace webrtc {
 
 namespace {
 constexpr int kMaxPacketAge = 10'000;
+// Smallest power of two that covers `kMaxPacketAge` packets.
+constexpr size_t kTrackedWindowSize = 1 << 14;
+static_assert(kTrackedWindowSize > kMaxPacketAge);
+// Number of erased packets in the nack list tolerated before it is compacted.
+constexpr size_t kMinErasedToCompact = 64;
 constexpr int kMaxNackPackets = 1000;
 constexpr TimeDelta kDefaultRtt = TimeDelta::Millis(100);
 // Number of times a packet can be nacked before giving up. Nack is sent at most
@@ -106,6 +112,90 @@ NackRequester::NackInfo::NackInfo(uint16_t seq_num,
       sent_at_time(Timestamp::MinusInfinity()),
       retries(0) {}
 
+NackRequester::NackList::NackList(size_t window_size)
+    : pending_(window_size) {}
+
+NackRequester::NackList::~NackList() = default;
+
+void NackRequester::NackList::PushBack(const NackInfo& info) {
+  Trim();
+  RTC_DCHECK(count_ == 0 || AheadOf(info.seq_num, at(count_ - 1).seq_num));
+  if (count_ == ring_.size()) {
+    std::vector<NackInfo> ring(std::max<size_t>(2 * ring_.size(), 64));
+    for (size_t i = 0; i < count_; ++i) {
+      ring[i] = at(i);
+    }
+    ring_ = std::move(ring);
+    head_ = 0;
+  }
+  at(count_) = info;
+  ++count_;
+  bool inserted = pending_.Insert(info.seq_num);
+  RTC_DCHECK(inserted);
+}
+
+int NackRequester::NackList::Erase(uint16_t seq_num) {
+  if (!pending_.Erase(seq_num)) {
+    return 0;
+  }
+  // Binary search for the packet, sequence numbers are ordered relative to
+  // the first one in the list.
+  const uint16_t first = at(0).seq_num;
+  const uint16_t distance = seq_num - first;
+  size_t low = 0;
+  size_t high = count_;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (static_cast<uint16_t>(at(mid).seq_num - first) < distance) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  RTC_DCHECK_LT(low, count_);
+  RTC_DCHECK_EQ(at(low).seq_num, seq_num);
+  int retries = at(low).retries;
+  Trim();
+  return retries;
+}
+
+void NackRequester::NackList::EraseOlderThan(uint16_t seq_num) {
+  pending_.EraseOlderThan(seq_num);
+  Trim();
+}
+
+void NackRequester::NackList::Clear() {
+  pending_.Clear();
+  head_ = 0;
+  count_ = 0;
+  first_never_sent_ = 0;
+}
+
+void NackRequester::NackList::Trim() {
+  while (count_ > 0 && !IsPending(0)) {
+    head_ = (head_ + 1) & (ring_.size() - 1);
+    --count_;
+    if (first_never_sent_ > 0) {
+      --first_never_sent_;
+    }
+  }
+  if (count_ - size() >= size() + kMinErasedToCompact) {
+    size_t num_pending = 0;
+    for (size_t i = 0; i < count_; ++i) {
+      if (IsPending(i)) {
+        at(num_pending++) = at(i);
+      }
+    }
+    count_ = num_pending;
+    first_never_sent_ = 0;
+  }
+  while (first_never_sent_ < count_ &&
+         (!IsPending(first_never_sent_) ||
+          at(first_never_sent_).sent_at_time.IsFinite())) {
+    ++first_never_sent_;
+  }
+}
+
 NackRequester::NackRequester(TaskQueueBase* current_queue,
                              NackPeriodicProcessor* periodic_processor,
                              Clock* clock,
@@ -116,6 +206,8 @@ NackRequester::NackRequester(TaskQueueBase* current_queue,
       clock_(clock),
       nack_sender_(nack_sender),
       keyframe_request_sender_(keyframe_request_sender),
+      nack_list_(kTrackedWindowSize),
+      recovered_list_(kTrackedWindowSize),
       reordering_histogram_(kNumReorderingBuckets, kMaxReorderedPackets),
       initialized_(false),
       rtt_(kDefaultRtt),
@@ -170,11 +262,9 @@ int NackRequester::OnReceivedPacket(uint16_t seq_num,
 
   if (AheadOf(newest_seq_num_, seq_num)) {
     // An out of order packet has been received.
-    auto nack_list_it = nack_list_.find(seq_num);
     int nacks_sent_for_packet = 0;
-    if (nack_list_it != nack_list_.end()) {
-      nacks_sent_for_packet = nack_list_it->second.retries;
-      nack_list_.erase(nack_list_it);
+    if (nack_list_.Contains(seq_num)) {
+      nacks_sent_for_packet = nack_list_.Erase(seq_num);
     }
     if (!is_retransmitted)
       UpdateReorderingStatistics(seq_num);
@@ -182,12 +272,10 @@ int NackRequester::OnReceivedPacket(uint16_t seq_num,
   }
 
   if (is_recovered) {
-    recovered_list_.insert(seq_num);
+    recovered_list_.Insert(seq_num);
 
     // Remove old ones so we don't accumulate recovered packets.
-    auto it = recovered_list_.lower_bound(seq_num - kMaxPacketAge);
-    if (it != recovered_list_.begin())
-      recovered_list_.erase(recovered_list_.begin(), it);
+    recovered_list_.EraseOlderThan(seq_num - kMaxPacketAge);
 
     // Do not send nack for packets recovered by FEC or RTX.
     return 0;
@@ -214,9 +302,8 @@ void NackRequester::ClearUpTo(uint16_t seq_num) {
   // needs to be posted to the worker thread if callers migrate to the network
   // thread.
   RTC_DCHECK_RUN_ON(worker_thread_);
-  nack_list_.erase(nack_list_.begin(), nack_list_.lower_bound(seq_num));
-  recovered_list_.erase(recovered_list_.begin(),
-                        recovered_list_.lower_bound(seq_num));
+  nack_list_.EraseOlderThan(seq_num);
+  recovered_list_.EraseOlderThan(seq_num);
 }
 
 void NackRequester::UpdateRtt(int64_t rtt_ms) {
@@ -228,12 +315,11 @@ void NackRequester::AddPacketsToNack(uint16_t seq_num_start,
                                      uint16_t seq_num_end) {
   // Called on worker_thread_.
   // Remove old packets.
-  auto it = nack_list_.lower_bound(seq_num_end - kMaxPacketAge);
-  nack_list_.erase(nack_list_.begin(), it);
+  nack_list_.EraseOlderThan(seq_num_end - kMaxPacketAge);
 
   uint16_t num_new_nacks = ForwardDiff(seq_num_start, seq_num_end);
   if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
-    nack_list_.clear();
+    nack_list_.Clear();
     RTC_LOG(LS_WARNING) << "NACK list full, clearing NACK"
                            " list and requesting keyframe.";
     keyframe_request_sender_->RequestKeyFrame();
@@ -242,12 +328,12 @@ void NackRequester::AddPacketsToNack(uint16_t seq_num_start,
 
   for (uint16_t seq_num = seq_num_start; seq_num != seq_num_end; ++seq_num) {
     // Do not send nack for packets that are already recovered by FEC or RTX
-    if (recovered_list_.find(seq_num) != recovered_list_.end())
+    if (recovered_list_.Contains(seq_num))
       continue;
     NackInfo nack_info(seq_num, seq_num + WaitNumberOfPackets(0.5),
                        clock_->CurrentTime());
-    RTC_DCHECK(nack_list_.find(seq_num) == nack_list_.end());
-    nack_list_[seq_num] = nack_info;
+    RTC_DCHECK(!nack_list_.Contains(seq_num));
+    nack_list_.PushBack(nack_info);
   }
 }
 
@@ -258,28 +344,30 @@ std::vector<uint16_t> NackRequester::GetNackBatch(NackFilterOptions options) {
   bool consider_timestamp = options != kSeqNumOnly;
   Timestamp now = clock_->CurrentTime();
   std::vector<uint16_t> nack_batch;
-  auto it = nack_list_.begin();
-  while (it != nack_list_.end()) {
-    bool delay_timed_out = now - it->second.created_at_time >= send_nack_delay_;
-    bool nack_on_rtt_passed = now - it->second.sent_at_time >= rtt_;
+  auto maybe_nack = [&](NackInfo& info) {
+    bool delay_timed_out = now - info.created_at_time >= send_nack_delay_;
+    bool nack_on_rtt_passed = now - info.sent_at_time >= rtt_;
     bool nack_on_seq_num_passed =
-        it->second.sent_at_time.IsInfinite() &&
-        AheadOrAt(newest_seq_num_, it->second.send_at_seq_num);
+        info.sent_at_time.IsInfinite() &&
+        AheadOrAt(newest_seq_num_, info.send_at_seq_num);
     if (delay_timed_out && ((consider_seq_num && nack_on_seq_num_passed) ||
                             (consider_timestamp && nack_on_rtt_passed))) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now;
-      if (it->second.retries >= kMaxNackRetries) {
-        RTC_LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
+      nack_batch.emplace_back(info.seq_num);
+      ++info.retries;
+      info.sent_at_time = now;
+      if (info.retries >= kMaxNackRetries) {
+        RTC_LOG(LS_WARNING) << "Sequence number " << info.seq_num
                             << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
+        return false;
       }
-      continue;
     }
-    ++it;
+    return true;
+  };
+  if (consider_timestamp) {
+    nack_list_.ForEach(maybe_nack);
+  } else {
+    // Packets that were already nacked are only nacked again after rtt.
+    nack_list_.ForEachNeverSent(maybe_nack);
   }
   return nack_batch;
 }
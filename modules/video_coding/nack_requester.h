@@ -13,8 +13,6 @@
 
 #include <stdint.h>
 
-#include <map>
-#include <set>
 #include <vector>
 
 #include "api/field_trials_view.h"
@@ -25,6 +23,7 @@
 #include "api/units/timestamp.h"
 #include "modules/include/module_common_types.h"
 #include "modules/video_coding/histogram.h"
+#include "modules/video_coding/sequence_number_bitset.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/task_utils/repeating_task.h"
 #include "rtc_base/thread_annotations.h"
@@ -105,6 +104,66 @@ class NackRequester final : public NackRequesterBase {
     int retries;
   };
 
+  // Packets to nack ordered by sequence number. Packets are added in
+  // ascending order and are mostly removed from the front, thus they are
+  // stored in a ring buffer, while a bitset tracks which of them are still
+  // pending. Packets removed from the middle are only dropped from the bitset
+  // and are skipped until they reach the front or the buffer is compacted.
+  class NackList {
+   public:
+    explicit NackList(size_t window_size);
+    ~NackList();
+
+    bool empty() const { return pending_.empty(); }
+    size_t size() const { return pending_.size(); }
+    bool Contains(uint16_t seq_num) const { return pending_.Contains(seq_num); }
+
+    // `info.seq_num` must be ahead of all packets in the list.
+    void PushBack(const NackInfo& info);
+    // Returns number of retries of the erased packet.
+    int Erase(uint16_t seq_num);
+    void EraseOlderThan(uint16_t seq_num);
+    void Clear();
+
+    // Calls `callback` for each pending packet in ascending sequence number
+    // order. Packet is erased when `callback` returns false.
+    template <typename Callback>
+    void ForEach(Callback callback) {
+      ForEachFrom(0, callback);
+    }
+    // Same as above, but skips packets that were nacked at least once.
+    template <typename Callback>
+    void ForEachNeverSent(Callback callback) {
+      ForEachFrom(first_never_sent_, callback);
+    }
+
+   private:
+    NackInfo& at(size_t i) { return ring_[(head_ + i) & (ring_.size() - 1)]; }
+    bool IsPending(size_t i) { return pending_.Contains(at(i).seq_num); }
+
+    template <typename Callback>
+    void ForEachFrom(size_t begin, Callback callback) {
+      for (size_t i = begin; i < count_; ++i) {
+        NackInfo& info = at(i);
+        if (pending_.Contains(info.seq_num) && !callback(info)) {
+          pending_.Erase(info.seq_num);
+        }
+      }
+      Trim();
+    }
+    // Drops erased packets from the front and compacts the buffer when most
+    // of it is occupied by erased packets.
+    void Trim();
+
+    std::vector<NackInfo> ring_;
+    size_t head_ = 0;
+    // Number of used slots in the `ring_`, including erased packets.
+    size_t count_ = 0;
+    // All pending packets before this slot were nacked at least once.
+    size_t first_never_sent_ = 0;
+    SequenceNumberBitset pending_;
+  };
+
   void AddPacketsToNack(uint16_t seq_num_start, uint16_t seq_num_end)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
 
@@ -128,10 +187,8 @@ class NackRequester final : public NackRequesterBase {
   // TODO(philipel): Some of the variables below are consistently used on a
   // known thread (e.g. see `initialized_`). Those probably do not need
   // synchronized access.
-  std::map<uint16_t, NackInfo, DescendingSeqNumComp<uint16_t>> nack_list_
-      RTC_GUARDED_BY(worker_thread_);
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> recovered_list_
-      RTC_GUARDED_BY(worker_thread_);
+  NackList nack_list_ RTC_GUARDED_BY(worker_thread_);
+  SequenceNumberBitset recovered_list_ RTC_GUARDED_BY(worker_thread_);
   video_coding::Histogram reordering_histogram_ RTC_GUARDED_BY(worker_thread_);
   bool initialized_ RTC_GUARDED_BY(worker_thread_);
   TimeDelta rtt_ RTC_GUARDED_BY(worker_thread_);
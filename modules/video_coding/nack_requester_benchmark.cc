@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures NackRequester bookkeeping cost on a high bitrate stream that
+// periodically loses bursts of packets, about half of which are recovered by
+// retransmissions.
+
+#include <cstdint>
+#include <vector>
+
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/include/module_common_types.h"
+#include "modules/video_coding/nack_requester.h"
+#include "system_wrappers/include/clock.h"
+#include "test/run_loop.h"
+#include "test/scoped_key_value_config.h"
+
+namespace webrtc {
+namespace {
+
+// Packets received between the starts of two consecutive loss bursts.
+constexpr int kPacketsPerPeriod = 1000;
+// Offset of the loss burst within the period.
+constexpr int kBurstOffset = 10;
+// How far behind the newest packet the frames are considered complete and
+// cleared from the NackRequester.
+constexpr int kClearDistance = 500;
+
+class CountingSender : public NackSender, public KeyFrameRequestSender {
+ public:
+  void SendNack(const std::vector<uint16_t>& sequence_numbers,
+                bool /* buffering_allowed */) override {
+    num_nacked_packets_ += sequence_numbers.size();
+  }
+  void RequestKeyFrame() override { ++num_keyframe_requests_; }
+
+  int64_t num_nacked_packets() const { return num_nacked_packets_; }
+  int num_keyframe_requests() const { return num_keyframe_requests_; }
+
+ private:
+  int64_t num_nacked_packets_ = 0;
+  int num_keyframe_requests_ = 0;
+};
+
+void BM_NackRequesterLossBursts(benchmark::State& state) {
+  const int burst_length = state.range(0);
+  test::RunLoop loop;
+  SimulatedClock clock(Timestamp::Seconds(1000));
+  NackPeriodicProcessor processor;
+  test::ScopedKeyValueConfig field_trials;
+  CountingSender sender;
+  NackRequester nack_requester(TaskQueueBase::Current(), &processor, &clock,
+                               &sender, &sender, field_trials);
+  nack_requester.UpdateRtt(/*rtt_ms=*/50);
+
+  uint16_t seq_num = 0;
+  for (auto _ : state) {
+    const uint16_t burst_start = seq_num + kBurstOffset;
+    for (int i = 0; i < kPacketsPerPeriod; ++i, ++seq_num) {
+      if (static_cast<uint16_t>(seq_num - burst_start) <
+          static_cast<uint16_t>(burst_length)) {
+        continue;
+      }
+      clock.AdvanceTime(TimeDelta::Micros(200));
+      nack_requester.OnReceivedPacket(seq_num);
+      if (i % 100 == 0 && i > kBurstOffset + burst_length) {
+        // Retransmissions of every other lost packet, and duplicates of them,
+        // arrive some time after the burst.
+        for (int j = 0; j < burst_length; j += 2) {
+          nack_requester.OnReceivedPacket(burst_start + j,
+                                          /*is_recovered=*/false);
+        }
+        nack_requester.ProcessNacks();
+      }
+    }
+    nack_requester.ClearUpTo(seq_num - kClearDistance);
+  }
+  state.SetItemsProcessed(state.iterations() * kPacketsPerPeriod);
+  state.counters["nacked"] = benchmark::Counter(
+      sender.num_nacked_packets(), benchmark::Counter::kAvgIterations);
+  state.counters["keyframes"] = sender.num_keyframe_requests();
+}
+
+// Number of packets lost in each burst.
+BENCHMARK(BM_NackRequesterLossBursts)->Arg(10)->Arg(100)->Arg(400);
+
+}  // namespace
+}  // namespace webrtc
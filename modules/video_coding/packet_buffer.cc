@@ -33,6 +33,15 @@
 
 namespace webrtc {
 namespace video_coding {
+namespace {
+
+// Missing packets older than this many sequence numbers are forgotten, see
+// UpdateMissingPackets.
+constexpr int kMaxPaddingAge = 1000;
+constexpr size_t kMissingPacketsWindowSize = 1024;
+static_assert(kMissingPacketsWindowSize >= size_t{kMaxPaddingAge});
+
+}  // namespace
 
 PacketBuffer::Packet::Packet(const RtpPacketReceived& rtp_packet,
                              int64_t sequence_number,
@@ -54,6 +63,8 @@ PacketBuffer::PacketBuffer(size_t start_buffer_size, size_t max_buffer_size)
       first_packet_received_(false),
       is_cleared_to_first_seq_num_(false),
       buffer_(start_buffer_size),
+      missing_packets_(kMissingPacketsWindowSize),
+      received_padding_(max_buffer_size),
       sps_pps_idr_is_h264_keyframe_(false) {
   RTC_DCHECK_LE(start_buffer_size, max_buffer_size);
   // Buffer size must always be a power of 2.
@@ -119,9 +130,7 @@ PacketBuffer::InsertResult PacketBuffer::InsertPacket(
 
   UpdateMissingPackets(seq_num);
 
-  received_padding_.erase(
-      received_padding_.begin(),
-      received_padding_.lower_bound(seq_num - (buffer_.size() / 4)));
+  received_padding_.EraseOlderThan(seq_num - (buffer_.size() / 4));
 
   result.packets = FindFrames(seq_num);
   return result;
@@ -156,11 +165,8 @@ void PacketBuffer::ClearTo(uint16_t seq_num) {
   first_seq_num_ = seq_num;
 
   is_cleared_to_first_seq_num_ = true;
-  missing_packets_.erase(missing_packets_.begin(),
-                         missing_packets_.lower_bound(seq_num));
-
-  received_padding_.erase(received_padding_.begin(),
-                          received_padding_.lower_bound(seq_num));
+  missing_packets_.EraseOlderThan(seq_num);
+  received_padding_.EraseOlderThan(seq_num);
 }
 
 void PacketBuffer::Clear() {
@@ -170,7 +176,7 @@ void PacketBuffer::Clear() {
 PacketBuffer::InsertResult PacketBuffer::InsertPadding(uint16_t seq_num) {
   PacketBuffer::InsertResult result;
   UpdateMissingPackets(seq_num);
-  received_padding_.insert(seq_num);
+  received_padding_.Insert(seq_num);
   result.packets = FindFrames(static_cast<uint16_t>(seq_num + 1));
   return result;
 }
@@ -191,8 +197,8 @@ void PacketBuffer::ClearInternal() {
   first_packet_received_ = false;
   is_cleared_to_first_seq_num_ = false;
   newest_inserted_seq_num_.reset();
-  missing_packets_.clear();
-  received_padding_.clear();
+  missing_packets_.Clear();
+  received_padding_.Clear();
 }
 
 bool PacketBuffer::ExpandBufferSize() {
@@ -244,7 +250,7 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
   auto start = seq_num;
 
   for (size_t i = 0; i < buffer_.size(); ++i) {
-    if (received_padding_.find(seq_num) != received_padding_.end()) {
+    if (received_padding_.Contains(seq_num)) {
       seq_num += 1;
       continue;
     }
@@ -254,11 +260,17 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
     }
 
     size_t index = seq_num % buffer_.size();
-    buffer_[index]->continuous = true;
+    Packet& entry = *buffer_[index];
+    entry.continuous = true;
+    entry.first_seq_num_in_frame =
+        entry.is_first_packet_in_frame()
+            ? seq_num
+            : buffer_[static_cast<uint16_t>(seq_num - 1) % buffer_.size()]
+                  ->first_seq_num_in_frame;
 
     // If all packets of the frame is continuous, find the first packet of the
     // frame and add all packets of the frame to the returned packets.
-    if (buffer_[index]->is_last_packet_in_frame()) {
+    if (entry.is_last_packet_in_frame()) {
       uint16_t start_seq_num = seq_num;
 
       // Find the start index by searching backward until the packet with
@@ -278,7 +290,18 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
       int idr_width = -1;
       int idr_height = -1;
       bool full_frame_found = false;
-      while (true) {
+      // Without the H.264 descriptor, the first packet is marked by the
+      // `frame_begin` flag and continuity is propagated from it, so there is no
+      // need to search for it. The frame is only incomplete if the first packet
+      // has been cleared since.
+      const bool search_for_start = is_h264_descriptor;
+      if (!search_for_start) {
+        start_seq_num = entry.first_seq_num_in_frame;
+        const auto& first_packet = buffer_[start_seq_num % buffer_.size()];
+        full_frame_found =
+            first_packet != nullptr && first_packet->seq_num() == start_seq_num;
+      }
+      while (search_for_start) {
         // GFD is only attached to first packet of frame, so update check on
         // every packet.
         if (buffer_[start_index] != nullptr) {
@@ -380,8 +403,8 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
 
         // If this is not a keyframe, make sure there are no gaps in the packet
         // sequence numbers up until this point.
-        if (!is_h264_keyframe && missing_packets_.upper_bound(start_seq_num) !=
-                                     missing_packets_.begin()) {
+        if (!is_h264_keyframe &&
+            missing_packets_.ContainsOlderThan(start_seq_num + 1)) {
           return found_frames;
         }
       }
@@ -401,10 +424,8 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
           found_frames.push_back(std::move(packet));
         }
 
-        missing_packets_.erase(missing_packets_.begin(),
-                               missing_packets_.upper_bound(seq_num));
-        received_padding_.erase(received_padding_.lower_bound(start),
-                                received_padding_.upper_bound(seq_num));
+        missing_packets_.EraseOlderThan(seq_num + 1);
+        received_padding_.EraseRange(start, seq_num + 1);
       }
     }
     ++seq_num;
@@ -416,11 +437,9 @@ void PacketBuffer::UpdateMissingPackets(uint16_t seq_num) {
   if (!newest_inserted_seq_num_)
     newest_inserted_seq_num_ = seq_num;
 
-  const int kMaxPaddingAge = 1000;
   if (AheadOf(seq_num, *newest_inserted_seq_num_)) {
     uint16_t old_seq_num = seq_num - kMaxPaddingAge;
-    auto erase_to = missing_packets_.lower_bound(old_seq_num);
-    missing_packets_.erase(missing_packets_.begin(), erase_to);
+    missing_packets_.EraseOlderThan(old_seq_num);
 
     // Guard against inserting a large amount of missing packets if there is a
     // jump in the sequence number.
@@ -429,11 +448,11 @@ void PacketBuffer::UpdateMissingPackets(uint16_t seq_num) {
 
     ++*newest_inserted_seq_num_;
     while (AheadOf(seq_num, *newest_inserted_seq_num_)) {
-      missing_packets_.insert(*newest_inserted_seq_num_);
+      missing_packets_.Insert(*newest_inserted_seq_num_);
       ++*newest_inserted_seq_num_;
     }
   } else {
-    missing_packets_.erase(seq_num);
+    missing_packets_.Erase(seq_num);
   }
 }
 
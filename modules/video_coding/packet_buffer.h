@@ -13,7 +13,6 @@
 
 #include <memory>
 #include <queue>
-#include <set>
 #include <vector>
 
 #include "absl/base/attributes.h"
@@ -22,6 +21,7 @@
 #include "api/video/encoded_image.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "modules/rtp_rtcp/source/rtp_video_header.h"
+#include "modules/video_coding/sequence_number_bitset.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/thread_annotations.h"
@@ -57,6 +57,9 @@ class PacketBuffer {
     // If all its previous packets have been inserted into the packet buffer.
     // Set and used internally by the PacketBuffer.
     bool continuous = false;
+    // Sequence number of the first packet of the frame, valid once the packet
+    // is continuous. Set and used internally by the PacketBuffer.
+    uint16_t first_seq_num_in_frame = 0;
     bool marker_bit = false;
     uint8_t payload_type = 0;
     int64_t sequence_number = 0;
@@ -118,9 +121,9 @@ class PacketBuffer {
   std::vector<std::unique_ptr<Packet>> buffer_;
 
   std::optional<uint16_t> newest_inserted_seq_num_;
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> missing_packets_;
+  SequenceNumberBitset missing_packets_;
 
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> received_padding_;
+  SequenceNumberBitset received_padding_;
 
   // Indicates if we should require SPS, PPS, and IDR for a particular
   // RTP timestamp to treat the corresponding frame as a keyframe.
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures PacketBuffer insertion cost for large frames, as produced by high
+// bitrate 4K streams, received with reordering and a few retransmissions.
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/video/video_codec_type.h"
+#include "benchmark/benchmark.h"
+#include "modules/video_coding/packet_buffer.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kStartBufferSize = 512;
+constexpr size_t kMaxBufferSize = 2048;
+// Packets within each group of this size arrive in reverse order.
+constexpr int kReorderDistance = 8;
+// One in this many packets is lost and arrives as a retransmission after the
+// rest of the frame.
+constexpr int kRetransmissionInterval = 50;
+
+// Packets handed back by the PacketBuffer are reused so that the benchmark
+// measures the buffer rather than allocation of packets.
+class PacketPool {
+ public:
+  std::unique_ptr<video_coding::PacketBuffer::Packet> Create(int64_t seq_num,
+                                                             uint32_t timestamp,
+                                                             bool first,
+                                                             bool last) {
+    std::unique_ptr<video_coding::PacketBuffer::Packet> packet;
+    if (free_.empty()) {
+      packet = std::make_unique<video_coding::PacketBuffer::Packet>();
+      packet->video_header.codec = kVideoCodecVP9;
+    } else {
+      packet = std::move(free_.back());
+      free_.pop_back();
+    }
+    packet->sequence_number = seq_num;
+    packet->timestamp = timestamp;
+    packet->video_header.is_first_packet_in_frame = first;
+    packet->video_header.is_last_packet_in_frame = last;
+    packet->marker_bit = last;
+    return packet;
+  }
+
+  void Release(std::vector<std::unique_ptr<video_coding::PacketBuffer::Packet>>
+                   packets) {
+    for (auto& packet : packets) {
+      free_.push_back(std::move(packet));
+    }
+  }
+
+ private:
+  std::vector<std::unique_ptr<video_coding::PacketBuffer::Packet>> free_;
+};
+
+// Order in which the packets of a frame arrive.
+std::vector<int> ArrivalOrder(int packets_per_frame) {
+  std::vector<int> order;
+  std::vector<int> retransmitted;
+  for (int group = 0; group < packets_per_frame; group += kReorderDistance) {
+    for (int i = std::min(group + kReorderDistance, packets_per_frame) - 1;
+         i >= group; --i) {
+      if (i % kRetransmissionInterval == kRetransmissionInterval - 1) {
+        retransmitted.push_back(i);
+      } else {
+        order.push_back(i);
+      }
+    }
+  }
+  order.insert(order.end(), retransmitted.begin(), retransmitted.end());
+  return order;
+}
+
+void BM_PacketBufferInsertLargeFrames(benchmark::State& state) {
+  const int packets_per_frame = state.range(0);
+  const std::vector<int> arrival_order = ArrivalOrder(packets_per_frame);
+  video_coding::PacketBuffer packet_buffer(kStartBufferSize, kMaxBufferSize);
+  PacketPool pool;
+  // Start from steady state, where the buffer has already been cleared up to
+  // the previous frame.
+  int64_t first_seq_num = 0;
+  uint32_t timestamp = 0;
+  RTC_CHECK_EQ(packet_buffer
+                   .InsertPacket(pool.Create(first_seq_num, timestamp,
+                                             /*first=*/true, /*last=*/true))
+                   .packets.size(),
+               1);
+  packet_buffer.ClearTo(first_seq_num);
+  ++first_seq_num;
+  timestamp += 3000;
+  int64_t num_frames = 0;
+  for (auto _ : state) {
+    for (int i : arrival_order) {
+      video_coding::PacketBuffer::InsertResult result =
+          packet_buffer.InsertPacket(
+              pool.Create(first_seq_num + i, timestamp, i == 0,
+                          i == packets_per_frame - 1));
+      if (!result.packets.empty()) {
+        RTC_CHECK_EQ(result.packets.size(), packets_per_frame);
+        ++num_frames;
+        pool.Release(std::move(result.packets));
+      }
+    }
+    packet_buffer.ClearTo(first_seq_num + packets_per_frame - 1);
+    first_seq_num += packets_per_frame;
+    timestamp += 3000;
+  }
+  RTC_CHECK_EQ(num_frames, state.iterations());
+  state.SetItemsProcessed(state.iterations() * packets_per_frame);
+}
+
+// Number of packets per frame.
+BENCHMARK(BM_PacketBufferInsertLargeFrames)->Arg(10)->Arg(100)->Arg(400);
+
+}  // namespace
+}  // namespace webrtc
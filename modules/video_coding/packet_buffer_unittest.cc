@@ -356,6 +356,26 @@ TEST_F(PacketBufferTest, FramesReordered) {
               StartSeqNumsAre(seq_num + 2));
 }
 
+TEST_F(PacketBufferTest, LargeFrameReceivedInReverseOrder) {
+  const int64_t seq_num = Rand();
+  const int kNumPackets = kStartSize - 1;
+  EXPECT_THAT(Insert(seq_num - 1, kKeyFrame, kFirst, kLast),
+              StartSeqNumsAre(seq_num - 1));
+  packet_buffer_.ClearTo(seq_num - 1);
+
+  EXPECT_THAT(Insert(seq_num + kNumPackets - 1, kKeyFrame, kNotFirst, kLast)
+                  .packets,
+              IsEmpty());
+  for (int i = kNumPackets - 2; i > 0; --i) {
+    EXPECT_THAT(Insert(seq_num + i, kKeyFrame, kNotFirst, kNotLast).packets,
+                IsEmpty());
+  }
+  PacketBufferInsertResult result =
+      Insert(seq_num, kKeyFrame, kFirst, kNotLast);
+  EXPECT_THAT(result, StartSeqNumsAre(seq_num));
+  EXPECT_THAT(result.packets, SizeIs(kNumPackets));
+}
+
 TEST_F(PacketBufferTest, InsertPacketAfterSequenceNumberWrapAround) {
   int64_t kFirstSeqNum = 0;
   uint32_t kTimestampDelta = 100;
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/sequence_number_bitset.h"
+
+#include <algorithm>
+
+#include "absl/numeric/bits.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/numerics/sequence_number_util.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kBitsPerWord = 64;
+
+// Calls `fn(word_index, mask)` for every word covering the `count` bits
+// starting at bit `index` of a ring of `window_size` bits.
+template <typename Fn>
+void ForEachWord(size_t index, size_t count, size_t window_size, Fn fn) {
+  RTC_DCHECK_LE(count, window_size);
+  while (count > 0) {
+    size_t bit = index % kBitsPerWord;
+    size_t n = std::min({count, kBitsPerWord - bit, window_size - index});
+    uint64_t mask = n == kBitsPerWord ? ~uint64_t{0}
+                                      : ((uint64_t{1} << n) - 1) << bit;
+    fn(index / kBitsPerWord, mask);
+    count -= n;
+    index = (index + n) % window_size;
+  }
+}
+
+}  // namespace
+
+SequenceNumberBitset::SequenceNumberBitset(size_t window_size)
+    : index_mask_(window_size - 1),
+      bits_(std::max<size_t>(window_size / kBitsPerWord, 1), 0) {
+  RTC_CHECK_GT(window_size, 0);
+  RTC_CHECK_LE(window_size, 1 << 15);
+  RTC_CHECK_EQ(window_size & (window_size - 1), 0)
+      << "window_size must be a power of two.";
+}
+
+SequenceNumberBitset::~SequenceNumberBitset() = default;
+
+bool SequenceNumberBitset::InWindow(uint16_t seq_num) const {
+  return static_cast<uint16_t>(seq_num - begin_) <
+         static_cast<uint16_t>(end_ - begin_);
+}
+
+bool SequenceNumberBitset::Contains(uint16_t seq_num) const {
+  if (empty() || !InWindow(seq_num)) {
+    return false;
+  }
+  size_t index = Index(seq_num);
+  return (bits_[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1;
+}
+
+bool SequenceNumberBitset::ContainsOlderThan(uint16_t seq_num) const {
+  if (empty() || !AheadOf(seq_num, begin_)) {
+    return false;
+  }
+  size_t count = std::min(static_cast<uint16_t>(seq_num - begin_),
+                          static_cast<uint16_t>(end_ - begin_));
+  return CountBits(begin_, count) > 0;
+}
+
+bool SequenceNumberBitset::Insert(uint16_t seq_num) {
+  const size_t window_size = size_t{index_mask_} + 1;
+  if (empty()) {
+    begin_ = seq_num;
+    end_ = seq_num + 1;
+  } else if (AheadOf<uint16_t>(seq_num, end_ - 1)) {
+    // Slide the window forward, erasing members that no longer fit.
+    uint16_t new_end = seq_num + 1;
+    if (static_cast<uint16_t>(new_end - begin_) > window_size) {
+      uint16_t new_begin = new_end - window_size;
+      size_t num_dropped = std::min<size_t>(
+          static_cast<uint16_t>(new_begin - begin_),
+          static_cast<uint16_t>(end_ - begin_));
+      size_ -= ClearBits(begin_, num_dropped);
+      begin_ = new_begin;
+    }
+    end_ = new_end;
+  } else if (!InWindow(seq_num)) {
+    // `seq_num` is older than any member, extend the window backward.
+    if (static_cast<uint16_t>(end_ - seq_num) > window_size) {
+      return false;
+    }
+    begin_ = seq_num;
+  }
+
+  size_t index = Index(seq_num);
+  uint64_t& word = bits_[index / kBitsPerWord];
+  const uint64_t mask = uint64_t{1} << (index % kBitsPerWord);
+  if (word & mask) {
+    return false;
+  }
+  word |= mask;
+  ++size_;
+  return true;
+}
+
+bool SequenceNumberBitset::Erase(uint16_t seq_num) {
+  if (!Contains(seq_num)) {
+    return false;
+  }
+  size_t index = Index(seq_num);
+  bits_[index / kBitsPerWord] &= ~(uint64_t{1} << (index % kBitsPerWord));
+  --size_;
+  return true;
+}
+
+void SequenceNumberBitset::EraseOlderThan(uint16_t seq_num) {
+  if (empty() || !AheadOf(seq_num, begin_)) {
+    return;
+  }
+  uint16_t num_erased = seq_num - begin_;
+  if (num_erased >= static_cast<uint16_t>(end_ - begin_)) {
+    Clear();
+    return;
+  }
+  size_ -= ClearBits(begin_, num_erased);
+  begin_ = seq_num;
+}
+
+void SequenceNumberBitset::EraseRange(uint16_t first, uint16_t end) {
+  if (empty()) {
+    return;
+  }
+  if (AheadOf(begin_, first)) {
+    first = begin_;
+  }
+  if (AheadOf(end, end_)) {
+    end = end_;
+  }
+  if (!AheadOf(end, first)) {
+    return;
+  }
+  size_ -= ClearBits(first, static_cast<uint16_t>(end - first));
+}
+
+void SequenceNumberBitset::Clear() {
+  if (empty()) {
+    return;
+  }
+  ClearBits(begin_, static_cast<uint16_t>(end_ - begin_));
+  size_ = 0;
+}
+
+size_t SequenceNumberBitset::CountBits(uint16_t seq_num, size_t count) const {
+  size_t num_set = 0;
+  ForEachWord(Index(seq_num), count, size_t{index_mask_} + 1,
+              [&](size_t word_index, uint64_t mask) {
+                num_set += absl::popcount(bits_[word_index] & mask);
+              });
+  return num_set;
+}
+
+size_t SequenceNumberBitset::ClearBits(uint16_t seq_num, size_t count) {
+  size_t num_cleared = 0;
+  ForEachWord(Index(seq_num), count, size_t{index_mask_} + 1,
+              [&](size_t word_index, uint64_t mask) {
+                num_cleared += absl::popcount(bits_[word_index] & mask);
+                bits_[word_index] &= ~mask;
+              });
+  return num_cleared;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_SEQUENCE_NUMBER_BITSET_H_
+#define MODULES_VIDEO_CODING_SEQUENCE_NUMBER_BITSET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace webrtc {
+
+// Set of RTP sequence numbers that lie within a sliding window of
+// `window_size` consecutive sequence numbers, stored as a ring of bits.
+// Insert, Erase and Contains are O(1) and never allocate. Inserting a sequence
+// number ahead of the window slides the window forward, dropping members that
+// fall out of it.
+class SequenceNumberBitset {
+ public:
+  // `window_size` must be a power of two no larger than 2^15 so that members
+  // can be ordered taking wrap around into account.
+  explicit SequenceNumberBitset(size_t window_size);
+  SequenceNumberBitset(const SequenceNumberBitset&) = delete;
+  SequenceNumberBitset& operator=(const SequenceNumberBitset&) = delete;
+  ~SequenceNumberBitset();
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  bool Contains(uint16_t seq_num) const;
+
+  // Returns true if any member is older than `seq_num`.
+  bool ContainsOlderThan(uint16_t seq_num) const;
+
+  // Returns false if `seq_num` is already a member or is too old to fit into
+  // the window.
+  bool Insert(uint16_t seq_num);
+
+  // Returns false if `seq_num` is not a member.
+  bool Erase(uint16_t seq_num);
+
+  // Erases all members older than `seq_num`.
+  void EraseOlderThan(uint16_t seq_num);
+
+  // Erases all members in the [`first`, `end`) range.
+  void EraseRange(uint16_t first, uint16_t end);
+
+  void Clear();
+
+ private:
+  size_t Index(uint16_t seq_num) const { return seq_num & index_mask_; }
+  // Returns true if `seq_num` is inside the [`begin_`, `end_`) window.
+  bool InWindow(uint16_t seq_num) const;
+  // Returns number of members among the `count` sequence numbers starting at
+  // `seq_num`.
+  size_t CountBits(uint16_t seq_num, size_t count) const;
+  // Clears `count` bits starting at the bit for `seq_num`. Returns number of
+  // members that were erased.
+  size_t ClearBits(uint16_t seq_num, size_t count);
+
+  const uint16_t index_mask_;
+  std::vector<uint64_t> bits_;
+  size_t size_ = 0;
+  // All members are within [`begin_`, `end_`). Meaningful only when not empty.
+  uint16_t begin_ = 0;
+  uint16_t end_ = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_SEQUENCE_NUMBER_BITSET_H_
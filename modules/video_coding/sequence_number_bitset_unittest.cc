@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/sequence_number_bitset.h"
+
+#include <cstdint>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+TEST(SequenceNumberBitsetTest, InsertsAndErases) {
+  SequenceNumberBitset bitset(/*window_size=*/128);
+  EXPECT_TRUE(bitset.empty());
+  EXPECT_FALSE(bitset.Contains(5));
+
+  EXPECT_TRUE(bitset.Insert(5));
+  EXPECT_TRUE(bitset.Insert(7));
+  EXPECT_FALSE(bitset.Insert(7));
+  EXPECT_EQ(bitset.size(), 2u);
+  EXPECT_TRUE(bitset.Contains(5));
+  EXPECT_FALSE(bitset.Contains(6));
+  EXPECT_TRUE(bitset.Contains(7));
+
+  EXPECT_TRUE(bitset.Erase(5));
+  EXPECT_FALSE(bitset.Erase(5));
+  EXPECT_FALSE(bitset.Contains(5));
+  EXPECT_EQ(bitset.size(), 1u);
+}
+
+TEST(SequenceNumberBitsetTest, DoesNotAliasSequenceNumbersOutsideWindow) {
+  SequenceNumberBitset bitset(/*window_size=*/128);
+  EXPECT_TRUE(bitset.Insert(5));
+  EXPECT_FALSE(bitset.Contains(5 + 128));
+  EXPECT_FALSE(bitset.Contains(5 - 128));
+}
+
+TEST(SequenceNumberBitsetTest, SlidesWindowForward) {
+  SequenceNumberBitset bitset(/*window_size=*/128);
+  EXPECT_TRUE(bitset.Insert(10));
+  EXPECT_TRUE(bitset.Insert(20));
+  EXPECT_TRUE(bitset.Insert(10 + 128));
+
+  EXPECT_FALSE(bitset.Contains(10));
+  EXPECT_TRUE(bitset.Contains(20));
+  EXPECT_TRUE(bitset.Contains(10 + 128));
+  EXPECT_EQ(bitset.size(), 2u);
+
+  // Too old to fit into the window any more.
+  EXPECT_FALSE(bitset.Insert(10));
+  EXPECT_EQ(bitset.size(), 2u);
+}
+
+TEST(SequenceNumberBitsetTest, LargeJumpDropsAllMembers) {
+  SequenceNumberBitset bitset(/*window_size=*/128);
+  EXPECT_TRUE(bitset.Insert(10));
+  EXPECT_TRUE(bitset.Insert(20));
+  EXPECT_TRUE(bitset.Insert(20'000));
+
+  EXPECT_EQ(bitset.size(), 1u);
+  EXPECT_FALSE(bitset.Contains(10));
+  EXPECT_FALSE(bitset.Contains(20));
+  EXPECT_TRUE(bitset.Contains(20'000));
+}
+
+TEST(SequenceNumberBitsetTest, ExtendsWindowBackward) {
+  SequenceNumberBitset bitset(/*window_size=*/128);
+  EXPECT_TRUE(bitset.Insert(100));
+  EXPECT_TRUE(bitset.Insert(50));
+  EXPECT_TRUE(bitset.Contains(50));
+  EXPECT_TRUE(bitset.Contains(100));
+  EXPECT_FALSE(bitset.Contains(75));
+}
+
+TEST(SequenceNumberBitsetTest, EraseOlderThan) {
+  SequenceNumberBitset bitset(/*window_size=*/256);
+  for (uint16_t seq_num = 0; seq_num < 200; seq_num += 2) {
+    EXPECT_TRUE(bitset.Insert(seq_num));
+  }
+
+  bitset.EraseOlderThan(100);
+  EXPECT_EQ(bitset.size(), 50u);
+  EXPECT_FALSE(bitset.Contains(98));
+  EXPECT_TRUE(bitset.Contains(100));
+
+  // Erasing older than the oldest member is a no-op.
+  bitset.EraseOlderThan(50);
+  EXPECT_EQ(bitset.size(), 50u);
+
+  bitset.EraseOlderThan(1000);
+  EXPECT_TRUE(bitset.empty());
+  EXPECT_FALSE(bitset.Contains(198));
+}
+
+TEST(SequenceNumberBitsetTest, EraseRange) {
+  SequenceNumberBitset bitset(/*window_size=*/256);
+  for (uint16_t seq_num = 10; seq_num < 20; ++seq_num) {
+    EXPECT_TRUE(bitset.Insert(seq_num));
+  }
+
+  bitset.EraseRange(12, 15);
+  EXPECT_EQ(bitset.size(), 7u);
+  EXPECT_TRUE(bitset.Contains(11));
+  EXPECT_FALSE(bitset.Contains(12));
+  EXPECT_FALSE(bitset.Contains(14));
+  EXPECT_TRUE(bitset.Contains(15));
+
+  // Ranges are clipped to the window.
+  bitset.EraseRange(0, 11);
+  bitset.EraseRange(19, 1000);
+  EXPECT_EQ(bitset.size(), 5u);
+  EXPECT_FALSE(bitset.Contains(10));
+  EXPECT_FALSE(bitset.Contains(19));
+
+  // Empty range.
+  bitset.EraseRange(16, 16);
+  EXPECT_EQ(bitset.size(), 5u);
+}
+
+TEST(SequenceNumberBitsetTest, ContainsOlderThan) {
+  SequenceNumberBitset bitset(/*window_size=*/1024);
+  EXPECT_FALSE(bitset.ContainsOlderThan(100));
+
+  EXPECT_TRUE(bitset.Insert(0xfffe));
+  EXPECT_TRUE(bitset.Insert(300));
+  EXPECT_FALSE(bitset.ContainsOlderThan(0xfffe));
+  EXPECT_TRUE(bitset.ContainsOlderThan(0xffff));
+  EXPECT_TRUE(bitset.ContainsOlderThan(100));
+
+  EXPECT_TRUE(bitset.Erase(0xfffe));
+  EXPECT_FALSE(bitset.ContainsOlderThan(300));
+  EXPECT_TRUE(bitset.ContainsOlderThan(301));
+  EXPECT_TRUE(bitset.ContainsOlderThan(5000));
+}
+
+TEST(SequenceNumberBitsetTest, HandlesWrapAround) {
+  SequenceNumberBitset bitset(/*window_size=*/1024);
+  EXPECT_TRUE(bitset.Insert(0xfff0));
+  EXPECT_TRUE(bitset.Insert(0xffff));
+  EXPECT_TRUE(bitset.Insert(0x0005));
+  EXPECT_EQ(bitset.size(), 3u);
+
+  bitset.EraseOlderThan(0x0000);
+  EXPECT_EQ(bitset.size(), 1u);
+  EXPECT_FALSE(bitset.Contains(0xffff));
+  EXPECT_TRUE(bitset.Contains(0x0005));
+}
+
+TEST(SequenceNumberBitsetTest, ClearRemovesAllMembers) {
+  SequenceNumberBitset bitset(/*window_size=*/64);
+  EXPECT_TRUE(bitset.Insert(1));
+  EXPECT_TRUE(bitset.Insert(60));
+  bitset.Clear();
+  EXPECT_TRUE(bitset.empty());
+  EXPECT_FALSE(bitset.Contains(1));
+
+  // Stale bits must not reappear once the window moves over them again.
+  EXPECT_TRUE(bitset.Insert(2));
+  EXPECT_FALSE(bitset.Contains(1));
+  EXPECT_FALSE(bitset.Contains(60));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -20,6 +20,8 @@
 #include "net/dcsctp/packet/bounded_byte_reader.h"
 #include "net/dcsctp/packet/bounded_byte_writer.h"
 #include "net/dcsctp/packet/chunk/data_common.h"
+#include "net/dcsctp/public/payload.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/strings/string_builder.h"
 
 namespace dcsctp {
@@ -63,9 +65,9 @@ std::optional<DataChunk> DataChunk::Parse(rtc::ArrayView<const uint8_t> data) {
   options.immediate_ack =
       ImmediateAckFlag((flags & (1 << kFlagsBitImmediateAck)) != 0);
 
+  rtc::ArrayView<const uint8_t> payload = reader->variable_data();
   return DataChunk(tsn, stream_identifier, ssn, ppid,
-                   std::vector<uint8_t>(reader->variable_data().begin(),
-                                        reader->variable_data().end()),
+                   Payload(rtc::Buffer(payload.data(), payload.size())),
                    options);
 }
 
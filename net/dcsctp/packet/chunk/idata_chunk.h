@@ -23,6 +23,7 @@
 #include "net/dcsctp/packet/chunk/data_common.h"
 #include "net/dcsctp/packet/data.h"
 #include "net/dcsctp/packet/tlv_trait.h"
+#include "net/dcsctp/public/payload.h"
 
 namespace dcsctp {
 
@@ -45,7 +46,7 @@ class IDataChunk : public AnyDataChunk, public TLVTrait<IDataChunkConfig> {
              MID mid,
              PPID ppid,
              FSN fsn,
-             std::vector<uint8_t> payload,
+             Payload payload,
              const Options& options)
       : AnyDataChunk(tsn,
                      stream_id,
@@ -14,16 +14,25 @@
 #include "third_party/crc32c/src/include/crc32c/crc32c.h"
 
 namespace dcsctp {
-
-uint32_t GenerateCrc32C(rtc::ArrayView<const uint8_t> data) {
-  uint32_t crc32c = crc32c_value(data.data(), data.size());
-
-  // Byte swapping for little endian byte order:
+namespace {
+// Byte swapping for little endian byte order. The swap is its own inverse.
+uint32_t SwapBytes(uint32_t crc32c) {
   uint8_t byte0 = crc32c;
   uint8_t byte1 = crc32c >> 8;
   uint8_t byte2 = crc32c >> 16;
   uint8_t byte3 = crc32c >> 24;
-  crc32c = ((byte0 << 24) | (byte1 << 16) | (byte2 << 8) | byte3);
-  return crc32c;
+  return ((byte0 << 24) | (byte1 << 16) | (byte2 << 8) | byte3);
+}
+}  // namespace
+
+uint32_t GenerateCrc32C(rtc::ArrayView<const uint8_t> data) {
+  return SwapBytes(crc32c_value(data.data(), data.size()));
+}
+
+uint32_t ExtendCrc32C(uint32_t crc32c, rtc::ArrayView<const uint8_t> data) {
+  // The crc32c library selects a hardware accelerated implementation (SSE4.2
+  // or ARMv8 CRC instructions) at runtime, when available.
+  return SwapBytes(
+      crc32c_extend(SwapBytes(crc32c), data.data(), data.size()));
 }
 }  // namespace dcsctp
@@ -19,6 +19,13 @@ namespace dcsctp {
 // Generates the CRC32C checksum of `data`.
 uint32_t GenerateCrc32C(rtc::ArrayView<const uint8_t> data);
 
+// Extends `crc32c`, which is a checksum previously returned by
+// `GenerateCrc32C` or `ExtendCrc32C`, with `data`. The result is the same as
+// if `GenerateCrc32C` was called with all the data at once, which allows the
+// checksum to be calculated incrementally, e.g. while the data is still in the
+// cache. A `crc32c` of zero is the checksum of no data.
+uint32_t ExtendCrc32C(uint32_t crc32c, rtc::ArrayView<const uint8_t> data);
+
 }  // namespace dcsctp
 
 #endif  // NET_DCSCTP_PACKET_CRC32C_H_
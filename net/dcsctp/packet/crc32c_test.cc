@@ -9,6 +9,7 @@
  */
 #include "net/dcsctp/packet/crc32c.h"
 
+#include "api/array_view.h"
 #include "test/gmock.h"
 
 namespace dcsctp {
@@ -54,5 +55,16 @@ TEST(Crc32Test, TestVectors) {
   EXPECT_EQ(GenerateCrc32C(kISCSICommandPDU), 0x563a96d9U);
 }
 
+TEST(Crc32Test, ExtendingIsSameAsGeneratingAtOnce) {
+  rtc::ArrayView<const uint8_t> data(kISCSICommandPDU);
+  EXPECT_EQ(ExtendCrc32C(0, data), 0x563a96d9U);
+  EXPECT_EQ(ExtendCrc32C(GenerateCrc32C(kEmpty), data), 0x563a96d9U);
+  for (size_t split = 0; split <= data.size(); ++split) {
+    EXPECT_EQ(ExtendCrc32C(ExtendCrc32C(0, data.subview(0, split)),
+                           data.subview(split)),
+              0x563a96d9U);
+  }
+}
+
 }  // namespace
 }  // namespace dcsctp
@@ -11,6 +11,8 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -52,7 +54,10 @@ SctpPacket::Builder::Builder(VerificationTag verification_tag,
     : verification_tag_(verification_tag),
       source_port_(options.local_port),
       dest_port_(options.remote_port),
-      max_packet_size_(RoundDownTo4(options.mtu)) {}
+      max_packet_size_(RoundDownTo4(options.mtu)),
+      incremental_checksum_(
+          options.zero_checksum_alternate_error_detection_method ==
+          ZeroChecksumAlternateErrorDetectionMethod::None()) {}
 
 SctpPacket::Builder& SctpPacket::Builder::Add(const Chunk& chunk) {
   if (out_.empty()) {
@@ -70,6 +75,14 @@ SctpPacket::Builder& SctpPacket::Builder::Add(const Chunk& chunk) {
   if (out_.size() % 4 != 0) {
     out_.resize(RoundUpTo4(out_.size()));
   }
+  if (incremental_checksum_) {
+    // The chunk was just written, so its data (e.g. a DATA chunk's payload,
+    // that was copied into the packet) will not have to be read from memory
+    // again.
+    checksum_ = ExtendCrc32C(
+        checksum_, rtc::ArrayView<const uint8_t>(out_).subview(checksum_size_));
+    checksum_size_ = out_.size();
+  }
 
   RTC_DCHECK(out_.size() <= max_packet_size_)
       << "Exceeded max size, data=" << out_.size()
@@ -94,9 +107,13 @@ std::vector<uint8_t> SctpPacket::Builder::Build(bool write_checksum) {
   out_.swap(out);
 
   if (!out.empty() && write_checksum) {
-    uint32_t crc = GenerateCrc32C(out);
+    // Only what hasn't been included incrementally, if anything.
+    uint32_t crc = ExtendCrc32C(
+        checksum_, rtc::ArrayView<const uint8_t>(out).subview(checksum_size_));
     BoundedByteWriter<kHeaderSize>(out).Store32<8>(crc);
   }
+  checksum_ = 0;
+  checksum_size_ = 0;
 
   RTC_DCHECK(out.size() <= max_packet_size_)
       << "Exceeded max size, data=" << out.size()
@@ -121,10 +138,6 @@ std::optional<SctpPacket> SctpPacket::Parse(rtc::ArrayView<const uint8_t> data,
   common_header.verification_tag = VerificationTag(reader.Load32<4>());
   common_header.checksum = reader.Load32<8>();
 
-  // Create a copy of the packet, which will be held by this object.
-  std::vector<uint8_t> data_copy =
-      std::vector<uint8_t>(data.begin(), data.end());
-
   if (options.disable_checksum_verification ||
       (options.zero_checksum_alternate_error_detection_method !=
            ZeroChecksumAlternateErrorDetectionMethod::None() &&
@@ -135,9 +148,14 @@ std::optional<SctpPacket> SctpPacket::Parse(rtc::ArrayView<const uint8_t> data,
     // checksum value of zero in addition to SCTP packets containing the correct
     // CRC32c checksum value for this association.
   } else {
-    // Verify the checksum. The checksum field must be zero when that's done.
-    BoundedByteWriter<kHeaderSize>(data_copy).Store32<8>(0);
-    uint32_t calculated_checksum = GenerateCrc32C(data_copy);
+    // Verify the checksum. The checksum field must be zero when that's done,
+    // so the header is copied with the field cleared, and the rest of the
+    // packet is then used as-is, without having to modify it.
+    std::array<uint8_t, kHeaderSize> header;
+    std::copy(data.begin(), data.begin() + kHeaderSize, header.begin());
+    BoundedByteWriter<kHeaderSize>(header).Store32<8>(0);
+    uint32_t calculated_checksum =
+        ExtendCrc32C(GenerateCrc32C(header), data.subview(kHeaderSize));
     if (calculated_checksum != common_header.checksum) {
       RTC_DLOG(LS_WARNING) << rtc::StringFormat(
           "Invalid packet checksum, packet_checksum=0x%08x, "
@@ -145,11 +163,14 @@ std::optional<SctpPacket> SctpPacket::Parse(rtc::ArrayView<const uint8_t> data,
           common_header.checksum, calculated_checksum);
       return std::nullopt;
     }
-    // Restore the checksum in the header.
-    BoundedByteWriter<kHeaderSize>(data_copy).Store32<8>(
-        common_header.checksum);
   }
 
+  // Create a copy of the packet, which will be held by this object. This is
+  // done after the checksum has been verified, as invalid packets are dropped
+  // and as the packet is then likely to be in the cache when copied.
+  std::vector<uint8_t> data_copy =
+      std::vector<uint8_t>(data.begin(), data.end());
+
   // Validate and parse the chunk headers in the message.
   /*
     0                   1                   2                   3
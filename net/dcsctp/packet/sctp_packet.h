@@ -85,7 +85,14 @@ class SctpPacket {
     // The maximum packet size is always even divisible by four, as chunks are
     // always padded to a size even divisible by four.
     size_t max_packet_size_;
+    // If the checksum is calculated incrementally as chunks are added, while
+    // they are still in the cache. This is not done if the peer may accept a
+    // zero checksum, as it's then likely that it will not be needed.
+    bool incremental_checksum_;
     std::vector<uint8_t> out_;
+    // The checksum of the first `checksum_size_` bytes of `out_`.
+    uint32_t checksum_ = 0;
+    size_t checksum_size_ = 0;
   };
 
   // Parses `data` as an SCTP packet and returns it if it validates.
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the per-packet cost of building and parsing MTU-sized packets with
+// DATA chunks, which is dominated by copying the payload and by calculating
+// the CRC32C checksum, as for high-throughput data channels.
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "net/dcsctp/common/internal_types.h"
+#include "net/dcsctp/common/math.h"
+#include "net/dcsctp/packet/chunk/data_chunk.h"
+#include "net/dcsctp/packet/crc32c.h"
+#include "net/dcsctp/packet/sctp_packet.h"
+#include "net/dcsctp/public/dcsctp_options.h"
+#include "net/dcsctp/public/types.h"
+#include "rtc_base/checks.h"
+
+namespace dcsctp {
+namespace {
+
+constexpr VerificationTag kVerificationTag = VerificationTag(0x12345678);
+
+DcSctpOptions MakeOptions(bool zero_checksum) {
+  DcSctpOptions options;
+  if (zero_checksum) {
+    options.zero_checksum_alternate_error_detection_method =
+        ZeroChecksumAlternateErrorDetectionMethod::LowerLayerDtls();
+  }
+  return options;
+}
+
+// Returns as many DATA chunks with `payload_size` bytes of payload as fit in a
+// packet.
+std::vector<DataChunk> MakeChunks(const DcSctpOptions& options,
+                                  size_t payload_size) {
+  SctpPacket::Builder builder(kVerificationTag, options);
+  std::vector<DataChunk> chunks;
+  std::vector<uint8_t> payload(payload_size);
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = static_cast<uint8_t>(i);
+  }
+  size_t chunk_size = DataChunk::kHeaderSize + RoundUpTo4(payload_size);
+  while (builder.bytes_remaining() >= chunk_size) {
+    chunks.emplace_back(TSN(chunks.size()), StreamID(1), SSN(0), PPID(53),
+                        payload, /*options=*/DataChunk::Options());
+    builder.Add(chunks.back());
+  }
+  RTC_CHECK(!chunks.empty());
+  return chunks;
+}
+
+// The first argument is the size of the payload of each DATA chunk, and the
+// second indicates if the checksum is calculated incrementally as chunks are
+// added (0) or over the whole packet when it's built (1), as is done when the
+// peer may accept zero checksums.
+void BM_BuildPacket(benchmark::State& state) {
+  const DcSctpOptions options = MakeOptions(state.range(1) != 0);
+  const std::vector<DataChunk> chunks = MakeChunks(options, state.range(0));
+  SctpPacket::Builder builder(kVerificationTag, options);
+  size_t bytes = 0;
+  for (auto _ : state) {
+    for (const DataChunk& chunk : chunks) {
+      builder.Add(chunk);
+    }
+    std::vector<uint8_t> packet = builder.Build(/*write_checksum=*/true);
+    bytes += packet.size();
+    benchmark::DoNotOptimize(packet.data());
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_BuildPacket)
+    ->ArgNames({"payload_size", "at_build"})
+    ->ArgsProduct({{100, 500, 1100}, {0, 1}});
+
+// The first argument is the size of the payload of each DATA chunk, and the
+// second indicates if the checksum is verified.
+void BM_ParsePacket(benchmark::State& state) {
+  DcSctpOptions options;
+  options.disable_checksum_verification = state.range(1) == 0;
+  const std::vector<DataChunk> chunks = MakeChunks(options, state.range(0));
+  SctpPacket::Builder builder(kVerificationTag, options);
+  for (const DataChunk& chunk : chunks) {
+    builder.Add(chunk);
+  }
+  const std::vector<uint8_t> packet = builder.Build();
+  for (auto _ : state) {
+    std::optional<SctpPacket> parsed = SctpPacket::Parse(packet, options);
+    RTC_DCHECK(parsed.has_value());
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetBytesProcessed(state.iterations() * packet.size());
+}
+BENCHMARK(BM_ParsePacket)
+    ->ArgNames({"payload_size", "verify"})
+    ->ArgsProduct({{100, 500, 1100}, {0, 1}});
+
+// The cost of calculating the checksum alone, of an MTU-sized and of the
+// largest possible packet.
+void BM_GenerateCrc32C(benchmark::State& state) {
+  const std::vector<uint8_t> data(state.range(0), 0xab);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(GenerateCrc32C(data));
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_GenerateCrc32C)->Arg(1200)->Arg(65535);
+
+}  // namespace
+}  // namespace dcsctp
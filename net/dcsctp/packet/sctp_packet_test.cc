@@ -448,5 +448,45 @@ TEST(SctpPacketTest, WritePacketWithZeroChecksum) {
                           0x00, 0x01, 0xc8, 0x00, 0x00, 0x00, 0x00));
 }
 
+
+TEST(SctpPacketTest, WritesSameChecksumWhenCalculatedIncrementally) {
+  auto build = [](const DcSctpOptions& options) {
+    SctpPacket::Builder b(kVerificationTag, options);
+    b.Add(DataChunk(TSN(123), StreamID(456), SSN(789), PPID(9090),
+                    /*payload=*/{1, 2, 3, 4, 5},
+                    /*options=*/{}));
+    b.Add(SackChunk(/*cumulative_tsn_ack=*/TSN(999), /*a_rwnd=*/456,
+                    {SackChunk::GapAckBlock(2, 3)},
+                    /*duplicate_tsns=*/{}));
+    return b.Build();
+  };
+
+  // When zero checksums may be used, the checksum is calculated when building.
+  std::vector<uint8_t> incremental = build(kVerifyChecksumOptions);
+  std::vector<uint8_t> at_build = build(
+      {.zero_checksum_alternate_error_detection_method =
+           ZeroChecksumAlternateErrorDetectionMethod::LowerLayerDtls()});
+  EXPECT_EQ(incremental, at_build);
+  EXPECT_TRUE(
+      SctpPacket::Parse(incremental, kVerifyChecksumOptions).has_value());
+}
+
+TEST(SctpPacketTest, BuilderCanBeReusedAfterBuildingWithoutChecksum) {
+  SctpPacket::Builder b(kVerificationTag, {});
+  b.Add(SackChunk(/*cumulative_tsn_ack=*/TSN(999), /*a_rwnd=*/456,
+                  /*gap_ack_blocks=*/{},
+                  /*duplicate_tsns=*/{}));
+  b.Build(/*write_checksum=*/false);
+
+  b.Add(SackChunk(/*cumulative_tsn_ack=*/TSN(999), /*a_rwnd=*/456,
+                  /*gap_ack_blocks=*/{},
+                  /*duplicate_tsns=*/{}));
+  EXPECT_THAT(b.Build(),
+              ElementsAre(0x13, 0x88, 0x13, 0x88, 0x12, 0x34, 0x56, 0x78,  //
+                          0x07, 0xe8, 0x38, 0x77,  // checksum
+                          0x03, 0x00, 0x00, 0x10, 0x00, 0x00, 0x03, 0xe7, 0x00,
+                          0x00, 0x01, 0xc8, 0x00, 0x00, 0x00, 0x00));
+}
+
 }  // namespace
 }  // namespace dcsctp
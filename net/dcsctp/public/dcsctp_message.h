@@ -15,7 +15,9 @@
 #include <vector>
 
 #include "api/array_view.h"
+#include "net/dcsctp/public/payload.h"
 #include "net/dcsctp/public/types.h"
+#include "rtc_base/buffer.h"
 
 namespace dcsctp {
 
@@ -24,7 +26,9 @@ namespace dcsctp {
 // identifier (`ppid`).
 class DcSctpMessage {
  public:
-  DcSctpMessage(StreamID stream_id, PPID ppid, std::vector<uint8_t> payload)
+  // The payload, which may be a `std::vector<uint8_t>`, is not copied when the
+  // message is fragmented or retransmitted, and may be shared with other users.
+  DcSctpMessage(StreamID stream_id, PPID ppid, Payload payload)
       : stream_id_(stream_id), ppid_(ppid), payload_(std::move(payload)) {}
 
   DcSctpMessage(DcSctpMessage&& other) = default;
@@ -41,13 +45,28 @@ class DcSctpMessage {
   // The payload of the message.
   rtc::ArrayView<const uint8_t> payload() const { return payload_; }
 
-  // When destructing the message, extracts the payload.
-  std::vector<uint8_t> ReleasePayload() && { return std::move(payload_); }
+  // The payload of the message, which can be sliced and shared without copying
+  // it.
+  const Payload& shared_payload() const { return payload_; }
+
+  // When destructing the message, extracts the payload. The payload is only
+  // copied if it is shared with other users.
+  std::vector<uint8_t> ReleasePayload() && {
+    return std::move(payload_).ReleaseVector();
+  }
+
+  // When destructing the message, extracts the payload as an `rtc::Buffer`,
+  // which can be adopted by an `rtc::CopyOnWriteBuffer`. Received messages are
+  // backed by such a buffer, so their payload is only copied if it is shared
+  // with other users.
+  rtc::Buffer ReleasePayloadBuffer() && {
+    return std::move(payload_).ReleaseBuffer();
+  }
 
  private:
   StreamID stream_id_;
   PPID ppid_;
-  std::vector<uint8_t> payload_;
+  Payload payload_;
 };
 }  // namespace dcsctp
 
@@ -18,6 +18,20 @@
 #include "net/dcsctp/public/types.h"
 
 namespace dcsctp {
+
+// The congestion control algorithm that limits the amount of data in-flight.
+enum class CongestionControlAlgorithm {
+  // The loss-based algorithm described in
+  // https://tools.ietf.org/html/rfc4960#section-7.2, which halves the
+  // congestion window when packet loss is detected.
+  kNewReno,
+  // A model-based algorithm inspired by BBR, which sizes the congestion window
+  // from the estimated bottleneck bandwidth and minimum round-trip time, and
+  // which doesn't back off on isolated packet loss. This gives a higher
+  // throughput on lossy paths and on paths with a high bandwidth-delay product.
+  kBbr,
+};
+
 struct DcSctpOptions {
   // The largest safe SCTP packet. Starting from the minimum guaranteed MTU
   // value of 1280 for IPv6 (which may not support fragmentation), take off 85
@@ -138,6 +152,14 @@ struct DcSctpOptions {
   // unacknowledged packet. Whatever is smallest of RTO/2 and this will be used.
   DurationMs delayed_ack_max_timeout = DurationMs(200);
 
+  // A SACK will be sent for at least every this number of received packets
+  // with DATA chunks. RFC 4960 recommends two, but a larger value reduces the
+  // number of packets (and processing) on servers with many associations, at
+  // the cost of a slower growing congestion window on the sender, and more
+  // bursty sending. `delayed_ack_max_timeout` still limits how long a SACK is
+  // delayed.
+  size_t delayed_ack_max_packets = 2;
+
   // The minimum limit for the measured RTT variance
   //
   // Setting this below the expected delayed ack timeout (+ margin) of the peer
@@ -176,6 +198,10 @@ struct DcSctpOptions {
   // creating small fragmented packets.
   size_t avoid_fragmentation_cwnd_mtus = 6;
 
+  // The congestion control algorithm to use.
+  CongestionControlAlgorithm congestion_control_algorithm =
+      CongestionControlAlgorithm::kNewReno;
+
   // The number of packets that may be sent at once. This is limited to avoid
   // bursts that too quickly fill the send buffer. Typically in a a socket in
   // its "slow start" phase (when it sends as much as it can), it will send
@@ -198,9 +224,27 @@ struct DcSctpOptions {
   // RFC8260 Stream Schedulers and User Message Interleaving
   bool enable_message_interleaving = false;
 
+  // If messages should be sent in order of when they expire, across all
+  // streams, using `SendOptions::lifetime` (earliest deadline first). Streams
+  // with messages without a limited lifetime are scheduled as usual, after all
+  // messages that have a lifetime. Messages are still sent in order within a
+  // stream. This helps real-time data, such as game state, to arrive before it
+  // expires when the send buffer builds up, and makes expired messages be
+  // discarded before they would be sent.
+  bool enable_deadline_scheduling = false;
+
   // If RTO should be added to heartbeat_interval
   bool heartbeat_interval_include_rtt = true;
 
+  // If packets that are generated while handling a single call into the socket
+  // (e.g. receiving a packet, sending messages or handling a timeout) should be
+  // coalesced into as few packets as possible, bundling control and DATA
+  // chunks up to the MTU. This also includes packets generated from within the
+  // callbacks that are triggered by that call, such as sending a message when
+  // `OnMessageReceived` is called. This reduces the number of packets sent, at
+  // the cost of delaying packets until after those callbacks have returned.
+  bool enable_packet_coalescing = false;
+
   // Disables SCTP packet crc32 verification. For fuzzers only!
   bool disable_checksum_verification = false;
 
@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef NET_DCSCTP_PUBLIC_PAYLOAD_H_
+#define NET_DCSCTP_PUBLIC_PAYLOAD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/make_ref_counted.h"
+#include "api/scoped_refptr.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/ref_counted_object.h"
+
+namespace dcsctp {
+
+// An immutable, reference counted byte buffer, or a slice of one.
+//
+// Copying a `Payload` or taking a `Slice` of it never copies the bytes, which
+// allows a message to be fragmented into chunks, and those chunks to be
+// retransmitted, without copying the message payload. The underlying buffer is
+// freed when the last `Payload` referencing it is destroyed.
+//
+// The bytes are owned either by a `std::vector`, as provided by clients when
+// sending, or by an `rtc::Buffer`, which is used for received data, as it can
+// be handed over to an `rtc::CopyOnWriteBuffer` without copying.
+class Payload {
+ public:
+  using value_type = uint8_t;
+  using const_iterator = const uint8_t*;
+
+  Payload() = default;
+
+  // Takes ownership of `bytes` without copying them. Intentionally implicit, to
+  // allow passing a vector wherever a `Payload` is expected.
+  Payload(std::vector<uint8_t> bytes)  // NOLINT(runtime/explicit)
+      : size_(bytes.size()) {
+    if (!bytes.empty()) {
+      vector_ =
+          webrtc::make_ref_counted<std::vector<uint8_t>>(std::move(bytes));
+      data_ = vector_->data();
+    }
+  }
+
+  // Takes ownership of `bytes` without copying them.
+  explicit Payload(rtc::Buffer bytes) : size_(bytes.size()) {
+    if (!bytes.empty()) {
+      buffer_ = webrtc::make_ref_counted<rtc::Buffer>(std::move(bytes));
+      data_ = buffer_->data();
+    }
+  }
+
+  Payload(std::initializer_list<uint8_t> bytes)  // NOLINT(runtime/explicit)
+      : Payload(std::vector<uint8_t>(bytes)) {}
+
+  Payload(const Payload&) = default;
+  Payload& operator=(const Payload&) = default;
+  Payload(Payload&& other) noexcept
+      : vector_(std::move(other.vector_)),
+        buffer_(std::move(other.buffer_)),
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  Payload& operator=(Payload&& other) noexcept {
+    vector_ = std::move(other.vector_);
+    buffer_ = std::move(other.buffer_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const uint8_t* begin() const { return data_; }
+  const uint8_t* end() const { return data_ + size_; }
+  uint8_t operator[](size_t index) const {
+    RTC_DCHECK_LT(index, size_);
+    return data_[index];
+  }
+
+  // Returns a payload that references `length` bytes of this payload starting
+  // at `offset`, sharing the underlying buffer.
+  Payload Slice(size_t offset, size_t length) const {
+    RTC_DCHECK_LE(offset, size_);
+    RTC_DCHECK_LE(length, size_ - offset);
+    Payload slice;
+    if (length > 0) {
+      slice.vector_ = vector_;
+      slice.buffer_ = buffer_;
+      slice.data_ = data_ + offset;
+      slice.size_ = length;
+    }
+    return slice;
+  }
+
+  // Returns the bytes as a vector, which is only copied if the buffer is
+  // shared, if this is a slice of it, or if it's not owned by a vector.
+  std::vector<uint8_t> ReleaseVector() && {
+    std::vector<uint8_t> bytes;
+    if (vector_ != nullptr && vector_->HasOneRef() &&
+        data_ == vector_->data() && size_ == vector_->size()) {
+      bytes = std::move(*vector_);
+    } else {
+      bytes.assign(begin(), end());
+    }
+    Reset();
+    return bytes;
+  }
+
+  // Returns the bytes as an `rtc::Buffer`, which is only copied if the buffer
+  // is shared, if this is a slice of it, or if it's not owned by a buffer.
+  rtc::Buffer ReleaseBuffer() && {
+    rtc::Buffer bytes;
+    if (buffer_ != nullptr && buffer_->HasOneRef() &&
+        data_ == buffer_->data() && size_ == buffer_->size()) {
+      bytes = std::move(*buffer_);
+    } else {
+      bytes.SetData(data_, size_);
+    }
+    Reset();
+    return bytes;
+  }
+
+ private:
+  void Reset() {
+    vector_ = nullptr;
+    buffer_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  // At most one of `vector_` and `buffer_` is set, and `data_` points into it.
+  webrtc::scoped_refptr<webrtc::FinalRefCountedObject<std::vector<uint8_t>>>
+      vector_;
+  webrtc::scoped_refptr<webrtc::FinalRefCountedObject<rtc::Buffer>> buffer_;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace dcsctp
+
+#endif  // NET_DCSCTP_PUBLIC_PAYLOAD_H_
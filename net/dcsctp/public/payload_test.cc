@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "net/dcsctp/public/payload.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/buffer.h"
+#include "rtc_base/gunit.h"
+#include "test/gmock.h"
+
+namespace dcsctp {
+namespace {
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(PayloadTest, AdoptsVectorWithoutCopying) {
+  std::vector<uint8_t> bytes = {1, 2, 3, 4};
+  const uint8_t* data = bytes.data();
+  Payload payload(std::move(bytes));
+  EXPECT_EQ(payload.data(), data);
+  EXPECT_THAT(payload, ElementsAre(1, 2, 3, 4));
+}
+
+TEST(PayloadTest, DefaultConstructedIsEmpty) {
+  Payload payload;
+  EXPECT_TRUE(payload.empty());
+  EXPECT_THAT(payload, IsEmpty());
+  EXPECT_THAT(std::move(payload).ReleaseVector(), IsEmpty());
+}
+
+TEST(PayloadTest, SlicesShareBuffer) {
+  Payload payload = {1, 2, 3, 4, 5};
+  Payload slice = payload.Slice(1, 3);
+  EXPECT_EQ(slice.data(), payload.data() + 1);
+  EXPECT_THAT(slice, ElementsAre(2, 3, 4));
+
+  Payload slice_of_slice = slice.Slice(2, 1);
+  EXPECT_EQ(slice_of_slice.data(), payload.data() + 3);
+  EXPECT_THAT(slice_of_slice, ElementsAre(4));
+
+  EXPECT_THAT(payload.Slice(5, 0), IsEmpty());
+}
+
+TEST(PayloadTest, SliceOutlivesOriginal) {
+  Payload slice;
+  {
+    Payload payload = {1, 2, 3, 4, 5};
+    slice = payload.Slice(3, 2);
+  }
+  EXPECT_THAT(slice, ElementsAre(4, 5));
+}
+
+TEST(PayloadTest, CopiesShareBuffer) {
+  Payload payload = {1, 2, 3};
+  Payload copy = payload;
+  EXPECT_EQ(copy.data(), payload.data());
+
+  Payload moved = std::move(payload);
+  EXPECT_EQ(moved.data(), copy.data());
+  EXPECT_THAT(payload, IsEmpty());
+}
+
+TEST(PayloadTest, ReleasesVectorWithoutCopyingWhenNotShared) {
+  std::vector<uint8_t> bytes = {1, 2, 3};
+  const uint8_t* data = bytes.data();
+  Payload payload(std::move(bytes));
+  std::vector<uint8_t> released = std::move(payload).ReleaseVector();
+  EXPECT_EQ(released.data(), data);
+  EXPECT_THAT(released, ElementsAre(1, 2, 3));
+}
+
+TEST(PayloadTest, ReleasesCopyWhenShared) {
+  Payload payload = {1, 2, 3};
+  Payload copy = payload;
+  std::vector<uint8_t> released = std::move(payload).ReleaseVector();
+  EXPECT_NE(released.data(), copy.data());
+  EXPECT_THAT(released, ElementsAre(1, 2, 3));
+  EXPECT_THAT(copy, ElementsAre(1, 2, 3));
+
+  EXPECT_THAT(copy.Slice(1, 2).ReleaseVector(), ElementsAre(2, 3));
+}
+
+TEST(PayloadTest, AdoptsBufferWithoutCopying) {
+  const uint8_t bytes[] = {1, 2, 3, 4};
+  rtc::Buffer buffer(bytes);
+  const uint8_t* data = buffer.data();
+  Payload payload(std::move(buffer));
+  EXPECT_EQ(payload.data(), data);
+  EXPECT_THAT(payload, ElementsAre(1, 2, 3, 4));
+  EXPECT_EQ(payload.Slice(1, 2).data(), data + 1);
+}
+
+TEST(PayloadTest, ReleasesBufferWithoutCopyingWhenNotShared) {
+  const uint8_t bytes[] = {1, 2, 3};
+  rtc::Buffer buffer(bytes);
+  const uint8_t* data = buffer.data();
+  Payload payload(std::move(buffer));
+  rtc::Buffer released = std::move(payload).ReleaseBuffer();
+  EXPECT_EQ(released.data(), data);
+  EXPECT_THAT(released, ElementsAre(1, 2, 3));
+  EXPECT_THAT(payload, IsEmpty());
+}
+
+TEST(PayloadTest, ReleasesBufferCopyWhenSharedOrOwnedByVector) {
+  const uint8_t bytes[] = {1, 2, 3};
+  Payload payload{rtc::Buffer(bytes)};
+  Payload copy = payload;
+  rtc::Buffer released = std::move(payload).ReleaseBuffer();
+  EXPECT_NE(released.data(), copy.data());
+  EXPECT_THAT(released, ElementsAre(1, 2, 3));
+  EXPECT_THAT(copy, ElementsAre(1, 2, 3));
+
+  EXPECT_THAT(copy.Slice(1, 2).ReleaseBuffer(), ElementsAre(2, 3));
+  EXPECT_THAT(Payload({4, 5}).ReleaseBuffer(), ElementsAre(4, 5));
+  EXPECT_THAT(Payload().ReleaseBuffer(), IsEmpty());
+}
+
+}  // namespace
+}  // namespace dcsctp
@@ -206,12 +206,22 @@ bool DataTracker::Observe(TSN tsn,
   // "Specifically, an acknowledgement SHOULD be generated for at least
   // every second packet (not every second DATA chunk) received, and SHOULD be
   // generated within 200 ms of the arrival of any unacknowledged DATA chunk."
+  ObserveAckEliciting("received DATA when idle",
+                      "received DATA when already delayed");
+  return !is_duplicate;
+}
+
+void DataTracker::ObserveAckEliciting(absl::string_view reason_idle,
+                                      absl::string_view reason_delayed) {
+  is_ack_eliciting_packet_ = true;
   if (ack_state_ == AckState::kIdle) {
-    UpdateAckState(AckState::kBecomingDelayed, "received DATA when idle");
-  } else if (ack_state_ == AckState::kDelayed) {
-    UpdateAckState(AckState::kImmediate, "received DATA when already delayed");
+    UpdateAckState(delayed_ack_max_packets_ <= 1 ? AckState::kImmediate
+                                                 : AckState::kBecomingDelayed,
+                   reason_idle);
+  } else if (ack_state_ == AckState::kDelayed &&
+             delayed_packets_ + 1 >= delayed_ack_max_packets_) {
+    UpdateAckState(AckState::kImmediate, reason_delayed);
   }
-  return !is_duplicate;
 }
 
 bool DataTracker::HandleForwardTsn(TSN new_cumulative_ack) {
@@ -264,13 +274,8 @@ bool DataTracker::HandleForwardTsn(TSN new_cumulative_ack) {
   // "Any time a FORWARD TSN chunk arrives, for the purposes of sending a
   // SACK, the receiver MUST follow the same rules as if a DATA chunk had been
   // received (i.e., follow the delayed sack rules specified in ..."
-  if (ack_state_ == AckState::kIdle) {
-    UpdateAckState(AckState::kBecomingDelayed,
-                   "received FORWARD_TSN when idle");
-  } else if (ack_state_ == AckState::kDelayed) {
-    UpdateAckState(AckState::kImmediate,
-                   "received FORWARD_TSN when already delayed");
-  }
+  ObserveAckEliciting("received FORWARD_TSN when idle",
+                      "received FORWARD_TSN when already delayed");
   return true;
 }
 
@@ -288,6 +293,14 @@ SackChunk DataTracker::CreateSelectiveAck(size_t a_rwnd) {
                    CreateGapAckBlocks(), std::move(duplicate_tsns));
 }
 
+size_t DataTracker::selective_ack_size() const {
+  // Every gap ack block and duplicate TSN is four bytes.
+  return SackChunkConfig::kHeaderSize +
+         4 * std::min(additional_tsn_blocks_.blocks().size(),
+                      kMaxGapAckBlocksReported) +
+         4 * duplicate_tsns_.size();
+}
+
 std::vector<SackChunk::GapAckBlock> DataTracker::CreateGapAckBlocks() const {
   const auto& blocks = additional_tsn_blocks_.blocks();
   std::vector<SackChunk::GapAckBlock> gap_ack_blocks;
@@ -331,7 +344,10 @@ void DataTracker::HandleDelayedAckTimerExpiry() {
 void DataTracker::ObservePacketEnd() {
   if (ack_state_ == AckState::kBecomingDelayed) {
     UpdateAckState(AckState::kDelayed, "packet end");
+  } else if (ack_state_ == AckState::kDelayed && is_ack_eliciting_packet_) {
+    ++delayed_packets_;
   }
+  is_ack_eliciting_packet_ = false;
 }
 
 void DataTracker::UpdateAckState(AckState new_state, absl::string_view reason) {
@@ -343,6 +359,7 @@ void DataTracker::UpdateAckState(AckState new_state, absl::string_view reason) {
       delayed_ack_timer_.Stop();
     } else if (new_state == AckState::kDelayed) {
       delayed_ack_timer_.Start();
+      delayed_packets_ = 1;
     }
     ack_state_ = new_state;
   }
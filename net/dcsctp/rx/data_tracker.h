@@ -35,9 +35,10 @@ namespace dcsctp {
 // It only uses TSNs to track delivery and doesn't need to be aware of streams.
 //
 // SACKs are optimally sent every second packet on connections with no packet
-// loss. When packet loss is detected, it's sent for every packet. When SACKs
-// are not sent directly, a timer is used to send a SACK delayed (by RTO/2, or
-// 200ms, whatever is smallest).
+// loss (or every `delayed_ack_max_packets` packet, if configured). When packet
+// loss is detected, it's sent for every packet. When SACKs are not sent
+// directly, a timer is used to send a SACK delayed (by RTO/2, or 200ms,
+// whatever is smallest).
 class DataTracker {
  public:
   // The maximum number of duplicate TSNs that will be reported in a SACK.
@@ -54,8 +55,10 @@ class DataTracker {
 
   DataTracker(absl::string_view log_prefix,
               Timer* delayed_ack_timer,
-              TSN peer_initial_tsn)
+              TSN peer_initial_tsn,
+              size_t delayed_ack_max_packets = 2)
       : log_prefix_(log_prefix),
+        delayed_ack_max_packets_(delayed_ack_max_packets),
         seen_packet_(false),
         delayed_ack_timer_(*delayed_ack_timer),
         last_cumulative_acked_tsn_(
@@ -87,6 +90,12 @@ class DataTracker {
   // `also_if_delayed` is set to true. Then it will return true as well.
   bool ShouldSendAck(bool also_if_delayed = false);
 
+  // Indicates if a SACK is to be sent, but has been delayed.
+  bool is_ack_delayed() const {
+    return ack_state_ == AckState::kBecomingDelayed ||
+           ack_state_ == AckState::kDelayed;
+  }
+
   // Returns the last cumulative ack TSN - the last seen data chunk's TSN
   // value before any packet loss was detected.
   TSN last_cumulative_acked_tsn() const {
@@ -107,6 +116,10 @@ class DataTracker {
   // consumed must be sent.
   SackChunk CreateSelectiveAck(size_t a_rwnd);
 
+  // Returns the serialized size of the SackChunk that would be created by
+  // `CreateSelectiveAck`.
+  size_t selective_ack_size() const;
+
   void HandleDelayedAckTimerExpiry();
 
   HandoverReadinessStatus GetHandoverReadiness() const;
@@ -174,14 +187,26 @@ class DataTracker {
   };
 
   std::vector<SackChunk::GapAckBlock> CreateGapAckBlocks() const;
+  // Called for DATA and FORWARD-TSN chunks, which follow the same delayed ack
+  // rules.
+  void ObserveAckEliciting(absl::string_view reason_idle,
+                           absl::string_view reason_delayed);
   void UpdateAckState(AckState new_state, absl::string_view reason);
   static absl::string_view ToString(AckState ack_state);
 
   const absl::string_view log_prefix_;
+  // A SACK is sent for at least every this number of received packets with
+  // DATA or FORWARD-TSN chunks.
+  const size_t delayed_ack_max_packets_;
   // If a packet has ever been seen.
   bool seen_packet_;
   Timer& delayed_ack_timer_;
   AckState ack_state_ = AckState::kIdle;
+  // The number of packets with DATA or FORWARD-TSN chunks that have been
+  // received since the delayed ack timer was started.
+  size_t delayed_packets_ = 0;
+  // If the current packet has DATA or FORWARD-TSN chunks.
+  bool is_ack_eliciting_packet_ = false;
   UnwrappedTSN::Unwrapper tsn_unwrapper_;
 
   // All TSNs up until (and including) this value have been seen.
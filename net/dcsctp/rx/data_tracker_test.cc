@@ -357,6 +357,41 @@ TEST_F(DataTrackerTest, SendsSackEverySecondPacketWhenThereIsNoPacketLoss) {
   EXPECT_FALSE(timer_->is_running());
 }
 
+TEST_F(DataTrackerTest, SendsSackEveryConfiguredNumberOfPackets) {
+  tracker_ = std::make_unique<DataTracker>("log: ", timer_.get(), kInitialTSN,
+                                           /*delayed_ack_max_packets=*/4);
+  Observer({11});
+  tracker_->ObservePacketEnd();
+  EXPECT_TRUE(tracker_->ShouldSendAck());
+  EXPECT_FALSE(timer_->is_running());
+
+  for (uint32_t tsn : {12, 13, 14}) {
+    Observer({tsn});
+    tracker_->ObservePacketEnd();
+    EXPECT_FALSE(tracker_->ShouldSendAck());
+    EXPECT_TRUE(timer_->is_running());
+  }
+  // Packets without DATA are not counted.
+  tracker_->ObservePacketEnd();
+  EXPECT_FALSE(tracker_->ShouldSendAck());
+
+  Observer({15, 16});
+  tracker_->ObservePacketEnd();
+  EXPECT_TRUE(tracker_->ShouldSendAck());
+  EXPECT_FALSE(timer_->is_running());
+}
+
+TEST_F(DataTrackerTest, SendsSackEveryPacketWhenConfiguredToNotDelay) {
+  tracker_ = std::make_unique<DataTracker>("log: ", timer_.get(), kInitialTSN,
+                                           /*delayed_ack_max_packets=*/1);
+  for (uint32_t tsn : {11, 12, 13}) {
+    Observer({tsn});
+    tracker_->ObservePacketEnd();
+    EXPECT_TRUE(tracker_->ShouldSendAck());
+    EXPECT_FALSE(timer_->is_running());
+  }
+}
+
 TEST_F(DataTrackerTest, SendsSackEveryPacketOnPacketLoss) {
   Observer({11});
   tracker_->ObservePacketEnd();
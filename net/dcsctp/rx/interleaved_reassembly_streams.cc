@@ -12,11 +12,10 @@
 #include <stddef.h>
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <iterator>
-#include <map>
 #include <numeric>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -25,7 +24,10 @@
 #include "net/dcsctp/common/sequence_numbers.h"
 #include "net/dcsctp/packet/chunk/forward_tsn_common.h"
 #include "net/dcsctp/packet/data.h"
+#include "net/dcsctp/public/dcsctp_message.h"
+#include "net/dcsctp/public/payload.h"
 #include "net/dcsctp/public/types.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/logging.h"
 
 namespace dcsctp {
@@ -35,36 +37,44 @@ InterleavedReassemblyStreams::InterleavedReassemblyStreams(
     OnAssembledMessage on_assembled_message)
     : log_prefix_(log_prefix), on_assembled_message_(on_assembled_message) {}
 
+InterleavedReassemblyStreams::Stream::PendingMessages::iterator
+InterleavedReassemblyStreams::Stream::FindMessage(UnwrappedMID mid) {
+  auto it = absl::c_lower_bound(
+      messages_, mid,
+      [](const PendingMessage& a, UnwrappedMID b) { return a.mid < b; });
+  return it != messages_.end() && it->mid == mid ? it : messages_.end();
+}
+
 size_t InterleavedReassemblyStreams::Stream::TryToAssembleMessage(
     UnwrappedMID mid) {
-  std::map<UnwrappedMID, ChunkMap>::iterator it = chunks_by_mid_.find(mid);
-  if (it == chunks_by_mid_.end()) {
-    RTC_DLOG(LS_VERBOSE) << parent_.log_prefix_ << "TryToAssembleMessage "
+  PendingMessages::iterator it = FindMessage(mid);
+  if (it == messages_.end()) {
+    RTC_DLOG(LS_VERBOSE) << parent_->log_prefix_ << "TryToAssembleMessage "
                          << *mid.Wrap() << " - no chunks";
     return 0;
   }
-  ChunkMap& chunks = it->second;
-  if (!chunks.begin()->second.second.is_beginning ||
-      !chunks.rbegin()->second.second.is_end) {
-    RTC_DLOG(LS_VERBOSE) << parent_.log_prefix_ << "TryToAssembleMessage "
+  const auto& chunks = it->chunks;
+  if (!chunks.front().second.second.is_beginning ||
+      !chunks.back().second.second.is_end) {
+    RTC_DLOG(LS_VERBOSE) << parent_->log_prefix_ << "TryToAssembleMessage "
                          << *mid.Wrap() << "- missing beginning or end";
     return 0;
   }
-  int64_t fsn_diff = *chunks.rbegin()->first - *chunks.begin()->first;
+  int64_t fsn_diff = *chunks.back().first - *chunks.front().first;
   if (fsn_diff != (static_cast<int64_t>(chunks.size()) - 1)) {
-    RTC_DLOG(LS_VERBOSE) << parent_.log_prefix_ << "TryToAssembleMessage "
+    RTC_DLOG(LS_VERBOSE) << parent_->log_prefix_ << "TryToAssembleMessage "
                          << *mid.Wrap() << "- not all chunks exist (have "
                          << chunks.size() << ", expect " << (fsn_diff + 1)
                          << ")";
     return 0;
   }
 
-  size_t removed_bytes = AssembleMessage(chunks);
-  RTC_DLOG(LS_VERBOSE) << parent_.log_prefix_ << "TryToAssembleMessage "
+  size_t removed_bytes = AssembleMessage(*it);
+  RTC_DLOG(LS_VERBOSE) << parent_->log_prefix_ << "TryToAssembleMessage "
                        << *mid.Wrap() << " - succeeded and removed "
                        << removed_bytes;
 
-  chunks_by_mid_.erase(mid);
+  messages_.erase(it);
   return removed_bytes;
 }
 
@@ -73,40 +83,43 @@ size_t InterleavedReassemblyStreams::Stream::AssembleMessage(UnwrappedTSN tsn,
   size_t payload_size = data.size();
   UnwrappedTSN tsns[1] = {tsn};
   DcSctpMessage message(data.stream_id, data.ppid, std::move(data.payload));
-  parent_.on_assembled_message_(tsns, std::move(message));
+  parent_->on_assembled_message_(tsns, std::move(message));
   return payload_size;
 }
 
 size_t InterleavedReassemblyStreams::Stream::AssembleMessage(
-    ChunkMap& tsn_chunks) {
-  size_t count = tsn_chunks.size();
+    PendingMessage& message) {
+  auto& chunks = message.chunks;
+  size_t count = chunks.size();
   if (count == 1) {
     // Fast path - zero-copy
-    return AssembleMessage(tsn_chunks.begin()->second.first,
-                           std::move(tsn_chunks.begin()->second.second));
+    return AssembleMessage(chunks.front().second.first,
+                           std::move(chunks.front().second.second));
   }
 
   // Slow path - will need to concatenate the payload.
   std::vector<UnwrappedTSN> tsns;
   tsns.reserve(count);
 
-  std::vector<uint8_t> payload;
   size_t payload_size = absl::c_accumulate(
-      tsn_chunks, 0,
+      chunks, 0,
       [](size_t v, const auto& p) { return v + p.second.second.size(); });
-  payload.reserve(payload_size);
+  // Assembled into an `rtc::Buffer`, which the client can adopt without
+  // copying it again.
+  rtc::Buffer payload(0, payload_size);
 
-  for (auto& item : tsn_chunks) {
+  for (auto& item : chunks) {
     const UnwrappedTSN tsn = item.second.first;
     const Data& data = item.second.second;
     tsns.push_back(tsn);
-    payload.insert(payload.end(), data.payload.begin(), data.payload.end());
+    payload.AppendData(data.payload.data(), data.payload.size());
   }
 
-  const Data& data = tsn_chunks.begin()->second.second;
+  const Data& data = chunks.front().second.second;
 
-  DcSctpMessage message(data.stream_id, data.ppid, std::move(payload));
-  parent_.on_assembled_message_(tsns, std::move(message));
+  DcSctpMessage assembled(data.stream_id, data.ppid,
+                          Payload(std::move(payload)));
+  parent_->on_assembled_message_(tsns, std::move(assembled));
   return payload_size;
 }
 
@@ -114,12 +127,11 @@ size_t InterleavedReassemblyStreams::Stream::EraseTo(MID mid) {
   UnwrappedMID unwrapped_mid = mid_unwrapper_.Unwrap(mid);
 
   size_t removed_bytes = 0;
-  auto it = chunks_by_mid_.begin();
-  while (it != chunks_by_mid_.end() && it->first <= unwrapped_mid) {
+  while (!messages_.empty() && messages_.front().mid <= unwrapped_mid) {
     removed_bytes += absl::c_accumulate(
-        it->second, 0,
+        messages_.front().chunks, 0,
         [](size_t r2, const auto& q) { return r2 + q.second.second.size(); });
-    it = chunks_by_mid_.erase(it);
+    messages_.pop_front();
   }
 
   if (!stream_id_.unordered) {
@@ -142,7 +154,7 @@ int InterleavedReassemblyStreams::Stream::Add(UnwrappedTSN tsn, Data data) {
   UnwrappedMID mid = mid_unwrapper_.Unwrap(data.mid);
   FSN fsn = data.fsn;
 
-  // Avoid inserting it into any map if it can be delivered directly.
+  // Avoid inserting it into any queue if it can be delivered directly.
   if (stream_id_.unordered && data.is_beginning && data.is_end) {
     AssembleMessage(tsn, std::move(data));
     return 0;
@@ -155,12 +167,27 @@ int InterleavedReassemblyStreams::Stream::Add(UnwrappedTSN tsn, Data data) {
     return -TryToAssembleMessages();
   }
 
-  // Slow path.
-  auto [unused, inserted] =
-      chunks_by_mid_[mid].emplace(fsn, std::make_pair(tsn, std::move(data)));
-  if (!inserted) {
-    return 0;
+  // Slow path. Messages and their fragments are mostly received in order, so
+  // start by looking at the end.
+  PendingMessages::iterator message = messages_.end();
+  if (!messages_.empty() && mid <= messages_.back().mid) {
+    message = absl::c_lower_bound(
+        messages_, mid,
+        [](const PendingMessage& a, UnwrappedMID b) { return a.mid < b; });
+  }
+  if (message == messages_.end() || message->mid != mid) {
+    message = messages_.insert(message, PendingMessage{.mid = mid});
   }
+  auto& chunks = message->chunks;
+  auto chunk = chunks.end();
+  if (!chunks.empty() && fsn <= chunks.back().first) {
+    chunk = absl::c_lower_bound(
+        chunks, fsn, [](const auto& a, FSN b) { return a.first < b; });
+    if (chunk->first == fsn) {
+      return 0;
+    }
+  }
+  chunks.emplace(chunk, fsn, std::make_pair(tsn, std::move(data)));
 
   if (stream_id_.unordered) {
     queued_bytes -= TryToAssembleMessage(mid);
@@ -204,15 +231,7 @@ void InterleavedReassemblyStreams::Stream::AddHandoverState(
 
 InterleavedReassemblyStreams::Stream&
 InterleavedReassemblyStreams::GetOrCreateStream(const FullStreamId& stream_id) {
-  auto it = streams_.find(stream_id);
-  if (it == streams_.end()) {
-    it =
-        streams_
-            .emplace(std::piecewise_construct, std::forward_as_tuple(stream_id),
-                     std::forward_as_tuple(stream_id, this))
-            .first;
-  }
-  return it->second;
+  return streams_.try_emplace(stream_id, stream_id, this).first->second;
 }
 
 int InterleavedReassemblyStreams::Add(UnwrappedTSN tsn, Data data) {
@@ -276,15 +295,12 @@ void InterleavedReassemblyStreams::RestoreFromState(
   for (const DcSctpSocketHandoverState::OrderedStream& state :
        state.rx.ordered_streams) {
     FullStreamId stream_id(IsUnordered(false), StreamID(state.id));
-    streams_.emplace(
-        std::piecewise_construct, std::forward_as_tuple(stream_id),
-        std::forward_as_tuple(stream_id, this, MID(state.next_ssn)));
+    streams_.try_emplace(stream_id, stream_id, this, MID(state.next_ssn));
   }
   for (const DcSctpSocketHandoverState::UnorderedStream& state :
        state.rx.unordered_streams) {
     FullStreamId stream_id(IsUnordered(true), StreamID(state.id));
-    streams_.emplace(std::piecewise_construct, std::forward_as_tuple(stream_id),
-                     std::forward_as_tuple(stream_id, this));
+    streams_.try_emplace(stream_id, stream_id, this);
   }
 }
 
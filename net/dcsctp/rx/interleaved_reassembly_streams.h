@@ -11,9 +11,10 @@
 #define NET_DCSCTP_RX_INTERLEAVED_REASSEMBLY_STREAMS_H_
 
 #include <cstdint>
-#include <map>
+#include <deque>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "api/array_view.h"
@@ -21,6 +22,7 @@
 #include "net/dcsctp/packet/chunk/forward_tsn_common.h"
 #include "net/dcsctp/packet/data.h"
 #include "net/dcsctp/rx/reassembly_streams.h"
+#include "rtc_base/containers/flat_map.h"
 
 namespace dcsctp {
 
@@ -46,8 +48,8 @@ class InterleavedReassemblyStreams : public ReassemblyStreams {
 
  private:
   struct FullStreamId {
-    const IsUnordered unordered;
-    const StreamID stream_id;
+    IsUnordered unordered;
+    StreamID stream_id;
 
     FullStreamId(IsUnordered unordered, StreamID stream_id)
         : unordered(unordered), stream_id(stream_id) {}
@@ -64,24 +66,35 @@ class InterleavedReassemblyStreams : public ReassemblyStreams {
            InterleavedReassemblyStreams* parent,
            MID next_mid = MID(0))
         : stream_id_(stream_id),
-          parent_(*parent),
+          parent_(parent),
           next_mid_(mid_unwrapper_.Unwrap(next_mid)) {}
+    Stream(Stream&&) = default;
+    Stream& operator=(Stream&&) = default;
     int Add(UnwrappedTSN tsn, Data data);
     size_t EraseTo(MID mid);
     void Reset() {
       mid_unwrapper_.Reset();
       next_mid_ = mid_unwrapper_.Unwrap(MID(0));
     }
-    bool has_unassembled_chunks() const { return !chunks_by_mid_.empty(); }
+    bool has_unassembled_chunks() const { return !messages_.empty(); }
     void AddHandoverState(DcSctpSocketHandoverState& state) const;
 
    private:
-    using ChunkMap = std::map<FSN, std::pair<UnwrappedTSN, Data>>;
-
+    // The received chunks of a message that is not yet assembled.
+    struct PendingMessage {
+      UnwrappedMID mid;
+      // Sorted by FSN. Typically small, as it's bounded by the number of
+      // fragments of the message.
+      std::vector<std::pair<FSN, std::pair<UnwrappedTSN, Data>>> chunks;
+    };
+    using PendingMessages = std::deque<PendingMessage>;
+
+    // Returns the message with `mid`, or `messages_.end()` if there is none.
+    PendingMessages::iterator FindMessage(UnwrappedMID mid);
     // Try to assemble one message identified by `mid`.
     // Returns the number of bytes assembled if a message was assembled.
     size_t TryToAssembleMessage(UnwrappedMID mid);
-    size_t AssembleMessage(ChunkMap& tsn_chunks);
+    size_t AssembleMessage(PendingMessage& message);
     size_t AssembleMessage(UnwrappedTSN tsn, Data data);
 
     // Try to assemble one or several messages in order from the stream.
@@ -89,9 +102,12 @@ class InterleavedReassemblyStreams : public ReassemblyStreams {
     // assembled.
     size_t TryToAssembleMessages();
 
-    const FullStreamId stream_id_;
-    InterleavedReassemblyStreams& parent_;
-    std::map<UnwrappedMID, ChunkMap> chunks_by_mid_;
+    FullStreamId stream_id_;
+    InterleavedReassemblyStreams* parent_;
+    // Pending messages, sorted by MID. Only messages with received chunks are
+    // stored, so the memory used is bounded by the number of received chunks
+    // and not by the span of MIDs chosen by the peer.
+    PendingMessages messages_;
     UnwrappedMID::Unwrapper mid_unwrapper_;
     UnwrappedMID next_mid_;
   };
@@ -103,8 +119,9 @@ class InterleavedReassemblyStreams : public ReassemblyStreams {
   // Callback for when a message has been assembled.
   const OnAssembledMessage on_assembled_message_;
 
-  // All unordered and ordered streams, managing not-yet-assembled data.
-  std::map<FullStreamId, Stream> streams_;
+  // All unordered and ordered streams, managing not-yet-assembled data. Stored
+  // in a sorted vector, as streams are looked up for every received chunk.
+  webrtc::flat_map<FullStreamId, Stream> streams_;
 };
 
 }  // namespace dcsctp
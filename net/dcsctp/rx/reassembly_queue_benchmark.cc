@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures ReassemblyQueue throughput for messages sent on many streams and
+// received out of order.
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "net/dcsctp/common/internal_types.h"
+#include "net/dcsctp/packet/data.h"
+#include "net/dcsctp/public/payload.h"
+#include "net/dcsctp/public/types.h"
+#include "net/dcsctp/rx/reassembly_queue.h"
+#include "rtc_base/checks.h"
+
+namespace dcsctp {
+namespace {
+
+constexpr size_t kMaxQueueSize = 10'000'000;
+constexpr size_t kFragmentSize = 100;
+constexpr int kMessagesPerBatch = 256;
+// Chunks within each group of this size arrive in reverse order.
+constexpr int kReorderDistance = 16;
+constexpr PPID kPpid(53);
+
+struct ChunkTemplate {
+  uint32_t tsn_offset;
+  StreamID stream_id;
+  // Index of the message within the stream, in this batch.
+  uint32_t message_index;
+  uint32_t fsn;
+  bool is_beginning;
+  bool is_end;
+};
+
+// Returns the chunks of a batch of messages, sent round robin on the streams,
+// in the order they arrive.
+std::vector<ChunkTemplate> CreateBatch(bool interleaved,
+                                       int num_streams,
+                                       int fragments_per_message) {
+  std::vector<ChunkTemplate> chunks;
+  for (int m = 0; m < kMessagesPerBatch; ++m) {
+    int stream = m % num_streams;
+    uint32_t message_index = m / num_streams;
+    for (int f = 0; f < fragments_per_message; ++f) {
+      chunks.push_back({.stream_id = StreamID(stream),
+                        .message_index = message_index,
+                        .fsn = static_cast<uint32_t>(f),
+                        .is_beginning = f == 0,
+                        .is_end = f == fragments_per_message - 1});
+    }
+  }
+  if (interleaved) {
+    // With I-DATA, fragments of messages on different streams are
+    // interleaved.
+    std::stable_sort(chunks.begin(), chunks.end(),
+                     [](const ChunkTemplate& a, const ChunkTemplate& b) {
+                       return a.message_index < b.message_index ||
+                              (a.message_index == b.message_index &&
+                               a.fsn < b.fsn);
+                     });
+  }
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    chunks[i].tsn_offset = i;
+  }
+  for (size_t group = 0; group < chunks.size(); group += kReorderDistance) {
+    std::reverse(
+        chunks.begin() + group,
+        chunks.begin() + std::min(group + kReorderDistance, chunks.size()));
+  }
+  return chunks;
+}
+
+void BM_ReassemblyQueueOutOfOrder(benchmark::State& state) {
+  const bool interleaved = state.range(0) != 0;
+  const int num_streams = state.range(1);
+  const int fragments_per_message = state.range(2);
+  RTC_CHECK_EQ(kMessagesPerBatch % num_streams, 0);
+  const uint32_t messages_per_stream = kMessagesPerBatch / num_streams;
+  const std::vector<ChunkTemplate> batch =
+      CreateBatch(interleaved, num_streams, fragments_per_message);
+  const Payload payload = std::vector<uint8_t>(kFragmentSize);
+
+  ReassemblyQueue queue("log: ", kMaxQueueSize, interleaved);
+  uint32_t tsn = 10;
+  std::vector<uint32_t> next_message(num_streams, 0);
+  for (auto _ : state) {
+    for (const ChunkTemplate& chunk : batch) {
+      uint32_t message = next_message[*chunk.stream_id] + chunk.message_index;
+      queue.Add(TSN(tsn + chunk.tsn_offset),
+                Data(chunk.stream_id, SSN(message), MID(message),
+                     FSN(chunk.fsn), kPpid, payload,
+                     Data::IsBeginning(chunk.is_beginning),
+                     Data::IsEnd(chunk.is_end), IsUnordered(false)));
+    }
+    RTC_CHECK_EQ(queue.FlushMessages().size(), kMessagesPerBatch);
+    tsn += batch.size();
+    for (uint32_t& message : next_message) {
+      message += messages_per_stream;
+    }
+  }
+  RTC_CHECK_EQ(queue.queued_bytes(), 0);
+  state.SetItemsProcessed(state.iterations() * batch.size());
+}
+
+// Arguments are: if I-DATA is used, number of streams and number of fragments
+// per message.
+BENCHMARK(BM_ReassemblyQueueOutOfOrder)
+    ->ArgsProduct({{0, 1}, {1, 16, 256}, {1, 8}});
+
+}  // namespace
+}  // namespace dcsctp
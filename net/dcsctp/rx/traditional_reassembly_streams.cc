@@ -12,9 +12,9 @@
 #include <stddef.h>
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <iterator>
-#include <map>
 #include <numeric>
 #include <optional>
 #include <utility>
@@ -26,18 +26,21 @@
 #include "net/dcsctp/packet/chunk/forward_tsn_common.h"
 #include "net/dcsctp/packet/data.h"
 #include "net/dcsctp/public/dcsctp_message.h"
+#include "net/dcsctp/public/payload.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/logging.h"
 
 namespace dcsctp {
 namespace {
 
-// Given a map (`chunks`) and an iterator to within that map (`iter`), this
-// function will return an iterator to the first chunk in that message, which
-// has the `is_beginning` flag set. If there are any gaps, or if the beginning
-// can't be found, `std::nullopt` is returned.
-std::optional<std::map<UnwrappedTSN, Data>::iterator> FindBeginning(
-    const std::map<UnwrappedTSN, Data>& chunks,
-    std::map<UnwrappedTSN, Data>::iterator iter) {
+// Given a queue (`chunks`) sorted by TSN and an iterator to within that queue
+// (`iter`), this function will return an iterator to the first chunk in that
+// message, which has the `is_beginning` flag set. If there are any gaps, or if
+// the beginning can't be found, `std::nullopt` is returned.
+template <typename Container>
+std::optional<typename Container::iterator> FindBeginning(
+    const Container& chunks,
+    typename Container::iterator iter) {
   UnwrappedTSN prev_tsn = iter->first;
   for (;;) {
     if (iter->second.is_beginning) {
@@ -54,13 +57,14 @@ std::optional<std::map<UnwrappedTSN, Data>::iterator> FindBeginning(
   }
 }
 
-// Given a map (`chunks`) and an iterator to within that map (`iter`), this
-// function will return an iterator to the chunk after the last chunk in that
-// message, which has the `is_end` flag set. If there are any gaps, or if the
-// end can't be found, `std::nullopt` is returned.
-std::optional<std::map<UnwrappedTSN, Data>::iterator> FindEnd(
-    std::map<UnwrappedTSN, Data>& chunks,
-    std::map<UnwrappedTSN, Data>::iterator iter) {
+// Given a queue (`chunks`) sorted by TSN and an iterator to within that queue
+// (`iter`), this function will return an iterator to the chunk after the last
+// chunk in that message, which has the `is_end` flag set. If there are any
+// gaps, or if the end can't be found, `std::nullopt` is returned.
+template <typename Container>
+std::optional<typename Container::iterator> FindEnd(
+    Container& chunks,
+    typename Container::iterator iter) {
   UnwrappedTSN prev_tsn = iter->first;
   for (;;) {
     if (iter->second.is_end) {
@@ -76,6 +80,32 @@ std::optional<std::map<UnwrappedTSN, Data>::iterator> FindEnd(
     prev_tsn = iter->first;
   }
 }
+
+// Inserts `tsn` and `data` into `chunks`, which is sorted by TSN. Returns an
+// iterator to the inserted chunk, or `std::nullopt` if it's a duplicate.
+template <typename Container>
+std::optional<typename Container::iterator> InsertSorted(Container& chunks,
+                                                         UnwrappedTSN tsn,
+                                                         Data data) {
+  // Chunks are mostly received in order, so start by looking at the end.
+  auto it = chunks.end();
+  if (!chunks.empty() && tsn <= chunks.back().first) {
+    it = absl::c_lower_bound(
+        chunks, tsn, [](const auto& a, UnwrappedTSN b) { return a.first < b; });
+    if (it->first == tsn) {
+      return std::nullopt;
+    }
+  }
+  return chunks.emplace(it, tsn, std::move(data));
+}
+
+template <typename Iterator>
+size_t SumPayloadSizes(Iterator start, Iterator end) {
+  return std::accumulate(
+      start, end, size_t{0},
+      [](size_t v, const auto& p) { return v + p.second.size(); });
+}
+
 }  // namespace
 
 TraditionalReassemblyStreams::TraditionalReassemblyStreams(
@@ -92,27 +122,28 @@ int TraditionalReassemblyStreams::UnorderedStream::Add(UnwrappedTSN tsn,
     return 0;
   }
   int queued_bytes = data.size();
-  auto [it, inserted] = chunks_.emplace(tsn, std::move(data));
-  if (!inserted) {
+  std::optional<ChunkQueue::iterator> it =
+      InsertSorted(chunks_, tsn, std::move(data));
+  if (!it.has_value()) {
     return 0;
   }
 
-  queued_bytes -= TryToAssembleMessage(it);
+  queued_bytes -= TryToAssembleMessage(*it);
 
   return queued_bytes;
 }
 
 size_t TraditionalReassemblyStreams::UnorderedStream::TryToAssembleMessage(
-    ChunkMap::iterator iter) {
+    ChunkQueue::iterator iter) {
   // TODO(boivie): This method is O(N) with the number of fragments in a
   // message, which can be inefficient for very large values of N. This could be
   // optimized by e.g. only trying to assemble a message once _any_ beginning
   // and _any_ end has been found.
-  std::optional<ChunkMap::iterator> start = FindBeginning(chunks_, iter);
+  std::optional<ChunkQueue::iterator> start = FindBeginning(chunks_, iter);
   if (!start.has_value()) {
     return 0;
   }
-  std::optional<ChunkMap::iterator> end = FindEnd(chunks_, iter);
+  std::optional<ChunkQueue::iterator> end = FindEnd(chunks_, iter);
   if (!end.has_value()) {
     return 0;
   }
@@ -122,9 +153,10 @@ size_t TraditionalReassemblyStreams::UnorderedStream::TryToAssembleMessage(
   return bytes_assembled;
 }
 
+template <typename Iterator>
 size_t TraditionalReassemblyStreams::StreamBase::AssembleMessage(
-    const ChunkMap::iterator start,
-    const ChunkMap::iterator end) {
+    const Iterator start,
+    const Iterator end) {
   size_t count = std::distance(start, end);
 
   if (count == 1) {
@@ -134,23 +166,22 @@ size_t TraditionalReassemblyStreams::StreamBase::AssembleMessage(
 
   // Slow path - will need to concatenate the payload.
   std::vector<UnwrappedTSN> tsns;
-  std::vector<uint8_t> payload;
 
-  size_t payload_size = std::accumulate(
-      start, end, 0,
-      [](size_t v, const auto& p) { return v + p.second.size(); });
+  size_t payload_size = SumPayloadSizes(start, end);
+  // Assembled into an `rtc::Buffer`, which the client can adopt without
+  // copying it again.
+  rtc::Buffer payload(0, payload_size);
 
   tsns.reserve(count);
-  payload.reserve(payload_size);
   for (auto it = start; it != end; ++it) {
     const Data& data = it->second;
     tsns.push_back(it->first);
-    payload.insert(payload.end(), data.payload.begin(), data.payload.end());
+    payload.AppendData(data.payload.data(), data.payload.size());
   }
 
   DcSctpMessage message(start->second.stream_id, start->second.ppid,
-                        std::move(payload));
-  parent_.on_assembled_message_(tsns, std::move(message));
+                        Payload(std::move(payload)));
+  parent_->on_assembled_message_(tsns, std::move(message));
 
   return payload_size;
 }
@@ -162,40 +193,57 @@ size_t TraditionalReassemblyStreams::StreamBase::AssembleMessage(
   size_t payload_size = data.size();
   UnwrappedTSN tsns[1] = {tsn};
   DcSctpMessage message(data.stream_id, data.ppid, std::move(data.payload));
-  parent_.on_assembled_message_(tsns, std::move(message));
+  parent_->on_assembled_message_(tsns, std::move(message));
   return payload_size;
 }
 
 size_t TraditionalReassemblyStreams::UnorderedStream::EraseTo(
     UnwrappedTSN tsn) {
-  auto end_iter = chunks_.upper_bound(tsn);
-  size_t removed_bytes = std::accumulate(
-      chunks_.begin(), end_iter, 0,
-      [](size_t r, const auto& p) { return r + p.second.size(); });
+  auto end_iter = absl::c_upper_bound(
+      chunks_, tsn, [](UnwrappedTSN a, const auto& b) { return a < b.first; });
+  size_t removed_bytes = SumPayloadSizes(chunks_.begin(), end_iter);
 
   chunks_.erase(chunks_.begin(), end_iter);
   return removed_bytes;
 }
 
+bool TraditionalReassemblyStreams::OrderedStream::Insert(UnwrappedSSN ssn,
+                                                         UnwrappedTSN tsn,
+                                                         Data data) {
+  // Messages are mostly received in SSN order, so start by looking at the end.
+  auto it = messages_.end();
+  if (!messages_.empty() && ssn <= messages_.back().ssn) {
+    it = absl::c_lower_bound(messages_, ssn,
+                             [](const PendingMessage& a, UnwrappedSSN b) {
+                               return a.ssn < b;
+                             });
+  }
+  if (it == messages_.end() || it->ssn != ssn) {
+    it = messages_.insert(it, PendingMessage{.ssn = ssn});
+  }
+  return InsertSorted(it->chunks, tsn, std::move(data)).has_value();
+}
+
 size_t TraditionalReassemblyStreams::OrderedStream::TryToAssembleMessage() {
-  if (chunks_by_ssn_.empty() || chunks_by_ssn_.begin()->first != next_ssn_) {
+  if (messages_.empty() || messages_.front().ssn != next_ssn_) {
     return 0;
   }
 
-  ChunkMap& chunks = chunks_by_ssn_.begin()->second;
+  std::vector<std::pair<UnwrappedTSN, Data>>& chunks =
+      messages_.front().chunks;
 
-  if (!chunks.begin()->second.is_beginning || !chunks.rbegin()->second.is_end) {
+  if (!chunks.front().second.is_beginning || !chunks.back().second.is_end) {
     return 0;
   }
 
   uint32_t tsn_diff =
-      UnwrappedTSN::Difference(chunks.rbegin()->first, chunks.begin()->first);
+      UnwrappedTSN::Difference(chunks.back().first, chunks.front().first);
   if (tsn_diff != chunks.size() - 1) {
     return 0;
   }
 
   size_t assembled_bytes = AssembleMessage(chunks.begin(), chunks.end());
-  chunks_by_ssn_.erase(chunks_by_ssn_.begin());
+  messages_.pop_front();
   next_ssn_.Increment();
   return assembled_bytes;
 }
@@ -225,8 +273,7 @@ TraditionalReassemblyStreams::OrderedStream::TryToAssembleMessagesFastpath(
     next_ssn_.Increment();
   } else {
     size_t queued_bytes = data.size();
-    auto [iter, inserted] = chunks_by_ssn_[ssn].emplace(tsn, std::move(data));
-    if (!inserted) {
+    if (!Insert(ssn, tsn, std::move(data))) {
       // Not actually assembled, but deduplicated meaning queued size doesn't
       // include this message.
       return queued_bytes;
@@ -243,8 +290,7 @@ int TraditionalReassemblyStreams::OrderedStream::Add(UnwrappedTSN tsn,
     return queued_bytes -
            TryToAssembleMessagesFastpath(ssn, tsn, std::move(data));
   }
-  auto [iter, inserted] = chunks_by_ssn_[ssn].emplace(tsn, std::move(data));
-  if (!inserted) {
+  if (!Insert(ssn, tsn, std::move(data))) {
     return 0;
   }
   return queued_bytes;
@@ -253,15 +299,12 @@ int TraditionalReassemblyStreams::OrderedStream::Add(UnwrappedTSN tsn,
 size_t TraditionalReassemblyStreams::OrderedStream::EraseTo(SSN ssn) {
   UnwrappedSSN unwrapped_ssn = ssn_unwrapper_.Unwrap(ssn);
 
-  auto end_iter = chunks_by_ssn_.upper_bound(unwrapped_ssn);
-  size_t removed_bytes = std::accumulate(
-      chunks_by_ssn_.begin(), end_iter, 0, [](size_t r1, const auto& p) {
-        return r1 +
-               absl::c_accumulate(p.second, 0, [](size_t r2, const auto& q) {
-                 return r2 + q.second.size();
-               });
-      });
-  chunks_by_ssn_.erase(chunks_by_ssn_.begin(), end_iter);
+  size_t removed_bytes = 0;
+  while (!messages_.empty() && messages_.front().ssn <= unwrapped_ssn) {
+    const auto& chunks = messages_.front().chunks;
+    removed_bytes += SumPayloadSizes(chunks.begin(), chunks.end());
+    messages_.pop_front();
+  }
 
   if (unwrapped_ssn >= next_ssn_) {
     unwrapped_ssn.Increment();
@@ -363,16 +406,12 @@ void TraditionalReassemblyStreams::RestoreFromState(
 
   for (const DcSctpSocketHandoverState::OrderedStream& state_stream :
        state.rx.ordered_streams) {
-    ordered_streams_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(StreamID(state_stream.id)),
-        std::forward_as_tuple(this, SSN(state_stream.next_ssn)));
+    ordered_streams_.try_emplace(StreamID(state_stream.id), this,
+                                 SSN(state_stream.next_ssn));
   }
   for (const DcSctpSocketHandoverState::UnorderedStream& state_stream :
        state.rx.unordered_streams) {
-    unordered_streams_.emplace(std::piecewise_construct,
-                               std::forward_as_tuple(StreamID(state_stream.id)),
-                               std::forward_as_tuple(this));
+    unordered_streams_.try_emplace(StreamID(state_stream.id), this);
   }
 }
 
@@ -12,8 +12,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <map>
+#include <deque>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "api/array_view.h"
@@ -21,6 +23,7 @@
 #include "net/dcsctp/packet/chunk/forward_tsn_common.h"
 #include "net/dcsctp/packet/data.h"
 #include "net/dcsctp/rx/reassembly_streams.h"
+#include "rtc_base/containers/flat_map.h"
 
 namespace dcsctp {
 
@@ -46,17 +49,19 @@ class TraditionalReassemblyStreams : public ReassemblyStreams {
   void RestoreFromState(const DcSctpSocketHandoverState& state) override;
 
  private:
-  using ChunkMap = std::map<UnwrappedTSN, Data>;
+  // Received chunks, sorted by TSN.
+  using ChunkQueue = std::deque<std::pair<UnwrappedTSN, Data>>;
 
   // Base class for `UnorderedStream` and `OrderedStream`.
   class StreamBase {
    protected:
     explicit StreamBase(TraditionalReassemblyStreams* parent)
-        : parent_(*parent) {}
+        : parent_(parent) {}
 
-    size_t AssembleMessage(ChunkMap::iterator start, ChunkMap::iterator end);
+    template <typename Iterator>
+    size_t AssembleMessage(Iterator start, Iterator end);
     size_t AssembleMessage(UnwrappedTSN tsn, Data data);
-    TraditionalReassemblyStreams& parent_;
+    TraditionalReassemblyStreams* parent_;
   };
 
   // Manages all received data for a specific unordered stream, and assembles
@@ -65,20 +70,22 @@ class TraditionalReassemblyStreams : public ReassemblyStreams {
    public:
     explicit UnorderedStream(TraditionalReassemblyStreams* parent)
         : StreamBase(parent) {}
+    UnorderedStream(UnorderedStream&&) = default;
+    UnorderedStream& operator=(UnorderedStream&&) = default;
     int Add(UnwrappedTSN tsn, Data data);
     // Returns the number of bytes removed from the queue.
     size_t EraseTo(UnwrappedTSN tsn);
     bool has_unassembled_chunks() const { return !chunks_.empty(); }
 
    private:
-    // Given an iterator to any chunk within the map, try to assemble a message
-    // into `reassembled_messages` containing it and - if successful - erase
-    // those chunks from the stream chunks map.
+    // Given an iterator to any chunk within the queue, try to assemble a
+    // message into `reassembled_messages` containing it and - if successful -
+    // erase those chunks from the stream chunks queue.
     //
     // Returns the number of bytes that were assembled.
-    size_t TryToAssembleMessage(ChunkMap::iterator iter);
+    size_t TryToAssembleMessage(ChunkQueue::iterator iter);
 
-    ChunkMap chunks_;
+    ChunkQueue chunks_;
   };
 
   // Manages all received data for a specific ordered stream, and assembles
@@ -88,6 +95,8 @@ class TraditionalReassemblyStreams : public ReassemblyStreams {
     explicit OrderedStream(TraditionalReassemblyStreams* parent,
                            SSN next_ssn = SSN(0))
         : StreamBase(parent), next_ssn_(ssn_unwrapper_.Unwrap(next_ssn)) {}
+    OrderedStream(OrderedStream&&) = default;
+    OrderedStream& operator=(OrderedStream&&) = default;
     int Add(UnwrappedTSN tsn, Data data);
     size_t EraseTo(SSN ssn);
     void Reset() {
@@ -95,20 +104,34 @@ class TraditionalReassemblyStreams : public ReassemblyStreams {
       next_ssn_ = ssn_unwrapper_.Unwrap(SSN(0));
     }
     SSN next_ssn() const { return next_ssn_.Wrap(); }
-    bool has_unassembled_chunks() const { return !chunks_by_ssn_.empty(); }
+    bool has_unassembled_chunks() const { return !messages_.empty(); }
 
    private:
+    // The received chunks of a message that is not yet assembled.
+    struct PendingMessage {
+      UnwrappedSSN ssn;
+      // Sorted by TSN. Typically small, as it's bounded by the number of
+      // fragments of the message.
+      std::vector<std::pair<UnwrappedTSN, Data>> chunks;
+    };
+
+    // Adds the chunk to the message with `ssn`. Returns false if it's a
+    // duplicate.
+    bool Insert(UnwrappedSSN ssn, UnwrappedTSN tsn, Data data);
     // Try to assemble one or several messages in order from the stream.
     // Returns the number of bytes assembled if a message was assembled.
     size_t TryToAssembleMessage();
     size_t TryToAssembleMessages();
     // Same as above but when inserting the first complete message avoid
-    // insertion into the map.
+    // insertion into the queue.
     size_t TryToAssembleMessagesFastpath(UnwrappedSSN ssn,
                                          UnwrappedTSN tsn,
                                          Data data);
-    // This must be an ordered container to be able to iterate in SSN order.
-    std::map<UnwrappedSSN, ChunkMap> chunks_by_ssn_;
+    // Pending messages, sorted by SSN, so that the next message to deliver is
+    // at the front when it has been received. Only messages with received
+    // chunks are stored, so the memory used is bounded by the number of
+    // received chunks and not by the span of SSNs chosen by the peer.
+    std::deque<PendingMessage> messages_;
     UnwrappedSSN::Unwrapper ssn_unwrapper_;
     UnwrappedSSN next_ssn_;
   };
@@ -118,9 +141,10 @@ class TraditionalReassemblyStreams : public ReassemblyStreams {
   // Callback for when a message has been assembled.
   const OnAssembledMessage on_assembled_message_;
 
-  // All unordered and ordered streams, managing not-yet-assembled data.
-  std::map<StreamID, UnorderedStream> unordered_streams_;
-  std::map<StreamID, OrderedStream> ordered_streams_;
+  // All unordered and ordered streams, managing not-yet-assembled data. Stored
+  // in sorted vectors, as streams are looked up for every received chunk.
+  webrtc::flat_map<StreamID, UnorderedStream> unordered_streams_;
+  webrtc::flat_map<StreamID, OrderedStream> ordered_streams_;
 };
 
 }  // namespace dcsctp
@@ -310,5 +310,38 @@ TEST_F(TraditionalReassemblyStreamsTest, CanReassembleFastPathOrdered) {
   EXPECT_EQ(streams.Add(tsn(2), std::move(data2)), -1);
   EXPECT_EQ(streams.Add(tsn(4), std::move(data4)), 0);
 }
+
+TEST_F(TraditionalReassemblyStreamsTest,
+       ReassemblesOrderedMessagesReceivedInReverseOrder) {
+  NiceMock<MockFunction<ReassemblyStreams::OnAssembledMessage>> on_assembled;
+
+  {
+    testing::InSequence s;
+    EXPECT_CALL(on_assembled,
+                Call(ElementsAre(tsn(1), tsn(2)),
+                     Property(&DcSctpMessage::payload, ElementsAre(1, 2))));
+    EXPECT_CALL(on_assembled,
+                Call(ElementsAre(tsn(3), tsn(4)),
+                     Property(&DcSctpMessage::payload, ElementsAre(3, 4))));
+    EXPECT_CALL(on_assembled,
+                Call(ElementsAre(tsn(5)),
+                     Property(&DcSctpMessage::payload, ElementsAre(5))));
+  }
+
+  TraditionalReassemblyStreams streams("", on_assembled.AsStdFunction());
+
+  Data data1 = gen_.Ordered({1}, "B");
+  Data data2 = gen_.Ordered({2}, "E");
+  Data data3 = gen_.Ordered({3}, "B");
+  Data data4 = gen_.Ordered({4}, "E");
+  Data data5 = gen_.Ordered({5}, "BE");
+  EXPECT_EQ(streams.Add(tsn(5), std::move(data5)), 1);
+  EXPECT_EQ(streams.Add(tsn(4), data4.Clone()), 1);
+  // Duplicates are not queued twice.
+  EXPECT_EQ(streams.Add(tsn(4), std::move(data4)), 0);
+  EXPECT_EQ(streams.Add(tsn(3), std::move(data3)), 1);
+  EXPECT_EQ(streams.Add(tsn(2), std::move(data2)), 1);
+  EXPECT_EQ(streams.Add(tsn(1), std::move(data1)), -4);
+}
 }  // namespace
 }  // namespace dcsctp
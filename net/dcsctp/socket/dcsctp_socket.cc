@@ -212,12 +212,15 @@ DcSctpSocket::DcSctpSocket(absl::string_view log_prefix,
                        TimerBackoffAlgorithm::kExponential,
                        options.max_retransmissions))),
       packet_sender_(callbacks_,
-                     absl::bind_front(&DcSctpSocket::OnSentPacket, this)),
+                     absl::bind_front(&DcSctpSocket::OnSentPacket, this),
+                     options.enable_packet_coalescing ? options.mtu : 0),
       send_queue_(log_prefix_,
                   &callbacks_,
                   options_.mtu,
                   options_.default_stream_priority,
-                  options_.total_buffered_amount_low_threshold) {}
+                  options_.total_buffered_amount_low_threshold) {
+  send_queue_.EnableDeadlineScheduling(options_.enable_deadline_scheduling);
+}
 
 std::string DcSctpSocket::log_prefix() const {
   return log_prefix_ + "[" + std::string(ToString(state_)) + "] ";
@@ -307,6 +310,7 @@ void DcSctpSocket::SendInit() {
 }
 
 void DcSctpSocket::Connect() {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
 
   if (state_ == State::kClosed) {
@@ -352,6 +356,7 @@ void DcSctpSocket::CreateTransmissionControlBlock(
 }
 
 void DcSctpSocket::RestoreFromState(const DcSctpSocketHandoverState& state) {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
 
   if (state_ != State::kClosed) {
@@ -394,6 +399,7 @@ void DcSctpSocket::RestoreFromState(const DcSctpSocketHandoverState& state) {
 }
 
 void DcSctpSocket::Shutdown() {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
 
   if (tcb_ != nullptr) {
@@ -422,6 +428,7 @@ void DcSctpSocket::Shutdown() {
 }
 
 void DcSctpSocket::Close() {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
 
   if (state_ != State::kClosed) {
@@ -477,6 +484,7 @@ StreamPriority DcSctpSocket::GetStreamPriority(StreamID stream_id) const {
 
 SendStatus DcSctpSocket::Send(DcSctpMessage message,
                               const SendOptions& send_options) {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
   SendStatus send_status = InternalSend(message, send_options);
   if (send_status != SendStatus::kSuccess)
@@ -493,6 +501,7 @@ SendStatus DcSctpSocket::Send(DcSctpMessage message,
 std::vector<SendStatus> DcSctpSocket::SendMany(
     rtc::ArrayView<DcSctpMessage> messages,
     const SendOptions& send_options) {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
   Timestamp now = callbacks_.Now();
   std::vector<SendStatus> send_statuses;
@@ -558,6 +567,7 @@ SendStatus DcSctpSocket::InternalSend(const DcSctpMessage& message,
 
 ResetStreamsStatus DcSctpSocket::ResetStreams(
     rtc::ArrayView<const StreamID> outgoing_streams) {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
 
   if (tcb_ == nullptr) {
@@ -767,6 +777,7 @@ bool DcSctpSocket::ValidatePacket(const SctpPacket& packet) {
 }
 
 void DcSctpSocket::HandleTimeout(TimeoutID timeout_id) {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
 
   timer_manager_.HandleTimeout(timeout_id);
@@ -780,6 +791,7 @@ void DcSctpSocket::HandleTimeout(TimeoutID timeout_id) {
 }
 
 void DcSctpSocket::ReceivePacket(rtc::ArrayView<const uint8_t> data) {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
 
   ++metrics_.rx_packets_count;
@@ -1789,6 +1801,7 @@ HandoverReadinessStatus DcSctpSocket::GetHandoverReadiness() const {
 
 std::optional<DcSctpSocketHandoverState>
 DcSctpSocket::GetHandoverStateAndClose() {
+  PacketSender::ScopedBatch batch(packet_sender_);
   CallbackDeferrer::ScopedDeferrer deferrer(callbacks_);
 
   if (!GetHandoverReadiness().IsReady()) {
@@ -494,6 +494,102 @@ TEST_F(DcSctpSocketNetworkTest, CanSendMessagesReliablyWithMuchPacketLoss) {
   EXPECT_THAT(bitrate, AllOf(Ge(1.5), Le(2.5)));
 }
 
+TEST_F(DcSctpSocketNetworkTest,
+       DCSCTP_NDEBUG_TEST(CanSendMessagesWithMediumBandwidthUsingBbr)) {
+  options_.congestion_control_algorithm = CongestionControlAlgorithm::kBbr;
+  webrtc::BuiltInNetworkBehaviorConfig pipe_config;
+  pipe_config.queue_delay_ms = 30;
+  pipe_config.link_capacity = DataRate::KilobitsPerSec(18000);
+  MakeNetwork(pipe_config);
+
+  SctpActor sender("A", emulated_socket_a_, options_);
+  SctpActor receiver("Z", emulated_socket_z_, options_);
+  sender.sctp_socket().Connect();
+
+  sender.SetActorMode(ActorMode::kThroughputSender);
+  receiver.SetActorMode(ActorMode::kThroughputReceiver);
+
+  Sleep(kBenchmarkRuntime);
+  sender.SetActorMode(ActorMode::kAtRest);
+  receiver.SetActorMode(ActorMode::kAtRest);
+
+  Sleep(kAWhile);
+
+  sender.sctp_socket().Shutdown();
+
+  Sleep(kAWhile);
+
+  // BBR doesn't fill the bottleneck queue, so it's slightly below the link
+  // capacity. Verify that the bitrates are in the range of 14-18 Mbps.
+  double bitrate = receiver.avg_received_bitrate_mbps();
+  EXPECT_THAT(bitrate, AllOf(Ge(14), Le(18)));
+}
+
+TEST_F(DcSctpSocketNetworkTest,
+       DCSCTP_NDEBUG_TEST(CanSendMessagesWithMuchPacketLossUsingBbr)) {
+  options_.congestion_control_algorithm = CongestionControlAlgorithm::kBbr;
+  webrtc::BuiltInNetworkBehaviorConfig config;
+  config.queue_delay_ms = 30;
+  config.loss_percent = 1;
+  MakeNetwork(config);
+
+  SctpActor sender("A", emulated_socket_a_, options_);
+  SctpActor receiver("Z", emulated_socket_z_, options_);
+  sender.sctp_socket().Connect();
+
+  sender.SetActorMode(ActorMode::kThroughputSender);
+  receiver.SetActorMode(ActorMode::kThroughputReceiver);
+
+  Sleep(kBenchmarkRuntime);
+  sender.SetActorMode(ActorMode::kAtRest);
+  receiver.SetActorMode(ActorMode::kAtRest);
+
+  Sleep(kAWhile);
+
+  sender.sctp_socket().Shutdown();
+
+  Sleep(kAWhile);
+
+  // Compared to `CanSendMessagesReliablyWithMuchPacketLoss`, where the
+  // congestion window is halved on every loss event, the goodput should be
+  // much higher.
+  double bitrate = receiver.avg_received_bitrate_mbps();
+  EXPECT_THAT(bitrate, Ge(5));
+}
+
+TEST_F(DcSctpSocketNetworkTest,
+       DCSCTP_NDEBUG_TEST(HasHighGoodputWithLossyHighBdpLinkUsingBbr)) {
+  options_.congestion_control_algorithm = CongestionControlAlgorithm::kBbr;
+  webrtc::BuiltInNetworkBehaviorConfig config;
+  config.queue_delay_ms = 50;
+  config.link_capacity = DataRate::KilobitsPerSec(50000);
+  config.loss_percent = 0.5;
+  MakeNetwork(config);
+
+  SctpActor sender("A", emulated_socket_a_, options_);
+  SctpActor receiver("Z", emulated_socket_z_, options_);
+  sender.sctp_socket().Connect();
+
+  sender.SetActorMode(ActorMode::kThroughputSender);
+  receiver.SetActorMode(ActorMode::kThroughputReceiver);
+
+  Sleep(kBenchmarkRuntime);
+  sender.SetActorMode(ActorMode::kAtRest);
+  receiver.SetActorMode(ActorMode::kAtRest);
+
+  Sleep(kAWhile);
+
+  sender.sctp_socket().Shutdown();
+
+  Sleep(kAWhile);
+
+  // With 100ms RTT and 0.5% packet loss, the default congestion control
+  // algorithm reaches around 2 Mbps, as the congestion window never grows
+  // large enough to fill the link.
+  double bitrate = receiver.avg_received_bitrate_mbps();
+  EXPECT_THAT(bitrate, AllOf(Ge(8), Le(50)));
+}
+
 TEST_F(DcSctpSocketNetworkTest, DCSCTP_NDEBUG_TEST(HasHighBandwidth)) {
   webrtc::BuiltInNetworkBehaviorConfig pipe_config;
   pipe_config.queue_delay_ms = 30;
@@ -0,0 +1,285 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the CPU usage and the number of timer wakeups of a server with many
+// associations, e.g. an SFU terminating data channels, where most associations
+// are idle and some exchange small messages. Every iteration simulates one
+// second, and it's run with timers per socket or with a shared timer service,
+// and with or without packet coalescing and less frequent SACKs.
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/strings/string_view.h"
+#include "api/array_view.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "net/dcsctp/public/dcsctp_message.h"
+#include "net/dcsctp/public/dcsctp_options.h"
+#include "net/dcsctp/public/dcsctp_socket.h"
+#include "net/dcsctp/public/payload.h"
+#include "net/dcsctp/public/timeout.h"
+#include "net/dcsctp/public/types.h"
+#include "net/dcsctp/socket/dcsctp_socket.h"
+#include "net/dcsctp/timer/shared_timeout_service.h"
+#include "net/dcsctp/timer/task_queue_timeout.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/random.h"
+
+namespace dcsctp {
+namespace {
+using ::webrtc::TimeDelta;
+using ::webrtc::Timestamp;
+
+constexpr int kIdleAssociations = 10'000;
+constexpr int kActiveAssociations = 1'000;
+constexpr TimeDelta kOneWayDelay = TimeDelta::Millis(20);
+constexpr TimeDelta kStep = TimeDelta::Millis(10);
+// Every active association sends a burst of messages at this interval, which
+// are echoed back by the peer.
+constexpr TimeDelta kMessageInterval = TimeDelta::Millis(100);
+constexpr int kMessagesPerBurst = 4;
+constexpr size_t kMessageSize = 100;
+
+// A single-threaded task queue with simulated time. Every delayed task that is
+// run would wake up a real thread, which is what is counted.
+class SimulatedTaskQueue : public webrtc::TaskQueueBase {
+ public:
+  void Delete() override {}
+
+  Timestamp now() const { return now_; }
+  int64_t wakeups() const { return wakeups_; }
+
+  // Runs `task` at `at`, without counting it as a wakeup, as for receiving
+  // packets from the network.
+  void RunAt(Timestamp at, absl::AnyInvocable<void() &&> task) {
+    Add(at, std::move(task), /*is_wakeup=*/false);
+  }
+
+  void RunUntil(Timestamp end) {
+    while (!tasks_.empty() && tasks_.front().at <= end) {
+      std::pop_heap(tasks_.begin(), tasks_.end(), Later);
+      Task task = std::move(tasks_.back());
+      tasks_.pop_back();
+      now_ = task.at;
+      if (task.is_wakeup) {
+        ++wakeups_;
+      }
+      CurrentTaskQueueSetter setter(this);
+      std::move(task.task)();
+    }
+    now_ = end;
+  }
+
+ protected:
+  void PostTaskImpl(absl::AnyInvocable<void() &&> task,
+                    const PostTaskTraits& traits,
+                    const webrtc::Location& location) override {
+    Add(now_, std::move(task), /*is_wakeup=*/false);
+  }
+
+  void PostDelayedTaskImpl(absl::AnyInvocable<void() &&> task,
+                           TimeDelta delay,
+                           const PostDelayedTaskTraits& traits,
+                           const webrtc::Location& location) override {
+    Add(now_ + delay, std::move(task), /*is_wakeup=*/true);
+  }
+
+ private:
+  struct Task {
+    Timestamp at;
+    uint64_t sequence_number;
+    bool is_wakeup;
+    absl::AnyInvocable<void() &&> task;
+  };
+
+  static bool Later(const Task& a, const Task& b) {
+    return a.at != b.at ? a.at > b.at : a.sequence_number > b.sequence_number;
+  }
+
+  void Add(Timestamp at, absl::AnyInvocable<void() &&> task, bool is_wakeup) {
+    tasks_.push_back({.at = at,
+                      .sequence_number = next_sequence_number_++,
+                      .is_wakeup = is_wakeup,
+                      .task = std::move(task)});
+    std::push_heap(tasks_.begin(), tasks_.end(), Later);
+  }
+
+  Timestamp now_ = Timestamp::Zero();
+  uint64_t next_sequence_number_ = 0;
+  int64_t wakeups_ = 0;
+  std::vector<Task> tasks_;
+};
+
+class Endpoint : public DcSctpSocketCallbacks {
+ public:
+  Endpoint(SimulatedTaskQueue& task_queue,
+           SharedTimeoutService* shared_timeout_service,
+           const DcSctpOptions& options,
+           int64_t& packets_sent)
+      : task_queue_(task_queue),
+        shared_timeout_service_(shared_timeout_service),
+        packets_sent_(packets_sent),
+        timeout_factory_(
+            task_queue_,
+            [this]() { return TimeMs(task_queue_.now().ms()); },
+            [this](TimeoutID timeout_id) {
+              socket_.HandleTimeout(timeout_id);
+            }),
+        socket_("", *this, /*packet_observer=*/nullptr, options) {}
+
+  void set_peer(Endpoint* peer) { peer_ = peer; }
+  void set_echo(bool echo) { echo_ = echo; }
+  DcSctpSocket& socket() { return socket_; }
+
+  SendPacketStatus SendPacketWithStatus(
+      rtc::ArrayView<const uint8_t> data) override {
+    ++packets_sent_;
+    task_queue_.RunAt(task_queue_.now() + kOneWayDelay,
+                      [peer = peer_,
+                       packet = std::vector<uint8_t>(data.begin(), data.end())] {
+                        peer->socket().ReceivePacket(packet);
+                      });
+    return SendPacketStatus::kSuccess;
+  }
+
+  std::unique_ptr<Timeout> CreateTimeout(
+      webrtc::TaskQueueBase::DelayPrecision precision) override {
+    if (shared_timeout_service_ != nullptr) {
+      return shared_timeout_service_->CreateTimeout(
+          [this](TimeoutID timeout_id) { socket_.HandleTimeout(timeout_id); });
+    }
+    return timeout_factory_.CreateTimeout(precision);
+  }
+
+  webrtc::Timestamp Now() override { return task_queue_.now(); }
+  TimeMs TimeMillis() override { return TimeMs(task_queue_.now().ms()); }
+  uint32_t GetRandomInt(uint32_t low, uint32_t high) override {
+    return random_.Rand(low, high);
+  }
+
+  void OnMessageReceived(DcSctpMessage message) override {
+    if (echo_) {
+      socket_.Send(std::move(message), {});
+    }
+  }
+  void OnError(ErrorKind error, absl::string_view message) override {}
+  void OnAborted(ErrorKind error, absl::string_view message) override {}
+  void OnConnected() override {}
+  void OnClosed() override {}
+  void OnConnectionRestarted() override {}
+  void OnStreamsResetFailed(rtc::ArrayView<const StreamID> outgoing_streams,
+                            absl::string_view reason) override {}
+  void OnStreamsResetPerformed(
+      rtc::ArrayView<const StreamID> outgoing_streams) override {}
+  void OnIncomingStreamsReset(
+      rtc::ArrayView<const StreamID> incoming_streams) override {}
+
+ private:
+  SimulatedTaskQueue& task_queue_;
+  SharedTimeoutService* const shared_timeout_service_;
+  int64_t& packets_sent_;
+  webrtc::Random random_{42};
+  Endpoint* peer_ = nullptr;
+  bool echo_ = false;
+  TaskQueueTimeoutFactory timeout_factory_;
+  DcSctpSocket socket_;
+};
+
+// The first argument selects if timers are shared between all sockets, and the
+// second if packets are coalesced and SACKs are sent less frequently.
+void BM_ManyAssociations(benchmark::State& state) {
+  const bool use_shared_timers = state.range(0) != 0;
+  const bool use_batching = state.range(1) != 0;
+
+  DcSctpOptions options;
+  if (use_batching) {
+    options.enable_packet_coalescing = true;
+    options.delayed_ack_max_packets = 4;
+  }
+
+  SimulatedTaskQueue task_queue;
+  std::unique_ptr<SharedTimeoutService> shared_timeout_service;
+  if (use_shared_timers) {
+    shared_timeout_service = std::make_unique<SharedTimeoutService>(
+        task_queue, [&]() { return TimeMs(task_queue.now().ms()); });
+  }
+
+  int64_t packets_sent = 0;
+  std::vector<std::unique_ptr<Endpoint>> clients;
+  std::vector<std::unique_ptr<Endpoint>> servers;
+  auto connect = [&](int count, TimeDelta duration) {
+    const size_t first = clients.size();
+    const int steps = duration / kStep;
+    for (int step = 0; step < steps; ++step) {
+      while (clients.size() < first + count * (step + 1) / steps) {
+        clients.push_back(std::make_unique<Endpoint>(
+            task_queue, shared_timeout_service.get(), options, packets_sent));
+        servers.push_back(std::make_unique<Endpoint>(
+            task_queue, shared_timeout_service.get(), options, packets_sent));
+        clients.back()->set_peer(servers.back().get());
+        servers.back()->set_peer(clients.back().get());
+        servers.back()->set_echo(true);
+        clients.back()->socket().Connect();
+      }
+      task_queue.RunUntil(task_queue.now() + kStep);
+    }
+  };
+  // Spread out the idle associations over the heartbeat interval, so that
+  // their heartbeats are spread out as well.
+  connect(kIdleAssociations, options.heartbeat_interval.ToTimeDelta());
+  connect(kActiveAssociations, TimeDelta::Seconds(1));
+
+  const Payload payload = std::vector<uint8_t>(kMessageSize);
+  const int steps_per_message = kMessageInterval / kStep;
+  int64_t steps = 0;
+  int64_t wakeups_before = task_queue.wakeups();
+  int64_t packets_before = packets_sent;
+  for (auto _ : state) {
+    for (int i = 0; i < TimeDelta::Seconds(1) / kStep; ++i, ++steps) {
+      for (int j = steps % steps_per_message; j < kActiveAssociations;
+           j += steps_per_message) {
+        for (int k = 0; k < kMessagesPerBurst; ++k) {
+          clients[kIdleAssociations + j]->socket().Send(
+              DcSctpMessage(StreamID(1), PPID(53), payload), {});
+        }
+      }
+      task_queue.RunUntil(task_queue.now() + kStep);
+    }
+  }
+
+  double seconds = (steps * kStep).seconds<double>();
+  state.counters["timer_wakeups_per_s"] =
+      (task_queue.wakeups() - wakeups_before) / seconds;
+  state.counters["packets_per_s"] = (packets_sent - packets_before) / seconds;
+
+  for (auto& endpoint : clients) {
+    RTC_CHECK(endpoint->socket().state() == SocketState::kConnected);
+  }
+  // Sockets must be destroyed before the timer service.
+  clients.clear();
+  servers.clear();
+}
+BENCHMARK(BM_ManyAssociations)
+    ->ArgNames({"shared_timers", "batching"})
+    ->Args({0, 0})
+    ->Args({1, 0})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace dcsctp
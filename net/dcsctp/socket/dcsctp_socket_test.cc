@@ -811,6 +811,26 @@ TEST(DcSctpSocketTest, SendMessageAfterEstablished) {
   EXPECT_EQ(msg->stream_id(), StreamID(1));
 }
 
+TEST(DcSctpSocketTest, CoalescesSackWithMessageSentFromCallback) {
+  DcSctpOptions options = {.enable_packet_coalescing = true};
+  SocketUnderTest a("A", options);
+  SocketUnderTest z("Z", options);
+
+  ConnectSockets(a, z);
+
+  EXPECT_CALL(z.cb, OnMessageReceived).WillOnce([&](DcSctpMessage message) {
+    z.socket.Send(DcSctpMessage(message.stream_id(), PPID(53), {3, 4}),
+                  kSendOptions);
+  });
+  a.socket.Send(DcSctpMessage(StreamID(1), PPID(53), {1, 2}), kSendOptions);
+  z.socket.ReceivePacket(a.cb.ConsumeSentPacket());
+
+  EXPECT_THAT(z.cb.ConsumeSentPacket(),
+              HasChunks(ElementsAre(IsChunkType(SackChunk::kType),
+                                    IsChunkType(DataChunk::kType))));
+  EXPECT_THAT(z.cb.ConsumeSentPacket(), IsEmpty());
+}
+
 TEST_P(DcSctpSocketParametrizedTest, TimeoutResendsPacket) {
   SocketUnderTest a("A");
   auto z = std::make_unique<SocketUnderTest>("Z");
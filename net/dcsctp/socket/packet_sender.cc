@@ -9,17 +9,75 @@
  */
 #include "net/dcsctp/socket/packet_sender.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
+#include "api/array_view.h"
+#include "net/dcsctp/common/math.h"
+#include "net/dcsctp/packet/bounded_byte_reader.h"
+#include "net/dcsctp/packet/bounded_byte_writer.h"
+#include "net/dcsctp/packet/chunk/abort_chunk.h"
+#include "net/dcsctp/packet/chunk/cookie_echo_chunk.h"
+#include "net/dcsctp/packet/chunk/init_ack_chunk.h"
+#include "net/dcsctp/packet/chunk/init_chunk.h"
+#include "net/dcsctp/packet/chunk/shutdown_complete_chunk.h"
+#include "net/dcsctp/packet/crc32c.h"
 #include "net/dcsctp/public/types.h"
 
 namespace dcsctp {
 
+namespace {
+// Chunks start after the common header, and have a type (1 byte), flags
+// (1 byte) and a length (2 bytes), not including any padding.
+constexpr size_t kChunkHeaderSize = 4;
+
+uint8_t FirstChunkType(rtc::ArrayView<const uint8_t> packet) {
+  return packet[SctpPacket::kHeaderSize];
+}
+}  // namespace
+
 PacketSender::PacketSender(DcSctpSocketCallbacks& callbacks,
                            std::function<void(rtc::ArrayView<const uint8_t>,
-                                              SendPacketStatus)> on_sent_packet)
-    : callbacks_(callbacks), on_sent_packet_(std::move(on_sent_packet)) {}
+                                              SendPacketStatus)> on_sent_packet,
+                           size_t max_coalesced_packet_size)
+    : callbacks_(callbacks),
+      max_coalesced_packet_size_(RoundDownTo4(max_coalesced_packet_size)),
+      on_sent_packet_(std::move(on_sent_packet)) {}
+
+bool PacketSender::CanBeCoalesced(rtc::ArrayView<const uint8_t> packet) {
+  // https://tools.ietf.org/html/rfc4960#section-6.10
+  // "An endpoint MUST NOT bundle INIT, INIT ACK, or SHUTDOWN COMPLETE with any
+  // other chunks." ABORT chunks are also sent by themselves, as they may not be
+  // bundled with DATA chunks, and are sometimes sent with a reflected tag.
+  size_t offset = SctpPacket::kHeaderSize;
+  while (offset + kChunkHeaderSize <= packet.size()) {
+    uint8_t type = packet[offset];
+    size_t length = (packet[offset + 2] << 8) | packet[offset + 3];
+    if (type == InitChunk::kType || type == InitAckChunk::kType ||
+        type == AbortChunk::kType || type == ShutdownCompleteChunk::kType ||
+        length < kChunkHeaderSize) {
+      return false;
+    }
+    offset += RoundUpTo4(length);
+  }
+  return true;
+}
+
+bool PacketSender::CanAppendToPending(rtc::ArrayView<const uint8_t> packet,
+                                      bool write_checksum) const {
+  // The ports and the verification tag in the common header must match.
+  constexpr size_t kChecksumOffset = 8;
+  return !pending_.empty() && write_checksum == pending_write_checksum_ &&
+         pending_.size() + packet.size() - SctpPacket::kHeaderSize <=
+             max_coalesced_packet_size_ &&
+         std::equal(packet.begin(), packet.begin() + kChecksumOffset,
+                    pending_.begin()) &&
+         // "The COOKIE ECHO chunk [...] MUST be the first chunk in the packet."
+         FirstChunkType(packet) != CookieEchoChunk::kType;
+}
 
 bool PacketSender::Send(SctpPacket::Builder& builder, bool write_checksum) {
   if (builder.empty()) {
@@ -27,7 +85,45 @@ bool PacketSender::Send(SctpPacket::Builder& builder, bool write_checksum) {
   }
 
   std::vector<uint8_t> payload = builder.Build(write_checksum);
+  if (batch_depth_ == 0 || max_coalesced_packet_size_ == 0) {
+    return SendNow(std::move(payload));
+  }
+
+  if (!CanBeCoalesced(payload)) {
+    Flush();
+    return SendNow(std::move(payload));
+  }
+  if (CanAppendToPending(payload, write_checksum)) {
+    size_t offset = pending_.size();
+    pending_.insert(pending_.end(), payload.begin() + SctpPacket::kHeaderSize,
+                    payload.end());
+    if (write_checksum) {
+      // The checksum of the pending packet is extended with the appended
+      // chunks, while they are still in the cache.
+      uint32_t crc =
+          BoundedByteReader<SctpPacket::kHeaderSize>(pending_).Load32<8>();
+      crc = ExtendCrc32C(
+          crc, rtc::ArrayView<const uint8_t>(pending_).subview(offset));
+      BoundedByteWriter<SctpPacket::kHeaderSize>(pending_).Store32<8>(crc);
+    }
+    return true;
+  }
+  Flush();
+  pending_ = std::move(payload);
+  pending_write_checksum_ = write_checksum;
+  return true;
+}
+
+void PacketSender::Flush() {
+  if (pending_.empty()) {
+    return;
+  }
+  std::vector<uint8_t> payload;
+  payload.swap(pending_);
+  SendNow(std::move(payload));
+}
 
+bool PacketSender::SendNow(std::vector<uint8_t> payload) {
   SendPacketStatus status = callbacks_.SendPacketWithStatus(payload);
   on_sent_packet_(payload, status);
   switch (status) {
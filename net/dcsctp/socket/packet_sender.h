@@ -10,6 +10,12 @@
 #ifndef NET_DCSCTP_SOCKET_PACKET_SENDER_H_
 #define NET_DCSCTP_SOCKET_PACKET_SENDER_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "api/array_view.h"
 #include "net/dcsctp/packet/sctp_packet.h"
 #include "net/dcsctp/public/dcsctp_socket.h"
 
@@ -18,17 +24,57 @@ namespace dcsctp {
 // The PacketSender sends packets to the network using the provided callback
 // interface. When an attempt to send a packet is made, the `on_sent_packet`
 // callback will be triggered.
+//
+// If `max_coalesced_packet_size` is non-zero, packets that are sent while a
+// `ScopedBatch` is alive are coalesced: the chunks of consecutive packets are
+// merged into as few packets as possible, each at most that size, which are
+// sent when the outermost batch goes out of scope.
 class PacketSender {
  public:
+  // Defers sending packets until the outermost batch is destroyed.
+  class ScopedBatch {
+   public:
+    explicit ScopedBatch(PacketSender& sender) : sender_(sender) {
+      ++sender_.batch_depth_;
+    }
+    ScopedBatch(const ScopedBatch&) = delete;
+    ScopedBatch& operator=(const ScopedBatch&) = delete;
+
+    ~ScopedBatch() {
+      if (--sender_.batch_depth_ == 0) {
+        sender_.Flush();
+      }
+    }
+
+   private:
+    PacketSender& sender_;
+  };
+
   PacketSender(DcSctpSocketCallbacks& callbacks,
                std::function<void(rtc::ArrayView<const uint8_t>,
-                                  SendPacketStatus)> on_sent_packet);
+                                  SendPacketStatus)> on_sent_packet,
+               size_t max_coalesced_packet_size = 0);
 
-  // Sends the packet, and returns true if it was sent successfully.
+  // Sends the packet, and returns true if it was sent successfully. If the
+  // packet is coalesced with other packets, it's sent later, and this method
+  // returns true.
   bool Send(SctpPacket::Builder& builder, bool write_checksum = true);
 
  private:
+  // Indicates if the chunks in `packet` may be bundled with other chunks.
+  static bool CanBeCoalesced(rtc::ArrayView<const uint8_t> packet);
+  bool CanAppendToPending(rtc::ArrayView<const uint8_t> packet,
+                          bool write_checksum) const;
+  bool SendNow(std::vector<uint8_t> payload);
+  void Flush();
+
   DcSctpSocketCallbacks& callbacks_;
+  const size_t max_coalesced_packet_size_;
+  int batch_depth_ = 0;
+  // The packet that is being coalesced, or empty. If it has a checksum, it's
+  // kept up to date as chunks are appended.
+  std::vector<uint8_t> pending_;
+  bool pending_write_checksum_ = true;
 
   // Callback that will be triggered for every send attempt, indicating the
   // status of the operation.
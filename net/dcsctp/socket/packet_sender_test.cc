@@ -9,8 +9,15 @@
  */
 #include "net/dcsctp/socket/packet_sender.h"
 
+#include <cstdint>
+#include <vector>
+
 #include "net/dcsctp/common/internal_types.h"
+#include "net/dcsctp/packet/chunk/abort_chunk.h"
 #include "net/dcsctp/packet/chunk/cookie_ack_chunk.h"
+#include "net/dcsctp/packet/chunk/data_chunk.h"
+#include "net/dcsctp/packet/chunk/sack_chunk.h"
+#include "net/dcsctp/packet/parameter/parameter.h"
 #include "net/dcsctp/socket/mock_dcsctp_socket_callbacks.h"
 #include "rtc_base/gunit.h"
 #include "test/gmock.h"
@@ -18,8 +25,23 @@
 namespace dcsctp {
 namespace {
 using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::SizeIs;
 
 constexpr VerificationTag kVerificationTag(123);
+constexpr size_t kMtu = 1000;
+
+std::vector<uint8_t> ChunkTypes(rtc::ArrayView<const uint8_t> data) {
+  std::optional<SctpPacket> packet = SctpPacket::Parse(data, DcSctpOptions());
+  std::vector<uint8_t> types;
+  if (packet.has_value()) {
+    for (const SctpPacket::ChunkDescriptor& descriptor :
+         packet->descriptors()) {
+      types.push_back(descriptor.type);
+    }
+  }
+  return types;
+}
 
 class PacketSenderTest : public testing::Test {
  protected:
@@ -46,5 +68,118 @@ TEST_F(PacketSenderTest, SendPacketCallsCallback) {
   EXPECT_FALSE(sender_.Send(PacketBuilder().Add(CookieAckChunk())));
 }
 
+class PacketSenderCoalescingTest : public testing::Test {
+ protected:
+  PacketSenderCoalescingTest()
+      : sender_(callbacks_, on_send_fn_.AsStdFunction(), kMtu) {
+    options_.mtu = kMtu;
+    ON_CALL(callbacks_, SendPacketWithStatus)
+        .WillByDefault([this](rtc::ArrayView<const uint8_t> data) {
+          sent_packets_.emplace_back(data.begin(), data.end());
+          return SendPacketStatus::kSuccess;
+        });
+  }
+
+  SctpPacket::Builder PacketBuilder(
+      VerificationTag tag = kVerificationTag) const {
+    return SctpPacket::Builder(tag, options_);
+  }
+
+  DataChunk MakeDataChunk(uint32_t tsn, size_t size) const {
+    return DataChunk(TSN(tsn), StreamID(1), SSN(0), PPID(53),
+                     std::vector<uint8_t>(size), DataChunk::Options());
+  }
+
+  DcSctpOptions options_;
+  testing::NiceMock<MockDcSctpSocketCallbacks> callbacks_;
+  testing::NiceMock<
+      testing::MockFunction<void(rtc::ArrayView<const uint8_t>,
+                                 SendPacketStatus)>>
+      on_send_fn_;
+  PacketSender sender_;
+  std::vector<std::vector<uint8_t>> sent_packets_;
+};
+
+TEST_F(PacketSenderCoalescingTest, SendsDirectlyOutsideOfBatch) {
+  EXPECT_TRUE(sender_.Send(PacketBuilder().Add(CookieAckChunk())));
+  EXPECT_TRUE(sender_.Send(PacketBuilder().Add(CookieAckChunk())));
+  EXPECT_THAT(sent_packets_, SizeIs(2));
+}
+
+TEST_F(PacketSenderCoalescingTest, CoalescesPacketsInBatch) {
+  {
+    PacketSender::ScopedBatch batch(sender_);
+    EXPECT_TRUE(sender_.Send(PacketBuilder().Add(SackChunk(
+        TSN(10), 1000, /*gap_ack_blocks=*/{}, /*duplicate_tsns=*/{}))));
+    {
+      PacketSender::ScopedBatch nested_batch(sender_);
+      EXPECT_TRUE(sender_.Send(PacketBuilder().Add(MakeDataChunk(1, 100))));
+    }
+    EXPECT_TRUE(sender_.Send(PacketBuilder().Add(MakeDataChunk(2, 100))));
+    EXPECT_THAT(sent_packets_, SizeIs(0));
+  }
+
+  ASSERT_THAT(sent_packets_, SizeIs(1));
+  EXPECT_THAT(
+      ChunkTypes(sent_packets_[0]),
+      ElementsAre(SackChunk::kType, DataChunk::kType, DataChunk::kType));
+}
+
+TEST_F(PacketSenderCoalescingTest, StartsNewPacketWhenExceedingMtu) {
+  {
+    PacketSender::ScopedBatch batch(sender_);
+    for (uint32_t tsn = 1; tsn <= 5; ++tsn) {
+      EXPECT_TRUE(sender_.Send(PacketBuilder().Add(MakeDataChunk(tsn, 400))));
+    }
+  }
+
+  ASSERT_THAT(sent_packets_, SizeIs(3));
+  EXPECT_THAT(ChunkTypes(sent_packets_[0]), SizeIs(2));
+  EXPECT_THAT(ChunkTypes(sent_packets_[1]), SizeIs(2));
+  EXPECT_THAT(ChunkTypes(sent_packets_[2]), SizeIs(1));
+  for (const auto& packet : sent_packets_) {
+    EXPECT_LE(packet.size(), kMtu);
+  }
+}
+
+TEST_F(PacketSenderCoalescingTest, DoesNotCoalescePacketsWithDifferentTags) {
+  {
+    PacketSender::ScopedBatch batch(sender_);
+    EXPECT_TRUE(sender_.Send(PacketBuilder().Add(CookieAckChunk())));
+    EXPECT_TRUE(sender_.Send(
+        PacketBuilder(VerificationTag(456)).Add(CookieAckChunk())));
+  }
+
+  EXPECT_THAT(sent_packets_, SizeIs(2));
+}
+
+TEST_F(PacketSenderCoalescingTest, SendsAbortAlone) {
+  {
+    PacketSender::ScopedBatch batch(sender_);
+    EXPECT_TRUE(sender_.Send(PacketBuilder().Add(MakeDataChunk(1, 100))));
+    EXPECT_TRUE(sender_.Send(PacketBuilder().Add(
+        AbortChunk(/*filled_in_verification_tag=*/true,
+                   Parameters::Builder().Build()))));
+    EXPECT_THAT(sent_packets_, SizeIs(2));
+    EXPECT_TRUE(sender_.Send(PacketBuilder().Add(MakeDataChunk(2, 100))));
+  }
+
+  ASSERT_THAT(sent_packets_, SizeIs(3));
+  EXPECT_THAT(ChunkTypes(sent_packets_[0]), ElementsAre(DataChunk::kType));
+  EXPECT_THAT(ChunkTypes(sent_packets_[1]), ElementsAre(AbortChunk::kType));
+  EXPECT_THAT(ChunkTypes(sent_packets_[2]), ElementsAre(DataChunk::kType));
+}
+
+TEST_F(PacketSenderCoalescingTest, ReportsCoalescedPacketWhenSent) {
+  EXPECT_CALL(on_send_fn_, Call(_, SendPacketStatus::kSuccess)).Times(0);
+  {
+    PacketSender::ScopedBatch batch(sender_);
+    sender_.Send(PacketBuilder().Add(CookieAckChunk()));
+    sender_.Send(PacketBuilder().Add(CookieAckChunk()));
+    testing::Mock::VerifyAndClearExpectations(&on_send_fn_);
+    EXPECT_CALL(on_send_fn_, Call(_, SendPacketStatus::kSuccess)).Times(1);
+  }
+}
+
 }  // namespace
 }  // namespace dcsctp
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "api/units/time_delta.h"
+#include "net/dcsctp/common/math.h"
 #include "net/dcsctp/packet/chunk/data_chunk.h"
 #include "net/dcsctp/packet/chunk/forward_tsn_chunk.h"
 #include "net/dcsctp/packet/chunk/idata_chunk.h"
@@ -88,7 +89,10 @@ TransmissionControlBlock::TransmissionControlBlock(
       packet_sender_(packet_sender),
       rto_(options),
       tx_error_counter_(log_prefix, options),
-      data_tracker_(log_prefix, delayed_ack_timer_.get(), peer_initial_tsn),
+      data_tracker_(log_prefix,
+                    delayed_ack_timer_.get(),
+                    peer_initial_tsn,
+                    options.delayed_ack_max_packets),
       reassembly_queue_(log_prefix,
                         options.max_receiver_window_buffer_size,
                         capabilities.message_interleaving),
@@ -210,6 +214,8 @@ void TransmissionControlBlock::MaybeSendFastRetransmit() {
 void TransmissionControlBlock::SendBufferedPackets(SctpPacket::Builder& builder,
                                                    Timestamp now) {
   for (int packet_idx = 0; packet_idx < options_.max_burst; ++packet_idx) {
+    // If a delayed SACK can be bundled in this packet.
+    bool bundle_delayed_sack = false;
     // Only add control chunks to the first packet that is sent, if sending
     // multiple packets in one go (as allowed by the congestion window).
     if (packet_idx == 0) {
@@ -227,9 +233,14 @@ void TransmissionControlBlock::SendBufferedPackets(SctpPacket::Builder& builder,
       // sender should create a SACK and bundle it with the outbound DATA chunk,
       // as long as the size of the final SCTP packet does not exceed the
       // current MTU."
-      if (data_tracker_.ShouldSendAck(/*also_if_delayed=*/true)) {
+      //
+      // A delayed SACK is only sent if there are other chunks to bundle it
+      // with, as it would otherwise not be delayed at all.
+      if (data_tracker_.ShouldSendAck(/*also_if_delayed=*/false)) {
         builder.Add(data_tracker_.CreateSelectiveAck(
             reassembly_queue_.remaining_bytes()));
+      } else {
+        bundle_delayed_sack = data_tracker_.is_ack_delayed();
       }
       MaybeSendForwardTsn(builder, now);
       std::optional<ReConfigChunk> reconfig =
@@ -239,8 +250,18 @@ void TransmissionControlBlock::SendBufferedPackets(SctpPacket::Builder& builder,
       }
     }
 
-    auto chunks =
-        retransmission_queue_.GetChunksToSend(now, builder.bytes_remaining());
+    size_t bytes_remaining = builder.bytes_remaining();
+    if (bundle_delayed_sack) {
+      bytes_remaining -= std::min(
+          bytes_remaining, RoundUpTo4(data_tracker_.selective_ack_size()));
+    }
+    auto chunks = retransmission_queue_.GetChunksToSend(now, bytes_remaining);
+
+    if (bundle_delayed_sack && (!chunks.empty() || !builder.empty()) &&
+        data_tracker_.ShouldSendAck(/*also_if_delayed=*/true)) {
+      builder.Add(data_tracker_.CreateSelectiveAck(
+          reassembly_queue_.remaining_bytes()));
+    }
 
     if (!chunks.empty()) {
       // https://datatracker.ietf.org/doc/html/rfc9260#section-8.3
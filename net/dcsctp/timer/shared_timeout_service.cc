@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "net/dcsctp/timer/shared_timeout_service.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "api/task_queue/pending_task_safety_flag.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace dcsctp {
+
+class SharedTimeoutService::SharedTimeout : public Timeout {
+ public:
+  SharedTimeout(SharedTimeoutService& parent,
+                std::function<void(TimeoutID)> on_expired)
+      : parent_(parent),
+        on_expired_(std::move(on_expired)),
+        slot_(parent_.AllocateSlot(this)) {}
+
+  ~SharedTimeout() override {
+    RTC_DCHECK_RUN_ON(&parent_.thread_checker_);
+    Stop();
+    parent_.ReleaseSlot(slot_);
+  }
+
+  void Start(DurationMs duration, TimeoutID timeout_id) override {
+    RTC_DCHECK_RUN_ON(&parent_.thread_checker_);
+    RTC_DCHECK(!expiry_tick_.has_value());
+    // Round up, to never expire early.
+    int64_t expiry_ms = *parent_.get_time_() + *duration;
+    expiry_tick_ = (expiry_ms + parent_.resolution_ms_ - 1) /
+                   parent_.resolution_ms_;
+    timeout_id_ = timeout_id;
+    ++parent_.running_timeouts_;
+
+    if (scheduled_tick_.has_value() && *scheduled_tick_ <= *expiry_tick_) {
+      // The timeout is already in a bucket that is handled sooner than the new
+      // expiration time. When that bucket is handled, the timeout will be moved
+      // to the right bucket, unless it's stopped before that, which most
+      // timeouts are.
+      return;
+    }
+    scheduled_tick_ = expiry_tick_;
+    parent_.Schedule(slot_, *scheduled_tick_);
+  }
+
+  void Stop() override {
+    RTC_DCHECK_RUN_ON(&parent_.thread_checker_);
+    // The timeout is left in its bucket, and will be ignored when handled.
+    if (expiry_tick_.has_value()) {
+      expiry_tick_ = std::nullopt;
+      --parent_.running_timeouts_;
+    }
+  }
+
+  // Called when the bucket that this timeout was scheduled in is handled.
+  void OnBucketExpired(int64_t now_tick) {
+    scheduled_tick_ = std::nullopt;
+    if (!expiry_tick_.has_value()) {
+      // The timeout was stopped before it expired. Very common.
+      return;
+    }
+    if (*expiry_tick_ > now_tick) {
+      // The timeout was restarted with a later expiration time.
+      scheduled_tick_ = expiry_tick_;
+      parent_.Schedule(slot_, *scheduled_tick_);
+      return;
+    }
+    expiry_tick_ = std::nullopt;
+    --parent_.running_timeouts_;
+    RTC_DLOG(LS_VERBOSE) << "Timeout triggered: " << timeout_id_.value();
+    on_expired_(timeout_id_);
+  }
+
+ private:
+  SharedTimeoutService& parent_;
+  const std::function<void(TimeoutID)> on_expired_;
+  const uint32_t slot_;
+  // The tick when the timeout expires, if it's running.
+  std::optional<int64_t> expiry_tick_;
+  // The tick of the bucket in which this timeout currently has a valid entry.
+  std::optional<int64_t> scheduled_tick_;
+  TimeoutID timeout_id_ = TimeoutID(0);
+};
+
+SharedTimeoutService::SharedTimeoutService(webrtc::TaskQueueBase& task_queue,
+                                           std::function<TimeMs()> get_time,
+                                           webrtc::TimeDelta resolution)
+    : task_queue_(task_queue),
+      get_time_(std::move(get_time)),
+      resolution_ms_(std::max<int64_t>(resolution.ms(), 1)) {
+  thread_checker_.Detach();
+}
+
+SharedTimeoutService::~SharedTimeoutService() {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  RTC_DCHECK_EQ(slots_.size(), free_slots_.size())
+      << "All timeouts must be destroyed before the service";
+}
+
+std::unique_ptr<Timeout> SharedTimeoutService::CreateTimeout(
+    std::function<void(TimeoutID timeout_id)> on_expired) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  return std::make_unique<SharedTimeout>(*this, std::move(on_expired));
+}
+
+int64_t SharedTimeoutService::NowTick() const {
+  return *get_time_() / resolution_ms_;
+}
+
+uint32_t SharedTimeoutService::AllocateSlot(SharedTimeout* timeout) {
+  if (free_slots_.empty()) {
+    slots_.push_back({.timeout = timeout});
+    return slots_.size() - 1;
+  }
+  uint32_t slot = free_slots_.back();
+  free_slots_.pop_back();
+  slots_[slot].timeout = timeout;
+  return slot;
+}
+
+void SharedTimeoutService::ReleaseSlot(uint32_t slot) {
+  // Bumping the generation invalidates any entries in the buckets.
+  ++slots_[slot].generation;
+  slots_[slot].timeout = nullptr;
+  free_slots_.push_back(slot);
+}
+
+void SharedTimeoutService::Schedule(uint32_t slot, int64_t tick) {
+  // Any previous entry of this timeout, which must be in a later bucket, is
+  // invalidated by bumping the generation.
+  uint32_t generation = ++slots_[slot].generation;
+  buckets_[tick].push_back({.slot = slot, .generation = generation});
+  if (!posted_tick_.has_value() || tick < *posted_tick_) {
+    // If there already is a posted task, it's for a later bucket and will not
+    // do anything but to post a new task, if needed, when it runs. This is
+    // not expected to happen often, as most timeouts have similar durations.
+    PostTask(tick);
+  }
+}
+
+void SharedTimeoutService::PostTask(int64_t tick) {
+  posted_tick_ = tick;
+  int64_t delay_ms = std::max<int64_t>(tick * resolution_ms_ - *get_time_(), 0);
+  task_queue_.PostDelayedTaskWithPrecision(
+      webrtc::TaskQueueBase::DelayPrecision::kLow,
+      webrtc::SafeTask(safety_.flag(), [this, tick]() { OnTask(tick); }),
+      webrtc::TimeDelta::Millis(delay_ms));
+}
+
+void SharedTimeoutService::OnTask(int64_t tick) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  if (posted_tick_ == tick) {
+    posted_tick_ = std::nullopt;
+  }
+
+  int64_t now_tick = NowTick();
+  while (!buckets_.empty() && buckets_.begin()->first <= now_tick) {
+    // The bucket is extracted, as expired timeouts may add entries to the
+    // buckets when they are restarted.
+    auto bucket = buckets_.extract(buckets_.begin());
+    for (const Entry& entry : bucket.mapped()) {
+      // Note that `slots_` may be modified by the expired timeouts, so the
+      // slot is looked up for every entry.
+      const Slot& slot = slots_[entry.slot];
+      if (slot.generation == entry.generation && slot.timeout != nullptr) {
+        slot.timeout->OnBucketExpired(now_tick);
+      }
+    }
+  }
+
+  if (!buckets_.empty() &&
+      (!posted_tick_.has_value() || buckets_.begin()->first < *posted_tick_)) {
+    PostTask(buckets_.begin()->first);
+  }
+}
+
+}  // namespace dcsctp
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef NET_DCSCTP_TIMER_SHARED_TIMEOUT_SERVICE_H_
+#define NET_DCSCTP_TIMER_SHARED_TIMEOUT_SERVICE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "api/sequence_checker.h"
+#include "api/task_queue/pending_task_safety_flag.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "net/dcsctp/public/timeout.h"
+#include "net/dcsctp/public/types.h"
+#include "rtc_base/system/no_unique_address.h"
+
+namespace dcsctp {
+
+// The SharedTimeoutService creates `Timeout` instances for many sockets, which
+// all share a single posted delayed task on the provided `task_queue`.
+//
+// Compared to `TaskQueueTimeoutFactory`, which posts a delayed task per
+// timeout, this reduces the number of posted tasks and wakeups when there are
+// many associations, as timeouts are rounded up to the next multiple of
+// `resolution`, and all timeouts that expire at the same tick are handled in a
+// single task. Timeouts will never expire early, but they may expire up to
+// `resolution` late, regardless of their requested precision.
+//
+// Every timeout has its own `on_expired` callback, so the service can be
+// shared by sockets that use overlapping `TimeoutID`s.
+//
+// This class must outlive any created Timeout that it has created. This class,
+// and the timeouts created by it, are not thread safe. It may be created on
+// any thread, but must then only be used and destroyed on `task_queue`.
+class SharedTimeoutService {
+ public:
+  static constexpr webrtc::TimeDelta kDefaultResolution =
+      webrtc::TimeDelta::Millis(10);
+
+  // The `get_time` function must return the current time, relative to any
+  // epoch.
+  SharedTimeoutService(
+      webrtc::TaskQueueBase& task_queue,
+      std::function<TimeMs()> get_time,
+      webrtc::TimeDelta resolution = kDefaultResolution);
+  ~SharedTimeoutService();
+
+  // Creates an implementation of `Timeout`. Whenever it expires, `on_expired`
+  // will be triggered, and then the client should provide the `timeout_id` to
+  // `DcSctpSocketInterface::HandleTimeout`.
+  std::unique_ptr<Timeout> CreateTimeout(
+      std::function<void(TimeoutID timeout_id)> on_expired);
+
+  // Returns the number of running timeouts.
+  size_t running_timeouts() const { return running_timeouts_; }
+
+ private:
+  class SharedTimeout;
+
+  // References a timeout in a bucket. The entry is stale if the timeout has
+  // since been destroyed or re-scheduled to an earlier tick.
+  struct Entry {
+    uint32_t slot;
+    uint32_t generation;
+  };
+
+  struct Slot {
+    SharedTimeout* timeout = nullptr;
+    uint32_t generation = 0;
+  };
+
+  int64_t NowTick() const;
+  uint32_t AllocateSlot(SharedTimeout* timeout);
+  void ReleaseSlot(uint32_t slot);
+  // Adds the timeout in `slot` to the bucket of `tick`, and ensures that there
+  // is a posted task that will handle that bucket.
+  void Schedule(uint32_t slot, int64_t tick);
+  void PostTask(int64_t tick);
+  void OnTask(int64_t tick);
+
+  RTC_NO_UNIQUE_ADDRESS webrtc::SequenceChecker thread_checker_;
+  webrtc::TaskQueueBase& task_queue_;
+  const std::function<TimeMs()> get_time_;
+  const int64_t resolution_ms_;
+
+  size_t running_timeouts_ = 0;
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> free_slots_;
+  // Timeouts to handle, by the tick when they expire.
+  std::map<int64_t, std::vector<Entry>> buckets_;
+  // The earliest tick for which a task has been posted.
+  std::optional<int64_t> posted_tick_;
+  webrtc::ScopedTaskSafetyDetached safety_;
+};
+}  // namespace dcsctp
+
+#endif  // NET_DCSCTP_TIMER_SHARED_TIMEOUT_SERVICE_H_
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "net/dcsctp/timer/shared_timeout_service.h"
+
+#include <memory>
+#include <vector>
+
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/gunit.h"
+#include "test/gmock.h"
+#include "test/time_controller/simulated_time_controller.h"
+
+namespace dcsctp {
+namespace {
+using ::testing::MockFunction;
+using ::webrtc::TimeDelta;
+
+class CountingTaskQueue : public webrtc::TaskQueueBase {
+ public:
+  explicit CountingTaskQueue(webrtc::TaskQueueBase& task_queue)
+      : task_queue_(task_queue) {}
+
+  void Delete() override {}
+  void PostTaskImpl(absl::AnyInvocable<void() &&> task,
+                    const PostTaskTraits& traits,
+                    const webrtc::Location& location) override {
+    task_queue_.PostTask(std::move(task));
+  }
+  void PostDelayedTaskImpl(absl::AnyInvocable<void() &&> task,
+                           TimeDelta delay,
+                           const PostDelayedTaskTraits& traits,
+                           const webrtc::Location& location) override {
+    ++delayed_tasks_;
+    task_queue_.PostDelayedTask(std::move(task), delay);
+  }
+
+  int delayed_tasks() const { return delayed_tasks_; }
+
+ private:
+  webrtc::TaskQueueBase& task_queue_;
+  int delayed_tasks_ = 0;
+};
+
+class SharedTimeoutServiceTest : public testing::Test {
+ protected:
+  SharedTimeoutServiceTest()
+      : time_controller_(webrtc::Timestamp::Millis(1234)),
+        task_queue_(*time_controller_.GetMainThread()),
+        service_(
+            task_queue_,
+            [this]() {
+              return TimeMs(time_controller_.GetClock()->CurrentTime().ms());
+            },
+            TimeDelta::Millis(10)) {}
+
+  void AdvanceTime(DurationMs duration) {
+    time_controller_.AdvanceTime(TimeDelta::Millis(*duration));
+  }
+
+  webrtc::GlobalSimulatedTimeController time_controller_;
+  CountingTaskQueue task_queue_;
+  SharedTimeoutService service_;
+};
+
+TEST_F(SharedTimeoutServiceTest, ExpiresRoundedUpToResolution) {
+  MockFunction<void(TimeoutID)> on_expired;
+  std::unique_ptr<Timeout> timeout =
+      service_.CreateTimeout(on_expired.AsStdFunction());
+  timeout->Start(DurationMs(1000), TimeoutID(1));
+  EXPECT_EQ(service_.running_timeouts(), 1u);
+
+  // The timeout expires at 2234 ms, which is rounded up to 2240 ms.
+  EXPECT_CALL(on_expired, Call).Times(0);
+  AdvanceTime(DurationMs(1005));
+
+  EXPECT_CALL(on_expired, Call(TimeoutID(1)));
+  AdvanceTime(DurationMs(1));
+  EXPECT_EQ(service_.running_timeouts(), 0u);
+  timeout->Stop();
+}
+
+TEST_F(SharedTimeoutServiceTest, StopBeforeExpiringDoesntTrigger) {
+  MockFunction<void(TimeoutID)> on_expired;
+  std::unique_ptr<Timeout> timeout =
+      service_.CreateTimeout(on_expired.AsStdFunction());
+  timeout->Start(DurationMs(1000), TimeoutID(1));
+
+  EXPECT_CALL(on_expired, Call).Times(0);
+  AdvanceTime(DurationMs(999));
+  timeout->Stop();
+  EXPECT_EQ(service_.running_timeouts(), 0u);
+
+  AdvanceTime(DurationMs(1000));
+}
+
+TEST_F(SharedTimeoutServiceTest, RestartProlongingTimeoutDuration) {
+  MockFunction<void(TimeoutID)> on_expired;
+  std::unique_ptr<Timeout> timeout =
+      service_.CreateTimeout(on_expired.AsStdFunction());
+  timeout->Start(DurationMs(1000), TimeoutID(1));
+
+  EXPECT_CALL(on_expired, Call).Times(0);
+  AdvanceTime(DurationMs(500));
+  timeout->Restart(DurationMs(1000), TimeoutID(2));
+  AdvanceTime(DurationMs(999));
+
+  EXPECT_CALL(on_expired, Call(TimeoutID(2)));
+  AdvanceTime(DurationMs(10));
+  timeout->Stop();
+}
+
+TEST_F(SharedTimeoutServiceTest, RestartShortenedTimeoutDuration) {
+  MockFunction<void(TimeoutID)> on_expired;
+  std::unique_ptr<Timeout> timeout =
+      service_.CreateTimeout(on_expired.AsStdFunction());
+  timeout->Start(DurationMs(1000), TimeoutID(1));
+
+  AdvanceTime(DurationMs(100));
+  timeout->Restart(DurationMs(200), TimeoutID(2));
+
+  EXPECT_CALL(on_expired, Call).Times(0);
+  AdvanceTime(DurationMs(199));
+  EXPECT_CALL(on_expired, Call(TimeoutID(2)));
+  AdvanceTime(DurationMs(10));
+
+  // The stale entry of the first start doesn't trigger it again.
+  EXPECT_CALL(on_expired, Call).Times(0);
+  AdvanceTime(DurationMs(1000));
+  timeout->Stop();
+}
+
+TEST_F(SharedTimeoutServiceTest, DeletedTimeoutDoesntTrigger) {
+  MockFunction<void(TimeoutID)> on_expired;
+  std::unique_ptr<Timeout> timeout =
+      service_.CreateTimeout(on_expired.AsStdFunction());
+  timeout->Start(DurationMs(100), TimeoutID(1));
+  timeout->Stop();
+  timeout = nullptr;
+
+  // Reusing the slot of the deleted timeout.
+  MockFunction<void(TimeoutID)> on_expired2;
+  std::unique_ptr<Timeout> timeout2 =
+      service_.CreateTimeout(on_expired2.AsStdFunction());
+  timeout2->Start(DurationMs(200), TimeoutID(2));
+
+  EXPECT_CALL(on_expired, Call).Times(0);
+  EXPECT_CALL(on_expired2, Call).Times(0);
+  AdvanceTime(DurationMs(150));
+  EXPECT_CALL(on_expired2, Call(TimeoutID(2)));
+  AdvanceTime(DurationMs(60));
+  timeout2->Stop();
+}
+
+TEST_F(SharedTimeoutServiceTest, CanRestartTimeoutWhenExpiring) {
+  std::unique_ptr<Timeout> timeout;
+  int expirations = 0;
+  timeout = service_.CreateTimeout([&](TimeoutID timeout_id) {
+    ++expirations;
+    timeout->Start(DurationMs(100), TimeoutID(*timeout_id + 1));
+  });
+  timeout->Start(DurationMs(100), TimeoutID(1));
+
+  AdvanceTime(DurationMs(1010));
+  EXPECT_EQ(expirations, 10);
+  timeout->Stop();
+}
+
+TEST_F(SharedTimeoutServiceTest, HandlesManyTimeoutsWithFewTasks) {
+  constexpr int kTimeouts = 1000;
+  int expirations = 0;
+  std::vector<std::unique_ptr<Timeout>> timeouts;
+  for (int i = 0; i < kTimeouts; ++i) {
+    timeouts.push_back(
+        service_.CreateTimeout([&](TimeoutID) { ++expirations; }));
+    // Spread out over 100 ms, which is about ten ticks.
+    timeouts.back()->Start(DurationMs(1000 + i % 100), TimeoutID(i));
+  }
+  EXPECT_EQ(task_queue_.delayed_tasks(), 1);
+
+  AdvanceTime(DurationMs(1200));
+  EXPECT_EQ(expirations, kTimeouts);
+  EXPECT_LE(task_queue_.delayed_tasks(), 12);
+  for (auto& timeout : timeouts) {
+    timeout->Stop();
+  }
+}
+
+TEST_F(SharedTimeoutServiceTest, TimeoutsWithSameIdsAreSeparated) {
+  MockFunction<void(TimeoutID)> on_expired1;
+  MockFunction<void(TimeoutID)> on_expired2;
+  std::unique_ptr<Timeout> timeout1 =
+      service_.CreateTimeout(on_expired1.AsStdFunction());
+  std::unique_ptr<Timeout> timeout2 =
+      service_.CreateTimeout(on_expired2.AsStdFunction());
+  timeout1->Start(DurationMs(100), TimeoutID(1));
+  timeout2->Start(DurationMs(300), TimeoutID(1));
+
+  EXPECT_CALL(on_expired1, Call(TimeoutID(1)));
+  EXPECT_CALL(on_expired2, Call).Times(0);
+  AdvanceTime(DurationMs(200));
+
+  EXPECT_CALL(on_expired2, Call(TimeoutID(1)));
+  AdvanceTime(DurationMs(200));
+  timeout1->Stop();
+  timeout2->Stop();
+}
+
+}  // namespace
+}  // namespace dcsctp
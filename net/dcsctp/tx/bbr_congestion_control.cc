@@ -0,0 +1,281 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "net/dcsctp/tx/bbr_congestion_control.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+
+#include "absl/strings/string_view.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "net/dcsctp/public/dcsctp_handover_state.h"
+#include "net/dcsctp/public/dcsctp_options.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace dcsctp {
+namespace {
+using ::webrtc::DataRate;
+using ::webrtc::DataSize;
+using ::webrtc::TimeDelta;
+using ::webrtc::Timestamp;
+
+// Gain used in startup, to double the amount of data sent every round.
+constexpr double kStartupGain = 2.885;
+// Gain used in drain, to drain the queue created in startup within a round.
+constexpr double kDrainGain = 1.0 / kStartupGain;
+// Gains used in ProbeBW, cycling over one round each, which probes for more
+// bandwidth, and then drains the queue that it may have created.
+constexpr double kProbeBandwidthGains[] = {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+constexpr int kProbeBandwidthCycleLength = std::size(kProbeBandwidthGains);
+// As the congestion window is the only limit on the sending rate, and as the
+// peer may delay its SACKs, allow this many MTUs in-flight above the BDP to
+// keep the pipe full.
+constexpr size_t kExtraCwndMtus = 4;
+
+// Number of rounds that the bandwidth estimate is the maximum of.
+constexpr uint64_t kBandwidthFilterRounds = 10;
+// The bandwidth must grow by this factor within `kFullPipeRounds` rounds in
+// startup, or the pipe is considered full.
+constexpr double kFullPipeBandwidthGrowth = 1.25;
+constexpr int kFullPipeRounds = 3;
+
+// The minimum RTT is refreshed by entering ProbeRTT if it hasn't been measured
+// for this long.
+constexpr TimeDelta kMinRttWindow = TimeDelta::Seconds(10);
+constexpr TimeDelta kProbeRttDuration = TimeDelta::Millis(200);
+
+absl::string_view ToString(BbrCongestionControl::Mode mode) {
+  switch (mode) {
+    case BbrCongestionControl::Mode::kStartup:
+      return "STARTUP";
+    case BbrCongestionControl::Mode::kDrain:
+      return "DRAIN";
+    case BbrCongestionControl::Mode::kProbeBandwidth:
+      return "PROBE_BW";
+    case BbrCongestionControl::Mode::kProbeRtt:
+      return "PROBE_RTT";
+  }
+  RTC_CHECK_NOTREACHED();
+}
+}  // namespace
+
+BbrCongestionControl::BbrCongestionControl(absl::string_view log_prefix,
+                                           const DcSctpOptions& options)
+    : log_prefix_(log_prefix),
+      mtu_(options.mtu),
+      min_cwnd_(options.cwnd_mtus_min * options.mtu),
+      cwnd_(options.cwnd_mtus_initial * options.mtu) {}
+
+DataRate BbrCongestionControl::bandwidth_estimate() const {
+  return bandwidth_samples_.empty() ? DataRate::Zero()
+                                    : bandwidth_samples_.front().bandwidth;
+}
+
+std::optional<size_t> BbrCongestionControl::TargetCwnd(double gain) const {
+  if (bandwidth_samples_.empty() || min_rtt_.IsInfinite()) {
+    return std::nullopt;
+  }
+  DataSize bdp = bandwidth_estimate() * min_rtt_;
+  return std::max(
+      static_cast<size_t>(gain * bdp.bytes()) + kExtraCwndMtus * mtu_,
+      min_cwnd_);
+}
+
+void BbrCongestionControl::OnSack(const SackInfo& sack) {
+  delivered_ += sack.bytes_acked;
+  // Allow some margin for classifying as fully utilized, as the congestion
+  // window can rarely be entirely filled.
+  if (sack.unacked_bytes_before + mtu_ >= cwnd_) {
+    round_is_cwnd_limited_ = true;
+  }
+
+  bool round_ended = UpdateRound(sack);
+  UpdateMode(sack, round_ended);
+  UpdateCwnd(sack);
+}
+
+bool BbrCongestionControl::UpdateRound(const SackInfo& sack) {
+  if (round_end_tsn_.has_value() && sack.highest_tsn_acked < *round_end_tsn_) {
+    return false;
+  }
+
+  bool round_ended = round_end_tsn_.has_value();
+  if (round_ended) {
+    ++round_count_;
+    TimeDelta duration = sack.now - round_start_time_;
+    if (duration > TimeDelta::Zero()) {
+      DataRate bandwidth =
+          DataSize::Bytes(delivered_ - round_start_delivered_) / duration;
+      // Rounds where the application didn't send enough data to fill the
+      // congestion window underestimate the bandwidth, so only use those if
+      // they show that there is more bandwidth.
+      if (round_is_cwnd_limited_ || bandwidth > bandwidth_estimate()) {
+        UpdateBandwidthEstimate(bandwidth);
+      }
+    }
+    CheckIfPipeIsFilled();
+  }
+  round_end_tsn_ = sack.highest_outstanding_tsn;
+  round_start_time_ = sack.now;
+  round_start_delivered_ = delivered_;
+  round_is_cwnd_limited_ = false;
+  return round_ended;
+}
+
+void BbrCongestionControl::UpdateBandwidthEstimate(DataRate bandwidth) {
+  while (!bandwidth_samples_.empty() &&
+         bandwidth_samples_.front().round + kBandwidthFilterRounds <=
+             round_count_) {
+    bandwidth_samples_.pop_front();
+  }
+  while (!bandwidth_samples_.empty() &&
+         bandwidth_samples_.back().bandwidth <= bandwidth) {
+    bandwidth_samples_.pop_back();
+  }
+  bandwidth_samples_.push_back({.round = round_count_, .bandwidth = bandwidth});
+}
+
+void BbrCongestionControl::CheckIfPipeIsFilled() {
+  if (is_pipe_filled_ || !round_is_cwnd_limited_) {
+    return;
+  }
+  if (bandwidth_estimate() >= full_bandwidth_ * kFullPipeBandwidthGrowth) {
+    full_bandwidth_ = bandwidth_estimate();
+    rounds_without_bandwidth_growth_ = 0;
+    return;
+  }
+  if (++rounds_without_bandwidth_growth_ >= kFullPipeRounds) {
+    is_pipe_filled_ = true;
+  }
+}
+
+void BbrCongestionControl::EnterMode(Mode mode) {
+  RTC_DLOG(LS_VERBOSE) << log_prefix_ << "BBR mode " << ToString(mode_)
+                       << " -> " << ToString(mode)
+                       << ", bw=" << ToString(bandwidth_estimate())
+                       << ", min_rtt=" << ToString(min_rtt_)
+                       << ", cwnd=" << cwnd_;
+  mode_ = mode;
+}
+
+void BbrCongestionControl::UpdateMode(const SackInfo& sack, bool round_ended) {
+  if (mode_ == Mode::kStartup && is_pipe_filled_) {
+    EnterMode(Mode::kDrain);
+  }
+  if (mode_ == Mode::kDrain) {
+    std::optional<size_t> bdp = TargetCwnd(1.0);
+    if (bdp.has_value() && sack.unacked_bytes <= *bdp) {
+      EnterMode(Mode::kProbeBandwidth);
+      // Don't start the cycle by probing for more bandwidth, nor by draining
+      // more.
+      cycle_index_ = 2;
+    }
+  } else if (mode_ == Mode::kProbeBandwidth && round_ended) {
+    cycle_index_ = (cycle_index_ + 1) % kProbeBandwidthCycleLength;
+  }
+
+  min_rtt_expired_ |= sack.now > min_rtt_timestamp_ + kMinRttWindow;
+  if (mode_ != Mode::kProbeRtt && min_rtt_expired_ && min_rtt_.IsFinite()) {
+    EnterMode(Mode::kProbeRtt);
+    prior_cwnd_ = std::max(prior_cwnd_, cwnd_);
+    probe_rtt_done_ = std::nullopt;
+  }
+  min_rtt_expired_ = false;
+
+  if (mode_ == Mode::kProbeRtt) {
+    if (!probe_rtt_done_.has_value()) {
+      if (sack.unacked_bytes <= min_cwnd_) {
+        probe_rtt_done_ = sack.now + kProbeRttDuration;
+      }
+    } else if (sack.now >= *probe_rtt_done_) {
+      min_rtt_timestamp_ = sack.now;
+      cwnd_ = std::max(cwnd_, prior_cwnd_);
+      prior_cwnd_ = 0;
+      probe_rtt_done_ = std::nullopt;
+      EnterMode(is_pipe_filled_ ? Mode::kProbeBandwidth : Mode::kStartup);
+    }
+  }
+}
+
+void BbrCongestionControl::UpdateCwnd(const SackInfo& sack) {
+  if (mode_ == Mode::kProbeRtt) {
+    cwnd_ = std::min(cwnd_, min_cwnd_);
+    return;
+  }
+
+  std::optional<size_t> target;
+  switch (mode_) {
+    case Mode::kStartup:
+      target = TargetCwnd(kStartupGain);
+      break;
+    case Mode::kDrain:
+      target = TargetCwnd(kDrainGain);
+      break;
+    case Mode::kProbeBandwidth:
+      target = TargetCwnd(kProbeBandwidthGains[cycle_index_]);
+      break;
+    case Mode::kProbeRtt:
+      break;
+  }
+
+  // After a retransmission timeout, grow quickly back to the congestion window
+  // that was used before. The acknowledged bytes are only accounted once.
+  if (prior_cwnd_ > 0) {
+    cwnd_ = std::min(cwnd_ + sack.bytes_acked, prior_cwnd_);
+    if (cwnd_ == prior_cwnd_) {
+      prior_cwnd_ = 0;
+    }
+  } else if (is_pipe_filled_ && target.has_value()) {
+    cwnd_ = std::min(cwnd_ + sack.bytes_acked, *target);
+  } else if (!target.has_value() || cwnd_ < *target) {
+    // Like in slow start, only grow the congestion window when it's fully used.
+    if (sack.unacked_bytes_before + mtu_ >= cwnd_) {
+      cwnd_ += sack.bytes_acked;
+    }
+  }
+  cwnd_ = std::max(cwnd_, min_cwnd_);
+}
+
+void BbrCongestionControl::OnRttMeasured(Timestamp now, TimeDelta rtt) {
+  min_rtt_expired_ =
+      min_rtt_.IsFinite() && now > min_rtt_timestamp_ + kMinRttWindow;
+  if (rtt <= min_rtt_ || min_rtt_expired_) {
+    min_rtt_ = rtt;
+    min_rtt_timestamp_ = now;
+  }
+}
+
+void BbrCongestionControl::OnRetransmissionTimeout() {
+  // https://tools.ietf.org/html/rfc4960#section-6.3.3
+  // "For the destination address for which the timer expires, [...] set the
+  // cwnd <- MTU."
+  prior_cwnd_ = std::max(prior_cwnd_, cwnd_);
+  cwnd_ = mtu_;
+  RTC_DLOG(LS_VERBOSE) << log_prefix_ << "t3-rtx expired. new cwnd=" << cwnd_
+                       << " (" << prior_cwnd_ << ")";
+}
+
+void BbrCongestionControl::AddHandoverState(
+    DcSctpSocketHandoverState& state) const {
+  state.tx.cwnd = cwnd_;
+}
+
+void BbrCongestionControl::RestoreFromState(
+    const DcSctpSocketHandoverState& state) {
+  cwnd_ = state.tx.cwnd;
+}
+
+}  // namespace dcsctp
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef NET_DCSCTP_TX_BBR_CONGESTION_CONTROL_H_
+#define NET_DCSCTP_TX_BBR_CONGESTION_CONTROL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+#include "absl/strings/string_view.h"
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "net/dcsctp/common/sequence_numbers.h"
+#include "net/dcsctp/public/dcsctp_handover_state.h"
+#include "net/dcsctp/public/dcsctp_options.h"
+#include "net/dcsctp/tx/congestion_control.h"
+
+namespace dcsctp {
+
+// A model-based congestion control algorithm inspired by BBR, see
+// https://datatracker.ietf.org/doc/html/draft-cardwell-iccrg-bbr-congestion-control
+//
+// It estimates the bottleneck bandwidth, as the maximum delivery rate measured
+// over the last rounds, and the minimum round-trip time, and sizes the
+// congestion window to the bandwidth-delay product (BDP) of the path. Unlike
+// loss-based algorithms, it doesn't reduce the congestion window on isolated
+// packet loss, which allows keeping up the throughput on lossy paths and on
+// paths with a high BDP.
+//
+// As SCTP doesn't pace outgoing packets, the gains that BBR applies to its
+// pacing rate are applied to the congestion window instead.
+class BbrCongestionControl : public CongestionControl {
+ public:
+  enum class Mode {
+    // Exponentially grows the congestion window until the bottleneck bandwidth
+    // has been found.
+    kStartup,
+    // Drains the queue that was created during startup.
+    kDrain,
+    // Uses the estimated BDP, while periodically probing for more bandwidth.
+    kProbeBandwidth,
+    // Shrinks the congestion window to let queues drain, to measure the
+    // minimum round-trip time.
+    kProbeRtt,
+  };
+
+  BbrCongestionControl(absl::string_view log_prefix,
+                       const DcSctpOptions& options);
+
+  size_t cwnd() const override { return cwnd_; }
+  void set_cwnd(size_t cwnd) override { cwnd_ = cwnd; }
+
+  void OnSack(const SackInfo& sack) override;
+  void OnRttMeasured(webrtc::Timestamp now, webrtc::TimeDelta rtt) override;
+  void OnRetransmissionTimeout() override;
+
+  void AddHandoverState(DcSctpSocketHandoverState& state) const override;
+  void RestoreFromState(const DcSctpSocketHandoverState& state) override;
+
+  Mode mode() const { return mode_; }
+
+  // Returns the estimated bottleneck bandwidth, which is zero until the first
+  // round has completed.
+  webrtc::DataRate bandwidth_estimate() const;
+
+  // Returns the minimum round-trip time, which is infinite until measured.
+  webrtc::TimeDelta min_rtt() const { return min_rtt_; }
+
+ private:
+  struct BandwidthSample {
+    uint64_t round;
+    webrtc::DataRate bandwidth;
+  };
+
+  // Updates the round trip counting, and the bandwidth estimate when a round
+  // has ended. Returns true if a round has ended.
+  bool UpdateRound(const SackInfo& sack);
+  void UpdateBandwidthEstimate(webrtc::DataRate bandwidth);
+  void CheckIfPipeIsFilled();
+  void UpdateMode(const SackInfo& sack, bool round_ended);
+  void EnterMode(Mode mode);
+  void UpdateCwnd(const SackInfo& sack);
+
+  // Returns the congestion window to use, given `gain` applied to the BDP, or
+  // std::nullopt if the BDP isn't known yet.
+  std::optional<size_t> TargetCwnd(double gain) const;
+
+  const absl::string_view log_prefix_;
+  const size_t mtu_;
+  const size_t min_cwnd_;
+
+  Mode mode_ = Mode::kStartup;
+  size_t cwnd_;
+  // The congestion window before entering ProbeRTT or before a retransmission
+  // timeout, which is restored afterwards.
+  size_t prior_cwnd_ = 0;
+
+  // Total number of bytes acked.
+  uint64_t delivered_ = 0;
+  // A round ends when a chunk that was sent after the round started is acked.
+  std::optional<UnwrappedTSN> round_end_tsn_;
+  uint64_t round_count_ = 0;
+  webrtc::Timestamp round_start_time_ = webrtc::Timestamp::Zero();
+  uint64_t round_start_delivered_ = 0;
+  // If the amount of data in-flight was limited by the congestion window during
+  // the round, and not by the application sending too little data.
+  bool round_is_cwnd_limited_ = false;
+
+  // Windowed maximum of the bandwidth samples, with decreasing bandwidths.
+  std::deque<BandwidthSample> bandwidth_samples_;
+
+  // The bandwidth which, when it doesn't grow significantly anymore in
+  // startup, is considered to fill the pipe.
+  webrtc::DataRate full_bandwidth_ = webrtc::DataRate::Zero();
+  int rounds_without_bandwidth_growth_ = 0;
+  bool is_pipe_filled_ = false;
+
+  webrtc::TimeDelta min_rtt_ = webrtc::TimeDelta::PlusInfinity();
+  webrtc::Timestamp min_rtt_timestamp_ = webrtc::Timestamp::MinusInfinity();
+  bool min_rtt_expired_ = false;
+  // When ProbeRTT can be exited, once the congestion window has been reduced.
+  std::optional<webrtc::Timestamp> probe_rtt_done_;
+
+  // Index in the gain cycle of the ProbeBW mode.
+  int cycle_index_ = 0;
+};
+}  // namespace dcsctp
+
+#endif  // NET_DCSCTP_TX_BBR_CONGESTION_CONTROL_H_
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "net/dcsctp/tx/bbr_congestion_control.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "net/dcsctp/common/sequence_numbers.h"
+#include "net/dcsctp/public/dcsctp_handover_state.h"
+#include "net/dcsctp/public/dcsctp_options.h"
+#include "net/dcsctp/public/types.h"
+#include "rtc_base/gunit.h"
+#include "test/gmock.h"
+
+namespace dcsctp {
+namespace {
+using ::testing::AllOf;
+using ::testing::Ge;
+using ::testing::Le;
+using ::webrtc::DataRate;
+using ::webrtc::DataSize;
+using ::webrtc::TimeDelta;
+using ::webrtc::Timestamp;
+using Mode = ::dcsctp::BbrCongestionControl::Mode;
+
+constexpr size_t kMtu = 1000;
+constexpr DataRate kLinkRate = DataRate::KilobitsPerSec(8000);
+constexpr TimeDelta kBaseRtt = TimeDelta::Millis(100);
+constexpr size_t kBdp = 100'000;
+constexpr TimeDelta kSackInterval = TimeDelta::Millis(10);
+
+DcSctpOptions MakeOptions() {
+  DcSctpOptions options;
+  options.mtu = kMtu;
+  return options;
+}
+
+// The TSN of the chunk carrying the byte at offset `bytes` of the stream.
+UnwrappedTSN ToTsn(uint64_t bytes) {
+  return UnwrappedTSN::AddTo(UnwrappedTSN::Unwrapper().Unwrap(TSN(1)),
+                             bytes / kMtu);
+}
+
+// A fluid model of a path with a single bottleneck link, where the sender
+// always has data to send, and fills up the congestion window. Every
+// `kSackInterval`, a SACK acknowledges the data that was delivered.
+class SimulatedPath {
+ public:
+  explicit SimulatedPath(BbrCongestionControl& cc) : cc_(cc) {}
+
+  void RunFor(TimeDelta duration, bool lose_packets = false) {
+    Timestamp end = now_ + duration;
+    while (now_ < end) {
+      now_ += kSackInterval;
+      size_t in_flight = cc_.cwnd();
+      // When the window is smaller than the BDP, the link isn't fully used.
+      size_t max_delivered =
+          (kLinkRate * kSackInterval).bytes() * in_flight / kBdp;
+      size_t delivered =
+          std::min({in_flight, max_delivered,
+                    static_cast<size_t>((kLinkRate * kSackInterval).bytes())});
+      TimeDelta queuing_delay =
+          DataSize::Bytes(in_flight > kBdp ? in_flight - kBdp : 0) / kLinkRate;
+      cc_.OnRttMeasured(now_, kBaseRtt + queuing_delay);
+
+      delivered_ += delivered;
+      cc_.OnSack({
+          .now = now_,
+          .bytes_acked = delivered,
+          .unacked_bytes_before = in_flight,
+          .unacked_bytes = in_flight - delivered,
+          .cumulative_tsn_ack_advanced = !lose_packets,
+          .highest_tsn_acked = ToTsn(delivered_),
+          .highest_outstanding_tsn = ToTsn(delivered_ + in_flight - delivered),
+          .has_packet_loss = lose_packets,
+          .is_in_fast_recovery = lose_packets,
+      });
+    }
+  }
+
+  uint64_t delivered() const { return delivered_; }
+  DataRate delivery_rate() const {
+    return DataSize::Bytes(delivered_) / (now_ - Timestamp::Zero());
+  }
+
+ private:
+  BbrCongestionControl& cc_;
+  Timestamp now_ = Timestamp::Zero();
+  uint64_t delivered_ = 0;
+};
+
+TEST(BbrCongestionControlTest, StartsInStartupWithInitialCwnd) {
+  DcSctpOptions options = MakeOptions();
+  BbrCongestionControl cc("", options);
+
+  EXPECT_EQ(cc.mode(), Mode::kStartup);
+  EXPECT_EQ(cc.cwnd(), options.cwnd_mtus_initial * kMtu);
+  EXPECT_EQ(cc.bandwidth_estimate(), DataRate::Zero());
+  EXPECT_TRUE(cc.min_rtt().IsPlusInfinity());
+}
+
+TEST(BbrCongestionControlTest, ConvergesToBandwidthDelayProduct) {
+  BbrCongestionControl cc("", MakeOptions());
+  SimulatedPath path(cc);
+
+  path.RunFor(TimeDelta::Seconds(5));
+
+  EXPECT_EQ(cc.mode(), Mode::kProbeBandwidth);
+  EXPECT_EQ(cc.min_rtt(), kBaseRtt);
+  EXPECT_THAT(cc.bandwidth_estimate().bps(),
+              AllOf(Ge(kLinkRate.bps() * 9 / 10), Le(kLinkRate.bps())));
+  EXPECT_THAT(cc.cwnd(), AllOf(Ge(kBdp * 3 / 4), Le(kBdp * 3 / 2)));
+  EXPECT_GE(path.delivery_rate().bps(), kLinkRate.bps() * 3 / 4);
+}
+
+TEST(BbrCongestionControlTest, ProbesRttPeriodically) {
+  BbrCongestionControl cc("", MakeOptions());
+  SimulatedPath path(cc);
+  path.RunFor(TimeDelta::Seconds(5));
+  ASSERT_EQ(cc.mode(), Mode::kProbeBandwidth);
+
+  // With the congestion window above the BDP, the minimum RTT isn't measured
+  // again, so it will eventually be probed for.
+  cc.set_cwnd(2 * kBdp);
+  bool has_probed_rtt = false;
+  for (int i = 0; i < 1200 && !has_probed_rtt; ++i) {
+    path.RunFor(kSackInterval);
+    cc.set_cwnd(std::max(cc.cwnd(), 2 * kBdp));
+    has_probed_rtt = cc.mode() == Mode::kProbeRtt;
+  }
+  EXPECT_TRUE(has_probed_rtt);
+}
+
+TEST(BbrCongestionControlTest, DoesNotReduceCwndOnPacketLoss) {
+  BbrCongestionControl cc("", MakeOptions());
+  SimulatedPath path(cc);
+  path.RunFor(TimeDelta::Seconds(5));
+  size_t cwnd = cc.cwnd();
+
+  path.RunFor(TimeDelta::Seconds(1), /*lose_packets=*/true);
+
+  EXPECT_GE(cc.cwnd(), cwnd * 3 / 4);
+}
+
+TEST(BbrCongestionControlTest, RecoversQuicklyFromRetransmissionTimeout) {
+  BbrCongestionControl cc("", MakeOptions());
+  SimulatedPath path(cc);
+  path.RunFor(TimeDelta::Seconds(5));
+  size_t cwnd = cc.cwnd();
+
+  cc.OnRetransmissionTimeout();
+  EXPECT_EQ(cc.cwnd(), kMtu);
+
+  path.RunFor(TimeDelta::Seconds(1));
+  EXPECT_GE(cc.cwnd(), cwnd * 3 / 4);
+}
+
+TEST(BbrCongestionControlTest, GrowsOncePerSackAfterRetransmissionTimeout) {
+  BbrCongestionControl cc("", MakeOptions());
+  SimulatedPath path(cc);
+  path.RunFor(TimeDelta::Seconds(5));
+
+  cc.OnRetransmissionTimeout();
+  ASSERT_EQ(cc.cwnd(), kMtu);
+
+  cc.OnSack({
+      .now = Timestamp::Seconds(5) + kSackInterval,
+      .bytes_acked = 10 * kMtu,
+      .unacked_bytes_before = 10 * kMtu,
+      .unacked_bytes = 0,
+      .cumulative_tsn_ack_advanced = true,
+      .highest_tsn_acked = ToTsn(path.delivered() + 10 * kMtu),
+      .highest_outstanding_tsn = ToTsn(path.delivered() + 10 * kMtu),
+  });
+  EXPECT_EQ(cc.cwnd(), 11 * kMtu);
+}
+
+TEST(BbrCongestionControlTest, CanHandoverCwnd) {
+  BbrCongestionControl cc("", MakeOptions());
+  SimulatedPath path(cc);
+  path.RunFor(TimeDelta::Seconds(5));
+
+  DcSctpSocketHandoverState state;
+  cc.AddHandoverState(state);
+  BbrCongestionControl cc2("", MakeOptions());
+  cc2.RestoreFromState(state);
+
+  EXPECT_EQ(cc2.cwnd(), cc.cwnd());
+}
+
+}  // namespace
+}  // namespace dcsctp
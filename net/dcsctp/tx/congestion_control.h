@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef NET_DCSCTP_TX_CONGESTION_CONTROL_H_
+#define NET_DCSCTP_TX_CONGESTION_CONTROL_H_
+
+#include <cstddef>
+
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "net/dcsctp/common/sequence_numbers.h"
+#include "net/dcsctp/public/dcsctp_handover_state.h"
+
+namespace dcsctp {
+
+// A congestion control algorithm, which limits the amount of data that may be
+// in-flight (sent, but not yet acknowledged) by providing the congestion window
+// (cwnd).
+//
+// The RetransmissionQueue keeps track of the outstanding data and of fast
+// recovery, and informs the algorithm about acknowledged data, packet loss and
+// retransmission timeouts.
+class CongestionControl {
+ public:
+  // Describes an incoming SACK, after the outstanding data has been updated.
+  struct SackInfo {
+    webrtc::Timestamp now = webrtc::Timestamp::Zero();
+    // Number of bytes newly acked by the cumulative TSN ack and gap ack blocks.
+    size_t bytes_acked = 0;
+    // Number of bytes in-flight before and after the SACK was processed.
+    size_t unacked_bytes_before = 0;
+    size_t unacked_bytes = 0;
+    // If the cumulative TSN ack point was advanced by the SACK.
+    bool cumulative_tsn_ack_advanced = false;
+    // Highest TSN newly acknowledged by the SACK, an SCTP variable.
+    UnwrappedTSN highest_tsn_acked;
+    // Highest TSN that has been sent.
+    UnwrappedTSN highest_outstanding_tsn;
+    // If the SACK indicates that packet loss has occurred.
+    bool has_packet_loss = false;
+    // If the sender was in fast recovery, before `has_packet_loss` is handled.
+    // Packet loss reported when not in fast recovery makes the sender enter
+    // fast recovery.
+    bool is_in_fast_recovery = false;
+  };
+
+  virtual ~CongestionControl() = default;
+
+  // Returns the size of the congestion window, in bytes.
+  virtual size_t cwnd() const = 0;
+
+  // Overrides the current congestion window size.
+  virtual void set_cwnd(size_t cwnd) = 0;
+
+  // Called for every SACK that has been processed.
+  virtual void OnSack(const SackInfo& sack) = 0;
+
+  // Called when the round-trip time has been measured.
+  virtual void OnRttMeasured(webrtc::Timestamp now, webrtc::TimeDelta rtt) = 0;
+
+  // Called when the retransmission timer, T3-rtx, has expired.
+  virtual void OnRetransmissionTimeout() = 0;
+
+  virtual void AddHandoverState(DcSctpSocketHandoverState& state) const = 0;
+  virtual void RestoreFromState(const DcSctpSocketHandoverState& state) = 0;
+};
+
+}  // namespace dcsctp
+
+#endif  // NET_DCSCTP_TX_CONGESTION_CONTROL_H_
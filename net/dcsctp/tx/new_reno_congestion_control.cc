@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "net/dcsctp/tx/new_reno_congestion_control.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+#include "net/dcsctp/public/dcsctp_handover_state.h"
+#include "net/dcsctp/public/dcsctp_options.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace dcsctp {
+
+NewRenoCongestionControl::NewRenoCongestionControl(
+    absl::string_view log_prefix,
+    const DcSctpOptions& options,
+    size_t a_rwnd)
+    : log_prefix_(log_prefix),
+      mtu_(options.mtu),
+      min_cwnd_(options.cwnd_mtus_min * options.mtu),
+      cwnd_(options.cwnd_mtus_initial * options.mtu),
+      // https://tools.ietf.org/html/rfc4960#section-7.2.1
+      // "The initial value of ssthresh MAY be arbitrarily high (for
+      // example, implementations MAY use the size of the receiver advertised
+      // window).""
+      ssthresh_(a_rwnd) {}
+
+void NewRenoCongestionControl::OnSack(const SackInfo& sack) {
+  if (sack.cumulative_tsn_ack_advanced) {
+    HandleIncreasedCumulativeTsnAck(sack.unacked_bytes_before, sack.bytes_acked,
+                                    sack.is_in_fast_recovery);
+  }
+  if (sack.has_packet_loss) {
+    HandlePacketLoss(sack.is_in_fast_recovery);
+  }
+}
+
+void NewRenoCongestionControl::HandleIncreasedCumulativeTsnAck(
+    size_t unacked_bytes,
+    size_t total_bytes_acked,
+    bool is_in_fast_recovery) {
+  // Allow some margin for classifying as fully utilized, due to e.g. that too
+  // small packets (less than kMinimumFragmentedPayload) are not sent +
+  // overhead.
+  bool is_fully_utilized = unacked_bytes + mtu_ >= cwnd_;
+  size_t old_cwnd = cwnd_;
+  if (phase() == CongestionAlgorithmPhase::kSlowStart) {
+    if (is_fully_utilized && !is_in_fast_recovery) {
+      // https://tools.ietf.org/html/rfc4960#section-7.2.1
+      // "Only when these three conditions are met can the cwnd be
+      // increased; otherwise, the cwnd MUST not be increased. If these
+      // conditions are met, then cwnd MUST be increased by, at most, the
+      // lesser of 1) the total size of the previously outstanding DATA
+      // chunk(s) acknowledged, and 2) the destination's path MTU."
+      cwnd_ += std::min(total_bytes_acked, mtu_);
+      RTC_DLOG(LS_VERBOSE) << log_prefix_ << "SS increase cwnd=" << cwnd_
+                           << " (" << old_cwnd << ")";
+    }
+  } else if (phase() == CongestionAlgorithmPhase::kCongestionAvoidance) {
+    // https://tools.ietf.org/html/rfc4960#section-7.2.2
+    // "Whenever cwnd is greater than ssthresh, upon each SACK arrival
+    // that advances the Cumulative TSN Ack Point, increase
+    // partial_bytes_acked by the total number of bytes of all new chunks
+    // acknowledged in that SACK including chunks acknowledged by the new
+    // Cumulative TSN Ack and by Gap Ack Blocks."
+    size_t old_pba = partial_bytes_acked_;
+    partial_bytes_acked_ += total_bytes_acked;
+
+    if (partial_bytes_acked_ >= cwnd_ && is_fully_utilized) {
+      // https://tools.ietf.org/html/rfc4960#section-7.2.2
+      // "When partial_bytes_acked is equal to or greater than cwnd and
+      // before the arrival of the SACK the sender had cwnd or more bytes of
+      // data outstanding (i.e., before arrival of the SACK, flightsize was
+      // greater than or equal to cwnd), increase cwnd by MTU, and reset
+      // partial_bytes_acked to (partial_bytes_acked - cwnd)."
+
+      // Errata: https://datatracker.ietf.org/doc/html/rfc8540#section-3.12
+      partial_bytes_acked_ -= cwnd_;
+      cwnd_ += mtu_;
+      RTC_DLOG(LS_VERBOSE) << log_prefix_ << "CA increase cwnd=" << cwnd_
+                           << " (" << old_cwnd << ") ssthresh=" << ssthresh_
+                           << ", pba=" << partial_bytes_acked_ << " ("
+                           << old_pba << ")";
+    } else {
+      RTC_DLOG(LS_VERBOSE) << log_prefix_ << "CA unchanged cwnd=" << cwnd_
+                           << " (" << old_cwnd << ") ssthresh=" << ssthresh_
+                           << ", pba=" << partial_bytes_acked_ << " ("
+                           << old_pba << ")";
+    }
+  }
+}
+
+void NewRenoCongestionControl::HandlePacketLoss(bool is_in_fast_recovery) {
+  if (!is_in_fast_recovery) {
+    // https://tools.ietf.org/html/rfc4960#section-7.2.4
+    // "If not in Fast Recovery, adjust the ssthresh and cwnd of the
+    // destination address(es) to which the missing DATA chunks were last
+    // sent, according to the formula described in Section 7.2.3."
+    size_t old_cwnd = cwnd_;
+    size_t old_pba = partial_bytes_acked_;
+    ssthresh_ = std::max(cwnd_ / 2, min_cwnd_);
+    cwnd_ = ssthresh_;
+    partial_bytes_acked_ = 0;
+
+    RTC_DLOG(LS_VERBOSE) << log_prefix_
+                         << "packet loss detected (not fast recovery). cwnd="
+                         << cwnd_ << " (" << old_cwnd
+                         << "), ssthresh=" << ssthresh_
+                         << ", pba=" << partial_bytes_acked_ << " (" << old_pba
+                         << ")";
+  } else {
+    // https://tools.ietf.org/html/rfc4960#section-7.2.4
+    // "While in Fast Recovery, the ssthresh and cwnd SHOULD NOT change for
+    // any destinations due to a subsequent Fast Recovery event (i.e., one
+    // SHOULD NOT reduce the cwnd further due to a subsequent Fast Retransmit)."
+    RTC_DLOG(LS_VERBOSE) << log_prefix_
+                         << "packet loss detected (fast recovery). No changes.";
+  }
+}
+
+void NewRenoCongestionControl::OnRetransmissionTimeout() {
+  size_t old_cwnd = cwnd_;
+  // https://tools.ietf.org/html/rfc4960#section-6.3.3
+  // "For the destination address for which the timer expires, adjust
+  // its ssthresh with rules defined in Section 7.2.3 and set the cwnd <- MTU."
+  ssthresh_ = std::max(cwnd_ / 2, 4 * mtu_);
+  cwnd_ = 1 * mtu_;
+  // Errata: https://datatracker.ietf.org/doc/html/rfc8540#section-3.11
+  partial_bytes_acked_ = 0;
+
+  RTC_DLOG(LS_VERBOSE) << log_prefix_ << "t3-rtx expired. new cwnd=" << cwnd_
+                       << " (" << old_cwnd << "), ssthresh=" << ssthresh_;
+}
+
+void NewRenoCongestionControl::AddHandoverState(
+    DcSctpSocketHandoverState& state) const {
+  state.tx.cwnd = cwnd_;
+  state.tx.ssthresh = ssthresh_;
+  state.tx.partial_bytes_acked = partial_bytes_acked_;
+}
+
+void NewRenoCongestionControl::RestoreFromState(
+    const DcSctpSocketHandoverState& state) {
+  // Validate that the component is in pristine state.
+  RTC_DCHECK(partial_bytes_acked_ == 0);
+
+  cwnd_ = state.tx.cwnd;
+  ssthresh_ = state.tx.ssthresh;
+  partial_bytes_acked_ = state.tx.partial_bytes_acked;
+}
+
+}  // namespace dcsctp
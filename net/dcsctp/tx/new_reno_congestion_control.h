@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef NET_DCSCTP_TX_NEW_RENO_CONGESTION_CONTROL_H_
+#define NET_DCSCTP_TX_NEW_RENO_CONGESTION_CONTROL_H_
+
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "net/dcsctp/public/dcsctp_handover_state.h"
+#include "net/dcsctp/public/dcsctp_options.h"
+#include "net/dcsctp/tx/congestion_control.h"
+
+namespace dcsctp {
+
+// The congestion control algorithm described in
+// https://tools.ietf.org/html/rfc4960#section-7.2, where the congestion window
+// grows in the "slow start" and "congestion avoidance" phases, and is halved
+// when packet loss is detected.
+class NewRenoCongestionControl : public CongestionControl {
+ public:
+  NewRenoCongestionControl(absl::string_view log_prefix,
+                           const DcSctpOptions& options,
+                           size_t a_rwnd);
+
+  size_t cwnd() const override { return cwnd_; }
+  void set_cwnd(size_t cwnd) override { cwnd_ = cwnd; }
+
+  void OnSack(const SackInfo& sack) override;
+  void OnRttMeasured(webrtc::Timestamp /* now */,
+                     webrtc::TimeDelta /* rtt */) override {}
+  void OnRetransmissionTimeout() override;
+
+  void AddHandoverState(DcSctpSocketHandoverState& state) const override;
+  void RestoreFromState(const DcSctpSocketHandoverState& state) override;
+
+ private:
+  enum class CongestionAlgorithmPhase {
+    kSlowStart,
+    kCongestionAvoidance,
+  };
+
+  // Returns the current congestion control algorithm phase.
+  CongestionAlgorithmPhase phase() const {
+    return (cwnd_ <= ssthresh_)
+               ? CongestionAlgorithmPhase::kSlowStart
+               : CongestionAlgorithmPhase::kCongestionAvoidance;
+  }
+
+  // Update the congestion control algorithm given as the cumulative ack TSN
+  // value has increased, as reported in an incoming SACK chunk.
+  void HandleIncreasedCumulativeTsnAck(size_t unacked_bytes,
+                                       size_t total_bytes_acked,
+                                       bool is_in_fast_recovery);
+  // Update the congestion control algorithm, given as packet loss has been
+  // detected, as reported in an incoming SACK chunk.
+  void HandlePacketLoss(bool is_in_fast_recovery);
+
+  const absl::string_view log_prefix_;
+  const size_t mtu_;
+  const size_t min_cwnd_;
+
+  // Congestion Window. Number of bytes that may be in-flight (sent, not acked).
+  size_t cwnd_;
+  // Slow Start Threshold. See RFC4960.
+  size_t ssthresh_;
+  // Partial Bytes Acked. See RFC4960.
+  size_t partial_bytes_acked_ = 0;
+};
+}  // namespace dcsctp
+
+#endif  // NET_DCSCTP_TX_NEW_RENO_CONGESTION_CONTROL_H_
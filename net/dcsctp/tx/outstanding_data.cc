@@ -10,10 +10,12 @@
 #include "net/dcsctp/tx/outstanding_data.h"
 
 #include <algorithm>
-#include <set>
+#include <cstdint>
+#include <optional>
 #include <utility>
 #include <vector>
 
+#include "absl/numeric/bits.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
 #include "net/dcsctp/common/math.h"
@@ -76,33 +78,125 @@ bool OutstandingData::Item::has_expired(Timestamp now) const {
   return expires_at_ <= now;
 }
 
+OutstandingData::TsnBitmap::TsnBitmap(size_t capacity)
+    : words_(capacity / 64) {
+  RTC_DCHECK_GE(capacity, 64);
+  RTC_DCHECK_EQ(capacity & (capacity - 1), 0);
+}
+
+bool OutstandingData::TsnBitmap::Contains(UnwrappedTSN tsn) const {
+  size_t bit = *tsn & (words_.size() * 64 - 1);
+  return (words_[bit / 64] >> (bit % 64)) & 1;
+}
+
+void OutstandingData::TsnBitmap::Insert(UnwrappedTSN tsn) {
+  size_t bit = *tsn & (words_.size() * 64 - 1);
+  uint64_t mask = uint64_t{1} << (bit % 64);
+  if ((words_[bit / 64] & mask) == 0) {
+    words_[bit / 64] |= mask;
+    ++count_;
+  }
+}
+
+void OutstandingData::TsnBitmap::Erase(UnwrappedTSN tsn) {
+  size_t bit = *tsn & (words_.size() * 64 - 1);
+  uint64_t mask = uint64_t{1} << (bit % 64);
+  if ((words_[bit / 64] & mask) != 0) {
+    words_[bit / 64] &= ~mask;
+    --count_;
+  }
+}
+
+void OutstandingData::TsnBitmap::Clear() {
+  if (count_ > 0) {
+    std::fill(words_.begin(), words_.end(), 0);
+    count_ = 0;
+  }
+}
+
+UnwrappedTSN OutstandingData::TsnBitmap::FindFirst(UnwrappedTSN begin,
+                                                   UnwrappedTSN end,
+                                                   bool member) const {
+  if (member && count_ == 0) {
+    return end;
+  }
+  const size_t mask = words_.size() * 64 - 1;
+  UnwrappedTSN tsn = begin;
+  while (tsn < end) {
+    size_t bit = *tsn & mask;
+    uint64_t word = words_[bit / 64];
+    if (!member) {
+      word = ~word;
+    }
+    // Ignore the bits before `tsn`.
+    word >>= bit % 64;
+    if (word != 0) {
+      tsn = UnwrappedTSN::AddTo(tsn, absl::countr_zero(word));
+      return std::min(tsn, end);
+    }
+    tsn = UnwrappedTSN::AddTo(tsn, 64 - bit % 64);
+  }
+  return end;
+}
+
+void OutstandingData::TsnBitmap::MoveAllTo(TsnBitmap& other) {
+  RTC_DCHECK_EQ(words_.size(), other.words_.size());
+  for (size_t i = 0; i < words_.size(); ++i) {
+    RTC_DCHECK_EQ(words_[i] & other.words_[i], 0);
+    other.words_[i] |= words_[i];
+    words_[i] = 0;
+  }
+  other.count_ += count_;
+  count_ = 0;
+}
+
+void OutstandingData::TsnBitmap::Resize(size_t capacity,
+                                        UnwrappedTSN begin,
+                                        UnwrappedTSN end) {
+  TsnBitmap resized(capacity);
+  for (UnwrappedTSN tsn = FindFirst(begin, end, /*member=*/true); tsn < end;
+       tsn = FindFirst(tsn.next_value(), end, /*member=*/true)) {
+    resized.Insert(tsn);
+  }
+  RTC_DCHECK_EQ(resized.count_, count_);
+  *this = std::move(resized);
+}
+
 bool OutstandingData::IsConsistent() const {
   size_t actual_unacked_bytes = 0;
   size_t actual_unacked_items = 0;
 
-  std::set<UnwrappedTSN> combined_to_be_retransmitted;
-  combined_to_be_retransmitted.insert(to_be_retransmitted_.begin(),
-                                      to_be_retransmitted_.end());
-  combined_to_be_retransmitted.insert(to_be_fast_retransmitted_.begin(),
-                                      to_be_fast_retransmitted_.end());
+  size_t actual_acked_items = 0;
+  size_t actual_to_be_retransmitted_items = 0;
+  bool bitmaps_match = true;
 
-  std::set<UnwrappedTSN> actual_combined_to_be_retransmitted;
-  UnwrappedTSN tsn = last_cumulative_tsn_ack_;
-  for (const Item& item : outstanding_data_) {
-    tsn.Increment();
+  for (UnwrappedTSN tsn = last_cumulative_tsn_ack_.next_value();
+       tsn < next_tsn(); tsn.Increment()) {
+    const Item& item = GetItem(tsn);
     if (item.is_outstanding()) {
       actual_unacked_bytes += GetSerializedChunkSize(item.data());
       ++actual_unacked_items;
     }
 
+    if (item.is_acked()) {
+      ++actual_acked_items;
+    }
     if (item.should_be_retransmitted()) {
-      actual_combined_to_be_retransmitted.insert(tsn);
+      ++actual_to_be_retransmitted_items;
     }
+    bitmaps_match &= item.is_acked() == acked_.Contains(tsn) &&
+                     item.should_be_retransmitted() ==
+                         (to_be_retransmitted_.Contains(tsn) ||
+                          to_be_fast_retransmitted_.Contains(tsn)) &&
+                     !(to_be_retransmitted_.Contains(tsn) &&
+                       to_be_fast_retransmitted_.Contains(tsn));
   }
 
   return actual_unacked_bytes == unacked_bytes_ &&
-         actual_unacked_items == unacked_items_ &&
-         actual_combined_to_be_retransmitted == combined_to_be_retransmitted;
+         actual_unacked_items == unacked_items_ && bitmaps_match &&
+         actual_acked_items == acked_.size() &&
+         actual_to_be_retransmitted_items ==
+             to_be_retransmitted_.size() + to_be_fast_retransmitted_.size();
 }
 
 void OutstandingData::AckChunk(AckInfo& ack_info,
@@ -116,11 +210,11 @@ void OutstandingData::AckChunk(AckInfo& ack_info,
       --unacked_items_;
     }
     if (item.should_be_retransmitted()) {
-      RTC_DCHECK(to_be_fast_retransmitted_.find(tsn) ==
-                 to_be_fast_retransmitted_.end());
-      to_be_retransmitted_.erase(tsn);
+      RTC_DCHECK(!to_be_fast_retransmitted_.Contains(tsn));
+      to_be_retransmitted_.Erase(tsn);
     }
     item.Ack();
+    acked_.Insert(tsn);
     ack_info.highest_tsn_acked = std::max(ack_info.highest_tsn_acked, tsn);
   }
 }
@@ -147,27 +241,42 @@ OutstandingData::AckInfo OutstandingData::HandleSack(
 OutstandingData::Item& OutstandingData::GetItem(UnwrappedTSN tsn) {
   RTC_DCHECK(tsn > last_cumulative_tsn_ack_);
   RTC_DCHECK(tsn < next_tsn());
-  int index = UnwrappedTSN::Difference(tsn, last_cumulative_tsn_ack_) - 1;
-  RTC_DCHECK(index >= 0);
-  RTC_DCHECK(index < static_cast<int>(outstanding_data_.size()));
-  return outstanding_data_[index];
+  return *items_[*tsn & (items_.size() - 1)];
 }
 
 const OutstandingData::Item& OutstandingData::GetItem(UnwrappedTSN tsn) const {
   RTC_DCHECK(tsn > last_cumulative_tsn_ack_);
   RTC_DCHECK(tsn < next_tsn());
-  int index = UnwrappedTSN::Difference(tsn, last_cumulative_tsn_ack_) - 1;
-  RTC_DCHECK(index >= 0);
-  RTC_DCHECK(index < static_cast<int>(outstanding_data_.size()));
-  return outstanding_data_[index];
+  return *items_[*tsn & (items_.size() - 1)];
+}
+
+OutstandingData::Item& OutstandingData::EmplaceBack(Item item) {
+  UnwrappedTSN begin = last_cumulative_tsn_ack_.next_value();
+  UnwrappedTSN end = next_tsn();
+  if (size_ == items_.size()) {
+    size_t capacity = items_.size() * 2;
+    std::vector<std::optional<Item>> items(capacity);
+    for (UnwrappedTSN tsn = begin; tsn < end; tsn.Increment()) {
+      items[*tsn & (capacity - 1)] = std::move(GetItem(tsn));
+    }
+    items_ = std::move(items);
+    acked_.Resize(capacity, begin, end);
+    to_be_fast_retransmitted_.Resize(capacity, begin, end);
+    to_be_retransmitted_.Resize(capacity, begin, end);
+  }
+  std::optional<Item>& slot = items_[*end & (items_.size() - 1)];
+  RTC_DCHECK(!slot.has_value());
+  slot = std::move(item);
+  ++size_;
+  return *slot;
 }
 
 void OutstandingData::RemoveAcked(UnwrappedTSN cumulative_tsn_ack,
                                   AckInfo& ack_info) {
-  while (!outstanding_data_.empty() &&
-         last_cumulative_tsn_ack_ < cumulative_tsn_ack) {
+  while (size_ > 0 && last_cumulative_tsn_ack_ < cumulative_tsn_ack) {
     UnwrappedTSN tsn = last_cumulative_tsn_ack_.next_value();
-    Item& item = outstanding_data_.front();
+    std::optional<Item>& slot = items_[*tsn & (items_.size() - 1)];
+    Item& item = *slot;
     AckChunk(ack_info, tsn, item);
     if (item.lifecycle_id().IsSet()) {
       RTC_DCHECK(item.data().is_end);
@@ -177,7 +286,9 @@ void OutstandingData::RemoveAcked(UnwrappedTSN cumulative_tsn_ack,
         ack_info.acked_lifecycle_ids.push_back(item.lifecycle_id());
       }
     }
-    outstanding_data_.pop_front();
+    acked_.Erase(tsn);
+    slot.reset();
+    --size_;
     last_cumulative_tsn_ack_.Increment();
   }
 
@@ -195,14 +306,19 @@ void OutstandingData::AckGapBlocks(
   // SACK chunk as advisory.". Note that when NR-SACK is supported, this can be
   // handled differently.
 
+  // Chunks that have already been acked by previous SACKs are skipped using
+  // the `acked_` bitmap, to only visit the newly acked chunks.
   for (auto& block : gap_ack_blocks) {
-    UnwrappedTSN start = UnwrappedTSN::AddTo(cumulative_tsn_ack, block.start);
-    UnwrappedTSN end = UnwrappedTSN::AddTo(cumulative_tsn_ack, block.end);
-    for (UnwrappedTSN tsn = start; tsn <= end; tsn = tsn.next_value()) {
-      if (tsn > last_cumulative_tsn_ack_ && tsn < next_tsn()) {
-        Item& item = GetItem(tsn);
-        AckChunk(ack_info, tsn, item);
-      }
+    UnwrappedTSN start = std::max(
+        UnwrappedTSN::AddTo(cumulative_tsn_ack, block.start),
+        last_cumulative_tsn_ack_.next_value());
+    UnwrappedTSN end = std::min(
+        UnwrappedTSN::AddTo(cumulative_tsn_ack, block.end).next_value(),
+        next_tsn());
+    for (UnwrappedTSN tsn = acked_.FindFirst(start, end, /*member=*/false);
+         tsn < end;
+         tsn = acked_.FindFirst(tsn.next_value(), end, /*member=*/false)) {
+      AckChunk(ack_info, tsn, GetItem(tsn));
     }
   }
 }
@@ -261,15 +377,16 @@ bool OutstandingData::NackItem(UnwrappedTSN tsn,
     unacked_bytes_ -= GetSerializedChunkSize(item.data());
     --unacked_items_;
   }
+  acked_.Erase(tsn);
 
   switch (item.Nack(retransmit_now)) {
     case Item::NackAction::kNothing:
       return false;
     case Item::NackAction::kRetransmit:
       if (do_fast_retransmit) {
-        to_be_fast_retransmitted_.insert(tsn);
+        to_be_fast_retransmitted_.Insert(tsn);
       } else {
-        to_be_retransmitted_.insert(tsn);
+        to_be_retransmitted_.Insert(tsn);
       }
       RTC_DLOG(LS_VERBOSE) << *tsn.Wrap() << " marked for retransmission";
       break;
@@ -282,8 +399,12 @@ bool OutstandingData::NackItem(UnwrappedTSN tsn,
 }
 
 void OutstandingData::AbandonAllFor(const Item& item) {
+  // Adding an item may invalidate `item`.
+  const StreamID stream_id = item.data().stream_id;
+  const OutgoingMessageId message_id = item.message_id();
+
   // Erase all remaining chunks from the producer, if any.
-  if (discard_from_send_queue_(item.data().stream_id, item.message_id())) {
+  if (discard_from_send_queue_(stream_id, message_id)) {
     // There were remaining chunks to be produced for this message. Since the
     // receiver may have already received all chunks (up till now) for this
     // message, we can't just FORWARD-TSN to the last fragment in this
@@ -292,33 +413,34 @@ void OutstandingData::AbandonAllFor(const Item& item) {
     // skipped over). So create a new fragment, representing the end, that the
     // received will never see as it is abandoned immediately and used as cum
     // TSN in the sent FORWARD-TSN.
-    Data message_end(item.data().stream_id, item.data().ssn, item.data().mid,
+    Data message_end(stream_id, item.data().ssn, item.data().mid,
                      item.data().fsn, item.data().ppid, std::vector<uint8_t>(),
                      Data::IsBeginning(false), Data::IsEnd(true),
                      item.data().is_unordered);
     UnwrappedTSN tsn = next_tsn();
-    Item& added_item = outstanding_data_.emplace_back(
-        item.message_id(), std::move(message_end), Timestamp::Zero(),
-        MaxRetransmits(0), Timestamp::PlusInfinity(), LifecycleId::NotSet());
+    Item& added_item = EmplaceBack(
+        Item(message_id, std::move(message_end), Timestamp::Zero(),
+             MaxRetransmits(0), Timestamp::PlusInfinity(),
+             LifecycleId::NotSet()));
 
     // The added chunk shouldn't be included in `unacked_bytes`, so set it
     // as acked.
     added_item.Ack();
+    acked_.Insert(tsn);
     RTC_DLOG(LS_VERBOSE) << "Adding unsent end placeholder for message at tsn="
                          << *tsn.Wrap();
   }
 
-  UnwrappedTSN tsn = last_cumulative_tsn_ack_;
-  for (Item& other : outstanding_data_) {
-    tsn.Increment();
-    if (!other.is_abandoned() &&
-        other.data().stream_id == item.data().stream_id &&
-        other.message_id() == item.message_id()) {
+  for (UnwrappedTSN tsn = last_cumulative_tsn_ack_.next_value();
+       tsn < next_tsn(); tsn.Increment()) {
+    Item& other = GetItem(tsn);
+    if (!other.is_abandoned() && other.data().stream_id == stream_id &&
+        other.message_id() == message_id) {
       RTC_DLOG(LS_VERBOSE) << "Marking chunk " << *tsn.Wrap()
                            << " as abandoned";
       if (other.should_be_retransmitted()) {
-        to_be_fast_retransmitted_.erase(tsn);
-        to_be_retransmitted_.erase(tsn);
+        to_be_fast_retransmitted_.Erase(tsn);
+        to_be_retransmitted_.Erase(tsn);
       }
       other.Abandon();
     }
@@ -326,12 +448,15 @@ void OutstandingData::AbandonAllFor(const Item& item) {
 }
 
 std::vector<std::pair<TSN, Data>> OutstandingData::ExtractChunksThatCanFit(
-    std::set<UnwrappedTSN>& chunks,
+    TsnBitmap& chunks,
     size_t max_size) {
   std::vector<std::pair<TSN, Data>> result;
 
-  for (auto it = chunks.begin(); it != chunks.end();) {
-    UnwrappedTSN tsn = *it;
+  UnwrappedTSN end = next_tsn();
+  for (UnwrappedTSN tsn = chunks.FindFirst(
+           last_cumulative_tsn_ack_.next_value(), end, /*member=*/true);
+       tsn < end; tsn = chunks.FindFirst(tsn.next_value(), end,
+                                         /*member=*/true)) {
     Item& item = GetItem(tsn);
     RTC_DCHECK(item.should_be_retransmitted());
     RTC_DCHECK(!item.is_outstanding());
@@ -345,9 +470,7 @@ std::vector<std::pair<TSN, Data>> OutstandingData::ExtractChunksThatCanFit(
       max_size -= serialized_size;
       unacked_bytes_ += serialized_size;
       ++unacked_items_;
-      it = chunks.erase(it);
-    } else {
-      ++it;
+      chunks.Erase(tsn);
     }
     // No point in continuing if the packet is full.
     if (max_size <= data_chunk_header_size_) {
@@ -369,9 +492,7 @@ OutstandingData::GetChunksToBeFastRetransmitted(size_t max_size) {
   // marked for retransmission they will be retransmitted later on as soon as
   // cwnd allows."
   if (!to_be_fast_retransmitted_.empty()) {
-    to_be_retransmitted_.insert(to_be_fast_retransmitted_.begin(),
-                                to_be_fast_retransmitted_.end());
-    to_be_fast_retransmitted_.clear();
+    to_be_fast_retransmitted_.MoveAllTo(to_be_retransmitted_);
   }
 
   RTC_DCHECK(IsConsistent());
@@ -386,9 +507,9 @@ std::vector<std::pair<TSN, Data>> OutstandingData::GetChunksToBeRetransmitted(
 }
 
 void OutstandingData::ExpireOutstandingChunks(Timestamp now) {
-  UnwrappedTSN tsn = last_cumulative_tsn_ack_;
-  for (const Item& item : outstanding_data_) {
-    tsn.Increment();
+  for (UnwrappedTSN tsn = last_cumulative_tsn_ack_.next_value();
+       tsn < next_tsn(); tsn.Increment()) {
+    const Item& item = GetItem(tsn);
     // Chunks that are nacked can be expired. Care should be taken not to expire
     // unacked (in-flight) chunks as they might have been received, but the SACK
     // is either delayed or in-flight and may be received later.
@@ -408,8 +529,7 @@ void OutstandingData::ExpireOutstandingChunks(Timestamp now) {
 }
 
 UnwrappedTSN OutstandingData::highest_outstanding_tsn() const {
-  return UnwrappedTSN::AddTo(last_cumulative_tsn_ack_,
-                             outstanding_data_.size());
+  return UnwrappedTSN::AddTo(last_cumulative_tsn_ack_, size_);
 }
 
 std::optional<UnwrappedTSN> OutstandingData::Insert(
@@ -424,9 +544,8 @@ std::optional<UnwrappedTSN> OutstandingData::Insert(
   unacked_bytes_ += chunk_size;
   ++unacked_items_;
   UnwrappedTSN tsn = next_tsn();
-  Item& item = outstanding_data_.emplace_back(message_id, data.Clone(),
-                                              time_sent, max_retransmissions,
-                                              expires_at, lifecycle_id);
+  Item& item = EmplaceBack(Item(message_id, data.Clone(), time_sent,
+                                max_retransmissions, expires_at, lifecycle_id));
 
   if (item.has_expired(time_sent)) {
     // No need to send it - it was expired when it was in the send
@@ -444,12 +563,11 @@ std::optional<UnwrappedTSN> OutstandingData::Insert(
 }
 
 void OutstandingData::NackAll() {
-  UnwrappedTSN tsn = last_cumulative_tsn_ack_;
   // A two-pass algorithm is needed, as NackItem will invalidate iterators.
   std::vector<UnwrappedTSN> tsns_to_nack;
-  for (Item& item : outstanding_data_) {
-    tsn.Increment();
-    if (!item.is_acked()) {
+  for (UnwrappedTSN tsn = last_cumulative_tsn_ack_.next_value();
+       tsn < next_tsn(); tsn.Increment()) {
+    if (!GetItem(tsn).is_acked()) {
       tsns_to_nack.push_back(tsn);
     }
   }
@@ -482,9 +600,9 @@ std::vector<std::pair<TSN, OutstandingData::State>>
 OutstandingData::GetChunkStatesForTesting() const {
   std::vector<std::pair<TSN, State>> states;
   states.emplace_back(last_cumulative_tsn_ack_.Wrap(), State::kAcked);
-  UnwrappedTSN tsn = last_cumulative_tsn_ack_;
-  for (const Item& item : outstanding_data_) {
-    tsn.Increment();
+  for (UnwrappedTSN tsn = last_cumulative_tsn_ack_.next_value();
+       tsn < next_tsn(); tsn.Increment()) {
+    const Item& item = GetItem(tsn);
     State state;
     if (item.is_abandoned()) {
       state = State::kAbandoned;
@@ -504,8 +622,8 @@ OutstandingData::GetChunkStatesForTesting() const {
 }
 
 bool OutstandingData::ShouldSendForwardTsn() const {
-  if (!outstanding_data_.empty()) {
-    return outstanding_data_.front().is_abandoned();
+  if (size_ > 0) {
+    return GetItem(last_cumulative_tsn_ack_.next_value()).is_abandoned();
   }
   return false;
 }
@@ -514,9 +632,9 @@ ForwardTsnChunk OutstandingData::CreateForwardTsn() const {
   std::map<StreamID, SSN> skipped_per_ordered_stream;
   UnwrappedTSN new_cumulative_ack = last_cumulative_tsn_ack_;
 
-  UnwrappedTSN tsn = last_cumulative_tsn_ack_;
-  for (const Item& item : outstanding_data_) {
-    tsn.Increment();
+  for (UnwrappedTSN tsn = last_cumulative_tsn_ack_.next_value();
+       tsn < next_tsn(); tsn.Increment()) {
+    const Item& item = GetItem(tsn);
     if (stream_reset_breakpoint_tsns_.contains(tsn) ||
         (tsn != new_cumulative_ack.next_value()) || !item.is_abandoned()) {
       break;
@@ -540,9 +658,9 @@ IForwardTsnChunk OutstandingData::CreateIForwardTsn() const {
   std::map<std::pair<IsUnordered, StreamID>, MID> skipped_per_stream;
   UnwrappedTSN new_cumulative_ack = last_cumulative_tsn_ack_;
 
-  UnwrappedTSN tsn = last_cumulative_tsn_ack_;
-  for (const Item& item : outstanding_data_) {
-    tsn.Increment();
+  for (UnwrappedTSN tsn = last_cumulative_tsn_ack_.next_value();
+       tsn < next_tsn(); tsn.Increment()) {
+    const Item& item = GetItem(tsn);
     if (stream_reset_breakpoint_tsns_.contains(tsn) ||
         (tsn != new_cumulative_ack.next_value()) || !item.is_abandoned()) {
       break;
@@ -567,7 +685,7 @@ IForwardTsnChunk OutstandingData::CreateIForwardTsn() const {
 }
 
 void OutstandingData::ResetSequenceNumbers(UnwrappedTSN last_cumulative_tsn) {
-  RTC_DCHECK(outstanding_data_.empty());
+  RTC_DCHECK(empty());
   last_cumulative_tsn_ack_ = last_cumulative_tsn;
 }
 
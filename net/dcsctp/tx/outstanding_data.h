@@ -10,10 +10,9 @@
 #ifndef NET_DCSCTP_TX_OUTSTANDING_DATA_H_
 #define NET_DCSCTP_TX_OUTSTANDING_DATA_H_
 
-#include <deque>
+#include <cstdint>
 #include <map>
 #include <optional>
-#include <set>
 #include <utility>
 #include <vector>
 
@@ -33,7 +32,10 @@ namespace dcsctp {
 // handles acking, nacking, rescheduling and abandoning.
 //
 // Items are added to this queue as they are sent and will be removed when the
-// peer acks them using the cumulative TSN ack.
+// peer acks them using the cumulative TSN ack. They are stored in a ring buffer
+// indexed by TSN, and the retransmission and ack state of the items is also
+// tracked in bitmaps over that ring buffer, so that processing a SACK only
+// visits the chunks whose state changes and chunks reported as missing.
 class OutstandingData {
  public:
   // State for DATA chunks (message fragments) in the queue - used in tests.
@@ -83,7 +85,11 @@ class OutstandingData {
       std::function<bool(StreamID, OutgoingMessageId)> discard_from_send_queue)
       : data_chunk_header_size_(data_chunk_header_size),
         last_cumulative_tsn_ack_(last_cumulative_tsn_ack),
-        discard_from_send_queue_(std::move(discard_from_send_queue)) {}
+        discard_from_send_queue_(std::move(discard_from_send_queue)),
+        items_(kInitialCapacity),
+        acked_(kInitialCapacity),
+        to_be_fast_retransmitted_(kInitialCapacity),
+        to_be_retransmitted_(kInitialCapacity) {}
 
   AckInfo HandleSack(
       UnwrappedTSN cumulative_tsn_ack,
@@ -110,7 +116,7 @@ class OutstandingData {
   // least once) chunks that have a limited lifetime.
   void ExpireOutstandingChunks(webrtc::Timestamp now);
 
-  bool empty() const { return outstanding_data_.empty(); }
+  bool empty() const { return size_ == 0; }
 
   bool has_data_to_be_fast_retransmitted() const {
     return !to_be_fast_retransmitted_.empty();
@@ -196,6 +202,8 @@ class OutstandingData {
 
     Item(const Item&) = delete;
     Item& operator=(const Item&) = delete;
+    Item(Item&&) = default;
+    Item& operator=(Item&&) = default;
 
     OutgoingMessageId message_id() const { return message_id_; }
 
@@ -259,14 +267,14 @@ class OutstandingData {
     // NOTE: This data structure has been optimized for size, by ordering fields
     // to avoid unnecessary padding.
 
-    const OutgoingMessageId message_id_;
+    OutgoingMessageId message_id_;
 
     // When the packet was sent, and placed in this queue.
-    const webrtc::Timestamp time_sent_;
+    webrtc::Timestamp time_sent_;
     // If the message was sent with a maximum number of retransmissions, this is
     // set to that number. The value zero (0) means that it will never be
     // retransmitted.
-    const MaxRetransmits max_retransmissions_;
+    MaxRetransmits max_retransmissions_;
 
     // Indicates the life cycle status of this chunk.
     Lifecycle lifecycle_ = Lifecycle::kActive;
@@ -282,21 +290,65 @@ class OutstandingData {
 
     // At this exact millisecond, the item is considered expired. If the message
     // is not to be expired, this is set to the infinite future.
-    const webrtc::Timestamp expires_at_;
+    webrtc::Timestamp expires_at_;
 
     // An optional lifecycle id, which may only be set for the last fragment.
-    const LifecycleId lifecycle_id_;
+    LifecycleId lifecycle_id_;
 
     // The actual data to send/retransmit.
-    const Data data_;
+    Data data_;
   };
 
+  // A set of outstanding TSNs, stored as one bit per slot of the ring buffer of
+  // outstanding items, which allows searching a range of TSNs one word at a
+  // time. All TSNs in the set must be within the same window of `capacity`
+  // TSNs.
+  class TsnBitmap {
+   public:
+    // `capacity` must be a power of two, and at least 64.
+    explicit TsnBitmap(size_t capacity);
+
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+
+    bool Contains(UnwrappedTSN tsn) const;
+    void Insert(UnwrappedTSN tsn);
+    void Erase(UnwrappedTSN tsn);
+    void Clear();
+
+    // Returns the first TSN in [`begin`, `end`) which is a member of the set
+    // if `member` is true, or which isn't if `member` is false. Returns `end`
+    // if there is no such TSN.
+    UnwrappedTSN FindFirst(UnwrappedTSN begin,
+                           UnwrappedTSN end,
+                           bool member) const;
+
+    // Moves all TSNs to `other`, which must have the same capacity and must not
+    // contain any of them.
+    void MoveAllTo(TsnBitmap& other);
+
+    // Changes the capacity, keeping the TSNs in [`begin`, `end`).
+    void Resize(size_t capacity, UnwrappedTSN begin, UnwrappedTSN end);
+
+   private:
+    std::vector<uint64_t> words_;
+    size_t count_ = 0;
+  };
+
+  // Initial number of slots in the ring buffer. It's doubled whenever it's
+  // full.
+  static constexpr size_t kInitialCapacity = 128;
+
   // Returns how large a chunk will be, serialized, carrying the data
   size_t GetSerializedChunkSize(const Data& data) const;
 
   Item& GetItem(UnwrappedTSN tsn);
   const Item& GetItem(UnwrappedTSN tsn) const;
 
+  // Adds an item at the end of the ring buffer, growing it if it's full, which
+  // invalidates references to other items. Returns the added item.
+  Item& EmplaceBack(Item item);
+
   // Given a `cumulative_tsn_ack` from an incoming SACK, will remove those items
   // in the retransmission queue up until this value and will update `ack_info`
   // by setting `bytes_acked_by_cumulative_tsn_ack`.
@@ -332,18 +384,18 @@ class OutstandingData {
   // recovery.
   //
   // Note that since nacking an item may result in it becoming abandoned, which
-  // in turn could alter `outstanding_data_`, any iterators are invalidated
-  // after having called this method.
+  // in turn could add items to the ring buffer, any references to items are
+  // invalidated after having called this method.
   bool NackItem(UnwrappedTSN tsn, bool retransmit_now, bool do_fast_retransmit);
 
   // Given that a message fragment, `item` has been abandoned, abandon all other
   // fragments that share the same message - both never-before-sent fragments
-  // that are still in the SendQueue and outstanding chunks.
+  // that are still in the SendQueue and outstanding chunks. Note that `item`
+  // may be invalidated by this method.
   void AbandonAllFor(const OutstandingData::Item& item);
 
-  std::vector<std::pair<TSN, Data>> ExtractChunksThatCanFit(
-      std::set<UnwrappedTSN>& chunks,
-      size_t max_size);
+  std::vector<std::pair<TSN, Data>> ExtractChunksThatCanFit(TsnBitmap& chunks,
+                                                            size_t max_size);
 
   bool IsConsistent() const;
 
@@ -354,19 +406,25 @@ class OutstandingData {
   // Callback when to discard items from the send queue.
   std::function<bool(StreamID, OutgoingMessageId)> discard_from_send_queue_;
 
-  // Outstanding items. If non-empty, the first element has
-  // `TSN=last_cumulative_tsn_ack_ + 1` and the following items are in strict
-  // increasing TSN order. The last item has `TSN=highest_outstanding_tsn()`.
-  std::deque<Item> outstanding_data_;
+  // Outstanding items, in a ring buffer whose size is a power of two, where the
+  // item with a given TSN is stored at slot `TSN % items_.size()`. If
+  // non-empty, the first item has `TSN=last_cumulative_tsn_ack_ + 1`, and the
+  // following `size_ - 1` items are in strict increasing TSN order. The last
+  // item has `TSN=highest_outstanding_tsn()`. Unused slots are empty.
+  std::vector<std::optional<Item>> items_;
+  // The number of outstanding items.
+  size_t size_ = 0;
   // The number of bytes that are in-flight (sent but not yet acked or nacked).
   size_t unacked_bytes_ = 0;
   // The number of DATA chunks that are in-flight (sent but not yet acked or
   // nacked).
   size_t unacked_items_ = 0;
+  // Data chunks that have been acked by gap ack blocks.
+  TsnBitmap acked_;
   // Data chunks that are eligible for fast retransmission.
-  std::set<UnwrappedTSN> to_be_fast_retransmitted_;
+  TsnBitmap to_be_fast_retransmitted_;
   // Data chunks that are to be retransmitted.
-  std::set<UnwrappedTSN> to_be_retransmitted_;
+  TsnBitmap to_be_retransmitted_;
   // Wben a stream reset has begun, the "next TSN to assign" is added to this
   // set, and removed when the cum-ack TSN reaches it. This is used to limit a
   // FORWARD-TSN to reset streams past a "stream reset last assigned TSN".
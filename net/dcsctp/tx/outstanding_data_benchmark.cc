@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of processing SACKs with large windows of in-flight data,
+// as for data channels on high-bandwidth, high-RTT paths, while a lost chunk
+// is being recovered.
+
+#include <cstdint>
+#include <vector>
+
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "net/dcsctp/common/internal_types.h"
+#include "net/dcsctp/common/sequence_numbers.h"
+#include "net/dcsctp/packet/chunk/data_chunk.h"
+#include "net/dcsctp/packet/chunk/sack_chunk.h"
+#include "net/dcsctp/packet/data.h"
+#include "net/dcsctp/public/payload.h"
+#include "net/dcsctp/public/types.h"
+#include "net/dcsctp/tx/outstanding_data.h"
+#include "rtc_base/checks.h"
+
+namespace dcsctp {
+namespace {
+
+constexpr webrtc::Timestamp kNow = webrtc::Timestamp::Millis(42);
+constexpr size_t kPayloadSize = 1000;
+constexpr size_t kMaxPacketSize = 1200;
+// Like with delayed SACKs, every SACK acks this many new chunks.
+constexpr int kChunksPerSack = 2;
+
+// Each iteration handles one SACK. The first outstanding chunk is lost, and
+// is recovered one round-trip time later, when the whole window has been
+// acked by gap ack blocks. New chunks are sent as others are acked, keeping
+// the window full.
+void BM_OutstandingDataHandleSackWithLoss(benchmark::State& state) {
+  const int window = state.range(0);
+  const Payload payload = std::vector<uint8_t>(kPayloadSize);
+  UnwrappedTSN::Unwrapper unwrapper;
+  OutstandingData buf(DataChunk::kHeaderSize, unwrapper.Unwrap(TSN(1)),
+                      [](StreamID, OutgoingMessageId) { return false; });
+  uint32_t message_id = 0;
+  auto send = [&] {
+    Data data(StreamID(1), SSN(0), MID(message_id), FSN(0), PPID(53), payload,
+              Data::IsBeginning(true), Data::IsEnd(true), IsUnordered(true));
+    RTC_CHECK(buf.Insert(OutgoingMessageId(message_id++), data, kNow));
+  };
+
+  for (int i = 0; i < window; ++i) {
+    send();
+  }
+  // Number of chunks after the lost one that have been acked.
+  int gap_acked = 0;
+  int64_t retransmissions = 0;
+  for (auto _ : state) {
+    UnwrappedTSN cumulative_tsn_ack = buf.last_cumulative_tsn_ack();
+    if (gap_acked + kChunksPerSack < window) {
+      gap_acked += kChunksPerSack;
+      SackChunk::GapAckBlock blocks[] = {
+          SackChunk::GapAckBlock(2, 1 + gap_acked)};
+      buf.HandleSack(cumulative_tsn_ack, blocks, /*is_in_fast_recovery=*/false);
+      if (buf.has_data_to_be_fast_retransmitted()) {
+        retransmissions +=
+            buf.GetChunksToBeFastRetransmitted(kMaxPacketSize).size();
+      }
+    } else {
+      // The retransmitted chunk was received.
+      buf.HandleSack(UnwrappedTSN::AddTo(cumulative_tsn_ack, 1 + gap_acked),
+                     {}, /*is_in_fast_recovery=*/false);
+      gap_acked = 0;
+    }
+    for (int i = 0; i < kChunksPerSack; ++i) {
+      send();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["retransmissions_per_sack"] = benchmark::Counter(
+      retransmissions, benchmark::Counter::kAvgIterations);
+}
+
+// Number of chunks in flight.
+BENCHMARK(BM_OutstandingDataHandleSackWithLoss)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Arg(16384);
+
+}  // namespace
+}  // namespace dcsctp
@@ -10,6 +10,7 @@
 #include "net/dcsctp/tx/outstanding_data.h"
 
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "net/dcsctp/common/internal_types.h"
@@ -657,5 +658,43 @@ TEST_F(OutstandingDataTest, GeneratesForwardTsnUntilNextStreamResetTsn) {
   EXPECT_FALSE(buf_.ShouldSendForwardTsn());
 }
 
+TEST_F(OutstandingDataTest, KeepsStateWhenGrowingWithManyChunksInFlight) {
+  for (int i = 0; i < 100; ++i) {
+    buf_.Insert(kMessageId, gen_.Ordered({1}, "BE"), kNow);
+  }
+
+  // TSN 10 is lost, and is nacked by three SACKs acking the rest.
+  for (uint16_t end : {50, 80, 100}) {
+    std::vector<SackChunk::GapAckBlock> gab = {SackChunk::GapAckBlock(2, end)};
+    buf_.HandleSack(unwrapper_.Unwrap(TSN(9)), gab, false);
+  }
+  EXPECT_TRUE(buf_.has_data_to_be_fast_retransmitted());
+
+  for (int i = 0; i < 200; ++i) {
+    buf_.Insert(kMessageId, gen_.Ordered({1}, "BE"), kNow);
+  }
+
+  std::vector<std::pair<TSN, State>> states = buf_.GetChunkStatesForTesting();
+  ASSERT_EQ(states.size(), 301u);
+  EXPECT_EQ(states[1], std::make_pair(TSN(10), State::kToBeRetransmitted));
+  for (int i = 2; i <= 100; ++i) {
+    EXPECT_EQ(states[i], std::make_pair(TSN(9 + i), State::kAcked));
+  }
+  for (int i = 101; i <= 300; ++i) {
+    EXPECT_EQ(states[i], std::make_pair(TSN(9 + i), State::kInFlight));
+  }
+  EXPECT_EQ(buf_.unacked_items(), 200u);
+
+  EXPECT_THAT(buf_.GetChunksToBeFastRetransmitted(1000),
+              ElementsAre(Pair(TSN(10), _)));
+  EXPECT_FALSE(buf_.has_data_to_be_retransmitted());
+
+  buf_.HandleSack(unwrapper_.Unwrap(TSN(309)), {}, false);
+  EXPECT_TRUE(buf_.empty());
+  EXPECT_EQ(buf_.unacked_bytes(), 0u);
+  EXPECT_EQ(buf_.unacked_items(), 0u);
+  EXPECT_EQ(buf_.next_tsn().Wrap(), TSN(310));
+}
+
 }  // namespace
 }  // namespace dcsctp
@@ -14,6 +14,7 @@
 #include <functional>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -35,6 +36,9 @@
 #include "net/dcsctp/public/dcsctp_options.h"
 #include "net/dcsctp/public/types.h"
 #include "net/dcsctp/timer/timer.h"
+#include "net/dcsctp/tx/bbr_congestion_control.h"
+#include "net/dcsctp/tx/congestion_control.h"
+#include "net/dcsctp/tx/new_reno_congestion_control.h"
 #include "net/dcsctp/tx/outstanding_data.h"
 #include "net/dcsctp/tx/send_queue.h"
 #include "rtc_base/checks.h"
@@ -46,6 +50,20 @@ namespace dcsctp {
 namespace {
 using ::webrtc::TimeDelta;
 using ::webrtc::Timestamp;
+
+std::unique_ptr<CongestionControl> CreateCongestionControl(
+    absl::string_view log_prefix,
+    const DcSctpOptions& options,
+    size_t a_rwnd) {
+  switch (options.congestion_control_algorithm) {
+    case CongestionControlAlgorithm::kNewReno:
+      return std::make_unique<NewRenoCongestionControl>(log_prefix, options,
+                                                        a_rwnd);
+    case CongestionControlAlgorithm::kBbr:
+      return std::make_unique<BbrCongestionControl>(log_prefix, options);
+  }
+  RTC_CHECK_NOTREACHED();
+}
 }  // namespace
 
 RetransmissionQueue::RetransmissionQueue(
@@ -71,14 +89,9 @@ RetransmissionQueue::RetransmissionQueue(
       on_clear_retransmission_counter_(
           std::move(on_clear_retransmission_counter)),
       t3_rtx_(t3_rtx),
-      cwnd_(options_.cwnd_mtus_initial * options_.mtu),
+      congestion_control_(
+          CreateCongestionControl(log_prefix_, options_, a_rwnd)),
       rwnd_(a_rwnd),
-      // https://tools.ietf.org/html/rfc4960#section-7.2.1
-      // "The initial value of ssthresh MAY be arbitrarily high (for
-      // example, implementations MAY use the size of the receiver advertised
-      // window).""
-      ssthresh_(rwnd_),
-      partial_bytes_acked_(0),
       send_queue_(send_queue),
       outstanding_data_(
           data_chunk_header_size_,
@@ -110,97 +123,6 @@ void RetransmissionQueue::MaybeExitFastRecovery(
   }
 }
 
-void RetransmissionQueue::HandleIncreasedCumulativeTsnAck(
-    size_t unacked_bytes,
-    size_t total_bytes_acked) {
-  // Allow some margin for classifying as fully utilized, due to e.g. that too
-  // small packets (less than kMinimumFragmentedPayload) are not sent +
-  // overhead.
-  bool is_fully_utilized = unacked_bytes + options_.mtu >= cwnd_;
-  size_t old_cwnd = cwnd_;
-  if (phase() == CongestionAlgorithmPhase::kSlowStart) {
-    if (is_fully_utilized && !is_in_fast_recovery()) {
-      // https://tools.ietf.org/html/rfc4960#section-7.2.1
-      // "Only when these three conditions are met can the cwnd be
-      // increased; otherwise, the cwnd MUST not be increased. If these
-      // conditions are met, then cwnd MUST be increased by, at most, the
-      // lesser of 1) the total size of the previously outstanding DATA
-      // chunk(s) acknowledged, and 2) the destination's path MTU."
-      cwnd_ += std::min(total_bytes_acked, options_.mtu);
-      RTC_DLOG(LS_VERBOSE) << log_prefix_ << "SS increase cwnd=" << cwnd_
-                           << " (" << old_cwnd << ")";
-    }
-  } else if (phase() == CongestionAlgorithmPhase::kCongestionAvoidance) {
-    // https://tools.ietf.org/html/rfc4960#section-7.2.2
-    // "Whenever cwnd is greater than ssthresh, upon each SACK arrival
-    // that advances the Cumulative TSN Ack Point, increase
-    // partial_bytes_acked by the total number of bytes of all new chunks
-    // acknowledged in that SACK including chunks acknowledged by the new
-    // Cumulative TSN Ack and by Gap Ack Blocks."
-    size_t old_pba = partial_bytes_acked_;
-    partial_bytes_acked_ += total_bytes_acked;
-
-    if (partial_bytes_acked_ >= cwnd_ && is_fully_utilized) {
-      // https://tools.ietf.org/html/rfc4960#section-7.2.2
-      // "When partial_bytes_acked is equal to or greater than cwnd and
-      // before the arrival of the SACK the sender had cwnd or more bytes of
-      // data outstanding (i.e., before arrival of the SACK, flightsize was
-      // greater than or equal to cwnd), increase cwnd by MTU, and reset
-      // partial_bytes_acked to (partial_bytes_acked - cwnd)."
-
-      // Errata: https://datatracker.ietf.org/doc/html/rfc8540#section-3.12
-      partial_bytes_acked_ -= cwnd_;
-      cwnd_ += options_.mtu;
-      RTC_DLOG(LS_VERBOSE) << log_prefix_ << "CA increase cwnd=" << cwnd_
-                           << " (" << old_cwnd << ") ssthresh=" << ssthresh_
-                           << ", pba=" << partial_bytes_acked_ << " ("
-                           << old_pba << ")";
-    } else {
-      RTC_DLOG(LS_VERBOSE) << log_prefix_ << "CA unchanged cwnd=" << cwnd_
-                           << " (" << old_cwnd << ") ssthresh=" << ssthresh_
-                           << ", pba=" << partial_bytes_acked_ << " ("
-                           << old_pba << ")";
-    }
-  }
-}
-
-void RetransmissionQueue::HandlePacketLoss(
-    UnwrappedTSN /* highest_tsn_acked */) {
-  if (!is_in_fast_recovery()) {
-    // https://tools.ietf.org/html/rfc4960#section-7.2.4
-    // "If not in Fast Recovery, adjust the ssthresh and cwnd of the
-    // destination address(es) to which the missing DATA chunks were last
-    // sent, according to the formula described in Section 7.2.3."
-    size_t old_cwnd = cwnd_;
-    size_t old_pba = partial_bytes_acked_;
-    ssthresh_ = std::max(cwnd_ / 2, options_.cwnd_mtus_min * options_.mtu);
-    cwnd_ = ssthresh_;
-    partial_bytes_acked_ = 0;
-
-    RTC_DLOG(LS_VERBOSE) << log_prefix_
-                         << "packet loss detected (not fast recovery). cwnd="
-                         << cwnd_ << " (" << old_cwnd
-                         << "), ssthresh=" << ssthresh_
-                         << ", pba=" << partial_bytes_acked_ << " (" << old_pba
-                         << ")";
-
-    // https://tools.ietf.org/html/rfc4960#section-7.2.4
-    // "If not in Fast Recovery, enter Fast Recovery and mark the highest
-    // outstanding TSN as the Fast Recovery exit point."
-    fast_recovery_exit_tsn_ = outstanding_data_.highest_outstanding_tsn();
-    RTC_DLOG(LS_VERBOSE) << log_prefix_
-                         << "fast recovery initiated with exit_point="
-                         << *fast_recovery_exit_tsn_->Wrap();
-  } else {
-    // https://tools.ietf.org/html/rfc4960#section-7.2.4
-    // "While in Fast Recovery, the ssthresh and cwnd SHOULD NOT change for
-    // any destinations due to a subsequent Fast Recovery event (i.e., one
-    // SHOULD NOT reduce the cwnd further due to a subsequent Fast Retransmit)."
-    RTC_DLOG(LS_VERBOSE) << log_prefix_
-                         << "packet loss detected (fast recovery). No changes.";
-  }
-}
-
 void RetransmissionQueue::UpdateReceiverWindow(uint32_t a_rwnd) {
   rwnd_ = outstanding_data_.unacked_bytes() >= a_rwnd
               ? 0
@@ -312,12 +234,29 @@ bool RetransmissionQueue::HandleSack(Timestamp now, const SackChunk& sack) {
     // outstanding data on that address)."
     // Note: It may be started again in a bit further down.
     t3_rtx_.Stop();
-
-    HandleIncreasedCumulativeTsnAck(old_unacked_bytes, ack_info.bytes_acked);
   }
 
-  if (ack_info.has_packet_loss) {
-    HandlePacketLoss(ack_info.highest_tsn_acked);
+  congestion_control_->OnSack({
+      .now = now,
+      .bytes_acked = ack_info.bytes_acked,
+      .unacked_bytes_before = old_unacked_bytes,
+      .unacked_bytes = outstanding_data_.unacked_bytes(),
+      .cumulative_tsn_ack_advanced =
+          cumulative_tsn_ack > old_last_cumulative_tsn_ack,
+      .highest_tsn_acked = ack_info.highest_tsn_acked,
+      .highest_outstanding_tsn = outstanding_data_.highest_outstanding_tsn(),
+      .has_packet_loss = ack_info.has_packet_loss,
+      .is_in_fast_recovery = is_in_fast_recovery(),
+  });
+
+  if (ack_info.has_packet_loss && !is_in_fast_recovery()) {
+    // https://tools.ietf.org/html/rfc4960#section-7.2.4
+    // "If not in Fast Recovery, enter Fast Recovery and mark the highest
+    // outstanding TSN as the Fast Recovery exit point."
+    fast_recovery_exit_tsn_ = outstanding_data_.highest_outstanding_tsn();
+    RTC_DLOG(LS_VERBOSE) << log_prefix_
+                         << "fast recovery initiated with exit_point="
+                         << *fast_recovery_exit_tsn_->Wrap();
   }
 
   // https://tools.ietf.org/html/rfc4960#section-8.2
@@ -345,20 +284,18 @@ void RetransmissionQueue::UpdateRTT(Timestamp now,
   TimeDelta rtt = outstanding_data_.MeasureRTT(now, cumulative_tsn_ack);
 
   if (rtt.IsFinite()) {
+    congestion_control_->OnRttMeasured(now, rtt);
     on_new_rtt_(rtt);
   }
 }
 
 void RetransmissionQueue::HandleT3RtxTimerExpiry() {
-  size_t old_cwnd = cwnd_;
+  size_t old_cwnd = cwnd();
   size_t old_unacked_bytes = unacked_bytes();
   // https://tools.ietf.org/html/rfc4960#section-6.3.3
   // "For the destination address for which the timer expires, adjust
   // its ssthresh with rules defined in Section 7.2.3 and set the cwnd <- MTU."
-  ssthresh_ = std::max(cwnd_ / 2, 4 * options_.mtu);
-  cwnd_ = 1 * options_.mtu;
-  // Errata: https://datatracker.ietf.org/doc/html/rfc8540#section-3.11
-  partial_bytes_acked_ = 0;
+  congestion_control_->OnRetransmissionTimeout();
 
   // https://tools.ietf.org/html/rfc4960#section-6.3.3
   // "For the destination address for which the timer expires, set RTO
@@ -386,10 +323,9 @@ void RetransmissionQueue::HandleT3RtxTimerExpiry() {
 
   // Already done by the Timer implementation.
 
-  RTC_DLOG(LS_INFO) << log_prefix_ << "t3-rtx expired. new cwnd=" << cwnd_
-                    << " (" << old_cwnd << "), ssthresh=" << ssthresh_
-                    << ", unacked_bytes " << unacked_bytes() << " ("
-                    << old_unacked_bytes << ")";
+  RTC_DLOG(LS_INFO) << log_prefix_ << "t3-rtx expired. new cwnd=" << cwnd()
+                    << " (" << old_cwnd << "), unacked_bytes "
+                    << unacked_bytes() << " (" << old_unacked_bytes << ")";
   RTC_DCHECK(IsConsistent());
 }
 
@@ -524,7 +460,7 @@ std::vector<std::pair<TSN, Data>> RetransmissionQueue::GetChunksToSend(
                                   return r + GetSerializedChunkSize(d.second);
                                 })
                          << " bytes. unacked_bytes=" << unacked_bytes() << " ("
-                         << old_unacked_bytes << "), cwnd=" << cwnd_
+                         << old_unacked_bytes << "), cwnd=" << cwnd()
                          << ", rwnd=" << rwnd_ << " (" << old_rwnd << ")";
   }
   RTC_DCHECK(IsConsistent());
@@ -542,7 +478,7 @@ bool RetransmissionQueue::ShouldSendForwardTsn(Timestamp now) {
 }
 
 size_t RetransmissionQueue::max_bytes_to_send() const {
-  size_t left = unacked_bytes() >= cwnd_ ? 0 : cwnd_ - unacked_bytes();
+  size_t left = unacked_bytes() >= cwnd() ? 0 : cwnd() - unacked_bytes();
 
   if (unacked_bytes() == 0) {
     // https://datatracker.ietf.org/doc/html/rfc4960#section-6.1
@@ -593,9 +529,7 @@ HandoverReadinessStatus RetransmissionQueue::GetHandoverReadiness() const {
 void RetransmissionQueue::AddHandoverState(DcSctpSocketHandoverState& state) {
   state.tx.next_tsn = next_tsn().value();
   state.tx.rwnd = rwnd_;
-  state.tx.cwnd = cwnd_;
-  state.tx.ssthresh = ssthresh_;
-  state.tx.partial_bytes_acked = partial_bytes_acked_;
+  congestion_control_->AddHandoverState(state);
 }
 
 void RetransmissionQueue::RestoreFromState(
@@ -603,12 +537,9 @@ void RetransmissionQueue::RestoreFromState(
   // Validate that the component is in pristine state.
   RTC_DCHECK(outstanding_data_.empty());
   RTC_DCHECK(!t3_rtx_.is_running());
-  RTC_DCHECK(partial_bytes_acked_ == 0);
 
-  cwnd_ = state.tx.cwnd;
   rwnd_ = state.tx.rwnd;
-  ssthresh_ = state.tx.ssthresh;
-  partial_bytes_acked_ = state.tx.partial_bytes_acked;
+  congestion_control_->RestoreFromState(state);
 
   outstanding_data_.ResetSequenceNumbers(
       tsn_unwrapper_.Unwrap(TSN(state.tx.next_tsn - 1)));
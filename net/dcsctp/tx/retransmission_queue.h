@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -30,6 +31,7 @@
 #include "net/dcsctp/public/dcsctp_options.h"
 #include "net/dcsctp/public/dcsctp_socket.h"
 #include "net/dcsctp/timer/timer.h"
+#include "net/dcsctp/tx/congestion_control.h"
 #include "net/dcsctp/tx/outstanding_data.h"
 #include "net/dcsctp/tx/retransmission_timeout.h"
 #include "net/dcsctp/tx/send_queue.h"
@@ -43,7 +45,9 @@ namespace dcsctp {
 //
 // As congestion control is tightly connected with the state of transmitted
 // packets, that's also managed here to limit the amount of data that is
-// in-flight (sent, but not yet acknowledged).
+// in-flight (sent, but not yet acknowledged). The congestion window itself is
+// provided by a `CongestionControl` algorithm, selected by
+// `DcSctpOptions::congestion_control_algorithm`.
 class RetransmissionQueue {
  public:
   static constexpr size_t kMinimumFragmentedPayload = 10;
@@ -109,10 +113,10 @@ class RetransmissionQueue {
 
   // Returns the size of the congestion window, in bytes. This is the number of
   // bytes that may be in-flight.
-  size_t cwnd() const { return cwnd_; }
+  size_t cwnd() const { return congestion_control_->cwnd(); }
 
   // Overrides the current congestion window size.
-  void set_cwnd(size_t cwnd) { cwnd_ = cwnd; }
+  void set_cwnd(size_t cwnd) { congestion_control_->set_cwnd(cwnd); }
 
   // Returns the current receiver window size.
   size_t rwnd() const { return rwnd_; }
@@ -155,11 +159,6 @@ class RetransmissionQueue {
   void RestoreFromState(const DcSctpSocketHandoverState& state);
 
  private:
-  enum class CongestionAlgorithmPhase {
-    kSlowStart,
-    kCongestionAvoidance,
-  };
-
   bool IsConsistent() const;
 
   // Returns how large a chunk will be, serialized, carrying the data
@@ -188,26 +187,12 @@ class RetransmissionQueue {
   void StopT3RtxTimerOnIncreasedCumulativeTsnAck(
       UnwrappedTSN cumulative_tsn_ack);
 
-  // Update the congestion control algorithm given as the cumulative ack TSN
-  // value has increased, as reported in an incoming SACK chunk.
-  void HandleIncreasedCumulativeTsnAck(size_t unacked_bytes,
-                                       size_t total_bytes_acked);
-  // Update the congestion control algorithm, given as packet loss has been
-  // detected, as reported in an incoming SACK chunk.
-  void HandlePacketLoss(UnwrappedTSN highest_tsn_acked);
   // Update the view of the receiver window size.
   void UpdateReceiverWindow(uint32_t a_rwnd);
   // If there is data sent and not ACKED, ensure that the retransmission timer
   // is running.
   void StartT3RtxTimerIfOutstandingData();
 
-  // Returns the current congestion control algorithm phase.
-  CongestionAlgorithmPhase phase() const {
-    return (cwnd_ <= ssthresh_)
-               ? CongestionAlgorithmPhase::kSlowStart
-               : CongestionAlgorithmPhase::kCongestionAvoidance;
-  }
-
   // Returns the number of bytes that may be sent in a single packet according
   // to the congestion control algorithm.
   size_t max_bytes_to_send() const;
@@ -228,14 +213,11 @@ class RetransmissionQueue {
   // Unwraps TSNs
   UnwrappedTSN::Unwrapper tsn_unwrapper_;
 
-  // Congestion Window. Number of bytes that may be in-flight (sent, not acked).
-  size_t cwnd_;
+  // Provides the congestion window, which is the number of bytes that may be
+  // in-flight (sent, not acked).
+  const std::unique_ptr<CongestionControl> congestion_control_;
   // Receive Window. Number of bytes available in the receiver's RX buffer.
   size_t rwnd_;
-  // Slow Start Threshold. See RFC4960.
-  size_t ssthresh_;
-  // Partial Bytes Acked. See RFC4960.
-  size_t partial_bytes_acked_;
 
   // See `dcsctp::Metrics`.
   size_t rtx_packets_count_ = 0;
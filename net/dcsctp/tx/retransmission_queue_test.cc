@@ -1405,6 +1405,49 @@ TEST_F(RetransmissionQueueTest, CwndRecoversWhenAcking) {
   EXPECT_EQ(queue.cwnd(), kCwnd + serialized_size);
 }
 
+TEST_F(RetransmissionQueueTest, HalvesCwndOnPacketLossWithNewReno) {
+  options_.congestion_control_algorithm = CongestionControlAlgorithm::kNewReno;
+  RetransmissionQueue queue = CreateQueue();
+  size_t initial_cwnd = queue.cwnd();
+  EXPECT_CALL(producer_, Produce)
+      .WillOnce(CreateChunk(OutgoingMessageId(0)))
+      .WillOnce(CreateChunk(OutgoingMessageId(1)))
+      .WillOnce(CreateChunk(OutgoingMessageId(2)))
+      .WillOnce(CreateChunk(OutgoingMessageId(3)))
+      .WillOnce(CreateChunk(OutgoingMessageId(4)))
+      .WillRepeatedly([](Timestamp, size_t) { return std::nullopt; });
+  EXPECT_THAT(GetSentPacketTSNs(queue), SizeIs(5));
+
+  // Nack TSN 11 three times.
+  queue.HandleSack(now_, SackChunk(TSN(10), kArwnd, {{2, 2}}, {}));
+  queue.HandleSack(now_, SackChunk(TSN(10), kArwnd, {{2, 3}}, {}));
+  queue.HandleSack(now_, SackChunk(TSN(10), kArwnd, {{2, 4}}, {}));
+
+  EXPECT_EQ(queue.cwnd(), initial_cwnd / 2);
+}
+
+TEST_F(RetransmissionQueueTest, KeepsCwndOnPacketLossWithBbr) {
+  options_.congestion_control_algorithm = CongestionControlAlgorithm::kBbr;
+  RetransmissionQueue queue = CreateQueue();
+  size_t initial_cwnd = queue.cwnd();
+  EXPECT_CALL(producer_, Produce)
+      .WillOnce(CreateChunk(OutgoingMessageId(0)))
+      .WillOnce(CreateChunk(OutgoingMessageId(1)))
+      .WillOnce(CreateChunk(OutgoingMessageId(2)))
+      .WillOnce(CreateChunk(OutgoingMessageId(3)))
+      .WillOnce(CreateChunk(OutgoingMessageId(4)))
+      .WillRepeatedly([](Timestamp, size_t) { return std::nullopt; });
+  EXPECT_THAT(GetSentPacketTSNs(queue), SizeIs(5));
+
+  // Nack TSN 11 three times.
+  queue.HandleSack(now_, SackChunk(TSN(10), kArwnd, {{2, 2}}, {}));
+  queue.HandleSack(now_, SackChunk(TSN(10), kArwnd, {{2, 3}}, {}));
+  queue.HandleSack(now_, SackChunk(TSN(10), kArwnd, {{2, 4}}, {}));
+
+  EXPECT_THAT(GetTSNsForFastRetransmit(queue), ElementsAre(TSN(11)));
+  EXPECT_EQ(queue.cwnd(), initial_cwnd);
+}
+
 TEST_F(RetransmissionQueueTest, ReadyForHandoverWhenHasNoOutstandingData) {
   RetransmissionQueue queue = CreateQueue();
   EXPECT_CALL(producer_, Produce)
@@ -9,6 +9,7 @@
  */
 #include "net/dcsctp/tx/rr_send_queue.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <deque>
 #include <limits>
@@ -24,6 +25,7 @@
 #include "net/dcsctp/packet/data.h"
 #include "net/dcsctp/public/dcsctp_message.h"
 #include "net/dcsctp/public/dcsctp_socket.h"
+#include "net/dcsctp/public/payload.h"
 #include "net/dcsctp/public/types.h"
 #include "net/dcsctp/tx/send_queue.h"
 #include "rtc_base/logging.h"
@@ -61,6 +63,13 @@ size_t RRSendQueue::OutgoingStream::bytes_to_send_in_next_message() const {
   return items_.front().remaining_size;
 }
 
+Timestamp RRSendQueue::OutgoingStream::next_message_expires_at() const {
+  if (items_.empty()) {
+    return Timestamp::PlusInfinity();
+  }
+  return items_.front().attributes.expires_at;
+}
+
 void RRSendQueue::OutgoingStream::AddHandoverState(
     DcSctpSocketHandoverState::OutgoingStream& state) const {
   state.next_ssn = next_ssn_.value();
@@ -167,27 +176,23 @@ std::optional<SendQueue::DataToSend> RRSendQueue::OutgoingStream::Produce(
     }
 
     // Grab the next `max_size` fragment from this message and calculate flags.
-    rtc::ArrayView<const uint8_t> chunk_payload =
-        item.message.payload().subview(item.remaining_offset, max_size);
-    rtc::ArrayView<const uint8_t> message_payload = message.payload();
-    Data::IsBeginning is_beginning(chunk_payload.data() ==
-                                   message_payload.data());
-    Data::IsEnd is_end((chunk_payload.data() + chunk_payload.size()) ==
-                       (message_payload.data() + message_payload.size()));
+    // The fragment references the message payload, which isn't copied.
+    const Payload& message_payload = message.shared_payload();
+    const size_t payload_size = std::min(
+        max_size, message_payload.size() - item.remaining_offset);
+    Payload payload =
+        message_payload.Slice(item.remaining_offset, payload_size);
+    Data::IsBeginning is_beginning(item.remaining_offset == 0);
+    Data::IsEnd is_end(item.remaining_offset + payload_size ==
+                       message_payload.size());
 
     StreamID stream_id = message.stream_id();
     PPID ppid = message.ppid();
 
-    // Zero-copy the payload if the message fits in a single chunk.
-    std::vector<uint8_t> payload =
-        is_beginning && is_end
-            ? std::move(message).ReleasePayload()
-            : std::vector<uint8_t>(chunk_payload.begin(), chunk_payload.end());
-
     FSN fsn(item.current_fsn);
     item.current_fsn = FSN(*item.current_fsn + 1);
-    buffered_amount_.Decrease(payload.size());
-    parent_.total_buffered_amount_.Decrease(payload.size());
+    buffered_amount_.Decrease(payload_size);
+    parent_.total_buffered_amount_.Decrease(payload_size);
 
     SendQueue::DataToSend chunk(
         item.message_id, Data(stream_id, item.ssn.value_or(SSN(0)), *item.mid,
@@ -199,8 +204,8 @@ std::optional<SendQueue::DataToSend> RRSendQueue::OutgoingStream::Produce(
         is_end ? item.attributes.lifecycle_id : LifecycleId::NotSet();
 
     if (is_end) {
-      // The entire message has been sent, and its last data copied to `chunk`,
-      // so it can safely be discarded.
+      // The entire message has been sent, and its last data referenced by
+      // `chunk`, so it can safely be discarded.
       items_.pop_front();
 
       if (pause_state_ == PauseState::kPending) {
@@ -209,8 +214,8 @@ std::optional<SendQueue::DataToSend> RRSendQueue::OutgoingStream::Produce(
         pause_state_ = PauseState::kPaused;
       }
     } else {
-      item.remaining_offset += chunk_payload.size();
-      item.remaining_size -= chunk_payload.size();
+      item.remaining_offset += payload_size;
+      item.remaining_size -= payload_size;
       RTC_DCHECK(item.remaining_offset + item.remaining_size ==
                  item.message.payload().size());
       RTC_DCHECK(item.remaining_size > 0);
@@ -94,6 +94,13 @@ class RRSendQueue : public SendQueue {
     scheduler_.EnableMessageInterleaving(enabled);
   }
 
+  // Enables sending the messages that expire first, across all streams, first.
+  // See `DcSctpOptions::enable_deadline_scheduling`. This must be called before
+  // any message has been added.
+  void EnableDeadlineScheduling(bool enabled) {
+    scheduler_.EnableDeadlineScheduling(enabled);
+  }
+
   void SetStreamPriority(StreamID stream_id, StreamPriority priority);
   StreamPriority GetStreamPriority(StreamID stream_id) const;
   HandoverReadinessStatus GetHandoverReadiness() const;
@@ -157,6 +164,7 @@ class RRSendQueue : public SendQueue {
     std::optional<SendQueue::DataToSend> Produce(webrtc::Timestamp now,
                                                  size_t max_size) override;
     size_t bytes_to_send_in_next_message() const override;
+    webrtc::Timestamp next_message_expires_at() const override;
 
     const ThresholdWatcher& buffered_amount() const { return buffered_amount_; }
     ThresholdWatcher& buffered_amount() { return buffered_amount_; }
@@ -23,6 +23,7 @@
 #include "net/dcsctp/testing/testing_macros.h"
 #include "net/dcsctp/tx/send_queue.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
 #include "test/gmock.h"
 
 namespace dcsctp {
@@ -97,6 +98,24 @@ TEST_F(RRSendQueueTest, CarveOutBeginningMiddleAndEnd) {
   EXPECT_FALSE(buf_.Produce(kNow, kOneFragmentPacketSize).has_value());
 }
 
+TEST_F(RRSendQueueTest, FragmentsReferenceMessagePayload) {
+  std::vector<uint8_t> payload(60);
+  const uint8_t* payload_data = payload.data();
+  buf_.Add(kNow, DcSctpMessage(kStreamID, kPPID, std::move(payload)));
+
+  ASSERT_HAS_VALUE_AND_ASSIGN(SendQueue::DataToSend chunk_beg,
+                              buf_.Produce(kNow, /*max_size=*/20));
+  ASSERT_HAS_VALUE_AND_ASSIGN(SendQueue::DataToSend chunk_mid,
+                              buf_.Produce(kNow, /*max_size=*/20));
+  ASSERT_HAS_VALUE_AND_ASSIGN(SendQueue::DataToSend chunk_end,
+                              buf_.Produce(kNow, /*max_size=*/20));
+
+  EXPECT_EQ(chunk_beg.data.payload.data(), payload_data);
+  EXPECT_EQ(chunk_mid.data.payload.data(), payload_data + 20);
+  EXPECT_EQ(chunk_end.data.payload.data(), payload_data + 40);
+  EXPECT_EQ(chunk_end.data.Clone().payload.data(), payload_data + 40);
+}
+
 TEST_F(RRSendQueueTest, GetChunksFromTwoMessages) {
   std::vector<uint8_t> payload(60);
   buf_.Add(kNow, DcSctpMessage(kStreamID, kPPID, payload));
@@ -886,5 +905,97 @@ TEST_F(RRSendQueueTest, WillSendLifecycleExpireWhenDiscardingExplicitly) {
   EXPECT_CALL(callbacks_, OnLifecycleEnd(LifecycleId(1)));
   buf_.Discard(chunk_one->data.stream_id, chunk_one->message_id);
 }
+
+TEST_F(RRSendQueueTest, WillSendMessageThatExpiresFirstWithDeadlineScheduling) {
+  RRSendQueue q("log: ", &callbacks_, kMtu, kDefaultPriority,
+                kBufferedAmountLowThreshold);
+  q.EnableDeadlineScheduling(true);
+
+  q.Add(kNow, DcSctpMessage(StreamID(1), kPPID, std::vector<uint8_t>(10)));
+  q.Add(kNow, DcSctpMessage(StreamID(2), kPPID, std::vector<uint8_t>(10)),
+        SendOptions{.lifetime = DurationMs(200)});
+  q.Add(kNow, DcSctpMessage(StreamID(3), kPPID, std::vector<uint8_t>(10)),
+        SendOptions{.lifetime = DurationMs(100)});
+  // Expired when produced, and discarded before any other message is sent.
+  q.Add(kNow, DcSctpMessage(StreamID(4), kPPID, std::vector<uint8_t>(10)),
+        SendOptions{.lifetime = DurationMs(10)});
+
+  std::vector<uint16_t> expected_streams = {3, 2, 1};
+  for (uint16_t stream_num : expected_streams) {
+    ASSERT_HAS_VALUE_AND_ASSIGN(
+        SendQueue::DataToSend chunk,
+        q.Produce(kNow + TimeDelta::Millis(50), kOneFragmentPacketSize));
+    EXPECT_EQ(chunk.data.stream_id, StreamID(stream_num));
+  }
+  EXPECT_FALSE(q.Produce(kNow, kOneFragmentPacketSize).has_value());
+  EXPECT_TRUE(q.IsEmpty());
+}
+
+// Sends real-time messages with a limited lifetime on three streams, together
+// with bulk data without a limited lifetime on another, over a simulated link
+// that can send one chunk per millisecond. Returns the ratio of real-time
+// messages that were fully sent before they expired.
+double MeasureOnTimeRatio(DcSctpSocketCallbacks& callbacks,
+                          bool deadline_scheduling) {
+  constexpr size_t kMaxChunkPayload = 1000;
+  constexpr TimeDelta kDuration = TimeDelta::Seconds(2);
+  struct RealTimeStream {
+    StreamID stream_id;
+    TimeDelta interval;
+    size_t size;
+    DurationMs lifetime;
+  };
+  constexpr RealTimeStream kRealTimeStreams[] = {
+      {StreamID(2), TimeDelta::Millis(5), 300, DurationMs(30)},
+      {StreamID(3), TimeDelta::Millis(10), 500, DurationMs(15)},
+      {StreamID(4), TimeDelta::Millis(20), 2000, DurationMs(100)}};
+  constexpr StreamID kBulkStream(1);
+  constexpr size_t kBulkMessageSize = 10000;
+
+  RRSendQueue q("log: ", &callbacks, kMaxChunkPayload + 100, kDefaultPriority,
+                kBufferedAmountLowThreshold);
+  q.EnableDeadlineScheduling(deadline_scheduling);
+
+  int sent_messages = 0;
+  int on_time_messages = 0;
+  // Continue sending after the last message was added, until all messages
+  // have been sent or expired.
+  for (Timestamp now = kNow; now < kNow + kDuration + TimeDelta::Millis(200);
+       now += TimeDelta::Millis(1)) {
+    if (now < kNow + kDuration) {
+      for (const RealTimeStream& stream : kRealTimeStreams) {
+        if ((now - kNow).ms() % stream.interval.ms() == 0) {
+          q.Add(now,
+                DcSctpMessage(stream.stream_id, kPPID,
+                              std::vector<uint8_t>(stream.size)),
+                SendOptions{.lifetime = stream.lifetime});
+          ++sent_messages;
+        }
+      }
+    }
+    while (q.buffered_amount(kBulkStream) < 2 * kBulkMessageSize) {
+      q.Add(now, DcSctpMessage(kBulkStream, kPPID,
+                               std::vector<uint8_t>(kBulkMessageSize)));
+    }
+
+    std::optional<SendQueue::DataToSend> chunk =
+        q.Produce(now, kMaxChunkPayload);
+    if (chunk.has_value() && chunk->data.stream_id != kBulkStream &&
+        *chunk->data.is_end && now < chunk->expires_at) {
+      ++on_time_messages;
+    }
+  }
+  return static_cast<double>(on_time_messages) / sent_messages;
+}
+
+TEST_F(RRSendQueueTest, DeadlineSchedulingSendsMoreMessagesOnTime) {
+  double round_robin = MeasureOnTimeRatio(callbacks_, false);
+  double deadline = MeasureOnTimeRatio(callbacks_, true);
+  RTC_LOG(LS_INFO) << "On-time ratio, round-robin=" << round_robin
+                   << ", deadline=" << deadline;
+
+  EXPECT_GT(deadline, 0.95);
+  EXPECT_GT(deadline, round_robin);
+}
 }  // namespace
 }  // namespace dcsctp
@@ -47,6 +47,9 @@ std::optional<SendQueue::DataToSend> StreamScheduler::Produce(
                               [&](rtc::StringBuilder& sb, const auto& p) {
                                 sb << *p->stream_id() << "@"
                                    << *p->next_finish_time();
+                                if (p->next_deadline().IsFinite()) {
+                                  sb << "/" << p->next_deadline().ms();
+                                }
                               });
 
   RTC_DCHECK(rescheduling || current_stream_ != nullptr);
@@ -177,6 +180,9 @@ void StreamScheduler::Stream::MakeActive(size_t bytes_to_send_next) {
                        << *next_finish_time;
   RTC_DCHECK(next_finish_time_ == VirtualTime::Zero());
   next_finish_time_ = next_finish_time;
+  next_deadline_ = parent_.enable_deadline_scheduling_
+                       ? producer_.next_message_expires_at()
+                       : webrtc::Timestamp::PlusInfinity();
   RTC_DCHECK(!absl::c_any_of(parent_.active_streams_,
                              [this](const auto* p) { return p == this; }));
   parent_.active_streams_.emplace(this);
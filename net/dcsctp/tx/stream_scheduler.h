@@ -25,12 +25,14 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
 #include "api/array_view.h"
+#include "api/units/timestamp.h"
 #include "net/dcsctp/packet/chunk/idata_chunk.h"
 #include "net/dcsctp/packet/sctp_packet.h"
 #include "net/dcsctp/public/dcsctp_message.h"
 #include "net/dcsctp/public/dcsctp_socket.h"
 #include "net/dcsctp/public/types.h"
 #include "net/dcsctp/tx/send_queue.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/containers/flat_set.h"
 #include "rtc_base/strong_alias.h"
 
@@ -60,6 +62,13 @@ namespace dcsctp {
 // inverse of the stream's priority, meaning that a high priority - or a smaller
 // fragment - results in a closer virtual finish time, compared to a stream with
 // either a lower priority or a larger fragment to be sent.
+//
+// When deadline scheduling is enabled, streams are primarily ordered by the
+// expiration time of their next message (earliest deadline first), and the
+// virtual finish time is only used to order streams with the same deadline,
+// such as those without any limited lifetime. This makes messages that will
+// expire soon be sent before others, and expired messages be discarded as
+// soon as possible, instead of when they would have been sent.
 class StreamScheduler {
  private:
   class VirtualTime : public webrtc::StrongAlias<class VirtualTimeTag, double> {
@@ -94,6 +103,13 @@ class StreamScheduler {
     // next enqueued message, or zero if there are no enqueued messages or if
     // the stream has been actively paused.
     virtual size_t bytes_to_send_in_next_message() const = 0;
+
+    // Returns the time when the next enqueued message expires, or plus
+    // infinity if it doesn't have a limited lifetime. Only used when deadline
+    // scheduling is enabled.
+    virtual webrtc::Timestamp next_message_expires_at() const {
+      return webrtc::Timestamp::PlusInfinity();
+    }
   };
 
   class Stream {
@@ -140,6 +156,7 @@ class StreamScheduler {
 
     VirtualTime current_time() const { return current_virtual_time_; }
     VirtualTime next_finish_time() const { return next_finish_time_; }
+    webrtc::Timestamp next_deadline() const { return next_deadline_; }
     size_t bytes_to_send_in_next_message() const {
       return producer_.bytes_to_send_in_next_message();
     }
@@ -154,6 +171,9 @@ class StreamScheduler {
     // This outgoing stream's "current" virtual_time.
     VirtualTime current_virtual_time_ = VirtualTime::Zero();
     VirtualTime next_finish_time_ = VirtualTime::Zero();
+    // When deadline scheduling is enabled, the expiration time of the next
+    // message. Only valid when the stream is active.
+    webrtc::Timestamp next_deadline_ = webrtc::Timestamp::PlusInfinity();
   };
 
   // The `mtu` parameter represents the maximum SCTP packet size, which should
@@ -173,6 +193,13 @@ class StreamScheduler {
     enable_message_interleaving_ = enabled;
   }
 
+  // Enables earliest deadline first scheduling, see above. This must be called
+  // before any stream has been made active.
+  void EnableDeadlineScheduling(bool enabled) {
+    RTC_DCHECK(active_streams_.empty());
+    enable_deadline_scheduling_ = enabled;
+  }
+
   // Makes the scheduler stop producing message from the current stream and
   // re-evaluates which stream to produce from.
   void ForceReschedule() { currently_sending_a_message_ = false; }
@@ -188,8 +215,13 @@ class StreamScheduler {
 
  private:
   struct ActiveStreamComparator {
-    // Ordered by virtual finish time (primary), stream-id (secondary).
+    // Ordered by deadline (primary, which is plus infinity unless deadline
+    // scheduling is enabled), virtual finish time (secondary) and stream-id
+    // (tertiary).
     bool operator()(Stream* a, Stream* b) const {
+      if (a->next_deadline() != b->next_deadline()) {
+        return a->next_deadline() < b->next_deadline();
+      }
       VirtualTime a_vft = a->next_finish_time();
       VirtualTime b_vft = b->next_finish_time();
       if (a_vft == b_vft) {
@@ -211,6 +243,7 @@ class StreamScheduler {
   Stream* current_stream_ = nullptr;
 
   bool enable_message_interleaving_ = false;
+  bool enable_deadline_scheduling_ = false;
 
   // Indicates if the streams is currently sending a message, and should then
   // - if message interleaving is not enabled - continue sending from this
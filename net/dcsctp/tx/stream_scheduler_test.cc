@@ -74,6 +74,7 @@ class MockStreamProducer : public StreamScheduler::StreamProducer {
               (Timestamp, size_t),
               (override));
   MOCK_METHOD(size_t, bytes_to_send_in_next_message, (), (const, override));
+  MOCK_METHOD(Timestamp, next_message_expires_at, (), (const, override));
 };
 
 class TestStream {
@@ -763,5 +764,59 @@ TEST(StreamSchedulerTest, SendLargeMessageWithLargeMtu) {
   EXPECT_EQ(scheduler.Produce(kNow, kMtu), std::nullopt);
 }
 
+
+// With deadline scheduling, the stream whose next message expires first is
+// produced from first, and streams without expiring messages are produced from
+// last.
+TEST(StreamSchedulerTest, ProducesFromStreamWithEarliestDeadlineFirst) {
+  StreamScheduler scheduler("", kMtu);
+  scheduler.EnableDeadlineScheduling(true);
+
+  StrictMock<MockStreamProducer> producer1;
+  EXPECT_CALL(producer1, Produce)
+      .WillOnce(CreateChunk(OutgoingMessageId(0), StreamID(1), MID(1)));
+  EXPECT_CALL(producer1, bytes_to_send_in_next_message)
+      .WillOnce(Return(kPayloadSize))  // When making active
+      .WillOnce(Return(0));
+  EXPECT_CALL(producer1, next_message_expires_at)
+      .WillRepeatedly(Return(Timestamp::PlusInfinity()));
+  auto stream1 =
+      scheduler.CreateStream(&producer1, StreamID(1), StreamPriority(1));
+  stream1->MaybeMakeActive();
+
+  StrictMock<MockStreamProducer> producer2;
+  EXPECT_CALL(producer2, Produce)
+      .WillOnce(CreateChunk(OutgoingMessageId(1), StreamID(2), MID(2)))
+      .WillOnce(CreateChunk(OutgoingMessageId(3), StreamID(2), MID(4)));
+  EXPECT_CALL(producer2, bytes_to_send_in_next_message)
+      .WillOnce(Return(kPayloadSize))  // When making active
+      .WillOnce(Return(kPayloadSize))
+      .WillOnce(Return(0));
+  EXPECT_CALL(producer2, next_message_expires_at)
+      .WillOnce(Return(kNow + webrtc::TimeDelta::Millis(200)))
+      .WillOnce(Return(kNow + webrtc::TimeDelta::Millis(400)));
+  auto stream2 =
+      scheduler.CreateStream(&producer2, StreamID(2), StreamPriority(1));
+  stream2->MaybeMakeActive();
+
+  StrictMock<MockStreamProducer> producer3;
+  EXPECT_CALL(producer3, Produce)
+      .WillOnce(CreateChunk(OutgoingMessageId(2), StreamID(3), MID(3)));
+  EXPECT_CALL(producer3, bytes_to_send_in_next_message)
+      .WillOnce(Return(kPayloadSize))  // When making active
+      .WillOnce(Return(0));
+  EXPECT_CALL(producer3, next_message_expires_at)
+      .WillOnce(Return(kNow + webrtc::TimeDelta::Millis(300)));
+  auto stream3 =
+      scheduler.CreateStream(&producer3, StreamID(3), StreamPriority(1));
+  stream3->MaybeMakeActive();
+
+  EXPECT_THAT(scheduler.Produce(kNow, kMtu), HasDataWithMid(MID(2)));
+  EXPECT_THAT(scheduler.Produce(kNow, kMtu), HasDataWithMid(MID(3)));
+  EXPECT_THAT(scheduler.Produce(kNow, kMtu), HasDataWithMid(MID(4)));
+  EXPECT_THAT(scheduler.Produce(kNow, kMtu), HasDataWithMid(MID(1)));
+  EXPECT_EQ(scheduler.Produce(kNow, kMtu), std::nullopt);
+}
+
 }  // namespace
 }  // namespace dcsctp
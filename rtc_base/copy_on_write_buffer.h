@@ -41,6 +41,10 @@ class RTC_EXPORT CopyOnWriteBuffer {
   // Construct a buffer from a string, convenient for unittests.
   explicit CopyOnWriteBuffer(absl::string_view s);
 
+  // Construct a buffer that takes ownership of the data in `buffer`, without
+  // copying it.
+  explicit CopyOnWriteBuffer(Buffer&& buffer);
+
   // Construct a buffer with the specified number of uninitialized bytes.
   explicit CopyOnWriteBuffer(size_t size);
   CopyOnWriteBuffer(size_t size, size_t capacity);
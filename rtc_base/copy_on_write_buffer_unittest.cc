@@ -11,7 +11,9 @@
 #include "rtc_base/copy_on_write_buffer.h"
 
 #include <cstdint>
+#include <utility>
 
+#include "rtc_base/buffer.h"
 #include "test/gtest.h"
 
 namespace rtc {
@@ -79,6 +81,21 @@ TEST(CopyOnWriteBufferTest, TestMoveConstruct) {
   EXPECT_EQ(buf2.data(), buf1_data);
 }
 
+TEST(CopyOnWriteBufferTest, AdoptsBufferWithoutCopying) {
+  Buffer buffer(kTestData, 3, 10);
+  const uint8_t* data = buffer.data();
+
+  CopyOnWriteBuffer buf(std::move(buffer));
+  EXPECT_EQ(buf.cdata(), data);
+  EXPECT_EQ(buf.size(), 3u);
+  EXPECT_EQ(buf.capacity(), 10u);
+  EXPECT_EQ(buf, CopyOnWriteBuffer(kTestData, 3));
+
+  CopyOnWriteBuffer empty((Buffer()));
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.data(), nullptr);
+}
+
 TEST(CopyOnWriteBufferTest, TestMoveAssign) {
   CopyOnWriteBuffer buf1(kTestData, 3, 10);
   size_t buf1_size = buf1.size();
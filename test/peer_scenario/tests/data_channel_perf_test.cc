@@ -0,0 +1,255 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the throughput, message latency and CPU usage of data channels
+// between two peer connections in the same process, over an emulated network
+// in simulated time, so that no external signaling is needed. This is used to
+// catch performance regressions in SctpDataChannel and DcSctpTransport.
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "api/data_channel_interface.h"
+#include "api/numerics/samples_stats_counter.h"
+#include "api/scoped_refptr.h"
+#include "api/test/metrics/global_metrics_logger_and_exporter.h"
+#include "api/test/metrics/metric.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/strings/string_builder.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+#include "test/peer_scenario/peer_scenario.h"
+#include "test/peer_scenario/peer_scenario_client.h"
+
+namespace webrtc {
+namespace {
+
+using test::GetGlobalMetricsLogger;
+using test::ImprovementDirection;
+using test::PeerScenario;
+using test::PeerScenarioClient;
+using test::Unit;
+
+constexpr DataRate kLinkCapacity = DataRate::KilobitsPerSec(50'000);
+constexpr int kOneWayDelayMs = 10;
+constexpr double kLossRate = 0.005;
+constexpr TimeDelta kMeasurementDuration = TimeDelta::Seconds(5);
+// The sender keeps this much data buffered, which is enough to not be limited
+// by the application, while keeping the message latency bounded.
+constexpr DataSize kMaxBufferedAmount = DataSize::Bytes(256 * 1024);
+
+// Sends messages with a sequence number in the first bytes, as fast as the
+// data channel accepts them, and records when each message was sent.
+class Sender : public DataChannelObserver {
+ public:
+  Sender(rtc::scoped_refptr<DataChannelInterface> channel,
+         Clock& clock,
+         size_t message_size)
+      : channel_(channel), clock_(clock), message_size_(message_size) {
+    channel_->RegisterObserver(this);
+  }
+  ~Sender() override { channel_->UnregisterObserver(); }
+
+  void OnStateChange() override { MaybeSend(); }
+  void OnMessage(const DataBuffer& buffer) override {}
+  void OnBufferedAmountChange(uint64_t sent_data_size) override {
+    MaybeSend();
+  }
+
+  void Start() {
+    sending_ = true;
+    MaybeSend();
+  }
+  void Stop() { sending_ = false; }
+
+  // Returns when the message with `sequence_number` was sent.
+  Timestamp send_time(uint64_t sequence_number) const {
+    return send_times_[sequence_number];
+  }
+
+ private:
+  void MaybeSend() {
+    if (!sending_ || channel_->state() != DataChannelInterface::kOpen) {
+      return;
+    }
+    while (channel_->buffered_amount() + message_size_ <=
+           kMaxBufferedAmount.bytes()) {
+      rtc::CopyOnWriteBuffer payload(message_size_);
+      uint64_t sequence_number = send_times_.size();
+      std::memcpy(payload.MutableData(), &sequence_number,
+                  sizeof(sequence_number));
+      send_times_.push_back(clock_.CurrentTime());
+      RTC_CHECK(channel_->Send(DataBuffer(payload, /*binary=*/true)));
+    }
+  }
+
+  const rtc::scoped_refptr<DataChannelInterface> channel_;
+  Clock& clock_;
+  const size_t message_size_;
+  bool sending_ = false;
+  std::vector<Timestamp> send_times_;
+};
+
+class Receiver : public DataChannelObserver {
+ public:
+  Receiver(rtc::scoped_refptr<DataChannelInterface> channel,
+           Clock& clock,
+           const Sender& sender)
+      : channel_(channel), clock_(clock), sender_(sender) {
+    channel_->RegisterObserver(this);
+  }
+  ~Receiver() override { channel_->UnregisterObserver(); }
+
+  void OnStateChange() override {}
+  void OnMessage(const DataBuffer& buffer) override {
+    RTC_CHECK_GE(buffer.size(), sizeof(uint64_t));
+    uint64_t sequence_number;
+    std::memcpy(&sequence_number, buffer.data.cdata(), sizeof(sequence_number));
+    if (measuring_) {
+      received_bytes_ += buffer.size();
+      latency_ms_.AddSample(
+          (clock_.CurrentTime() - sender_.send_time(sequence_number)).ms());
+    }
+  }
+
+  void set_measuring(bool measuring) { measuring_ = measuring; }
+  int64_t received_bytes() const { return received_bytes_; }
+  const SamplesStatsCounter& latency_ms() const { return latency_ms_; }
+
+ private:
+  const rtc::scoped_refptr<DataChannelInterface> channel_;
+  Clock& clock_;
+  const Sender& sender_;
+  bool measuring_ = false;
+  int64_t received_bytes_ = 0;
+  SamplesStatsCounter latency_ms_;
+};
+
+// Parameterized by the message size, if messages are sent ordered, and if
+// they are sent reliably (or without retransmissions).
+class DataChannelPerfTest
+    : public ::testing::TestWithParam<std::tuple<size_t, bool, bool>> {
+ protected:
+  static std::string TestCaseName() {
+    auto [message_size, ordered, reliable] = GetParam();
+    rtc::StringBuilder sb;
+    sb << "DataChannel_" << message_size << "B_"
+       << (ordered ? "ordered" : "unordered") << "_"
+       << (reliable ? "reliable" : "unreliable");
+    return sb.Release();
+  }
+};
+
+TEST_P(DataChannelPerfTest, Throughput) {
+  auto [message_size, ordered, reliable] = GetParam();
+  PeerScenario s(*::testing::UnitTest::GetInstance()->current_test_info());
+  Clock& clock = *s.net()->time_controller()->GetClock();
+
+  PeerScenarioClient* caller = s.CreateClient(PeerScenarioClient::Config());
+  PeerScenarioClient* callee = s.CreateClient(PeerScenarioClient::Config());
+  auto send_node = s.net()
+                       ->NodeBuilder()
+                       .capacity(kLinkCapacity)
+                       .delay_ms(kOneWayDelayMs)
+                       .loss(kLossRate)
+                       .Build()
+                       .node;
+  auto ret_node = s.net()
+                      ->NodeBuilder()
+                      .capacity(kLinkCapacity)
+                      .delay_ms(kOneWayDelayMs)
+                      .loss(kLossRate)
+                      .Build()
+                      .node;
+
+  DataChannelInit init;
+  init.ordered = ordered;
+  if (!reliable) {
+    init.maxRetransmits = 0;
+  }
+  auto channel = caller->pc()->CreateDataChannelOrError("perf", &init);
+  ASSERT_TRUE(channel.ok());
+  Sender sender(channel.MoveValue(), clock, message_size);
+
+  std::unique_ptr<Receiver> receiver;
+  std::atomic<bool> channel_received(false);
+  callee->handlers()->on_data_channel.push_back(
+      [&](rtc::scoped_refptr<DataChannelInterface> channel) {
+        receiver = std::make_unique<Receiver>(channel, clock, sender);
+        channel_received = true;
+      });
+  s.SimpleConnection(caller, callee, {send_node}, {ret_node});
+  ASSERT_TRUE(s.WaitAndProcess(&channel_received));
+
+  // Let the congestion window open before measuring.
+  sender.Start();
+  s.ProcessMessages(TimeDelta::Seconds(2));
+
+  receiver->set_measuring(true);
+  int64_t cpu_start_ns = rtc::GetProcessCpuTimeNanos();
+  s.ProcessMessages(kMeasurementDuration);
+  int64_t cpu_ns = rtc::GetProcessCpuTimeNanos() - cpu_start_ns;
+  receiver->set_measuring(false);
+  sender.Stop();
+
+  ASSERT_GT(receiver->received_bytes(), 0);
+  const std::string test_case = TestCaseName();
+  DataRate throughput =
+      DataSize::Bytes(receiver->received_bytes()) / kMeasurementDuration;
+  GetGlobalMetricsLogger()->LogSingleValueMetric(
+      "throughput", test_case, throughput.kbps<double>(),
+      Unit::kKilobitsPerSecond, ImprovementDirection::kBiggerIsBetter);
+  GetGlobalMetricsLogger()->LogMetric(
+      "message_latency", test_case, receiver->latency_ms(),
+      Unit::kMilliseconds, ImprovementDirection::kSmallerIsBetter);
+  // GetPercentile() sorts the samples, hence the copy.
+  SamplesStatsCounter latency_ms = receiver->latency_ms();
+  for (double percentile : {0.5, 0.95, 0.99}) {
+    rtc::StringBuilder name;
+    name << "message_latency_p" << static_cast<int>(percentile * 100);
+    GetGlobalMetricsLogger()->LogSingleValueMetric(
+        name.str(), test_case, latency_ms.GetPercentile(percentile),
+        Unit::kMilliseconds, ImprovementDirection::kSmallerIsBetter);
+  }
+  // The CPU time is that of the whole process, which includes both peers and
+  // the network emulation.
+  GetGlobalMetricsLogger()->LogSingleValueMetric(
+      "cpu_time_per_megabyte", test_case,
+      cpu_ns / 1e6 / (receiver->received_bytes() / 1e6), Unit::kMilliseconds,
+      ImprovementDirection::kSmallerIsBetter);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    DataChannelPerfTest,
+    DataChannelPerfTest,
+    ::testing::Combine(::testing::Values(1000, 16000, 64000),
+                       ::testing::Bool(),
+                       ::testing::Bool()),
+    [](const ::testing::TestParamInfo<DataChannelPerfTest::ParamType>& info) {
+      rtc::StringBuilder sb;
+      sb << std::get<0>(info.param) << "B_"
+         << (std::get<1>(info.param) ? "Ordered" : "Unordered") << "_"
+         << (std::get<2>(info.param) ? "Reliable" : "Unreliable");
+      return sb.Release();
+    });
+
+}  // namespace
+}  // namespace webrtc